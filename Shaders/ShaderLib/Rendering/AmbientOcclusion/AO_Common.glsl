@@ -1,6 +1,8 @@
 #pragma once
 
 #define USE_NORMAL_TEXTURE_BIT 0x1
+#define USE_DEPTH_PYRAMID_BIT 0x2
+#define REVERSE_DEPTH_BIT 0x4
 
 #define AO_METHOD_SSAO 0
 #define AO_METHOD_RTAO 1
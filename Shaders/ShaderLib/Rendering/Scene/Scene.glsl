@@ -184,8 +184,8 @@ uvec3 getSceneMeshTriangleVerticexIndices(uint mesh_id, uint primitive_id, uint
 
 layout(SCENE_MATERIAL_BINDING + 0) buffer restrict SCENE_MATERIAL_ACCESS ScenePBMaterialsBinding
 {
-	PBMaterialProperties props;
-} scene_pb_materials[];
+	PBMaterialProperties props[];
+} scene_pb_materials;
 
 layout(SCENE_MATERIAL_BINDING + 1) buffer restrict SCENE_MATERIAL_ACCESS ScenePBMaterialsRefBinding
 {
@@ -227,7 +227,7 @@ bool SceneTestTriangleOpacity(uint object_index, uint primitive_id, vec2 triangl
 	const vec2 texture_uv = interpolateSceneVertex(hit_object_ref.mesh_id, vertices_id, triangle_uv).uv;
 	
 	const uint material_id = hit_object_ref.material_id;
-	const PBMaterialProperties props = scene_pb_materials[NonUniformEXT(material_id)].props;
+	const PBMaterialProperties props = scene_pb_materials.props[material_id];
 
 	//if((props.flags & MATERIAL_FLAG_USE_ALPHA_TEXTURE_BIT) != 0) // assumed to be true since not opaque
 	{
@@ -244,7 +244,7 @@ bool SceneTestTriangleOpacityIFN(uint object_index, uint primitive_id, vec2 tria
 	bool res = false;
 	const SceneObjectReference hit_object_ref = scene_objects_table.table[object_index];
 	const uint material_id = hit_object_ref.material_id;
-	const PBMaterialProperties props = scene_pb_materials[NonUniformEXT(material_id)].props;
+	const PBMaterialProperties props = scene_pb_materials.props[material_id];
 	if((props.flags & MATERIAL_FLAG_USE_ALPHA_TEXTURE_BIT) != 0)
 	{
 		res = SceneTestTriangleOpacity(object_index, primitive_id, triangle_uv);
@@ -9,6 +9,8 @@
 #endif
 
 #define SCENE_OBJECT_FLAG_VISIBLE_BIT 1
+// Moved during the latest frames
+#define SCENE_OBJECT_FLAG_DYNAMIC_BIT 2
 
 #define SCENE_BINDING SCENE_DESCRIPTOR_BINDING + 0
 
@@ -49,6 +49,9 @@ namespace vkl
 
 	class SamplerLibrary;
 	class TextureFileCache;
+	class GeometryArena;
+	class MemoryTelemetry;
+	class ShaderInstanceRegistry;
 
 	class DependencyTracker;
 
@@ -80,6 +83,10 @@ namespace vkl
 			bool dump_shader_spv : 1 = false;
 			bool dump_slang_to_glsl : 1 = false;
 			bool generate_shader_debug_info : 1 = false;
+			// No window, surface nor presentation
+			bool headless : 1 = false;
+			// Sub-allocate the meshes geometry from shared buffers
+			bool use_geometry_arena : 1 = true;
 
 			int shaderc_optimization_level = 0;
 			int slang_optiomization_level = 0;
@@ -153,6 +160,8 @@ namespace vkl
 		VkDevice _device = VK_NULL_HANDLE;
 
 		VmaAllocator _allocator = nullptr;
+		// Outlives the allocator (resources released late are still accounted)
+		std::unique_ptr<MemoryTelemetry> _memory_telemetry = nullptr;
 
 		MyVector<MyVector<std::shared_ptr<Queue>>> _queues_by_family = {};
 		MyVector<std::shared_ptr<CommandPool>> _command_pools = {};
@@ -235,6 +244,10 @@ namespace vkl
 
 		std::unique_ptr<TextureFileCache> _texture_file_cache = nullptr;
 
+		std::unique_ptr<GeometryArena> _geometry_arena = nullptr;
+
+		std::unique_ptr<ShaderInstanceRegistry> _shader_instance_registry = nullptr;
+
 		std::unique_ptr<PrebuilTransferCommands> _prebuilt_transfer_commands = nullptr;
 
 		DefinitionsMap _common_shader_definitions = {};
@@ -469,6 +482,22 @@ namespace vkl
 			return *_texture_file_cache;
 		}
 
+		MemoryTelemetry& memoryTelemetry()
+		{
+			return *_memory_telemetry;
+		}
+
+		// nullptr if disabled (--geometry_arena 0)
+		GeometryArena* geometryArena()
+		{
+			return _geometry_arena.get();
+		}
+
+		ShaderInstanceRegistry& shaderInstanceRegistry()
+		{
+			return *_shader_instance_registry;
+		}
+
 		PrebuilTransferCommands& getPrebuiltTransferCommands()
 		{
 			assert(_prebuilt_transfer_commands);
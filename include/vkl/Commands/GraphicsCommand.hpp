@@ -186,6 +186,8 @@ namespace vkl
 			uint32_t indirect_draw_stride = 5 * 4;
 			
 			BufferAndRangeInstance indirect_draw_buffer;
+			// IndirectDrawCount: the draw count is read from this buffer (draw_count is the max draw count)
+			BufferAndRangeInstance indirect_draw_count_buffer = {};
 			
 			BufferAndRangeInstance index_buffer = {};
 			
@@ -195,6 +197,9 @@ namespace vkl
 			Index vertex_buffer_begin = 0; // index in _vertex_buffers
 
 			std::shared_ptr<DescriptorSetAndPoolInstance> set = nullptr;
+
+			uint32_t first_index = 0;
+			int32_t vertex_offset = 0;
 		};
 
 		MyVector<DrawCallInfo> _draw_list;
@@ -246,6 +251,7 @@ namespace vkl
 			uint32_t indirect_draw_stride = 5 * 4;
 
 			BufferAndRange indirect_draw_buffer = {};
+			BufferAndRange indirect_draw_count_buffer = {};
 
 			BufferAndRange index_buffer = {};
 
@@ -255,6 +261,9 @@ namespace vkl
 			Index vertex_buffer_begin = 0;
 
 			std::shared_ptr<DescriptorSetAndPool> set = nullptr;
+
+			uint32_t first_index = 0;
+			int32_t vertex_offset = 0;
 		};
 
 	public:
@@ -309,6 +318,8 @@ namespace vkl
 			uint32_t indirect_draw_stride = 5 * 4;
 
 			BufferAndRange indirect_draw_buffer = {};
+			// IndirectDrawCount(Indexed): the draw count is read from this buffer (draw_count is the max draw count)
+			BufferAndRange indirect_draw_count_buffer = {};
 
 			BufferAndRange index_buffer = {};
 			VkIndexType index_type = VK_INDEX_TYPE_MAX_ENUM;
@@ -317,6 +328,10 @@ namespace vkl
 			typename std::conditional<CONST_VB, const BufferAndRange, BufferAndRange>::type * vertex_buffers = nullptr;
 
 			std::shared_ptr<DescriptorSetAndPool> set = nullptr;
+
+			// In elements of the bound index and vertex buffers (DrawIndexed)
+			uint32_t first_index = 0;
+			int32_t vertex_offset = 0;
 		};
 		using DrawCallInfo = DrawCallInfoT<false>;
 		using DrawCallInfoConst = DrawCallInfoT<true>;
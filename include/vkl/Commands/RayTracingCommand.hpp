@@ -15,6 +15,14 @@ namespace vkl
 		
 		Dyn<DefinitionsList> _common_shader_definitions;
 
+		struct ShaderAndDefinitions
+		{
+			std::shared_ptr<Shader> shader = nullptr;
+			// Definitions specific to the shader, prepended to the common shader definitions
+			DefinitionsList definitions = {};
+		};
+		MyVector<ShaderAndDefinitions> _shaders_definitions = {};
+
 		Dyn<VkExtent3D> _extent;
 		std::shared_ptr<ShaderBindingTable> _sbt = nullptr;
 
@@ -165,5 +173,7 @@ namespace vkl
 		}
 
 		virtual bool updateResources(UpdateContext & ctx) override;
+
+		virtual void prepareSpeculativeDefinitions(UpdateContext & ctx, DefinitionsList const& definitions) override;
 	};
 }
\ No newline at end of file
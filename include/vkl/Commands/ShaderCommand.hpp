@@ -116,6 +116,10 @@ namespace vkl
 
 		virtual bool updateResources(UpdateContext & ctx) override;
 
+		// Compile in the background the shaders for definitions (as the command definitions would evaluate to) likely to be used soon
+		// Can be called on a command that is not updated (ex: an alternative method of a module)
+		virtual void prepareSpeculativeDefinitions(UpdateContext & ctx, DefinitionsList const& definitions);
+
 		std::shared_ptr<Pipeline> const& pipeline()const
 		{
 			return _pipeline;
@@ -5,6 +5,10 @@
 #include <type_traits>
 #include <vkl/Utils/stl_extension.hpp>
 #include <optional>
+#include <atomic>
+#include <mutex>
+#include <cstring>
+#include <array>
 
 template <class Q, class T>
 concept TLike = std::is_convertible<Q, T>::value;
@@ -125,6 +129,45 @@ namespace vkl
 	DECLARE_FOR_EACH_BINARY_OPERATOR(DECLARE_BINARY_OPERATOR_WRAPPER)
 	//DECLARE_FOR_EACH_BINARY_OPERATOR_A(DECLARE_BINARY_ASSIGN_OPERATOR_WRAPPER)
 	DECLARE_FOR_EACH_UNARY_OPERATOR(DECLARE_UNARY_OPERATOR_WRAPPER)
+
+	// Monotonic counter: a memoized DynamicValue evaluates its source at most once per epoch
+	// The global epoch is advanced by ResourcesManager::beginUpdateCycle (once per update tick)
+	class DynamicValueEpoch
+	{
+	protected:
+
+		// 0 means "never evaluated"
+		std::atomic<size_t> _value = 1;
+
+	public:
+
+		size_t value() const
+		{
+			return _value.load(std::memory_order_acquire);
+		}
+
+		size_t advance()
+		{
+			return _value.fetch_add(1, std::memory_order_acq_rel) + 1;
+		}
+
+		static DynamicValueEpoch& Global()
+		{
+			static DynamicValueEpoch epoch;
+			return epoch;
+		}
+	};
+
+	struct DynamicValueStats
+	{
+		// Number of lambda invocations of all the DynamicValues (sample it before and after a frame)
+		static inline std::atomic<size_t> lambda_evaluations = 0;
+
+		static size_t LambdaEvaluations()
+		{
+			return lambda_evaluations.load(std::memory_order_relaxed);
+		}
+	};
 	
 	namespace impl
 	{
@@ -142,6 +185,9 @@ namespace vkl
 
 			mutable T _value = {};
 
+			// Epoch of the last change of _value
+			mutable size_t _change_epoch = DynamicValueEpoch::Global().value();
+
 		public:
 
 			DynamicValueInstance() = default;
@@ -188,18 +234,27 @@ namespace vkl
 			{
 				assert(canSetValue());
 				_value = t;
+				// The value might have been read during the current epoch
+				_change_epoch = DynamicValueEpoch::Global().value() + 1;
 			}
 
 			void setValue(T && t)
 			{
 				assert(canSetValue());
 				_value = std::move(t);
+				_change_epoch = DynamicValueEpoch::Global().value() + 1;
 			}
 
 			virtual bool canSetValue() const
 			{
 				return true;
 			}
+
+			// Conservative: true if the value may have changed after epoch (the epoch at which it was last read)
+			virtual bool changedSince(size_t epoch) const
+			{
+				return _change_epoch > epoch;
+			}
 		};
 
 		template <class T>
@@ -227,6 +282,11 @@ namespace vkl
 			{
 				return false;
 			}
+
+			virtual bool changedSince(size_t epoch) const override
+			{
+				return true;
+			}
 		};
 
 		template <class T>
@@ -253,6 +313,7 @@ namespace vkl
 
 			virtual T const& value() const override
 			{
+				DynamicValueStats::lambda_evaluations.fetch_add(1, std::memory_order_relaxed);
 				DynamicValueInstance<T>::_value = _lambda();
 				return DynamicValueInstance<T>::_value;
 			}
@@ -261,6 +322,11 @@ namespace vkl
 			{
 				return false;
 			}
+
+			virtual bool changedSince(size_t epoch) const override
+			{
+				return true;
+			}
 		};
 
 		template <class T>
@@ -287,6 +353,7 @@ namespace vkl
 
 			virtual T const& value() const override
 			{
+				DynamicValueStats::lambda_evaluations.fetch_add(1, std::memory_order_relaxed);
 				_lambda(DynamicValueInstance<T>::_value);
 				return DynamicValueInstance<T>::_value;
 			}
@@ -295,6 +362,100 @@ namespace vkl
 			{
 				return false;
 			}
+
+			virtual bool changedSince(size_t epoch) const override
+			{
+				return true;
+			}
+		};
+
+		// Caches the value of the source instance, re-evaluated (at most) once per epoch
+		// Only valid if the source does not change during an epoch (or if a value from the beginning of the epoch is acceptable)
+		// A change writes the slot which is not published: a reference returned by value() stays valid until the end of the next epoch
+		// Change epochs are always in the global epoch numbering (changedSince), whatever epoch drives the evaluations
+		// getCachedValue() is not meaningful for this instance
+		template <class T>
+		class MemoizedValueInstance : public DynamicValueInstance<T>
+		{
+		protected:
+
+			std::shared_ptr<DynamicValueInstance<T>> _source;
+			const DynamicValueEpoch* _epoch;
+
+			mutable std::array<T, 2> _slots = {};
+			mutable std::atomic<uint32_t> _published_slot = 0;
+			mutable std::atomic<size_t> _evaluated_epoch = 0;
+			// Global epoch
+			mutable std::atomic<size_t> _global_change_epoch = 0;
+			mutable std::mutex _mutex;
+
+			static bool Equals(T const& a, T const& b)
+			{
+				if constexpr (std::equality_comparable<T>)
+				{
+					return a == b;
+				}
+				else if constexpr (std::is_trivially_copyable<T>::value)
+				{
+					// Can report a false change because of padding, which is fine
+					return std::memcmp(&a, &b, sizeof(T)) == 0;
+				}
+				else
+				{
+					return false;
+				}
+			}
+
+			void refresh() const
+			{
+				const size_t epoch = _epoch->value();
+				if (_evaluated_epoch.load(std::memory_order_acquire) != epoch)
+				{
+					std::unique_lock lock(_mutex);
+					const size_t previous = _evaluated_epoch.load(std::memory_order_relaxed);
+					if (previous != epoch)
+					{
+						T const& value = _source->value();
+						const uint32_t published = _published_slot.load(std::memory_order_relaxed);
+						if (previous == 0 || !Equals(value, _slots[published]))
+						{
+							const uint32_t next = 1 - published;
+							_slots[next] = value;
+							_published_slot.store(next, std::memory_order_release);
+							// Evaluated at the first read of a global epoch: no reader of this epoch saw the previous value
+							// With another epoch, the global one may already have been read: conservative
+							const size_t global_epoch = DynamicValueEpoch::Global().value();
+							_global_change_epoch.store((_epoch == &DynamicValueEpoch::Global()) ? epoch : (global_epoch + 1), std::memory_order_release);
+						}
+						_evaluated_epoch.store(epoch, std::memory_order_release);
+					}
+				}
+			}
+
+		public:
+
+			MemoizedValueInstance(std::shared_ptr<DynamicValueInstance<T>> const& source, const DynamicValueEpoch* epoch) :
+				DynamicValueInstance<T>(),
+				_source(source),
+				_epoch(epoch ? epoch : &DynamicValueEpoch::Global())
+			{}
+
+			virtual T const& value() const override
+			{
+				refresh();
+				return _slots[_published_slot.load(std::memory_order_acquire)];
+			}
+
+			virtual bool canSetValue() const override
+			{
+				return false;
+			}
+
+			virtual bool changedSince(size_t epoch) const override
+			{
+				refresh();
+				return _global_change_epoch.load(std::memory_order_acquire) > epoch;
+			}
 		};
 	}
 
@@ -488,6 +649,24 @@ namespace vkl
 			return hasValue() ? value() : std::optional<T>{};
 		}
 
+		// Opt-in: returns a DynamicValue evaluating this one at most once per epoch (the global update epoch by default)
+		DynamicValue memoized(const DynamicValueEpoch * epoch = nullptr) const
+		{
+			DynamicValue res;
+			if (hasValue())
+			{
+				res._inst = std::make_shared<impl::MemoizedValueInstance<T>>(_inst, epoch);
+			}
+			return res;
+		}
+
+		// epoch: value of DynamicValueEpoch::Global() when the value was last read
+		// Cheap for memoized and constant values, always true for the other lambda and pointer values
+		bool changedSince(size_t epoch) const
+		{
+			return hasValue() ? _inst->changedSince(epoch) : false;
+		}
+
 		operator std::optional<T>() const
 		{
 			return optionalValue();
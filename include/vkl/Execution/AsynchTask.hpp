@@ -6,6 +6,7 @@
 #include <functional>
 #include <shared_mutex>
 #include <chrono>
+#include <algorithm>
 
 #include <vkl/Core/LogOptions.hpp>
 
@@ -141,6 +142,14 @@ namespace vkl
 			return _priority;
 		}
 
+		// Never lowers the priority
+		// A task already queued in an executor should be promoted with DelayedTaskExecutor::promoteTask instead
+		void raisePriority(TaskPriority priority)
+		{
+			std::unique_lock lock(_mutex);
+			_priority = std::max(_priority, priority);
+		}
+
 		void cancel(const Logger * logger = {})
 		{
 			cancel(true, logger);
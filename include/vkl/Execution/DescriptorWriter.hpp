@@ -249,6 +249,9 @@ namespace vkl
 			return _tlas.data() + o;
 		}
 
+		// Appends the writes of other (after the writes of this)
+		void append(DescriptorWriter const& other);
+
 		void record();
 	};
 }
\ No newline at end of file
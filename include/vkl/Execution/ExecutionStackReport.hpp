@@ -45,6 +45,12 @@ namespace vkl
 
 			TimePoint begin_timepoint = {};
 			TimePoint end_timepoint = {};
+
+			// Second stage: label_range is the formatted text, the raw label and durations are kept for the exports
+			Range name_range = {};
+			double cpu_duration_ns = 0;
+			// NaN if not available
+			double gpu_duration_ns = 0;
 		};
 	
 	protected:
@@ -86,6 +92,16 @@ namespace vkl
 
 		void prepareForGUI();
 
+		MyVector<Segment> const& segments() const
+		{
+			return _stack;
+		}
+
+		std::string_view getSegmentName(Segment const& seg) const
+		{
+			return _strings.get(seg.name_range);
+		}
+
 		TimePoint const& beginTimepoint() const
 		{
 			return _begin_timepoint;
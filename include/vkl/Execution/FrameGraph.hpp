@@ -0,0 +1,107 @@
+#pragma once
+
+#include <vkl/Execution/ResourceState.hpp>
+#include <vkl/Commands/ResourceUsageList.hpp>
+
+#include <optional>
+
+namespace vkl
+{
+	// Resource access of a frame graph node
+	// The handles are only used as identifiers, so a frame graph can be compiled without a device
+	// Exactly one of buffer, image and memory is set
+	struct FrameGraphAccess
+	{
+		VkBuffer buffer = VK_NULL_HANDLE;
+		VkImage image = VK_NULL_HANDLE;
+		// Memory of aliased images (in buffer_range)
+		const ImageMemoryBlock * memory = nullptr;
+		Buffer::Range buffer_range = {};
+		VkImageSubresourceRange image_range = MakeZeroImageSubRange();
+		ResourceState2 state = {};
+		std::optional<ResourceState2> end_state = {};
+		// Only orders the nodes, not synchronized (e.g. the memory of aliased images)
+		bool ordering_only = false;
+
+		bool isImage() const
+		{
+			return image != VK_NULL_HANDLE;
+		}
+
+		bool sameResource(FrameGraphAccess const& o) const
+		{
+			return (buffer == o.buffer) && (image == o.image) && (memory == o.memory);
+		}
+
+		// Writes or changes the state (layout, end state) of the resource
+		bool modifiesResource() const;
+
+		bool overlaps(FrameGraphAccess const& o) const;
+
+		// The order of two conflicting accesses must be preserved
+		bool conflictsWith(FrameGraphAccess const& o) const;
+	};
+
+	struct FrameGraphBarrierCounts
+	{
+		size_t pipeline_barriers = 0;
+		size_t buffer_barriers = 0;
+		size_t image_barriers = 0;
+	};
+
+	// Compiles a segment of nodes recorded in order (with no state change in between, like a bound set or a debug label) into batches
+	// A node is placed in the batch following the latest batch of the nodes it depends on, so the nodes of a batch are independent
+	// Each batch can be synchronized with a single (merged) barrier, instead of one barrier per node
+	class FrameGraphCompiler
+	{
+	protected:
+
+		MyVector<FrameGraphAccess> _accesses = {};
+		// Ranges in _accesses
+		MyVector<Range32u> _nodes = {};
+
+		// Nodes indices, batch after batch, in recording order within a batch
+		MyVector<uint32_t> _order = {};
+		// Ranges in _order
+		MyVector<Range32u> _batches = {};
+		MyVector<uint32_t> _node_batch = {};
+		size_t _dependencies = 0;
+
+	public:
+
+		void clear();
+
+		// Returns the index of the new node, the following accesses are added to it
+		uint32_t addNode();
+
+		void addAccess(FrameGraphAccess const& access);
+
+		void addAccesses(ResourceUsageList const& resources);
+
+		void compile();
+
+		uint32_t nodeCount() const
+		{
+			return _nodes.size32();
+		}
+
+		MyVector<uint32_t> const& order() const
+		{
+			return _order;
+		}
+
+		MyVector<Range32u> const& batches() const
+		{
+			return _batches;
+		}
+
+		size_t dependencyCount() const
+		{
+			return _dependencies;
+		}
+
+		// CPU simulation of the barriers recorded by the SynchronizationHelper (tracking whole resources states)
+		// Either one synchronization per node in recording order, or one merged synchronization per compiled batch
+		FrameGraphBarrierCounts countBarriers(bool compiled) const;
+	};
+}
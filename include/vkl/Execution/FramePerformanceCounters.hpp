@@ -14,6 +14,16 @@ namespace vkl
 		size_t exec_update_time = 0;
 		size_t main_script_modules_time = 0;
 		size_t descriptor_updates = 0;
+		// Lambda invocations of DynamicValues during the frame
+		size_t dynamic_value_evaluations = 0;
+
+		// ResourcesLists::update phases (accumulated over the lists updated with the frame's UpdateContext)
+		size_t update_images_time = 0;
+		size_t update_buffers_time = 0;
+		size_t update_samplers_time = 0;
+		size_t update_commands_time = 0;
+		size_t update_sets_time = 0;
+		size_t update_framebuffers_time = 0;
 		
 		size_t generate_scene_draw_list_time = 0;
 		size_t render_draw_list_time = 0;
@@ -31,6 +41,70 @@ namespace vkl
 		size_t image_barriers = 0;
 		size_t layout_transitions = 0;
 
+		size_t submissions = 0;
+		size_t created_semaphores = 0;
+		size_t created_fences = 0;
+
+		size_t shadow_maps_rendered = 0;
+		size_t shadow_maps_reused = 0;
+		size_t shadow_map_static_layers_rendered = 0;
+		size_t shadow_casters = 0;
+		size_t shadow_casters_cull_time = 0;
+
+		// Calls f(name, value) on each counter, in declaration order (for exports)
+		template <class Function>
+		void forEach(Function const& f) const
+		{
+			f("frame_time", frame_time);
+			f("update_time", update_time);
+			f("render_time", render_time);
+			f("prepare_scene_time", prepare_scene_time);
+			f("update_scene_time", update_scene_time);
+			f("exec_update_time", exec_update_time);
+			f("main_script_modules_time", main_script_modules_time);
+			f("descriptor_updates", descriptor_updates);
+			f("dynamic_value_evaluations", dynamic_value_evaluations);
+			f("update_images_time", update_images_time);
+			f("update_buffers_time", update_buffers_time);
+			f("update_samplers_time", update_samplers_time);
+			f("update_commands_time", update_commands_time);
+			f("update_sets_time", update_sets_time);
+			f("update_framebuffers_time", update_framebuffers_time);
+			f("generate_scene_draw_list_time", generate_scene_draw_list_time);
+			f("render_draw_list_time", render_draw_list_time);
+			f("draw_calls", draw_calls);
+			f("total_draw_calls", total_draw_calls);
+			f("dispatch_calls", dispatch_calls);
+			f("total_dispatch_threads", total_dispatch_threads);
+			f("transfer_calls", transfer_calls);
+			f("total_upload_size", total_upload_size);
+			f("pipeline_barriers", pipeline_barriers);
+			f("buffer_barriers", buffer_barriers);
+			f("image_barriers", image_barriers);
+			f("layout_transitions", layout_transitions);
+			f("submissions", submissions);
+			f("created_semaphores", created_semaphores);
+			f("created_fences", created_fences);
+			f("shadow_maps_rendered", shadow_maps_rendered);
+			f("shadow_maps_reused", shadow_maps_reused);
+			f("shadow_map_static_layers_rendered", shadow_map_static_layers_rendered);
+			f("shadow_casters", shadow_casters);
+			f("shadow_casters_cull_time", shadow_casters_cull_time);
+		}
+
+		// Only size_t counters: summed member by member
+		FramePerfCounters& operator+=(FramePerfCounters const& o)
+		{
+			static_assert(sizeof(FramePerfCounters) % sizeof(size_t) == 0);
+			size_t * dst = reinterpret_cast<size_t*>(this);
+			const size_t * src = reinterpret_cast<const size_t*>(&o);
+			for (size_t i = 0; i < sizeof(FramePerfCounters) / sizeof(size_t); ++i)
+			{
+				dst[i] += src[i];
+			}
+			return *this;
+		}
+
 		void reset()
 		{
 			memset(this, 0, sizeof(FramePerfCounters));
@@ -2,6 +2,8 @@
 
 #include "Executor.hpp"
 #include "ExecutionContext.hpp"
+#include "FrameGraph.hpp"
+#include "SynchObjectsPool.hpp"
 
 #include <queue>
 
@@ -30,6 +32,7 @@ namespace vkl
 		ExecutionContext* _context;
 
 		uint32_t _current_render_pass_index = uint32_t(-1);
+		uint32_t _current_render_pass_command_index = uint32_t(-1);
 		uint32_t _current_subpass_index = 0;
 		bool _deferred_record = false;
 		bool _render_pass_synch_subpass = false;
@@ -95,12 +98,28 @@ namespace vkl
 		ResourceUsageList _render_pass_resources;
 		SynchronizationHelper _synch;
 
+		// Deferred record: the nodes (and render passes) between two state changes (bound sets, debug labels) form a segment of the frame graph
+		struct FrameGraphItem
+		{
+			uint32_t command_index = 0;
+			const ResourceUsageList * resources = nullptr;
+		};
+		FrameGraphCompiler _frame_graph;
+		MyVector<FrameGraphItem> _frame_graph_items;
+		MyVector<std::unique_ptr<ResourceUsageList>> _frame_graph_render_passes_resources;
+
 		void clearDeferedLists();
 
 		void executeNode(std::shared_ptr<ExecutionNode> const &node);
 
 		void recordEventNotRenderPass(uint32_t index, bool synch);
 
+		// Returns the index of the EndRenderPass event
+		uint32_t recordRenderPass(uint32_t command_index);
+
+		// Returns the index of the first event after the segment
+		uint32_t recordFrameGraphSegment(uint32_t begin);
+
 		bool useDeferredRecord() const;
 
 		void releaseNodes();
@@ -164,6 +183,19 @@ namespace vkl
 
 		void reset();
 
+		bool deferredRecord() const
+		{
+			return _deferred_record;
+		}
+
+		// When deferred, the commands are recorded by recordCommands(), with the barriers batched across independent nodes
+		void setDeferredRecord(bool deferred)
+		{
+			assert(_commands.empty());
+			_deferred_record = deferred;
+		}
+
+		// Records the deferred commands to the command buffer of the context
 		void recordCommands();
 	};
 
@@ -194,9 +226,32 @@ namespace vkl
 		ExecutionContext _context;
 
 		std::unique_ptr<ExecutionThread> _execution_thread;
+		bool _use_frame_graph = false;
 
 		ExecutionThread* _current_thread = nullptr;
 
+		// Binary semaphores and fences, only needed by the swapchain
+		std::shared_ptr<SynchObjectsPool> _synch_objects_pool = nullptr;
+		size_t _frame_created_semaphores = 0;
+		size_t _frame_created_fences = 0;
+		size_t _frame_submissions = 0;
+
+		// Each submission signals the next value of the timeline of its queue
+		struct QueueTimeline
+		{
+			Queue * queue = nullptr;
+			std::shared_ptr<TimelineSemaphore> semaphore = nullptr;
+			// Value of the latest recorded command buffer
+			uint64_t recorded_value = 0;
+			uint64_t submitted_value = 0;
+			// Polled in recyclePreviousEvents
+			uint64_t completed_value = 0;
+		};
+		// One per queue of the application, created with the executor
+		MyVector<QueueTimeline> _queue_timelines = {};
+
+		uint32_t getQueueTimelineIndex(Queue * queue);
+
 		std::deque<std::shared_ptr<CommandBufferSubmission>> _previous_cbs = {};
 		std::deque<std::shared_ptr<SwapchainEvent>> _previous_swapchain_events = {};
 
@@ -235,6 +290,7 @@ namespace vkl
 			bool use_ImGui = false;
 			bool use_debug_renderer = true;
 			bool use_ray_tracing = false;
+			bool use_frame_graph = false;
 		};
 
 		using CI = CreateInfo;
@@ -281,10 +337,29 @@ namespace vkl
 
 		void waitOnCommandCompletion(bool global_wait = false, uint64_t timeout = UINT64_MAX);
 
+		// Timeline value signaled by the latest submission on the queue (main queue if null)
+		uint64_t latestSubmissionValue(Queue * queue = nullptr);
+
+		bool submissionIsComplete(uint64_t value, Queue * queue = nullptr);
+
+		// CPU wait until the submissions of the queue up to value are complete
+		VkResult waitForSubmission(uint64_t value, Queue * queue = nullptr, uint64_t timeout = UINT64_MAX);
+
 		void waitOnSwapchainCompletion(bool global_wait = false, uint64_t timeout = UINT64_MAX);
 
 		virtual void waitForAllCompletion(uint64_t timeout = UINT64_MAX) override final;
 
+		bool useFrameGraph() const
+		{
+			return _use_frame_graph;
+		}
+
+		// Applied from the next command buffer
+		void setUseFrameGraph(bool use)
+		{
+			_use_frame_graph = use;
+		}
+
 		std::shared_ptr<FramePerfReport> const& getPendingFrameReport()
 		{
 			return _pending_frame_report;
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <vkl/App/VkApplication.hpp>
+
+#include <atomic>
+#include <array>
+#include <functional>
+#include <mutex>
+#include <map>
+#include <ostream>
+#include <filesystem>
+
+namespace vkl
+{
+	class StatRecords;
+	class GuiContext;
+
+	enum class MemoryCategory : uint8_t
+	{
+		// Deduced from the usage of the resource
+		Auto = 0,
+		Mesh,
+		Texture,
+		RenderTarget,
+		Staging,
+		Uniform,
+		AccelerationStructure,
+		Other,
+		MAX_ENUM,
+	};
+
+	const char * GetMemoryCategoryName(MemoryCategory category);
+
+	MemoryCategory DeduceBufferMemoryCategory(VkBufferUsageFlags usage, VmaMemoryUsage mem_usage);
+
+	MemoryCategory DeduceImageMemoryCategory(VkImageUsageFlags usage);
+
+	// Tracks the device memory allocated per category (by the BufferInstances and ImageInstances), and the heap budgets (from VMA)
+	class MemoryTelemetry : public VkObject
+	{
+	public:
+
+		struct HeapBudget
+		{
+			VkMemoryHeapFlags flags = 0;
+			// Of the whole process (as reported by the driver with VK_EXT_memory_budget, estimated otherwise)
+			VkDeviceSize usage = 0;
+			VkDeviceSize budget = 0;
+			// Of the VMA allocator
+			VkDeviceSize block_bytes = 0;
+			VkDeviceSize allocation_bytes = 0;
+			uint32_t block_count = 0;
+			uint32_t allocation_count = 0;
+		};
+
+		struct OverBudget
+		{
+			uint32_t heap = 0;
+			HeapBudget budget = {};
+			VkDeviceSize threshold = 0;
+		};
+
+		// Called once when a heap goes over the threshold (and again if it goes back under, then over)
+		using OverBudgetCallback = std::function<void(OverBudget const&)>;
+
+		struct CategoryStats
+		{
+			VkDeviceSize bytes = 0;
+			VkDeviceSize peak_bytes = 0;
+			uint32_t allocations = 0;
+		};
+
+	protected:
+
+		struct CategoryCounters
+		{
+			std::atomic<VkDeviceSize> bytes = 0;
+			std::atomic<VkDeviceSize> peak_bytes = 0;
+			std::atomic<uint32_t> allocations = 0;
+		};
+
+		std::array<CategoryCounters, size_t(MemoryCategory::MAX_ENUM)> _categories;
+
+		mutable std::mutex _mutex;
+		MyVector<HeapBudget> _heaps = {};
+		MyVector<uint8_t> _heaps_over_budget = {};
+		size_t _samples = 0;
+
+		// Fraction of the budget
+		float _over_budget_threshold = 0.95f;
+		uint32_t _callback_counter = 0;
+		std::map<uint32_t, OverBudgetCallback> _over_budget_callbacks = {};
+
+		std::filesystem::path _report_path = {};
+
+	public:
+
+		struct CreateInfo
+		{
+			VkApplication * app = nullptr;
+			std::string name = {};
+			float over_budget_threshold = 0.95f;
+			std::filesystem::path report_path = "memory_report.json";
+		};
+		using CI = CreateInfo;
+
+		MemoryTelemetry(CreateInfo const& ci);
+
+		virtual ~MemoryTelemetry() override;
+
+		// Thread safe
+		void onAllocate(MemoryCategory category, VkDeviceSize size);
+
+		// Thread safe
+		void onFree(MemoryCategory category, VkDeviceSize size);
+
+		CategoryStats categoryStats(MemoryCategory category) const;
+
+		// Queries the heap budgets and calls the over budget callbacks
+		// Cheap enough to be called once per frame
+		void sample();
+
+		MyVector<HeapBudget> heapBudgets() const;
+
+		uint32_t addOverBudgetCallback(OverBudgetCallback const& callback);
+
+		void removeOverBudgetCallback(uint32_t id);
+
+		// The records read the latest sample
+		void createStatRecords(StatRecords & records);
+
+		// JSON: heaps, categories and the detailed VMA statistics
+		void writeReport(std::ostream & out) const;
+
+		bool dumpReport(std::filesystem::path const& path);
+
+		void declareGUI(GuiContext & ctx);
+	};
+}
@@ -13,6 +13,7 @@ namespace vkl
 	class Command;
 	class Framebuffer;
 	class UpdateContext;
+	class DelayedTaskExecutor;
 
 	struct ResourcesLists
 	{
@@ -41,7 +42,11 @@ namespace vkl
 		ResourcesLists operator+(std::shared_ptr<DescriptorSetAndPool> const& set) const;
 		ResourcesLists operator+(std::shared_ptr<Command> const& cmd) const;
 
-		void update(UpdateContext& context);
+		// Updates in phases, in this order: images, buffers, samplers, commands, sets, framebuffers
+		// If executor is not null, the objects of the buffers, commands and sets phases are updated in parallel on it
+		// (each object once, with a context per chunk of objects, merged in order at the end of the phase)
+		// The other phases reach objects shared between the listed ones (images of views, attachments of framebuffers) and remain serial
+		void update(UpdateContext& context, DelayedTaskExecutor * executor = nullptr);
 
 		void clear();
 	};
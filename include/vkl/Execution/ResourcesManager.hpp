@@ -24,6 +24,9 @@ namespace vkl
 
 		DescriptorWriter _descriptor_writer;
 
+		// Update the resources to update later on the thread pool
+		bool _parallel_update = false;
+
 		void populateCommonObjects();
 
 	public:
@@ -33,6 +36,7 @@ namespace vkl
 			VkApplication * app = nullptr;
 			std::string name = {};
 			std::chrono::milliseconds auto_file_check_period = 1000ms;
+			bool parallel_update = false;
 		};
 
 		ResourcesManager(CreateInfo const& ci);
@@ -57,5 +61,15 @@ namespace vkl
 		{
 			return _common_definitions.get();
 		}
+
+		bool parallelUpdate() const
+		{
+			return _parallel_update;
+		}
+
+		void setParallelUpdate(bool parallel)
+		{
+			_parallel_update = parallel;
+		}
 	};
 }
\ No newline at end of file
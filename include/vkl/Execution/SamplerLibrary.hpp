@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vkl/VkObjects/Sampler.hpp>
+#include <vkl/Utils/ShardedCache.hpp>
 
 #include <unordered_map>
 #include <atomic>
@@ -29,10 +30,12 @@ namespace vkl
 			size_t operator()(SamplerInfo const& si) const;
 		};
 
+		// Of the named samplers
 		mutable std::shared_mutex _mutex;
 		
 		std::atomic<size_t> _sampler_count = 0;
-		std::unordered_map<SamplerInfo, std::shared_ptr<Sampler>, Hasher> _map;
+		// Looked up concurrently by the loader threads
+		ShardedCache<SamplerInfo, Sampler, Hasher> _cache;
 		std::unordered_map<std::string, std::shared_ptr<Sampler>> _named_samplers;
 		std::shared_ptr<Sampler> _default_sampler;
 
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <vkl/VkObjects/Semaphore.hpp>
+#include <vkl/VkObjects/Fence.hpp>
+
+#include <mutex>
+
+namespace vkl
+{
+	// Recycles the binary semaphores and fences
+	// The objects are handed as shared_ptr, they return to the pool when the last reference is released
+	// The owner must make sure the GPU is done with an object before releasing it (like before destroying it)
+	class SynchObjectsPool : public VkObject, public std::enable_shared_from_this<SynchObjectsPool>
+	{
+	protected:
+
+		std::mutex _mutex;
+		MyVector<std::unique_ptr<Semaphore>> _free_semaphores = {};
+		MyVector<std::unique_ptr<Fence>> _free_fences = {};
+
+		size_t _created_semaphores = 0;
+		size_t _created_fences = 0;
+
+		void release(Semaphore * semaphore);
+
+		void release(Fence * fence);
+
+	public:
+
+		struct CreateInfo
+		{
+			VkApplication * app = nullptr;
+			std::string name = {};
+		};
+		using CI = CreateInfo;
+
+		SynchObjectsPool(CreateInfo const& ci);
+
+		virtual ~SynchObjectsPool() override;
+
+		// Unsignaled binary semaphore
+		std::shared_ptr<Semaphore> getSemaphore();
+
+		// Unsignaled fence
+		std::shared_ptr<Fence> getFence();
+
+		size_t createdSemaphores() const
+		{
+			return _created_semaphores;
+		}
+
+		size_t createdFences() const
+		{
+			return _created_fences;
+		}
+
+		size_t freeSemaphores() const
+		{
+			return _free_semaphores.size();
+		}
+
+		size_t freeFences() const
+		{
+			return _free_fences.size();
+		}
+	};
+}
@@ -255,6 +255,11 @@ namespace vkl
 	bool InlineSynchronizeImage(ExecutionContext& ctx, std::shared_ptr<ImageInstance> const& ii, VkImageSubresourceRange const& range, ResourceState2 const& begin_state, std::optional<ResourceState2> const& end_state = {});
 	bool InlineSynchronizeImageView(ExecutionContext& ctx, std::shared_ptr<ImageViewInstance> const& ivi, ResourceState2 const& begin_state, std::optional<ResourceState2> const& end_state = {});
 
+	// Merges the barriers of a same pipeline barrier:
+	// - on the same range (the masks are combined, and at most one layout transition per subresource is kept)
+	// - with the same masks (and layouts) on contiguous ranges (buffer ranges, image mips or layers)
+	void MergeBarriers(MyVector<VkBufferMemoryBarrier2> & buffers, MyVector<VkImageMemoryBarrier2> & images);
+
 	class SynchronizationHelper
 	{
 	protected:
@@ -262,6 +267,8 @@ namespace vkl
 		ExecutionContext * _ctx = nullptr;
 		MyVector<VkBufferMemoryBarrier2> _buffers;
 		MyVector<VkImageMemoryBarrier2> _images;
+
+		bool _merge_barriers = false;
 		
 		BufferUsageFunction getBufferProcessFunction();
 
@@ -272,6 +279,12 @@ namespace vkl
 
 		void reset(ExecutionContext * ctx);
 
+		// Useful when committing the resources of multiple nodes before a single record
+		void setMergeBarriers(bool merge)
+		{
+			_merge_barriers = merge;
+		}
+
 		void commit(AbstractBufferUsageList const& buffers);
 
 		void commit(AbstractImageUsageList const& images);
@@ -39,6 +39,12 @@ namespace vkl
 
 		virtual bool isMultiThreaded() const = 0;
 
+		// Raises the priority of a task which may already be queued (ex: an urgent request joins a background task)
+		virtual void promoteTask(std::shared_ptr<AsynchTask> const& task, TaskPriority priority)
+		{
+			task->raisePriority(priority);
+		}
+
 		// Returns true if all tasks were completed
 		// Returns false if some task could not be launched because some dependencies could not be completed
 		virtual bool waitAll() = 0;
@@ -170,6 +176,9 @@ namespace vkl
 
 		virtual void pushTasks(const std::shared_ptr<AsynchTask> * tasks, size_t n) override;
 
+		// Moves the task in the ready queue if it is already there
+		virtual void promoteTask(std::shared_ptr<AsynchTask> const& task, TaskPriority priority) override;
+
 		virtual bool waitAll() override;
 
 		virtual bool isMultiThreaded() const override
@@ -182,4 +191,10 @@ namespace vkl
 			return _workers.size();
 		}
 	};
+
+	// Calls process(i) for each i in [0, count), on the calling thread and on up to maxCapacity() helper tasks of the executor
+	// Returns once every index is processed
+	// If process throws, the indices not started yet are skipped, and the first exception is rethrown once all the others are done
+	// The helpers don't own process: a helper starting after all the indices are taken returns without calling it
+	void ProcessInParallel(DelayedTaskExecutor * executor, size_t count, std::string const& name, std::function<void(size_t)> const& process);
 } // namespace vkl
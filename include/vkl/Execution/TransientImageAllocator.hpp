@@ -0,0 +1,107 @@
+#pragma once
+
+#include <vkl/Execution/Executor.hpp>
+#include <vkl/VkObjects/Image.hpp>
+#include <vkl/IO/GuiContext.hpp>
+
+namespace vkl
+{
+	// Binds images which are only alive during a part of the frame (their content is not kept from a frame to the next) to a shared memory block
+	// Images with non overlapping lifetimes are aliased (bound to the same memory)
+	// Must be updated before the images, and recordBeginFrame() must be recorded before their first use in the frame
+	class TransientImageAllocator : public VkObject
+	{
+	public:
+
+		// In passes indices of the frame: the image is first written in the pass first, and last read in the pass last
+		struct Lifetime
+		{
+			uint32_t first = 0;
+			uint32_t last = 0;
+
+			constexpr bool overlaps(Lifetime const& other) const
+			{
+				return (first <= other.last) && (other.first <= last);
+			}
+		};
+
+		struct Stats
+		{
+			uint32_t images = 0;
+			// Without aliasing
+			VkDeviceSize summed_size = 0;
+			// Size of the shared memory block
+			VkDeviceSize aliased_size = 0;
+		};
+
+	protected:
+
+		struct Entry
+		{
+			std::shared_ptr<Image> image = nullptr;
+			Lifetime lifetime = {};
+			// Of the current plan
+			bool held = false;
+			bool planned = false;
+			VkImageCreateInfo planned_ci = {};
+			VkMemoryRequirements requirements = {};
+			VkDeviceSize offset = 0;
+		};
+
+		MyVector<Entry> _entries = {};
+		std::shared_ptr<ImageMemoryBlock> _block = nullptr;
+		bool _enable = true;
+		bool _suspended = false;
+		bool _should_plan = true;
+		Stats _stats = {};
+
+		ExecutionNodePool _exec_node_cache;
+
+		bool active() const
+		{
+			return _enable && !_suspended;
+		}
+
+		bool entryChanged(Entry const& entry) const;
+
+		void plan();
+
+	public:
+
+		struct CreateInfo
+		{
+			VkApplication * app = nullptr;
+			std::string name = {};
+			bool enable = true;
+		};
+		using CI = CreateInfo;
+
+		TransientImageAllocator(CreateInfo const& ci);
+
+		virtual ~TransientImageAllocator() override;
+
+		void declare(std::shared_ptr<Image> const& image, Lifetime const& lifetime);
+
+		// While suspended, the images get a dedicated memory (e.g. to inspect their content after the frame)
+		void setSuspended(bool suspended)
+		{
+			if (suspended != _suspended)
+			{
+				_suspended = suspended;
+				_should_plan = true;
+			}
+		}
+
+		void updateResources(UpdateContext & ctx);
+
+		// Discards the content of the transient images, and waits for the previous uses of their memory before their next use
+		void recordBeginFrame(ExecutionRecorder & exec);
+
+		constexpr Stats const& stats() const
+		{
+			return _stats;
+		}
+
+		void declareGUI(GuiContext & ctx);
+	};
+}
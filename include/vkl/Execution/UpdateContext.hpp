@@ -62,6 +62,32 @@ namespace vkl
 			_tick_tock.tick();
 		}
 
+		// Context of a parallel update (see ResourcesLists::update): same tick, definitions and queues as the parent,
+		// but its own lists, descriptor writes and perf counters (set by the caller), merged in the parent afterwards
+		UpdateContext(UpdateContext const& parent, DescriptorWriter & descriptor_writer) :
+			VkObject(parent._app, parent.name()),
+			_update_tick(parent._update_tick),
+			_update_resources_anyway(parent._update_resources_anyway),
+			_common_definitions(parent._common_definitions),
+			_upload_queue(parent._upload_queue),
+			_mips_queue(parent._mips_queue),
+			_descriptor_writer(descriptor_writer)
+		{
+			_tick_tock.tick();
+		}
+
+		void merge(UpdateContext && shard)
+		{
+			_resources_to_update_later += shard._resources_to_update_later;
+			_resources_to_upload += std::move(shard._resources_to_upload);
+			_descriptor_writer.append(shard._descriptor_writer);
+			shard._resources_to_update_later.clear();
+			if (_frame_perf_counters && shard._frame_perf_counters)
+			{
+				*_frame_perf_counters += *shard._frame_perf_counters;
+			}
+		}
+
 		constexpr size_t updateTick()const
 		{
 			return _update_tick;
@@ -2,6 +2,7 @@
 
 #include <vkl/App/VkApplication.hpp>
 #include <vkl/Execution/ResourcesToUpload.hpp>
+#include <vkl/Execution/AsynchTask.hpp>
 
 #include <mutex>
 
@@ -60,6 +61,9 @@ namespace vkl
 
 		CompletionCallback completion_callback = {};
 
+		// Higher priority uploads are consumed first, uploads of the same priority are consumed in order
+		TaskPriority priority = TaskPriority::ASAP();
+
 		size_t getSize()const;
 	};
 
@@ -86,6 +90,8 @@ namespace vkl
 		void enqueue(AsynchUpload const& upload);
 		void enqueue(AsynchUpload && upload);
 
+		size_t size();
+
 		using Budget = TransferBudget;
 
 		ResourcesToUpload consume(Budget const& b);
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vkl/Core/VulkanCommons.hpp>
+#include "FileSystem.hpp"
+
+#include <span>
+
+namespace vkl
+{
+	// Block compressed (BCn) image with its stored mip chain, as read from a KTX2 or DDS container
+	// The file content is kept as is, subresources point into it
+	struct CompressedImage
+	{
+		VkFormat format = VK_FORMAT_UNDEFINED;
+		VkExtent3D extent = {};
+		uint32_t mips = 0;
+		uint32_t layers = 0;
+
+		struct Subresource
+		{
+			uint32_t mip = 0;
+			// If layer_count > 1, the layers are contiguous in the file
+			uint32_t layer = 0;
+			uint32_t layer_count = 1;
+			size_t offset = 0;
+			size_t size = 0;
+		};
+		MyVector<Subresource> subresources = {};
+
+		std::string content = {};
+
+		bool empty() const
+		{
+			return subresources.empty();
+		}
+
+		const void * data(Subresource const& sr) const
+		{
+			return content.data() + sr.offset;
+		}
+
+		// Only the image data (no header)
+		size_t byteSize() const;
+
+		void clear();
+
+		// BC1, BC3, BC4, BC5, BC7
+		static bool IsSupportedFormat(VkFormat format);
+
+		static uint32_t BlockByteSize(VkFormat format);
+
+		static size_t MipByteSize(VkFormat format, VkExtent3D const& extent, uint32_t mip);
+
+		// floor(log2(max(width, height))) + 1
+		static uint32_t MaxMipsCount(VkExtent3D const& extent);
+
+		// Files with more layers are rejected
+		static constexpr uint32_t MaxLayers = 2048;
+	};
+
+	enum class CompressedImageContainer
+	{
+		None,
+		KTX2,
+		DDS,
+	};
+
+	// Deduced from the extension
+	CompressedImageContainer GetCompressedImageContainer(std::filesystem::path const& path);
+
+	// Takes ownership of the file content
+	// Returns false (and describes the reason in error) if the file is invalid or uses a feature that is not supported (supercompression, cube maps, 3D, non BCn formats)
+	bool ParseCompressedImage(std::string && content, CompressedImageContainer container, CompressedImage & res, std::string * error = nullptr);
+
+	// Writes a DDS (with the DX10 header) with a single layer
+	struct DDSWriteInfo
+	{
+		VkFormat format = VK_FORMAT_UNDEFINED;
+		VkExtent3D extent = {};
+		// One per mip, from the largest
+		MyVector<std::span<const uint8_t>> mips = {};
+	};
+	std::string SerializeDDS(DDSWriteInfo const& info);
+}
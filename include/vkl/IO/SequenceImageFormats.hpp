@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vkl/Core/VulkanCommons.hpp>
+
+#include <string>
+
+namespace vkl
+{
+	// Fast lossless image formats, to write a sequence of frames as it is captured
+	// Encoded straight from the downloaded pixels (tightly packed, row major, first row at the top)
+	enum class SequenceImageFormat
+	{
+		// The pixels as they are, the whole sequence is described by a single json file
+		Raw,
+		// Quite OK Image format: 8 bits RGB or RGBA
+		QOI,
+		// Portable float map: 16 or 32 bits float R or RGB (alpha is dropped)
+		PFM,
+		MAX_ENUM,
+	};
+
+	const char * GetSequenceImageFormatName(SequenceImageFormat format);
+
+	const char * GetSequenceImageFormatExtension(SequenceImageFormat format);
+
+	// Of a tightly packed pixel, 0 if unknown
+	size_t GetRawPixelByteSize(VkFormat format);
+
+	struct RawImageView
+	{
+		VkFormat format = VK_FORMAT_UNDEFINED;
+		VkExtent2D extent = {};
+		const void * data = nullptr;
+
+		size_t byteSize() const
+		{
+			return size_t(extent.width) * size_t(extent.height) * GetRawPixelByteSize(format);
+		}
+	};
+
+	bool CanEncodeSequenceImage(SequenceImageFormat format, VkFormat vk_format);
+
+	// Appends the content of the file to out
+	// Returns false if the format cannot be encoded (see CanEncodeSequenceImage)
+	bool EncodeSequenceImage(SequenceImageFormat format, RawImageView const& image, bool strip_alpha, std::string & out);
+}
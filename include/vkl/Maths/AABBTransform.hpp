@@ -0,0 +1,40 @@
+#pragma once
+
+#include "AlignedAxisBoundingBox.hpp"
+
+namespace vkl
+{
+	class DelayedTaskExecutor;
+
+	// Box containing the transformed box, with the center / extent method:
+	// center' = M * center + t, extent' = |M| * extent
+	// Same box as transforming the 8 corners (up to rounding), for a fraction of the cost
+	inline AABB3f TransformAABB(AABB3f const& box, Matrix3x4f const& xform)
+	{
+		if (box.empty())
+		{
+			return AABB3f();
+		}
+		const Matrix3f m = xform.block<3, 3>(0, 0);
+		const Vector3f center = m * box.center() + xform.col(3);
+		const Vector3f extent = m.cwiseAbs() * (0.5f * box.diagonal());
+		return AABB3f(center - extent, center + extent);
+	}
+
+	// Transforms many boxes at once: the boxes are transposed in tiles (SoA) and transformed 8 (AVX) or 4 (SSE) at a time
+	// Empty input boxes result in inverted boxes (bottom > top), which leave a union unchanged
+	struct AABBTransformInfo
+	{
+		const AABB3f * boxes = nullptr;
+		const Matrix3x4f * xforms = nullptr;
+		size_t count = 0;
+		// Optional, the transformed boxes
+		AABB3f * results = nullptr;
+		// If not null, the boxes are split in tiles processed in parallel on the executor (the calling thread takes part in the work)
+		DelayedTaskExecutor * executor = nullptr;
+		size_t tile_size = 16 * 1024;
+	};
+
+	// Returns the union of the transformed boxes
+	AABB3f TransformAABBs(AABBTransformInfo const& info);
+}
@@ -0,0 +1,474 @@
+#pragma once
+
+#include "AlignedAxisBoundingBox.hpp"
+
+#include <vkl/Utils/MyVector.hpp>
+
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VKL_BVH_USE_SSE 1
+#include <immintrin.h>
+#else
+#define VKL_BVH_USE_SSE 0
+#endif
+
+namespace vkl
+{
+	// AABB padded to 4 floats (the 4th component is 0), for the SIMD box tests
+	struct alignas(16) BVHBox
+	{
+		float bottom[4];
+		float top[4];
+
+		static BVHBox From(AABB3f const& box)
+		{
+			return BVHBox{
+				.bottom = {box.bottom()[0], box.bottom()[1], box.bottom()[2], 0.0f},
+				.top = {box.top()[0], box.top()[1], box.top()[2], 0.0f},
+			};
+		}
+
+		static BVHBox Empty()
+		{
+			return From(AABB3f());
+		}
+
+		AABB3f toAABB() const
+		{
+			return AABB3f(Vector3f(bottom[0], bottom[1], bottom[2]), Vector3f(top[0], top[1], top[2]));
+		}
+
+		BVHBox& operator+=(BVHBox const& o)
+		{
+#if VKL_BVH_USE_SSE
+			_mm_store_ps(bottom, _mm_min_ps(_mm_load_ps(bottom), _mm_load_ps(o.bottom)));
+			_mm_store_ps(top, _mm_max_ps(_mm_load_ps(top), _mm_load_ps(o.top)));
+#else
+			for (uint32_t i = 0; i < 4; ++i)
+			{
+				bottom[i] = std::min(bottom[i], o.bottom[i]);
+				top[i] = std::max(top[i], o.top[i]);
+			}
+#endif
+			return *this;
+		}
+
+		bool operator==(BVHBox const& o) const
+		{
+			bool res = true;
+			for (uint32_t i = 0; i < 3; ++i)
+			{
+				res &= (bottom[i] == o.bottom[i]) && (top[i] == o.top[i]);
+			}
+			return res;
+		}
+
+		float halfArea() const
+		{
+			const float dx = top[0] - bottom[0];
+			const float dy = top[1] - bottom[1];
+			const float dz = top[2] - bottom[2];
+			return (dx < 0.0f) ? 0.0f : (dx * dy + dy * dz + dz * dx);
+		}
+	};
+
+	// Planes (normal, offset): a point p is inside if Dot(normal, p) + offset >= 0 for all planes
+	// The normals need not be normalized
+	struct alignas(16) FrustumPlanes
+	{
+		float planes[8][4] = {};
+		uint32_t count = 0;
+
+		void addPlane(Vector3f const& normal, float offset)
+		{
+			assert(count < 8);
+			planes[count][0] = normal[0];
+			planes[count][1] = normal[1];
+			planes[count][2] = normal[2];
+			planes[count][3] = offset;
+			++count;
+		}
+
+		// world_to_clip: Vulkan clip space (0 <= z <= w)
+		// The far plane is skipped with far_plane = false (infinite or reversed infinite projections)
+		static FrustumPlanes FromMatrix(Matrix4f const& world_to_clip, bool far_plane = true);
+	};
+
+	struct BVHRay
+	{
+		Vector3f origin = Vector3f::Zero();
+		Vector3f direction = Vector3f(0, 0, 1);
+		float t_min = 0.0f;
+		float t_max = std::numeric_limits<float>::infinity();
+	};
+
+	// Binary BVH over a set of AABBs (the items, identified by their index at build time)
+	// Built with a binned SAH, its boxes can be updated and refitted without rebuilding
+	class BoundingVolumeHierarchy
+	{
+	public:
+
+		struct Node
+		{
+			// Leaf: first item slot (in leaf order), Inner: first child (the second child follows it)
+			uint32_t index = 0;
+			// Number of items of a leaf, 0 for an inner node
+			uint32_t count = 0;
+
+			constexpr bool isLeaf() const
+			{
+				return count != 0;
+			}
+		};
+
+		struct BuildInfo
+		{
+			const AABB3f * boxes = nullptr;
+			uint32_t count = 0;
+			uint32_t max_leaf_size = 4;
+			uint32_t sah_bins = 16;
+		};
+
+		static constexpr uint32_t MaxDepth = 96;
+
+	protected:
+
+		MyVector<Node> _nodes = {};
+		MyVector<BVHBox> _node_boxes = {};
+		MyVector<uint32_t> _parents = {};
+
+		// Item of each slot (leaf order)
+		MyVector<uint32_t> _items = {};
+		// In leaf order
+		MyVector<BVHBox> _item_boxes = {};
+		// Slot and leaf of each item
+		MyVector<uint32_t> _item_slots = {};
+		MyVector<uint32_t> _item_leaves = {};
+
+		MyVector<uint32_t> _dirty_leaves = {};
+		MyVector<uint8_t> _dirty_flags = {};
+
+		float _built_sah_cost = 0.0f;
+
+		struct BuildContext;
+
+		void buildNode(BuildContext & ctx, uint32_t node_index, uint32_t begin, uint32_t end, uint32_t depth);
+
+		void refitNode(uint32_t node_index);
+
+	public:
+
+		void clear();
+
+		void build(BuildInfo const& info);
+
+		bool empty() const
+		{
+			return _nodes.empty();
+		}
+
+		uint32_t nodeCount() const
+		{
+			return _nodes.size32();
+		}
+
+		uint32_t itemCount() const
+		{
+			return _items.size32();
+		}
+
+		MyVector<Node> const& nodes() const
+		{
+			return _nodes;
+		}
+
+		AABB3f bounds() const
+		{
+			return _nodes.empty() ? AABB3f() : _node_boxes.front().toAABB();
+		}
+
+		AABB3f itemBox(uint32_t item) const
+		{
+			return _item_boxes[_item_slots[item]].toAABB();
+		}
+
+		// The tree is only updated by refit()
+		void setItemBox(uint32_t item, AABB3f const& box);
+
+		bool needsRefit() const
+		{
+			return !_dirty_leaves.empty();
+		}
+
+		// Only refits the ancestors of the updated items when few changed, else all the nodes
+		void refit();
+
+		// Expected cost of a query, relative to the root: traversed nodes + tested items
+		float sahCost() const;
+
+		float builtSahCost() const
+		{
+			return _built_sah_cost;
+		}
+
+		// Refits degrade the tree when items move a lot
+		bool shouldRebuild(float max_cost_ratio = 2.0f) const
+		{
+			return sahCost() > max_cost_ratio * _built_sah_cost;
+		}
+
+		static bool Overlap(BVHBox const& a, BVHBox const& b)
+		{
+#if VKL_BVH_USE_SSE
+			const __m128 c0 = _mm_cmple_ps(_mm_load_ps(a.bottom), _mm_load_ps(b.top));
+			const __m128 c1 = _mm_cmple_ps(_mm_load_ps(b.bottom), _mm_load_ps(a.top));
+			return (_mm_movemask_ps(_mm_and_ps(c0, c1)) & 0b111) == 0b111;
+#else
+			bool res = true;
+			for (uint32_t i = 0; i < 3; ++i)
+			{
+				res &= (a.bottom[i] <= b.top[i]) && (b.bottom[i] <= a.top[i]);
+			}
+			return res;
+#endif
+		}
+
+		// center: 4th component must be 0
+		static bool OverlapSphere(BVHBox const& box, const float * center, float radius2)
+		{
+#if VKL_BVH_USE_SSE
+			const __m128 c = _mm_loadu_ps(center);
+			const __m128 d = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_load_ps(box.bottom), c), _mm_sub_ps(c, _mm_load_ps(box.top))), _mm_setzero_ps());
+			const __m128 d2 = _mm_mul_ps(d, d);
+			const __m128 s = _mm_add_ps(d2, _mm_movehl_ps(d2, d2));
+			const float dist2 = _mm_cvtss_f32(_mm_add_ss(s, _mm_shuffle_ps(s, s, 1)));
+			return dist2 <= radius2;
+#else
+			float dist2 = 0.0f;
+			for (uint32_t i = 0; i < 3; ++i)
+			{
+				const float d = std::max(std::max(box.bottom[i] - center[i], center[i] - box.top[i]), 0.0f);
+				dist2 += d * d;
+			}
+			return dist2 <= radius2;
+#endif
+		}
+
+		// Conservative: the box may intersect the frustum
+		static bool OverlapFrustum(BVHBox const& box, FrustumPlanes const& frustum)
+		{
+#if VKL_BVH_USE_SSE
+			const __m128 b = _mm_load_ps(box.bottom);
+			const __m128 t = _mm_load_ps(box.top);
+			for (uint32_t p = 0; p < frustum.count; ++p)
+			{
+				const __m128 plane = _mm_load_ps(frustum.planes[p]);
+				// Per component, the corner the furthest along the normal (4th component: 0)
+				const __m128 m = _mm_max_ps(_mm_mul_ps(plane, b), _mm_mul_ps(plane, t));
+				const __m128 s = _mm_add_ps(m, _mm_movehl_ps(m, m));
+				const float d = _mm_cvtss_f32(_mm_add_ss(s, _mm_shuffle_ps(s, s, 1))) + frustum.planes[p][3];
+				if (d < 0.0f)
+				{
+					return false;
+				}
+			}
+			return true;
+#else
+			for (uint32_t p = 0; p < frustum.count; ++p)
+			{
+				float d = frustum.planes[p][3];
+				for (uint32_t i = 0; i < 3; ++i)
+				{
+					d += std::max(frustum.planes[p][i] * box.bottom[i], frustum.planes[p][i] * box.top[i]);
+				}
+				if (d < 0.0f)
+				{
+					return false;
+				}
+			}
+			return true;
+#endif
+		}
+
+		struct alignas(16) PreparedRay
+		{
+			float origin[4];
+			float inv_direction[4];
+			float t_min;
+			float t_max;
+
+			static PreparedRay From(BVHRay const& ray)
+			{
+				return PreparedRay{
+					.origin = {ray.origin[0], ray.origin[1], ray.origin[2], 0.0f},
+					.inv_direction = {1.0f / ray.direction[0], 1.0f / ray.direction[1], 1.0f / ray.direction[2], 0.0f},
+					.t_min = ray.t_min,
+					.t_max = ray.t_max,
+				};
+			}
+		};
+
+		// Slabs test, t_enter: the distance at which the ray enters the box
+		// A zero direction component gives 0 * inf = NaN when the origin is on a face of the box: that axis then does not restrict the interval
+		static bool IntersectRay(BVHBox const& box, PreparedRay const& ray, float & t_enter)
+		{
+#if VKL_BVH_USE_SSE
+			const __m128 o = _mm_load_ps(ray.origin);
+			const __m128 inv = _mm_load_ps(ray.inv_direction);
+			const __m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(box.bottom), o), inv);
+			const __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(box.top), o), inv);
+			const __m128 unordered = _mm_cmpunord_ps(t0, t1);
+			const __m128 tn = _mm_or_ps(_mm_andnot_ps(unordered, _mm_min_ps(t0, t1)), _mm_and_ps(unordered, _mm_set1_ps(-std::numeric_limits<float>::infinity())));
+			const __m128 tf = _mm_or_ps(_mm_andnot_ps(unordered, _mm_max_ps(t0, t1)), _mm_and_ps(unordered, _mm_set1_ps(std::numeric_limits<float>::infinity())));
+			// Reduce the first 3 components
+			const __m128 tn_max = _mm_max_ps(tn, _mm_max_ps(_mm_shuffle_ps(tn, tn, _MM_SHUFFLE(3, 0, 2, 1)), _mm_shuffle_ps(tn, tn, _MM_SHUFFLE(3, 1, 0, 2))));
+			const __m128 tf_min = _mm_min_ps(tf, _mm_min_ps(_mm_shuffle_ps(tf, tf, _MM_SHUFFLE(3, 0, 2, 1)), _mm_shuffle_ps(tf, tf, _MM_SHUFFLE(3, 1, 0, 2))));
+			const float t_near = std::max(_mm_cvtss_f32(tn_max), ray.t_min);
+			const float t_far = std::min(_mm_cvtss_f32(tf_min), ray.t_max);
+#else
+			float t_near = ray.t_min;
+			float t_far = ray.t_max;
+			for (uint32_t i = 0; i < 3; ++i)
+			{
+				const float t0 = (box.bottom[i] - ray.origin[i]) * ray.inv_direction[i];
+				const float t1 = (box.top[i] - ray.origin[i]) * ray.inv_direction[i];
+				if (std::isnan(t0) || std::isnan(t1))
+				{
+					continue;
+				}
+				t_near = std::max(t_near, std::min(t0, t1));
+				t_far = std::min(t_far, std::max(t0, t1));
+			}
+#endif
+			t_enter = t_near;
+			return t_near <= t_far;
+		}
+
+		// test(BVHBox const&) -> bool: whether the box may contain what is searched, called on nodes and items
+		// callback(uint32_t item) is called on the items which pass the test
+		template <class BoxTest, class ItemCallback>
+		void query(BoxTest const& test, ItemCallback const& callback) const
+		{
+			if (_nodes.empty())
+			{
+				return;
+			}
+			uint32_t stack[MaxDepth + 1];
+			uint32_t stack_size = 0;
+			stack[stack_size++] = 0;
+			while (stack_size != 0)
+			{
+				const uint32_t node_index = stack[--stack_size];
+				if (!test(_node_boxes[node_index]))
+				{
+					continue;
+				}
+				const Node & node = _nodes[node_index];
+				if (node.isLeaf())
+				{
+					for (uint32_t i = node.index; i < node.index + node.count; ++i)
+					{
+						if (node.count == 1 || test(_item_boxes[i]))
+						{
+							callback(_items[i]);
+						}
+					}
+				}
+				else
+				{
+					stack[stack_size++] = node.index + 1;
+					stack[stack_size++] = node.index;
+				}
+			}
+		}
+
+		template <class ItemCallback>
+		void queryAABB(AABB3f const& box, ItemCallback const& callback) const
+		{
+			const BVHBox b = BVHBox::From(box);
+			query([&b](BVHBox const& node_box) {return Overlap(node_box, b); }, callback);
+		}
+
+		template <class ItemCallback>
+		void querySphere(Vector3f const& center, float radius, ItemCallback const& callback) const
+		{
+			alignas(16) const float c[4] = {center[0], center[1], center[2], 0.0f};
+			const float r2 = radius * radius;
+			query([&](BVHBox const& node_box) {return OverlapSphere(node_box, c, r2); }, callback);
+		}
+
+		template <class ItemCallback>
+		void queryFrustum(FrustumPlanes const& frustum, ItemCallback const& callback) const
+		{
+			query([&frustum](BVHBox const& node_box) {return OverlapFrustum(node_box, frustum); }, callback);
+		}
+
+		// callback(uint32_t item, float t_enter) -> float is called on the items whose box is hit, near nodes first
+		// It returns the new t_max (eg the distance of a hit found in the item, or infinity to find all the items) to prune the farther nodes
+		template <class ItemCallback>
+		void queryRay(BVHRay const& ray, ItemCallback const& callback) const
+		{
+			if (_nodes.empty())
+			{
+				return;
+			}
+			PreparedRay r = PreparedRay::From(ray);
+			// The entry distance is kept with the node, to skip it if a nearer hit was found since it was pushed
+			struct StackEntry
+			{
+				uint32_t node;
+				float t_enter;
+			};
+			StackEntry stack[MaxDepth + 1];
+			uint32_t stack_size = 0;
+			float t;
+			if (!IntersectRay(_node_boxes[0], r, t))
+			{
+				return;
+			}
+			stack[stack_size++] = StackEntry{.node = 0, .t_enter = t};
+			while (stack_size != 0)
+			{
+				const StackEntry entry = stack[--stack_size];
+				if (entry.t_enter > r.t_max)
+				{
+					continue;
+				}
+				const Node & node = _nodes[entry.node];
+				if (node.isLeaf())
+				{
+					for (uint32_t i = node.index; i < node.index + node.count; ++i)
+					{
+						if (IntersectRay(_item_boxes[i], r, t))
+						{
+							r.t_max = std::min(r.t_max, static_cast<float>(callback(_items[i], t)));
+						}
+					}
+				}
+				else
+				{
+					float t0, t1;
+					const bool hit0 = IntersectRay(_node_boxes[node.index], r, t0);
+					const bool hit1 = IntersectRay(_node_boxes[node.index + 1], r, t1);
+					// Push the farthest first, so the nearest is traversed first
+					if (hit0 && hit1)
+					{
+						const bool first_near = t0 <= t1;
+						stack[stack_size++] = first_near ? StackEntry{.node = node.index + 1, .t_enter = t1} : StackEntry{.node = node.index, .t_enter = t0};
+						stack[stack_size++] = first_near ? StackEntry{.node = node.index, .t_enter = t0} : StackEntry{.node = node.index + 1, .t_enter = t1};
+					}
+					else if (hit0)
+					{
+						stack[stack_size++] = StackEntry{.node = node.index, .t_enter = t0};
+					}
+					else if (hit1)
+					{
+						stack[stack_size++] = StackEntry{.node = node.index + 1, .t_enter = t1};
+					}
+				}
+			}
+		}
+	};
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "BoundingVolumeHierarchy.hpp"
+#include "AABBTransform.hpp"
+
+#include <vkl/Core/VulkanCommons.hpp>
+
+#include <algorithm>
+#include <functional>
+
+namespace vkl
+{
+	// CPU reference of the culling of the scene objects by the GPU (ShaderLib/Rendering/Culling.slang)
+	// Depths follow the Vulkan convention (0 <= z <= 1 in NDC), the closest being 0 (or 1 with a reversed depth)
+
+	// Screen footprint of a world box
+	struct ProjectedAABB
+	{
+		// False if the box reaches the near plane (or behind the camera): it cannot be tested against a depth buffer
+		bool valid = false;
+		// In uv, clamped to [0, 1]
+		Vector2f uv_min = Vector2f::Zero();
+		Vector2f uv_max = Vector2f::Zero();
+		// Depth of the closest point of the box
+		float closest_depth = 0;
+	};
+
+	ProjectedAABB ProjectAABB(AABB3f const& world_box, Matrix4f const& world_to_proj, bool reverse_depth);
+
+	// Farthest depth of each texel of a depth pyramid (max depth, or min depth with a reversed depth)
+	// Level 0 has the extent of the depth buffer, each level halves the previous one (rounded down, at least 1)
+	// The last texel of a row (or column) of an odd level also covers the remaining texel of the previous level
+	struct DepthPyramidView
+	{
+		VkExtent2D extent = {};
+		uint32_t levels = 0;
+		std::function<float(uint32_t level, uint32_t x, uint32_t y)> fetch = {};
+	};
+
+	// CPU reference of the depth pyramid (RenderLib DepthPyramid), with the (min, max) depth of each texel
+	struct DepthMinMaxPyramid
+	{
+		VkExtent2D extent = {};
+		// levels[l][x + y * levelExtent(l).width]
+		MyVector<MyVector<Vector2f>> levels = {};
+
+		VkExtent2D levelExtent(uint32_t level) const
+		{
+			return VkExtent2D{
+				.width = std::max(extent.width >> level, 1u),
+				.height = std::max(extent.height >> level, 1u),
+			};
+		}
+
+		Vector2f fetch(uint32_t level, uint32_t x, uint32_t y) const
+		{
+			return levels[level][x + y * levelExtent(level).width];
+		}
+
+		// Valid as long as this pyramid
+		DepthPyramidView farthestDepthView(bool reverse_depth) const;
+
+		// depth: row major, of extent
+		static DepthMinMaxPyramid Build(const float * depth, VkExtent2D const& extent, uint32_t levels);
+	};
+
+	// Finest level where the footprint covers at most 2x2 texels
+	// Returns levels if no level is coarse enough
+	uint32_t SelectDepthPyramidLevel(ProjectedAABB const& box, VkExtent2D const& extent, uint32_t levels);
+
+	// Conservative: false if the footprint cannot be tested
+	bool IsOccluded(ProjectedAABB const& box, DepthPyramidView const& pyramid, bool reverse_depth);
+
+	enum class CullingResult
+	{
+		Visible,
+		OutsideFrustum,
+		Occluded,
+	};
+
+	struct CullingView
+	{
+		// Vulkan clip space
+		Matrix4f world_to_proj = Matrix4f::Identity();
+		FrustumPlanes frustum = {};
+		bool reverse_depth = false;
+		// Optional, to test the occlusion
+		const DepthPyramidView * depth_pyramid = nullptr;
+
+		static CullingView Make(Matrix4f const& world_to_proj, bool reverse_depth, const DepthPyramidView * depth_pyramid = nullptr);
+	};
+
+	CullingResult CullObject(AABB3f const& object_box, Matrix3x4f const& object_to_world, CullingView const& view);
+}
@@ -14,6 +14,9 @@ namespace vkl
 		BufferAndRange index_buffer = {};
 		VkIndexType index_type = VK_INDEX_TYPE_MAX_ENUM;
 		Array<BufferAndRange> vertex_buffers = {};
+		// In elements of the bound buffers (e.g. meshes sharing the buffers of the geometry arena)
+		uint32_t first_index = 0;
+		int32_t vertex_offset = 0;
 
 		std::shared_ptr<DescriptorSetAndPool> set = nullptr;
 		PushConstant pc = {};
@@ -26,6 +29,8 @@ namespace vkl
 			index_buffer = {};
 			index_type = VK_INDEX_TYPE_MAX_ENUM;
 			vertex_buffers.clear();
+			first_index = 0;
+			vertex_offset = 0;
 			set.reset();
 			pc.clear();
 		}
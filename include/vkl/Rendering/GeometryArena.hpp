@@ -0,0 +1,144 @@
+#pragma once
+
+#include <vkl/VkObjects/Buffer.hpp>
+#include <vkl/Utils/RangeAllocator.hpp>
+#include <vkl/IO/GuiContext.hpp>
+
+#include <mutex>
+#include <functional>
+#include <unordered_map>
+
+namespace vkl
+{
+	class ExecutionRecorder;
+
+	// Sub-allocates the geometry of the meshes (header, vertices, indices) from a few large device buffers (blocks)
+	// All the allocations of a block can be drawn with the same vertex and index buffers binds (with vertex and index offsets)
+	class GeometryArena : public VkObject
+	{
+	public:
+
+		struct Allocation
+		{
+			uint32_t block = uint32_t(-1);
+			VkDeviceSize offset = 0;
+			VkDeviceSize size = 0;
+
+			bool valid() const
+			{
+				return block != uint32_t(-1);
+			}
+		};
+
+		// Called (with the arena locked) when defragment() moves an allocation
+		// The content is copied on the device by recordTransferIFN(), but the ranges given to the descriptors and draws have to be updated
+		using RelocationCallback = std::function<void(Allocation const&)>;
+
+		struct Stats
+		{
+			uint32_t blocks = 0;
+			VkDeviceSize capacity = 0;
+			VkDeviceSize used = 0;
+			uint32_t allocations = 0;
+			uint32_t free_segments = 0;
+			// Mean of the blocks fragmentation, weighted by their free space
+			float fragmentation = 0;
+			size_t relocations = 0;
+		};
+
+	protected:
+
+		struct Block
+		{
+			std::shared_ptr<Buffer> buffer = nullptr;
+			RangeAllocator allocator;
+			// offset -> callback
+			std::unordered_map<VkDeviceSize, RelocationCallback> relocation_callbacks;
+			// Instance before the last defragmentation, to copy to the current one in recordTransferIFN()
+			std::shared_ptr<BufferInstance> prev_instance = nullptr;
+			MyVector<VkBufferCopy2> copies;
+		};
+
+		mutable std::mutex _mutex;
+
+		VkDeviceSize _block_size = 0;
+		VkBufferUsageFlags _usage = 0;
+		MyVector<Block> _blocks;
+
+		// Automatic defragmentation in updateResources() when the fragmentation is above
+		float _defragment_threshold = 0;
+		// Nothing to gain before an allocation is released
+		bool _released_since_defragment = false;
+		// From the GUI, done in the next updateResources()
+		bool _defragment_requested = false;
+		size_t _relocations = 0;
+
+		uint32_t createBlock(VkDeviceSize size);
+
+		void defragmentBlock(Block & block);
+
+		// Compacts the blocks (within each block), and releases the empty ones
+		// The blocks with a pinned allocation are skipped (the pending upload targets the current instance)
+		void defragment();
+
+	public:
+
+		struct CreateInfo
+		{
+			VkApplication * app = nullptr;
+			std::string name = {};
+			VkDeviceSize block_size = 64 * 1024 * 1024;
+			float defragment_threshold = 0.5f;
+		};
+		using CI = CreateInfo;
+
+		GeometryArena(CreateInfo const& ci);
+
+		virtual ~GeometryArena() override;
+
+		// Thread safe
+		// Allocate pinned to be sure not to be relocated before the content is uploaded
+		Allocation allocate(VkDeviceSize size, VkDeviceSize alignment, RelocationCallback const& on_relocation = {}, bool pinned = false);
+
+		// Thread safe
+		void release(Allocation const& allocation);
+
+		// A pinned allocation is not moved by defragment() (e.g. while an asynch upload targets it)
+		void setPinned(Allocation const& allocation, bool pinned);
+
+		std::shared_ptr<Buffer> buffer(uint32_t block) const
+		{
+			std::unique_lock lock(_mutex);
+			return _blocks[block].buffer;
+		}
+
+		BufferAndRange bufferAndRange(Allocation const& allocation) const
+		{
+			return BufferAndRange{
+				.buffer = buffer(allocation.block),
+				.range = Buffer::Range{.begin = allocation.offset, .len = allocation.size},
+			};
+		}
+
+		// The whole block, to bind it once for all its allocations
+		BufferAndRange blockBufferAndRange(uint32_t block) const
+		{
+			std::unique_lock lock(_mutex);
+			return BufferAndRange{
+				.buffer = _blocks[block].buffer,
+				.range = Buffer::Range{.begin = 0, .len = _blocks[block].allocator.capacity()},
+			};
+		}
+
+		Stats stats() const;
+
+		// Can defragment the blocks: must be called before the meshes are updated
+		void updateResources(UpdateContext & ctx);
+
+		// Copies the content of the defragmented blocks to their new instance
+		// Must be recorded before the meshes are used in the frame
+		void recordTransferIFN(ExecutionRecorder & exec);
+
+		void declareGUI(GuiContext & ctx);
+	};
+}
@@ -49,6 +49,11 @@ namespace vkl
 
 		ImagePicker(CreateInfo const& ci);
 
+		size_t index() const
+		{
+			return _gui_source.index();
+		}
+
 		void updateResources(UpdateContext & ctx);
 
 		void execute(ExecutionRecorder & recorder);
@@ -7,7 +7,12 @@
 
 #include <vkl/VkObjects/ImageView.hpp>
 
+#include <vkl/Execution/BufferPool.hpp>
+
 #include <vkl/IO/ImGuiUtils.hpp>
+#include <vkl/IO/SequenceImageFormats.hpp>
+
+#include <atomic>
 
 namespace vkl
 {
@@ -35,8 +40,57 @@ namespace vkl
 		int _jpg_quality = 100;
 		bool _create_folder_ifn = true;
 
+		// Sequence capture: every frame is downloaded and encoded (in parallel in the thread pool) until stopped
+		bool _capturing = false;
+		// When the encoders fall behind: drop the frame rather than waiting for them
+		bool _capture_drop_frames = false;
+		size_t _capture_first_index = 0;
+		VkFormat _capture_format = VK_FORMAT_UNDEFINED;
+		VkExtent3D _capture_extent = {};
+		ImGuiListSelection _gui_sequence_format;
+
+		// Readback buffers of the captured frames, recycled by the pool (a ring of as many buffers as frames in flight), and kept mapped
+		std::shared_ptr<BufferPool> _readback_pool = nullptr;
+
+		struct CaptureStats
+		{
+			using Clock = std::chrono::high_resolution_clock;
+			Clock::time_point begin = {};
+			Clock::time_point end = {};
+			size_t captured = 0;
+			size_t dropped = 0;
+			// Frames waiting for the encoders
+			size_t stalls = 0;
+			double stall_ms = 0;
+			size_t max_queue = 0;
+			// Written by the encoders
+			std::atomic<size_t> encoded = 0;
+			std::atomic<size_t> failed = 0;
+			std::atomic<size_t> bytes = 0;
+			std::atomic<int64_t> encode_us = 0;
+		};
+		CaptureStats _capture_stats;
+
 		void setExtension();
 
+		SequenceImageFormat sequenceFormat() const
+		{
+			return static_cast<SequenceImageFormat>(_gui_sequence_format.index());
+		}
+
+		void startCapture();
+
+		void stopCapture();
+
+		void recordCapture(ExecutionRecorder & exec);
+
+		// In a thread of the pool
+		bool encodeCapturedFrame(BufferInstance & buffer, std::filesystem::path const& path, SequenceImageFormat format, VkFormat vk_format, VkExtent3D const& extent);
+
+		void writeSequenceDescription();
+
+		void declareCaptureGUI();
+
 	public:
 
 		struct CreateInfo
@@ -57,6 +111,11 @@ namespace vkl
 
 		void execute(ExecutionRecorder & exec);
 
+		constexpr bool isCapturing() const
+		{
+			return _capturing;
+		}
+
 		void declareGUI(GuiContext & ctx);
 	};
 }
\ No newline at end of file
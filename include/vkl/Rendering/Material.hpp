@@ -4,6 +4,7 @@
 #include <vkl/VkObjects/Sampler.hpp>
 #include <vkl/VkObjects/Buffer.hpp>
 #include <vkl/Execution/DescriptorSetsManager.hpp>
+#include <vkl/Execution/HostManagedBuffer.hpp>
 #include <vkl/Execution/ResourcesHolder.hpp>
 #include <vkl/Execution/SamplerLibrary.hpp>
 #include <vkl/Rendering/Texture.hpp>
@@ -40,6 +41,14 @@ namespace vkl
 		};
 		MyVector<SetRegistration> _registered_sets = {};
 
+		// Slot of the material in a table of properties shared by many materials (e.g. the scene one)
+		struct TableRegistration
+		{
+			std::shared_ptr<HostManagedBuffer> table;
+			uint32_t index;
+		};
+		MyVector<TableRegistration> _registered_tables = {};
+
 		std::array<std::shared_ptr<Texture>, MAX_TEXTURE_COUNT> _textures = {};
 
 		// Use a shared sampler for all textures 
@@ -96,6 +105,11 @@ namespace vkl
 
 		virtual void unRegistgerFromDescriptorSet(std::shared_ptr<DescriptorSetAndPool> const& set, bool include_textures = true) = 0;
 
+		// The properties are written at table[index] (in properties units), and re-written when they change
+		virtual void registerToPropertiesTable(std::shared_ptr<HostManagedBuffer> const& table, uint32_t index) = 0;
+
+		void unRegisterFromPropertiesTable(std::shared_ptr<HostManagedBuffer> const& table);
+
 		virtual void callResourceUpdateCallbacks() = 0;
 
 		constexpr const auto& textures() const
@@ -139,6 +153,12 @@ namespace vkl
 			float metallic;
 			float roughness;
 			float cavity;
+
+			bool operator==(Properties const& other) const
+			{
+				// Not a memcmp: the padding is not initialized
+				return albedo == other.albedo && flags == other.flags && metallic == other.metallic && roughness == other.roughness && cavity == other.cavity;
+			}
 		};
 
 		struct Flags
@@ -177,6 +197,7 @@ namespace vkl
 		Properties _cached_props;
 
 		bool _should_update_props_buffer = false;
+		// Only created when registered to a descriptor set (e.g. by a Model), scenes use a properties table
 		std::shared_ptr<Buffer> _props_buffer = nullptr;
 
 		bool _force_albedo_prop = false;
@@ -243,6 +264,8 @@ namespace vkl
 
 		virtual void unRegistgerFromDescriptorSet(std::shared_ptr<DescriptorSetAndPool> const& set, bool include_textures = true) override;
 
+		virtual void registerToPropertiesTable(std::shared_ptr<HostManagedBuffer> const& table, uint32_t index) override;
+
 		virtual void callResourceUpdateCallbacks() override;
 	};
 
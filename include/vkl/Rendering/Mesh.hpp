@@ -11,6 +11,7 @@
 #include <vkl/Execution/ResourcesHolder.hpp>
 
 #include <vkl/Rendering/Drawable.hpp>
+#include <vkl/Rendering/GeometryArena.hpp>
 
 #include <vkl/IO/GuiContext.hpp>
 
@@ -304,17 +305,32 @@ namespace vkl
 			uint32_t num_vertices = 0;
 			VkIndexType index_type = VK_INDEX_TYPE_MAX_ENUM;
 
+			// Either a dedicated buffer, or a block of the geometry arena
 			std::shared_ptr<Buffer> mesh_buffer = nullptr;
+			GeometryArena * arena = nullptr;
+			GeometryArena::Allocation allocation = {};
+			bool pinned = false;
 			// In bytes
 			VkDeviceSize header_size = 0, vertices_size = 0, indices_size = 0;
 			VkDeviceSize total_buffer_size = 0;
+			// In the mesh buffer
+			VkDeviceSize header_offset = 0, vertices_offset = 0, indices_offset = 0;
 			BufferAndRange header_buffer;
 			BufferAndRange vertex_buffer;
 			BufferAndRange index_buffer;
-			// Structure of the mesh buffer:
+			// Structure of a dedicated mesh buffer:
 			// header
 			// vertices
 			// indices
+			// Structure of an arena allocation (the vertices are aligned on the vertex size):
+			// vertices
+			// indices
+			// header
+			// Draws bind the whole arena block (the same binds for all the meshes of the block)
+			BufferAndRange draw_vertex_buffer;
+			BufferAndRange draw_index_buffer;
+			uint32_t first_index = 0;
+			int32_t vertex_offset = 0;
 			bool up_to_date = false;
 			bool uploaded = false;
 			bool just_uploaded = false;
@@ -331,6 +347,18 @@ namespace vkl
 
 		void transmitToRegisteredSet(DescriptorSetAndPool::Registration & rs);
 
+		size_t vertexSize() const
+		{
+			return _host.use_full_vertices ? sizeof(Vertex) : (_host.dims * sizeof(float));
+		}
+
+		// From the offsets and sizes
+		void setDeviceRanges();
+
+		void createBLAS();
+
+		void setArenaPinned(bool pinned);
+
 	public:
 
 		struct CreateInfo
@@ -119,6 +119,11 @@ namespace vkl
 					&& (bind_mesh == o.bind_mesh) 
 					&& (bind_material == o.bind_material);
 			}
+
+			constexpr size_t hash() const
+			{
+				return (size_t(type) << 2) | (size_t(bind_mesh) << 1) | size_t(bind_material);
+			}
 		};
 
 		using ModelSetLayoutCache = DescriptorSetLayoutCacheImpl<SetLayoutOptions>;
@@ -4,6 +4,8 @@
 
 #include <vkl/Maths/Types.hpp>
 #include <vkl/Maths/AffineXForm.hpp>
+#include <vkl/Maths/BoundingVolumeHierarchy.hpp>
+#include <vkl/Maths/AABBTransform.hpp>
 
 
 #include <vkl/VkObjects/Buffer.hpp>
@@ -313,6 +315,14 @@ namespace vkl
 			virtual ~LightInstanceSpecificData() = default;
 		};
 
+		struct ShadowCaster
+		{
+			AABB3f world_aabb = {};
+			uint32_t model_unique_index = 0;
+			uint32_t num_indices = 0;
+			bool dynamic = false;
+		};
+
 	protected:
 
 		std::shared_ptr<DirectedAcyclicGraph> _tree;
@@ -341,6 +351,9 @@ namespace vkl
 		struct MaterialData
 		{
 			uint32_t unique_index;
+			// To unregister it from the properties table, if it is still alive
+			std::weak_ptr<Material> material = {};
+			size_t update_index = 0;
 		};
 
 		UniqueIndexAllocator _unique_mesh_index_pool;
@@ -349,8 +362,11 @@ namespace vkl
 		UniqueIndexAllocator _unique_texture_2D_index_pool;
 		std::unordered_map<Texture*, TextureData> _unique_textures;
 
-		UniqueIndexAllocator _unique_material_index_pool;
+		// Recycles the slots of the removed materials, so the packed tables do not grow with the materials swapped over time
+		UniqueIndexAllocator _unique_material_index_pool = UniqueIndexAllocator(UniqueIndexAllocator::Policy::FitCapacity);
 		std::unordered_map<Material*, MaterialData> _unique_materials;
+		// Properties of all the materials, indexed by material unique id (one descriptor for all)
+		std::shared_ptr<HostManagedBuffer> _material_props_buffer;
 		std::shared_ptr<HostManagedBuffer> _material_ref_buffer;
 
 		struct MaterialReference
@@ -371,11 +387,41 @@ namespace vkl
 		{
 			uint32_t model_unique_index;
 			uint32_t xform_unique_index;
+			// Shadow caster tracking
+			const Mesh * caster_mesh = nullptr;
+			AABB3f world_aabb = {};
+			uint32_t frames_since_moved = uint32_t(-1);
+			// Index in _shadow_casters
+			uint32_t caster_index = uint32_t(-1);
+			// Latest updateInternal which reached this instance in the DAG
+			size_t update_index = 0;
 		};
+		size_t _update_index = 0;
 		UniqueIndexAllocator _unique_model_index_pool;
 		std::unordered_map<DAG::RobustNodePath, ModelInstance> _unique_models; 
 		std::shared_ptr<HostManagedBuffer> _model_references_buffer;
 
+		// World AABBs of the shadow casters which changed during the latest updateInternal (before and after the change)
+		MyVector<AABB3f> _shadow_casters_changes = {};
+		// Subset: changes of the set of static casters
+		MyVector<AABB3f> _static_shadow_casters_changes = {};
+		// A caster which moved during the latest frames is dynamic
+		uint32_t _dynamic_caster_frames = 16;
+		// Rebuilt when the set of casters changes, the BVH is refitted when they move
+		MyVector<ShadowCaster> _shadow_casters = {};
+		BoundingVolumeHierarchy _shadow_casters_bvh = {};
+		bool _rebuild_shadow_casters = false;
+
+		void updateShadowCasters();
+
+		void buildShadowCastersBVH();
+
+		// Releases the model instances which were not reached by the latest DAG iteration
+		void removeUnreachedModels();
+
+		// Releases the material slots (properties and references) of the materials which were not reached by the latest DAG iteration
+		void removeUnreachedMaterials();
+
 		UniqueIndexAllocator _unique_xform_index_pool;
 		std::shared_ptr<HostManagedBuffer> _xforms_buffer;
 		std::shared_ptr<Buffer> _prev_xforms_buffer;
@@ -407,6 +453,9 @@ namespace vkl
 		};
 
 		AABB3f _aabb = {};
+		// Local AABBs and matrices of the instances of the frame, batch transformed into _aabb
+		MyVector<AABB3f> _instances_local_aabbs = {};
+		MyVector<Mat3x4> _instances_xforms = {};
 
 		vec3 _ambient = vec3::Constant(0.1f);
 		vec3 _uniform_sky = vec3::Constant(0);
@@ -481,6 +530,12 @@ namespace vkl
 			return _tree->root();
 		}
 
+		// World bounds of the models, as of the latest updateInternal
+		AABB3f const& aabb() const
+		{
+			return _aabb;
+		}
+
 		struct SetLayoutOptions
 		{
 			
@@ -510,6 +565,33 @@ namespace vkl
 			return _unique_model_index_pool.count();
 		}
 
+		MyVector<AABB3f> const& shadowCastersChanges() const
+		{
+			return _shadow_casters_changes;
+		}
+
+		MyVector<AABB3f> const& staticShadowCastersChanges() const
+		{
+			return _static_shadow_casters_changes;
+		}
+
+		uint32_t dynamicCasterFrames() const
+		{
+			return _dynamic_caster_frames;
+		}
+
+		MyVector<ShadowCaster> const& shadowCasters() const
+		{
+			return _shadow_casters;
+		}
+
+		// Items are indices in shadowCasters()
+		// Spatial index of the visible model instances: frustum, sphere, AABB and ray queries (eg for culling or picking)
+		BoundingVolumeHierarchy const& shadowCastersBVH() const
+		{
+			return _shadow_casters_bvh;
+		}
+
 		VkFormat lightDepthFormat() const
 		{
 			return _light_depth_format;
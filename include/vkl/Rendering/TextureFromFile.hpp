@@ -3,9 +3,12 @@
 #include "Texture.hpp"
 #include <filesystem>
 #include <that/img/Image.hpp>
+#include <vkl/IO/CompressedImage.hpp>
 
 #include <unordered_map>
 #include <mutex>
+#include <atomic>
+#include <algorithm>
 
 namespace vkl
 {
@@ -14,6 +17,7 @@ namespace vkl
 	protected:
 
 		size_t _latest_update_tick = 0;
+		size_t _latest_streaming_tick = 0;
 
 		FileSystem::Path _path = {};
 		FileSystem::Path _resolved_cannon_path = {};
@@ -31,6 +35,37 @@ namespace vkl
 
 		that::img::FormatedImage _host_image = {};
 
+		// Loaded instead of _host_image for KTX2 / DDS files: the mips are uploaded, not computed
+		// The mips are streamed: the device image only holds the mips [_resident_mip, mips)
+		CompressedImage _compressed_image = {};
+
+		// Device image being uploaded, replaces _image once all its subresources are uploaded
+		struct StreamingImage
+		{
+			uint32_t first_mip = 0;
+			std::shared_ptr<Image> image = nullptr;
+			std::shared_ptr<ImageView> view = nullptr;
+			// Indices in _compressed_image.subresources
+			MyVector<uint32_t> subresources = {};
+			MyVector<std::shared_ptr<ImageView>> subresources_views = {};
+			// Decremented by the completion callbacks, whatever the result
+			std::atomic<uint32_t> pending_uploads = 0;
+			// The image is uploaded again if any upload failed
+			std::atomic<uint32_t> failed_uploads = 0;
+			bool uploads_enqueued = false;
+
+			void updateResources(UpdateContext & ctx);
+		};
+		std::shared_ptr<StreamingImage> _streaming_image = nullptr;
+
+		uint32_t _resident_mip = 0;
+		// The smallest mips (up to StreamingTailResolution) are always resident, they are uploaded first so the texture is usable quickly
+		uint32_t _min_resident_mip = 0;
+		uint32_t _target_resident_mip = 0;
+		float _streaming_priority = 1.0f;
+
+		std::chrono::microseconds _load_duration = {};
+
 		std::shared_ptr<AsynchTask> _load_image_task = nullptr;
 
 		MipsOptions _desired_mips;
@@ -49,8 +84,32 @@ namespace vkl
 
 		void loadHostImage();
 
+		void loadFormatedImage();
+
+		void loadCompressedImage();
+
+		bool isCompressed() const
+		{
+			return !_compressed_image.empty();
+		}
+
+		size_t hostByteSize() const;
+
 		void createDeviceImage();
 
+		void createCompressedDeviceImage();
+
+		std::shared_ptr<StreamingImage> createStreamingImage(uint32_t first_mip);
+
+		void enqueueStreamingUploads(UpdateContext & ctx, bool synch);
+
+		bool streamingImageIsComplete() const
+		{
+			return _streaming_image && _streaming_image->uploads_enqueued && _streaming_image->pending_uploads == 0 && _streaming_image->failed_uploads == 0;
+		}
+
+		void swapStreamingImage();
+
 		void launchLoadTask();
 
 		void reload();
@@ -85,6 +144,58 @@ namespace vkl
 		virtual void updateResources(UpdateContext& ctx) override;
 
 		virtual void declareGUI(GuiContext & ctx) override;
+
+		// Applies the target residency (called by updateResources), without marking the texture as used
+		void updateStreaming(UpdateContext & ctx);
+
+		static constexpr uint32_t StreamingTailResolution = 128;
+
+		size_t latestUpdateTick() const
+		{
+			return _latest_update_tick;
+		}
+
+		// Only compressed images (with stored mips) are streamed, other textures are always fully resident
+		bool isStreamable() const
+		{
+			return isCompressed() && _min_resident_mip > 0;
+		}
+
+		uint32_t residentMip() const
+		{
+			return _resident_mip;
+		}
+
+		uint32_t minResidentMip() const
+		{
+			return _min_resident_mip;
+		}
+
+		uint32_t targetResidentMip() const
+		{
+			return _target_resident_mip;
+		}
+
+		// Clamped to [0, minResidentMip()]
+		void setTargetResidentMip(uint32_t mip);
+
+		// Device memory needed for the mips [first_mip, mips)
+		size_t residentByteSize(uint32_t first_mip) const;
+
+		// Device memory currently used (including an image being streamed)
+		size_t deviceByteSize() const;
+
+		float streamingPriority() const
+		{
+			return _streaming_priority;
+		}
+
+		// Relative importance in [0, 1] (e.g. screen coverage of the closest instance using the texture)
+		// Orders the streaming uploads and the residency budget allocation
+		void setStreamingPriority(float p)
+		{
+			_streaming_priority = std::clamp(p, 0.0f, 1.0f);
+		}
 	};
 
 	class TextureFileCache : public VkObject
@@ -95,12 +206,33 @@ namespace vkl
 		
 		std::unordered_map<FileSystem::Path, std::shared_ptr<TextureFromFile>> _cache;
 
+		// If true, a KTX2 or DDS file next to the requested image (same name, e.g. produced by TextureCompressor) is loaded instead, when it is not older
+		bool _prefer_compressed = true;
+
+		// Device memory budget of the streamed textures, the high mips of the unused or least important textures are evicted first
+		size_t _residency_budget = 0;
+		// A texture is unused if it was not updated for that many update cycles
+		size_t _unused_ticks = 0;
+
+		size_t _resident_bytes = 0;
+		size_t _target_bytes = 0;
+		size_t _fixed_bytes = 0;
+		size_t _streamed_textures = 0;
+		size_t _unused_textures = 0;
+
+		FileSystem::Path findCompressedCacheIFN(FileSystem::Path const& path) const;
+
+		void updateResidency(UpdateContext & ctx);
+
 	public:
 
 		struct CreateInfo
 		{
 			VkApplication * app = nullptr;
 			std::string name = {};
+			bool prefer_compressed = true;
+			size_t residency_budget = 1024 * 1024 * 1024;
+			size_t unused_ticks = 120;
 		};
 		using CI = CreateInfo;
 
@@ -109,6 +241,19 @@ namespace vkl
 
 		std::shared_ptr<TextureFromFile> getTexture(FileSystem::Path const& path, VkFormat desired_format = VK_FORMAT_UNDEFINED);
 
+		// Call after the users of the textures (e.g. the scene) are updated
 		void updateResources(UpdateContext & ctx);
+
+		size_t residencyBudget() const
+		{
+			return _residency_budget;
+		}
+
+		void setResidencyBudget(size_t budget)
+		{
+			_residency_budget = budget;
+		}
+
+		void declareGUI(GuiContext & ctx);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vkl/Core/VulkanCommons.hpp>
+#include <that/img/Image.hpp>
+
+namespace vkl
+{
+	class DelayedTaskExecutor;
+
+	// Converts tightly packed pixels from one format to another in a single pass:
+	// channels expansion / reduction (missing alpha is set to 1), type conversion between UNORM / sRGB (8 or 16 bits) and FLOAT (32 bits),
+	// or between integer formats of the same element size.
+	// UNORM <-> sRGB of the same size is a simple re-tagging (no gamma is applied).
+	struct ImageConversionInfo
+	{
+		const void * src = nullptr;
+		that::FormatInfo src_format = {};
+		void * dst = nullptr;
+		that::FormatInfo dst_format = {};
+		size_t pixel_count = 0;
+		// If not null, the pixels are split in tiles processed in parallel on the executor (the calling thread takes part in the work)
+		DelayedTaskExecutor * executor = nullptr;
+		size_t tile_size = 256 * 1024;
+	};
+
+	bool CanConvertImage(that::FormatInfo const& src, that::FormatInfo const& dst);
+
+	// Returns false if the conversion is not supported (nothing is written)
+	bool ConvertImage(ImageConversionInfo const& info);
+}
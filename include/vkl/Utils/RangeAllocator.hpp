@@ -0,0 +1,116 @@
+#pragma once
+
+#include <vkl/Utils/stl_extension.hpp>
+#include <vkl/Utils/MyVector.hpp>
+
+#include <map>
+#include <cstdint>
+
+namespace vkl
+{
+	// Sub-allocates ranges (of bytes) of a fixed capacity, with alignment
+	// First fit in a sorted free list, freed ranges are merged with their neighbours
+	class RangeAllocator
+	{
+	public:
+
+		using Offset = uint64_t;
+
+		static constexpr const Offset InvalidOffset = Offset(-1);
+
+		struct Stats
+		{
+			Offset capacity = 0;
+			Offset used = 0;
+			uint32_t allocations = 0;
+			uint32_t free_segments = 0;
+			Offset largest_free_segment = 0;
+
+			// 0: all the free space is contiguous, close to 1: the free space is scattered in small segments
+			float fragmentation() const
+			{
+				const Offset free_space = capacity - used;
+				return free_space ? (1.0f - float(largest_free_segment) / float(free_space)) : 0.0f;
+			}
+		};
+
+		// An allocation moved by compact()
+		struct Move
+		{
+			Offset src = 0;
+			Offset dst = 0;
+			Offset size = 0;
+		};
+
+	protected:
+
+		struct Allocation
+		{
+			Offset size = 0;
+			Offset alignment = 1;
+			bool pinned = false;
+		};
+
+		Offset _capacity = 0;
+		Offset _used = 0;
+
+		// begin -> len, sorted, never adjacent
+		std::map<Offset, Offset> _free_segments;
+		// begin -> allocation
+		std::map<Offset, Allocation> _allocations;
+
+		void insertFreeSegment(Offset begin, Offset len);
+
+	public:
+
+		RangeAllocator(Offset capacity = 0);
+
+		Offset capacity() const
+		{
+			return _capacity;
+		}
+
+		Offset used() const
+		{
+			return _used;
+		}
+
+		bool empty() const
+		{
+			return _allocations.empty();
+		}
+
+		// Returns InvalidOffset if there is no free segment large enough
+		Offset allocate(Offset size, Offset alignment = 1);
+
+		void release(Offset offset);
+
+		bool isAllocated(Offset offset) const
+		{
+			return _allocations.contains(offset);
+		}
+
+		// Pinned allocations are not moved by compact()
+		void setPinned(Offset offset, bool pinned);
+
+		bool hasPinned() const;
+
+		// callback(offset, size), in increasing offset order
+		template <class Callback>
+		void forEachAllocation(Callback const& callback) const
+		{
+			for (auto const& [offset, allocation] : _allocations)
+			{
+				callback(offset, allocation.size);
+			}
+		}
+
+		// Slides the (non pinned) allocations towards the beginning, in order, to gather the free space
+		// Returns the moved allocations, in increasing offset order
+		MyVector<Move> compact();
+
+		Stats stats() const;
+
+		bool checkIntegrity() const;
+	};
+}
@@ -0,0 +1,263 @@
+#pragma once
+
+#include <memory>
+#include <atomic>
+#include <array>
+#include <mutex>
+#include <future>
+#include <unordered_map>
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+namespace vkl
+{
+	// Read-mostly concurrent cache
+	// The keys are spread across shards by hash. Each shard publishes an immutable snapshot of its map (copied on write, RCU style):
+	// lookups only load the snapshot pointer, without taking the shard mutex.
+	// A replaced snapshot is retired, and freed by a writer once no reader is in the shard (the readers count themselves in and out).
+	// Inserts cost a copy of the shard map: meant for a read-mostly set of keys.
+	// Values are created outside of the locks, and concurrent requests of the same missing key wait for the first one (no duplicated creation).
+	template <class Key, class Value, class Hasher = std::hash<Key>, size_t ShardCount = 16>
+	class ShardedCache
+	{
+	public:
+
+		using ValuePtr = std::shared_ptr<Value>;
+		using Map = std::unordered_map<Key, ValuePtr, Hasher>;
+
+	protected:
+
+		struct alignas(64) Shard
+		{
+			std::atomic<const Map*> snapshot = nullptr;
+			// Number of readers using a snapshot of this shard
+			mutable std::atomic<uint32_t> readers = 0;
+			// Serializes the writers
+			std::mutex mutex;
+			std::unique_ptr<const Map> current = nullptr;
+			// Replaced snapshots, that readers may still use
+			std::vector<std::unique_ptr<const Map>> retired;
+			std::unordered_map<Key, std::shared_future<ValuePtr>, Hasher> in_flight;
+		};
+
+		// Keeps the snapshots of the shard alive while in scope
+		class ReadGuard
+		{
+		protected:
+			const Shard & _shard;
+		public:
+			// seq_cst: a reader counted after a writer saw none loads a snapshot published before (not retired)
+			ReadGuard(const Shard & shard) :
+				_shard(shard)
+			{
+				_shard.readers.fetch_add(1, std::memory_order_seq_cst);
+			}
+
+			~ReadGuard()
+			{
+				_shard.readers.fetch_sub(1, std::memory_order_release);
+			}
+
+			const Map * snapshot() const
+			{
+				return _shard.snapshot.load(std::memory_order_seq_cst);
+			}
+		};
+
+		Hasher _hasher = {};
+		std::array<Shard, ShardCount> _shards;
+
+		static size_t ShardIndex(size_t hash)
+		{
+			// Mix the hash (it can be the identity), the low bits are used by the maps of the shards
+			const uint64_t h = uint64_t(hash) * 0x9E3779B97F4A7C15ull;
+			return size_t(h >> 32) % ShardCount;
+		}
+
+		Shard & shard(size_t hash)
+		{
+			return _shards[ShardIndex(hash)];
+		}
+
+		const Shard & shard(size_t hash) const
+		{
+			return _shards[ShardIndex(hash)];
+		}
+
+		static ValuePtr Find(const Map * map, Key const& key)
+		{
+			ValuePtr res = nullptr;
+			if (map)
+			{
+				auto it = map->find(key);
+				if (it != map->end())
+				{
+					res = it->second;
+				}
+			}
+			return res;
+		}
+
+		// Assumes shard.mutex is locked
+		static void Reclaim(Shard & shard)
+		{
+			if (!shard.retired.empty() && shard.readers.load(std::memory_order_seq_cst) == 0)
+			{
+				shard.retired.clear();
+			}
+		}
+
+		// Assumes shard.mutex is locked
+		static void Replace(Shard & shard, std::unique_ptr<const Map> && map)
+		{
+			shard.snapshot.store(map.get(), std::memory_order_seq_cst);
+			if (shard.current)
+			{
+				shard.retired.push_back(std::move(shard.current));
+			}
+			shard.current = std::move(map);
+			Reclaim(shard);
+		}
+
+		// Assumes shard.mutex is locked
+		static void Publish(Shard & shard, Key const& key, ValuePtr const& value)
+		{
+			std::unique_ptr<Map> map = shard.current ? std::make_unique<Map>(*shard.current) : std::make_unique<Map>();
+			map->emplace(key, value);
+			Replace(shard, std::move(map));
+		}
+
+	public:
+
+		ShardedCache() = default;
+
+		ShardedCache(ShardedCache const&) = delete;
+		ShardedCache& operator=(ShardedCache const&) = delete;
+
+		// Does not lock the shard mutex
+		ValuePtr findIFP(Key const& key) const
+		{
+			const Shard & s = shard(_hasher(key));
+			const ReadGuard guard(s);
+			return Find(guard.snapshot(), key);
+		}
+
+		template <class CreateValueFunction>
+		ValuePtr findOrEmplace(Key const& key, CreateValueFunction const& create_value_function)
+		{
+			Shard & s = shard(_hasher(key));
+			ValuePtr res = findIFP(key);
+			if (res)
+			{
+				return res;
+			}
+
+			std::promise<ValuePtr> promise;
+			{
+				std::unique_lock lock(s.mutex);
+				// Created while waiting for the lock
+				res = Find(s.current.get(), key);
+				if (res)
+				{
+					return res;
+				}
+				auto it = s.in_flight.find(key);
+				if (it != s.in_flight.end())
+				{
+					std::shared_future<ValuePtr> future = it->second;
+					lock.unlock();
+					return future.get();
+				}
+				s.in_flight.emplace(key, promise.get_future().share());
+			}
+
+			try
+			{
+				res = create_value_function();
+			}
+			catch (...)
+			{
+				{
+					std::unique_lock lock(s.mutex);
+					s.in_flight.erase(key);
+				}
+				promise.set_exception(std::current_exception());
+				throw;
+			}
+
+			{
+				std::unique_lock lock(s.mutex);
+				Publish(s, key, res);
+				s.in_flight.erase(key);
+			}
+			promise.set_value(res);
+			return res;
+		}
+
+		// Returns false if the key is already present
+		bool record(Key const& key, ValuePtr const& value)
+		{
+			Shard & s = shard(_hasher(key));
+			std::unique_lock lock(s.mutex);
+			if (Find(s.current.get(), key))
+			{
+				return false;
+			}
+			Publish(s, key, value);
+			return true;
+		}
+
+		// On the current snapshots
+		template <class Function>
+		void forEach(Function const& f) const
+		{
+			for (Shard const& s : _shards)
+			{
+				const ReadGuard guard(s);
+				const Map * map = guard.snapshot();
+				if (map)
+				{
+					for (auto const& [key, value] : *map)
+					{
+						f(key, value);
+					}
+				}
+			}
+		}
+
+		size_t size() const
+		{
+			size_t res = 0;
+			for (Shard const& s : _shards)
+			{
+				const ReadGuard guard(s);
+				const Map * map = guard.snapshot();
+				res += map ? map->size() : 0;
+			}
+			return res;
+		}
+
+		// Can be concurrent with lookups: the snapshots in use are retired, not freed
+		// The values being created are not affected (they are published once created)
+		void clear()
+		{
+			for (Shard & s : _shards)
+			{
+				std::unique_lock lock(s.mutex);
+				Replace(s, nullptr);
+			}
+		}
+
+		// Frees the retired snapshots of the shards without readers
+		// Called at a quiescent point (e.g. updateResources), in case the writers always saw readers
+		void reclaim()
+		{
+			for (Shard & s : _shards)
+			{
+				std::unique_lock lock(s.mutex);
+				Reclaim(s);
+			}
+		}
+	};
+}
@@ -7,6 +7,7 @@
 #include <vkl/Execution/UpdateContext.hpp>
 #include <atomic>
 #include <vkl/Execution/ResourceState.hpp>
+#include <vkl/Execution/MemoryTelemetry.hpp>
 
 #ifndef VMA_NULL
 #define VMA_NULL nullptr
@@ -34,6 +35,8 @@ namespace vkl
 		size_t _unique_id = 0;
 		VmaAllocator _allocator = VMA_NULL;
 		VmaAllocation _alloc = VMA_NULL;
+		MemoryCategory _memory_category = MemoryCategory::Auto;
+		VkDeviceSize _memory_size = 0;
 
 		VkDeviceAddress _address = 0;
 
@@ -71,6 +74,7 @@ namespace vkl
 			VmaAllocationCreateInfo aci;
 			VkDeviceSize min_align = 1;
 			VmaAllocator allocator = VMA_NULL;
+			MemoryCategory memory_category = MemoryCategory::Auto;
 		};
 		using CI = CreateInfo;
 
@@ -90,6 +94,9 @@ namespace vkl
 
 		void flush();
 
+		// Before reading on the host what the device wrote (no-op on coherent memory)
+		void invalidate();
+
 		VkDeviceAddress deviceAddress() const
 		{
 			assert(_ci.usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT);
@@ -192,6 +199,8 @@ namespace vkl
 			VkBufferUsageFlags usage = 0;
 			std::vector<uint32_t> queues = {};
 			VmaMemoryUsage mem_usage = VMA_MEMORY_USAGE_MAX_ENUM;
+			// Of the telemetry
+			MemoryCategory memory_category = MemoryCategory::Auto;
 
 			VmaAllocator allocator = nullptr;
 			bool create_on_construct = false;
@@ -208,6 +217,7 @@ namespace vkl
 		std::vector<uint32_t> _queues = {};
 		VkSharingMode _sharing_mode = VK_SHARING_MODE_MAX_ENUM;
 		VmaMemoryUsage _mem_usage = VMA_MEMORY_USAGE_MAX_ENUM;
+		MemoryCategory _memory_category = MemoryCategory::Auto;
 		VmaAllocator _allocator = nullptr;
 		
 
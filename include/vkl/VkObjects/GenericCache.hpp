@@ -2,8 +2,13 @@
 
 #include <memory>
 #include <vector>
+#include <unordered_map>
+#include <functional>
+#include <atomic>
 #include <shared_mutex>
+#include <future>
 #include <vkl/Utils/CompileTimeOptional.hpp>
+#include <vkl/Utils/stl_extension.hpp>
 
 namespace vkl
 {
@@ -11,62 +16,256 @@ namespace vkl
 	class GenericCache
 	{
 	protected:
-		
+
 		mutable std::CompileTimeOptional<std::shared_mutex, thread_safe> _mutex;
 
 	public:
 
+		struct Stats
+		{
+			size_t size = 0;
+			size_t hits = 0;
+			size_t misses = 0;
+			size_t evictions = 0;
+		};
+
 		virtual void clear() = 0;
 
+		// Evicts the values only referenced by the cache
+		virtual size_t evictUnused() = 0;
+
+		virtual Stats stats() const = 0;
 	};
 
+	// Keys with a hash() method are indexed in a hash map, other keys are searched linearly
 	template <class Key, class Value, bool thread_safe = true>
 	class GenericCacheImpl : public GenericCache<Value, thread_safe>
 	{
-	protected:
+	public:
 
 		using ParentType = GenericCache<Value, thread_safe>;
-		
+		using Stats = typename ParentType::Stats;
+
+		static constexpr bool IsHashed = std::concepts::HashableFromMethod<Key>;
+
+		// Called (with the cache locked) for each evicted value, including by clear()
+		using EvictionCallback = std::function<void(Key const&, std::shared_ptr<Value> const&)>;
+
+	protected:
+
 		struct CachedValue
 		{
 			Key key;
 			std::shared_ptr<Value> value;
 		};
 
-		// TODO use a map if keys allow it
+		using Storage = std::conditional_t<IsHashed, std::unordered_map<Key, std::shared_ptr<Value>>, std::vector<CachedValue>>;
+
+		Storage _values;
+
+		struct InFlightValue
+		{
+			Key key;
+			std::shared_future<std::shared_ptr<Value>> future;
+		};
+
+		// Values being created (outside of the lock)
+		std::vector<InFlightValue> _in_flight;
+
+		EvictionCallback _eviction_callback = {};
 
-		std::vector<CachedValue> _values;
+		std::atomic<size_t> _hits = 0;
+		std::atomic<size_t> _misses = 0;
+		size_t _evictions = 0;
+
+		std::shared_ptr<Value> find(Key const& key) const
+		{
+			std::shared_ptr<Value> res = nullptr;
+			if constexpr (IsHashed)
+			{
+				auto it = _values.find(key);
+				if (it != _values.end())
+				{
+					res = it->second;
+				}
+			}
+			else
+			{
+				for (size_t i = 0; i < _values.size(); ++i)
+				{
+					if (_values[i].key == key)
+					{
+						res = _values[i].value;
+						break;
+					}
+				}
+			}
+			return res;
+		}
+
+		void insert(Key const& key, std::shared_ptr<Value> const& value)
+		{
+			if constexpr (IsHashed)
+			{
+				_values.emplace(key, value);
+			}
+			else
+			{
+				_values.emplace_back(CachedValue{
+					.key = key,
+					.value = value,
+				});
+			}
+		}
+
+		void eraseInFlight(Key const& key)
+		{
+			for (size_t i = 0; i < _in_flight.size(); ++i)
+			{
+				if (_in_flight[i].key == key)
+				{
+					_in_flight.erase(_in_flight.begin() + i);
+					break;
+				}
+			}
+		}
+
+		// Returns the number of evicted values
+		template <class Predicate>
+		size_t evictIf(Predicate const& predicate)
+		{
+			size_t res = 0;
+			const auto on_evict = [&](Key const& key, std::shared_ptr<Value> const& value)
+			{
+				if (_eviction_callback)
+				{
+					_eviction_callback(key, value);
+				}
+				++res;
+			};
+			if constexpr (IsHashed)
+			{
+				for (auto it = _values.begin(); it != _values.end();)
+				{
+					if (predicate(it->first, it->second))
+					{
+						on_evict(it->first, it->second);
+						it = _values.erase(it);
+					}
+					else
+					{
+						++it;
+					}
+				}
+			}
+			else
+			{
+				size_t kept = 0;
+				for (size_t i = 0; i < _values.size(); ++i)
+				{
+					if (predicate(_values[i].key, _values[i].value))
+					{
+						on_evict(_values[i].key, _values[i].value);
+					}
+					else
+					{
+						if (kept != i)
+						{
+							_values[kept] = std::move(_values[i]);
+						}
+						++kept;
+					}
+				}
+				_values.resize(kept);
+			}
+			_evictions += res;
+			return res;
+		}
 
 	public:
 
+		void setEvictionCallback(EvictionCallback const& callback)
+		{
+			if constexpr (thread_safe)
+			{
+				ParentType::_mutex._.lock();
+			}
+			_eviction_callback = callback;
+			if constexpr (thread_safe)
+			{
+				ParentType::_mutex._.unlock();
+			}
+		}
+
 		virtual void clear() final override
 		{
 			if constexpr (thread_safe)
 			{
 				ParentType::_mutex._.lock();
 			}
-			_values.clear();
+			evictIf([](Key const&, std::shared_ptr<Value> const&) {return true; });
 			if constexpr (thread_safe)
 			{
 				ParentType::_mutex._.unlock();
 			}
 		}
 
-		std::shared_ptr<Value> findIFP(Key const& key) const
+		// Returns false if the key is not in the cache
+		bool evict(Key const& key)
+		{
+			if constexpr (thread_safe)
+			{
+				ParentType::_mutex._.lock();
+			}
+			const size_t evicted = evictIf([&](Key const& k, std::shared_ptr<Value> const&) {return k == key; });
+			if constexpr (thread_safe)
+			{
+				ParentType::_mutex._.unlock();
+			}
+			return evicted != 0;
+		}
+
+		virtual size_t evictUnused() final override
+		{
+			if constexpr (thread_safe)
+			{
+				ParentType::_mutex._.lock();
+			}
+			const size_t res = evictIf([](Key const&, std::shared_ptr<Value> const& value) {return value.use_count() == 1; });
+			if constexpr (thread_safe)
+			{
+				ParentType::_mutex._.unlock();
+			}
+			return res;
+		}
+
+		virtual Stats stats() const final override
 		{
 			if constexpr (thread_safe)
 			{
 				ParentType::_mutex._.lock_shared();
 			}
-			std::shared_ptr<Value> res = nullptr;
-			for (size_t i = 0; i < _values.size(); ++i)
+			Stats res{
+				.size = _values.size(),
+				.hits = _hits.load(),
+				.misses = _misses.load(),
+				.evictions = _evictions,
+			};
+			if constexpr (thread_safe)
 			{
-				if (_values[i].key == key)
-				{
-					res = _values[i].value;
-					break;
-				}
+				ParentType::_mutex._.unlock_shared();
+			}
+			return res;
+		}
+
+		// Does not count as a hit or a miss
+		std::shared_ptr<Value> findIFP(Key const& key) const
+		{
+			if constexpr (thread_safe)
+			{
+				ParentType::_mutex._.lock_shared();
 			}
+			std::shared_ptr<Value> res = find(key);
 			if constexpr (thread_safe)
 			{
 				ParentType::_mutex._.unlock_shared();
@@ -74,37 +273,81 @@ namespace vkl
 			return res;
 		}
 
+		// The value is created outside of the lock
+		// Concurrent calls with the same key wait for the first one to create it (and count as misses)
 		template <class CreateValueFunction>
 		std::shared_ptr<Value> findOrEmplace(Key const& key, CreateValueFunction const& create_value_function)
 		{
-			if constexpr (thread_safe)
+			if constexpr (!thread_safe)
 			{
-				ParentType::_mutex._.lock();
+				std::shared_ptr<Value> res = find(key);
+				if (res)
+				{
+					_hits.fetch_add(1, std::memory_order_relaxed);
+				}
+				else
+				{
+					_misses.fetch_add(1, std::memory_order_relaxed);
+					res = create_value_function();
+					insert(key, res);
+				}
+				return res;
 			}
-			std::shared_ptr<Value> res = nullptr;
+			else
 			{
-				for (size_t i = 0; i < _values.size(); ++i)
+				std::shared_ptr<Value> res = findIFP(key);
+				if (res)
 				{
-					if (_values[i].key == key)
+					_hits.fetch_add(1, std::memory_order_relaxed);
+					return res;
+				}
+
+				_misses.fetch_add(1, std::memory_order_relaxed);
+				std::promise<std::shared_ptr<Value>> promise;
+				{
+					std::unique_lock lock(ParentType::_mutex._);
+					res = find(key);
+					if (res)
 					{
-						res = _values[i].value;
-						break;
+						return res;
+					}
+					for (size_t i = 0; i < _in_flight.size(); ++i)
+					{
+						if (_in_flight[i].key == key)
+						{
+							std::shared_future<std::shared_ptr<Value>> future = _in_flight[i].future;
+							lock.unlock();
+							return future.get();
+						}
 					}
+					_in_flight.emplace_back(InFlightValue{
+						.key = key,
+						.future = promise.get_future().share(),
+					});
 				}
-				if (!res)
+
+				try
 				{
 					res = create_value_function();
-					_values.emplace_back(CachedValue{
-						.key = key,
-						.value = res,
-					});
 				}
+				catch (...)
+				{
+					{
+						std::unique_lock lock(ParentType::_mutex._);
+						eraseInFlight(key);
+					}
+					promise.set_exception(std::current_exception());
+					throw;
+				}
+
+				{
+					std::unique_lock lock(ParentType::_mutex._);
+					insert(key, res);
+					eraseInFlight(key);
+				}
+				promise.set_value(res);
+				return res;
 			}
-			if constexpr (thread_safe)
-			{
-				ParentType::_mutex._.unlock();
-			}
-			return res;
 		}
 
 		void recordValue(Key&& k, std::shared_ptr<Value>&& v)
@@ -114,10 +357,7 @@ namespace vkl
 			{
 				ParentType::_mutex._.lock();
 			}
-			_values.emplace_back(CachedValue{
-				.key = std::move(k),
-				.value = std::move(v),
-			});
+			insert(k, v);
 			if constexpr (thread_safe)
 			{
 				ParentType::_mutex._.unlock();
@@ -131,14 +371,11 @@ namespace vkl
 			{
 				ParentType::_mutex._.lock();
 			}
-			_values.emplace_back(CachedValue{
-				.key = k,
-				.value = v,
-			});
+			insert(k, v);
 			if constexpr (thread_safe)
 			{
 				ParentType::_mutex._.unlock();
 			}
 		}
 	};
-}
\ No newline at end of file
+}
@@ -9,9 +9,62 @@
 #include <vkl/Execution/UpdateContext.hpp>
 #include <atomic>
 #include <vkl/Execution/ResourceState.hpp>
+#include <vkl/Execution/MemoryTelemetry.hpp>
 
 namespace vkl
 {
+	// Device memory on which several images can be bound (aliased)
+	class ImageMemoryBlock
+	{
+	protected:
+
+		VkApplication * _app = nullptr;
+		VmaAllocation _alloc = nullptr;
+		VkMemoryRequirements _requirements = {};
+		MemoryCategory _memory_category = MemoryCategory::RenderTarget;
+		VkDeviceSize _memory_size = 0;
+
+	public:
+
+		struct CreateInfo
+		{
+			VkApplication * app = nullptr;
+			VkMemoryRequirements requirements = {};
+			VmaMemoryUsage mem_usage = VMA_MEMORY_USAGE_GPU_ONLY;
+			MemoryCategory memory_category = MemoryCategory::RenderTarget;
+		};
+		using CI = CreateInfo;
+
+		ImageMemoryBlock(CreateInfo const& ci);
+
+		~ImageMemoryBlock();
+
+		ImageMemoryBlock(ImageMemoryBlock const&) = delete;
+		ImageMemoryBlock& operator=(ImageMemoryBlock const&) = delete;
+
+		constexpr VmaAllocation allocation()const
+		{
+			return _alloc;
+		}
+
+		constexpr VkMemoryRequirements const& requirements()const
+		{
+			return _requirements;
+		}
+	};
+
+	struct ImageMemoryPlacement
+	{
+		std::shared_ptr<ImageMemoryBlock> block = nullptr;
+		VkDeviceSize offset = 0;
+		VkDeviceSize size = 0;
+
+		bool fits(VkMemoryRequirements const& requirements) const
+		{
+			return block && (requirements.size <= size) && (offset % requirements.alignment == 0) && (requirements.memoryTypeBits & block->requirements().memoryTypeBits);
+		}
+	};
+
 	class ImageInstance : public AbstractInstance
 	{
 	public:
@@ -22,6 +75,10 @@ namespace vkl
 			std::string name = {};
 			VkImageCreateInfo ci;
 			VmaAllocationCreateInfo aci;
+			// If set, the image is bound there instead of a dedicated allocation (aci is ignored)
+			ImageMemoryPlacement placement = {};
+			// Placed images are accounted with their block
+			MemoryCategory memory_category = MemoryCategory::Auto;
 		};
 
 		using CI = CreateInfo;
@@ -48,6 +105,10 @@ namespace vkl
 		VmaAllocationCreateInfo _vma_ci = {};
 
 		VmaAllocation _alloc = nullptr;
+		// Keeps the memory block alive
+		ImageMemoryPlacement _placement = {};
+		MemoryCategory _memory_category = MemoryCategory::Auto;
+		VkDeviceSize _memory_size = 0;
 		VkImage _image = VK_NULL_HANDLE;
 		size_t _unique_id = 0;
 
@@ -123,9 +184,19 @@ namespace vkl
 			return _alloc;
 		}
 
-		constexpr bool ownership()const
+		bool ownership()const
+		{
+			return !!_alloc || !!_placement.block;
+		}
+
+		bool isPlaced()const
 		{
-			return !!_alloc;
+			return !!_placement.block;
+		}
+
+		constexpr ImageMemoryPlacement const& placement()const
+		{
+			return _placement;
 		}
 
 		constexpr size_t uniqueId()const
@@ -184,6 +255,8 @@ namespace vkl
 			VkImageUsageFlags usage = 0;
 			std::vector<uint32_t> queues = {};
 			VmaMemoryUsage mem_usage = VMA_MEMORY_USAGE_GPU_ONLY;
+			// Of the telemetry
+			MemoryCategory memory_category = MemoryCategory::Auto;
 			VkImageLayout initial_layout = VK_IMAGE_LAYOUT_UNDEFINED;
 			bool create_on_construct = false;
 			Dyn<bool> hold_instance = true;
@@ -239,9 +312,14 @@ namespace vkl
 		VkImageLayout _initial_layout = VK_IMAGE_LAYOUT_UNDEFINED;
 
 		VmaMemoryUsage _mem_usage = VMA_MEMORY_USAGE_UNKNOWN;
+		MemoryCategory _memory_category = MemoryCategory::Auto;
+
+		ImageMemoryPlacement _memory_placement = {};
 
 		// Could bitpack maybe
 		size_t _latest_update_tick = 0;
+		// Global DynamicValueEpoch at which the dynamic values were last compared with the instance
+		size_t _checked_epoch = 0;
 		bool _latest_update_res = false;
 		bool _inst_all_mips = false;
 
@@ -255,6 +333,20 @@ namespace vkl
 
 		void createInstance();
 
+		// With the current dynamic values (pQueueFamilyIndices points to this)
+		VkImageCreateInfo getInstanceCreateInfo() const;
+
+		// The next instances are bound at this place (when they fit in it), instead of a dedicated allocation
+		void setMemoryPlacement(ImageMemoryPlacement const& placement)
+		{
+			_memory_placement = placement;
+		}
+
+		constexpr ImageMemoryPlacement const& memoryPlacement()const
+		{
+			return _memory_placement;
+		}
+
 		constexpr VkImageCreateFlags flags()const
 		{
 			return _flags;
@@ -28,9 +28,16 @@ namespace vkl
 			create();
 		}
 
+		template <typename StringLike = std::string>
+		Semaphore(VkApplication* app, StringLike&& name, VkSemaphoreType type, uint64_t initial_value) :
+			VkObject(app, std::forward<StringLike>(name))
+		{
+			create(type, initial_value);
+		}
+
 		virtual ~Semaphore() override;
 
-		void create();
+		void create(VkSemaphoreType type = VK_SEMAPHORE_TYPE_BINARY, uint64_t initial_value = 0);
 
 		void destroy();
 
@@ -44,4 +51,29 @@ namespace vkl
 			return _handle;
 		}
 	};
+
+	// Monotonic counter signaled by the queue submissions
+	// The CPU can wait for (or poll) a value instead of a fence per submission
+	class TimelineSemaphore : public Semaphore
+	{
+	public:
+
+		template <typename StringLike = std::string>
+		TimelineSemaphore(VkApplication* app, StringLike&& name, uint64_t initial_value = 0) :
+			Semaphore(app, std::forward<StringLike>(name), VK_SEMAPHORE_TYPE_TIMELINE, initial_value)
+		{}
+
+		virtual ~TimelineSemaphore() override = default;
+
+		uint64_t value() const;
+
+		bool reached(uint64_t value) const
+		{
+			return this->value() >= value;
+		}
+
+		VkResult wait(uint64_t value, uint64_t timeout = UINT64_MAX) const;
+
+		void signal(uint64_t value);
+	};
 }
\ No newline at end of file
@@ -7,7 +7,10 @@
 #include "DescriptorSetLayout.hpp"
 #include "AbstractInstance.hpp"
 #include <set>
+#include <list>
 #include <unordered_map>
+#include <mutex>
+#include <atomic>
 #include <vkl/Execution/UpdateContext.hpp>
 #include <filesystem>
 
@@ -160,6 +163,114 @@ namespace vkl
 		{
 			return _has_debug_info;
 		}
+
+		// Approximation of the host memory held by this instance (the driver memory of the module is unknown)
+		size_t memoryFootprint() const
+		{
+			return _spv_code.size() * sizeof(uint32_t) + _preprocessed_source.capacity() + sizeof(ShaderInstance);
+		}
+	};
+
+	// Process wide table of the compiled ShaderInstances
+	// Shaders compiling the same source, for the same stage, with the same definitions and options share the same instance
+	// Only weak references are kept: an instance is released when no Shader uses it anymore
+	class ShaderInstanceRegistry : public VkObject
+	{
+	public:
+
+		struct Key
+		{
+			that::FileSystem::Path path = {};
+			VkShaderStageFlagBits stage = VK_SHADER_STAGE_FLAG_BITS_MAX_ENUM;
+			// Collapsed list of all the definitions (including the common ones)
+			std::string definitions = {};
+			size_t shader_string_packed_capacity = 32;
+			bool generate_debug_info = false;
+
+			bool operator==(Key const& o) const = default;
+		};
+
+		struct KeyHasher
+		{
+			size_t operator()(Key const& key) const;
+		};
+
+		struct PendingCompilation
+		{
+			std::shared_ptr<AsynchTask> task = nullptr;
+			// Valid once task succeeded
+			std::shared_ptr<ShaderInstance> result = nullptr;
+			// Set once task failed
+			std::string error_title = {};
+			std::string error_message = {};
+		};
+
+		struct Acquired
+		{
+			// Set if a compiled instance is already available
+			std::shared_ptr<ShaderInstance> instance = nullptr;
+			// Set otherwise, the caller should depend on pending->task
+			std::shared_ptr<PendingCompilation> pending = nullptr;
+		};
+
+		using CompileFunction = std::function<std::shared_ptr<ShaderInstance>(void)>;
+
+	protected:
+
+		struct Entry
+		{
+			std::weak_ptr<ShaderInstance> instance = {};
+			std::shared_ptr<PendingCompilation> pending = nullptr;
+		};
+
+		std::mutex _mutex;
+		std::unordered_map<Key, Entry, KeyHasher> _entries;
+		size_t _sweep_threshold = 64;
+		// Compilations queued or running
+		size_t _in_flight = 0;
+
+		std::atomic<size_t> _compiled_count = 0;
+		// Requests served by an already compiled instance
+		std::atomic<size_t> _shared_count = 0;
+		// Requests that waited on a compilation launched by another Shader
+		std::atomic<size_t> _joined_count = 0;
+		size_t _reported_compiled_count = 0;
+		size_t _reported_avoided_count = 0;
+
+		// Requires _mutex to be locked
+		void sweepExpiredEntriesIFN();
+
+		// Requires _mutex to be locked
+		void reportIFN();
+
+	public:
+
+		struct CreateInfo
+		{
+			VkApplication * app = nullptr;
+			std::string name = {};
+		};
+		using CI = CreateInfo;
+
+		ShaderInstanceRegistry(CreateInfo const& ci);
+
+		virtual ~ShaderInstanceRegistry() override;
+
+		// compile is only called (asynchronously on the thread pool) if no instance matching key is available or pending
+		Acquired acquire(Key const& key, CompileFunction const& compile, TaskPriority priority = TaskPriority::ASAP());
+
+		// Remove the entry of key if it points to instance, so that the next acquire recompiles the shader (ex: when a source file changed)
+		void forget(Key const& key, std::shared_ptr<ShaderInstance> const& instance);
+
+		size_t compiledCount() const
+		{
+			return _compiled_count.load();
+		}
+
+		size_t avoidedCompilationsCount() const
+		{
+			return _shared_count.load() + _joined_count.load();
+		}
 	};
 
 	class Shader : public InstanceHolder<ShaderInstance>
@@ -193,7 +304,81 @@ namespace vkl
 				return std::hash<std::string>()(key.definitions);
 			}
 		};
-		using SpecializationTable = std::unordered_map<SpecializationKey, std::shared_ptr<ShaderInstance>, SpecKeyHasher>;
+
+		struct Specialization
+		{
+			SpecializationKey key = {};
+			std::shared_ptr<ShaderInstance> instance = nullptr;
+			size_t footprint = 0;
+		};
+
+		// Bounded LRU cache of the compiled specializations
+		// Not thread safe
+		class SpecializationTable
+		{
+		protected:
+
+			// Most recently used first
+			std::list<Specialization> _list = {};
+			std::unordered_map<SpecializationKey, std::list<Specialization>::iterator, SpecKeyHasher> _index = {};
+			size_t _footprint = 0;
+			size_t _max_count = 0;
+			size_t _max_footprint = 0;
+			size_t _evicted_count = 0;
+
+			void evictIFN();
+
+		public:
+
+			SpecializationTable(size_t max_count, size_t max_footprint) :
+				_max_count(max_count),
+				_max_footprint(max_footprint)
+			{}
+
+			bool contains(SpecializationKey const& key) const
+			{
+				return _index.contains(key);
+			}
+
+			// Marks the specialization as the most recently used
+			std::shared_ptr<ShaderInstance> get(SpecializationKey const& key);
+
+			// Inserts (or replaces) as the most recently used (or as the least recently used if !most_recent, ex: speculative specializations),
+			// then evicts the least recently used ones if over budget
+			void insert(SpecializationKey const& key, std::shared_ptr<ShaderInstance> const& instance, bool most_recent = true);
+
+			void clear();
+
+			std::list<Specialization> const& list() const
+			{
+				return _list;
+			}
+
+			size_t size() const
+			{
+				return _list.size();
+			}
+
+			size_t footprint() const
+			{
+				return _footprint;
+			}
+
+			size_t evictedCount() const
+			{
+				return _evicted_count;
+			}
+		};
+
+		static constexpr size_t DefaultMaxSpecializations()
+		{
+			return 8;
+		}
+
+		static constexpr size_t DefaultMaxSpecializationsFootprint()
+		{
+			return 16 * 1024 * 1024;
+		}
 
 	protected:
 
@@ -204,6 +389,8 @@ namespace vkl
 		size_t _update_tick = 0;
 		bool _latest_update_result = false;
 		std::filesystem::path _path;
+		// Key of the ShaderInstanceRegistry, falls back to _path if it cannot be cannonized
+		std::filesystem::path _cannon_path;
 		VkShaderStageFlagBits _stage;
 		DynamicValue<DefinitionsList> _definitions;
 		std::vector<Dependecy> _dependencies;
@@ -211,7 +398,22 @@ namespace vkl
 		FileSystem::TimePoint _instance_time = {};
 
 		SpecializationKey _current_key = {};
-		SpecializationTable _specializations = {};
+		SpecializationTable _specializations;
+
+		struct SpeculativeCompilation
+		{
+			SpecializationKey key = {};
+			std::shared_ptr<ShaderInstanceRegistry::PendingCompilation> pending = nullptr;
+		};
+
+		// Launched by prepareSpeculativeDefinitions, moved to _specializations in the next update
+		MyVector<SpeculativeCompilation> _speculative_compilations = {};
+		
+		ShaderInstanceRegistry::Key makeRegistryKey(std::string const& collapsed_definitions, size_t string_packed_capacity, bool generate_shader_debug_info) const;
+
+		ShaderInstanceRegistry::CompileFunction makeCompileFunction(DefinitionsList && definitions, size_t string_packed_capacity, bool generate_shader_debug_info) const;
+
+		void collectSpeculativeCompilations();
 
 		void createInstance(SpecializationKey const& key, DefinitionsList const& common_definitions, size_t string_packed_capacity, bool generate_shader_debug_info);
 
@@ -234,6 +436,8 @@ namespace vkl
 			DynamicValue<DefinitionsList> definitions;
 			bool create_on_construct = false;
 			Dyn<bool> hold_instance = true;
+			size_t max_specializations = DefaultMaxSpecializations();
+			size_t max_specializations_footprint = DefaultMaxSpecializationsFootprint();
 		};
 		using CI = CreateInfo;
 
@@ -261,5 +465,16 @@ namespace vkl
 		{
 			return _stage;
 		}
+
+		// Declare definitions (as _definitions would evaluate to) likely to be used soon
+		// The specialization is compiled in the background (TaskPriority::WhenPossible) and kept in the specialization cache,
+		// so that switching to it later does not stall
+		// Can be called even if this shader is not updated
+		void prepareSpeculativeDefinitions(UpdateContext & ctx, DefinitionsList const& definitions);
+
+		SpecializationTable const& specializations() const
+		{
+			return _specializations;
+		}
 	};
-}
\ No newline at end of file
+}
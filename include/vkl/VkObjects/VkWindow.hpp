@@ -78,6 +78,8 @@ namespace vkl
 
 		Dyn<Vector2i> _extern_resolution = {};
 		Vector2i _desired_resolution = {};
+		// Advanced when the size changes: _dynamic_extent is memoized on it
+		DynamicValueEpoch _extent_epoch;
 		Dyn<VkExtent3D> _dynamic_extent = {};
 		
 
@@ -8,6 +8,7 @@ namespace vkl
 		_sets_layouts(ci.sets_layouts),
 		_positions(ci.positions),
 		_normals(ci.normals),
+		_depth_pyramid(ci.depth_pyramid),
 		_can_rt(ci.can_rt),
 		_gui_method(ImGuiListSelection::CI{
 			.name = "Method",
@@ -105,13 +106,9 @@ namespace vkl
 		});
 
 		const std::filesystem::path folder = "ShaderLib:/Rendering/AmbientOcclusion/";
-		_method_glsl = "AO_METHOD 0";
 		Dyn<DefinitionsList> defs = [this](DefinitionsList & res)
 		{
-			res.clear();
-			res.pushBackFormatted("OUT_FORMAT {:s}", _format_glsl);
-			res.pushBackFormatted("AO_SAMPLES {:d}", _ao_samples);
-			res.push_back(_method_glsl);
+			fillDefinitions(res, static_cast<uint32_t>(_gui_method.index()));
 			return res;
 		};
 
@@ -136,6 +133,16 @@ namespace vkl
 			});
 		}
 
+		ShaderBindings ssao_bindings = bindings;
+		if (_depth_pyramid)
+		{
+			ssao_bindings.push_back(Binding{
+				.image = _depth_pyramid->pyramid(),
+				.sampler = _sampler,
+				.binding = 3,
+			});
+		}
+
 		_ssao_compute_command = std::make_shared<ComputeCommand>(ComputeCommand::CI{
 			.app = application(),
 			.name = name() + ".SSAO",
@@ -143,7 +150,7 @@ namespace vkl
 			.extent = target_extent,
 			.dispatch_threads = true,
 			.sets_layouts = _sets_layouts,
-			.bindings = bindings,
+			.bindings = ssao_bindings,
 			.definitions = defs,
 		});
 
@@ -190,14 +197,52 @@ namespace vkl
 	}
 
 
+	void AmbientOcclusion::fillDefinitions(DefinitionsList& res, uint32_t method) const
+	{
+		res.clear();
+		res.pushBackFormatted("OUT_FORMAT {:s}", _format_glsl);
+		res.pushBackFormatted("AO_SAMPLES {:d}", _ao_samples);
+		res.pushBackFormatted("AO_METHOD {:d}", method);
+		res.pushBackFormatted("AO_DEPTH_PYRAMID {:d}", _depth_pyramid ? 1 : 0);
+	}
+
+	ShaderCommand* AmbientOcclusion::getMethodCommand(uint32_t method) const
+	{
+		ShaderCommand* res = nullptr;
+		if (method == static_cast<uint32_t>(Method::SSAO))
+		{
+			res = _ssao_compute_command.get();
+		}
+		else if (method == static_cast<uint32_t>(Method::RTAO))
+		{
+			res = _rtao_command.get();
+		}
+		else if (method == static_cast<uint32_t>(Method::RQAO))
+		{
+			res = _rqao_compute_command.get();
+		}
+		return res;
+	}
+
 	void AmbientOcclusion::updateResources(UpdateContext& ctx)
 	{
 		_target->updateResource(ctx);
 		if (_enable)
 		{
-			_method_glsl.back() = '0' + _gui_method.index();
 			_sampler->updateResources(ctx);
 
+			// Compile the other available methods in the background, so that switching is instant
+			static thread_local DefinitionsList speculative_definitions;
+			for (uint32_t m = 0; m < _gui_method.options().size32(); ++m)
+			{
+				ShaderCommand* command = getMethodCommand(m);
+				if (m != _gui_method.index() && command && !_gui_method.options()[m].disable)
+				{
+					fillDefinitions(speculative_definitions, m);
+					command->prepareSpeculativeDefinitions(ctx, speculative_definitions);
+				}
+			}
+
 			if (_gui_method.index() == static_cast<uint32_t>(Method::SSAO))
 			{
 				ctx.resourcesToUpdateLater() += _ssao_compute_command;
@@ -227,6 +272,14 @@ namespace vkl
 			{
 				flags |= 1;
 			}
+			if (needsDepthPyramid() && _depth_pyramid->isValid())
+			{
+				flags |= 2;
+			}
+			if (camera.hasReverseDepth())
+			{
+				flags |= 4;
+			}
 
 			const CommandPC pc{
 				.camera_position = camera.position(),
@@ -11,6 +11,8 @@
 
 #include <vkl/Rendering/Camera.hpp>
 
+#include "DepthPyramid.hpp"
+
 
 namespace vkl
 {
@@ -44,8 +46,6 @@ namespace vkl
 
 		MultiDescriptorSetsLayouts _sets_layouts = {};
 
-		std::string _method_glsl;
-
 		std::shared_ptr<ComputeCommand> _ssao_compute_command = nullptr;
 		std::shared_ptr<ComputeCommand> _rqao_compute_command = nullptr;
 		std::shared_ptr<RayTracingCommand> _rtao_command = nullptr;
@@ -62,6 +62,8 @@ namespace vkl
 
 		std::shared_ptr<ImageView> _positions = nullptr;
 		std::shared_ptr<ImageView> _normals = nullptr;
+		// Optional, the SSAO skips the background with it
+		std::shared_ptr<DepthPyramid> _depth_pyramid = nullptr;
 
 		VkFormat _format;
 		std::string _format_glsl = {};
@@ -70,6 +72,10 @@ namespace vkl
 
 		void createInternalResources();
 
+		void fillDefinitions(DefinitionsList & res, uint32_t method) const;
+
+		ShaderCommand* getMethodCommand(uint32_t method) const;
+
 	public:
 
 		struct CreateInfo
@@ -81,6 +87,8 @@ namespace vkl
 			std::shared_ptr<ImageView> normals = nullptr;
 			bool can_rt = false;
 			uint32_t default_method = 1;
+			// Of the positions, recorded before execute()
+			std::shared_ptr<DepthPyramid> depth_pyramid = nullptr;
 		};
 		using CI = CreateInfo;
 
@@ -105,6 +113,11 @@ namespace vkl
 			return _enable;
 		}
 
+		bool needsDepthPyramid()const
+		{
+			return _depth_pyramid && enable() && _gui_method.index() == static_cast<uint32_t>(Method::SSAO);
+		}
+
 		// 1 -> need RT
 		// 2 -> need RQ
 		uint32_t needRTOrRQ()const
@@ -48,6 +48,12 @@ namespace vkl
 		virtual ~DepthOfField() override = default;
 
 
+		// Only alive during record()
+		std::shared_ptr<ImageView> const& targetCopy() const
+		{
+			return _target_copy;
+		}
+
 		virtual void updateResources(UpdateContext& ctx);
 
 		virtual void record(ExecutionRecorder& exec);
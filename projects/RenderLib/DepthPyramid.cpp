@@ -0,0 +1,128 @@
+#include "DepthPyramid.hpp"
+
+#include <vkl/Commands/PrebuiltTransferCommands.hpp>
+
+namespace vkl
+{
+	DepthPyramid::DepthPyramid(CreateInfo const& ci) :
+		Module(ci.app, ci.name),
+		_depth(ci.depth),
+		_sets_layouts(ci.sets_layouts)
+	{
+		createInternals();
+	}
+
+	void DepthPyramid::createInternals()
+	{
+		_pyramid = std::make_shared<ImageView>(Image::CI{
+			.app = application(),
+			.name = name() + ".Pyramid",
+			.type = VK_IMAGE_TYPE_2D,
+			.format = VK_FORMAT_R32G32_SFLOAT,
+			.extent = _depth->image()->extent(),
+			.mips = Image::ALL_MIPS,
+			// Transfer src: read back by the checks
+			.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+			.mem_usage = VMA_MEMORY_USAGE_GPU_ONLY,
+		});
+
+		_level_views.resize(MaxLevels);
+		for (uint32_t l = 0; l < MaxLevels; ++l)
+		{
+			_level_views[l] = std::make_shared<ImageView>(ImageView::CI{
+				.app = application(),
+				.name = std::format("{}.Level{}", name(), l),
+				.image = _pyramid->image(),
+				.type = VK_IMAGE_VIEW_TYPE_2D,
+				.range = [this, l]() {
+					return VkImageSubresourceRange{
+						.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+						.baseMipLevel = std::min(l, levels() - 1),
+						.levelCount = 1,
+						.baseArrayLayer = 0,
+						.layerCount = 1,
+					};
+				},
+			});
+		}
+
+		_counter = std::make_shared<Buffer>(Buffer::CI{
+			.app = application(),
+			.name = name() + ".Counter",
+			.size = 4 * sizeof(uint32_t),
+			.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			.mem_usage = VMA_MEMORY_USAGE_GPU_ONLY,
+		});
+
+		std::filesystem::path shaders = "RenderLibShaders:/RenderLib/";
+
+		_command = std::make_shared<ComputeCommand>(ComputeCommand::CI{
+			.app = application(),
+			.name = name() + ".Reduce",
+			.shader_path = shaders / "DepthPyramid.slang",
+			.sets_layouts = _sets_layouts,
+			.bindings = {
+				Binding{
+					.image = _depth,
+					.binding = 0,
+				},
+				Binding{
+					.images = _level_views,
+					.binding = 1,
+				},
+				Binding{
+					.buffer = _counter,
+					.binding = 2,
+				},
+			},
+			.definitions = [](DefinitionsList& res) {
+				res.clear();
+				res.pushBackFormatted("DEPTH_PYRAMID_MAX_LEVELS {}", MaxLevels);
+			},
+		});
+	}
+
+	void DepthPyramid::updateResources(UpdateContext& ctx)
+	{
+		_pyramid->updateResource(ctx);
+		for (std::shared_ptr<ImageView> const& view : _level_views)
+		{
+			view->updateResource(ctx);
+		}
+		_counter->updateResource(ctx);
+		ctx.resourcesToUpdateLater() += _command;
+	}
+
+	void DepthPyramid::record(ExecutionRecorder& exec)
+	{
+		const VkExtent2D extent = this->extent();
+		struct PC
+		{
+			VkExtent2D extent;
+			uint32_t tiles_x;
+			uint32_t tiles_y;
+			uint32_t levels;
+		};
+		// 64x64 tiles, the last one of a row (or column) also covers the remaining texels
+		const PC pc{
+			.extent = extent,
+			.tiles_x = std::max(extent.width / 64, 1u),
+			.tiles_y = std::max(extent.height / 64, 1u),
+			.levels = levels(),
+		};
+
+		exec(application()->getPrebuiltTransferCommands().fill_buffer.with(FillBuffer::FillInfo{
+			.buffer = _counter,
+			.value = 0,
+		}));
+
+		exec(_command->with(ComputeCommand::SingleDispatchInfo{
+			.extent = VkExtent3D{.width = pc.tiles_x, .height = pc.tiles_y, .depth = 1},
+			.dispatch_threads = false,
+			.pc_data = &pc,
+			.pc_size = sizeof(pc),
+		}));
+
+		_built_extent = extent;
+	}
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <vkl/Execution/Module.hpp>
+#include <vkl/Execution/Executor.hpp>
+
+#include <vkl/Commands/ComputeCommand.hpp>
+
+namespace vkl
+{
+	// (min, max) depth mip chain of a depth buffer, generated in a single compute dispatch
+	// Level 0 has the extent of the depth buffer, each level halves the previous one (rounded down)
+	// The last texel of a row (or column) of an odd level also covers the remaining texel of the previous level
+	// CPU reference: DepthMinMaxPyramid (vkl/Maths/ViewCulling.hpp)
+	class DepthPyramid : public Module
+	{
+	public:
+
+		static constexpr uint32_t MaxLevels = 16;
+
+	protected:
+
+		std::shared_ptr<ImageView> _depth = nullptr;
+
+		// R32G32_SFLOAT: (min, max)
+		std::shared_ptr<ImageView> _pyramid = nullptr;
+		// One storage view per level (the levels past the last one alias it)
+		Array<std::shared_ptr<ImageView>> _level_views = {};
+
+		// Counts the finished workgroups, the last one reduces the coarsest levels
+		std::shared_ptr<Buffer> _counter = nullptr;
+
+		std::shared_ptr<ComputeCommand> _command = nullptr;
+
+		MultiDescriptorSetsLayouts _sets_layouts = {};
+
+		// Extent of the latest record, (0, 0) if none
+		VkExtent2D _built_extent = {};
+
+		void createInternals();
+
+	public:
+
+		struct CreateInfo
+		{
+			VkApplication* app = nullptr;
+			std::string name = {};
+			MultiDescriptorSetsLayouts sets_layouts = {};
+			std::shared_ptr<ImageView> depth = nullptr;
+		};
+		using CI = CreateInfo;
+
+		DepthPyramid(CreateInfo const& ci);
+
+		virtual ~DepthPyramid() override = default;
+
+		void updateResources(UpdateContext& ctx);
+
+		void record(ExecutionRecorder& exec);
+
+		// All the levels, to be read with texel fetches
+		std::shared_ptr<ImageView> const& pyramid() const
+		{
+			return _pyramid;
+		}
+
+		// Storage view of a single level
+		std::shared_ptr<ImageView> const& levelView(uint32_t level) const
+		{
+			return _level_views[level];
+		}
+
+		uint32_t levels() const
+		{
+			return std::min(_pyramid->image()->actualMipsCount(), MaxLevels);
+		}
+
+		VkExtent2D extent() const
+		{
+			return extract(_depth->image()->extent().value());
+		}
+
+		// The pyramid was recorded at the current extent of the depth buffer
+		bool isValid() const
+		{
+			const VkExtent2D e = extent();
+			return _built_extent.width == e.width && _built_extent.height == e.height;
+		}
+	};
+}
@@ -99,13 +99,7 @@ namespace vkl
 					},
 				},
 				.definitions = [this](DefinitionsList& res) {
-					res.clear();
-					res.pushBack(_target_format_str);
-					res.pushBack(_spectrum_mode_str);
-					if (_compile_time_max_depth)
-						res.pushBackFormatted("MAX_DEPTH {}", _max_depth);
-					if(_Li_resampling != 0)
-						res.pushBack("USE_Li_RESAMPLING");
+					fillDefinitions(res, Method::PathTracer);
 				},
 			});
 		}
@@ -124,14 +118,7 @@ namespace vkl
 				.any_hits = ahit_shaders,
 				.hit_groups = hit_groups,
 				.definitions = [this](DefinitionsList& res) {
-					res.clear();
-					res.pushBack(_target_format_str);
-					res.pushBack(_spectrum_mode_str);
-					if(_compile_time_max_depth)
-						res.pushBackFormatted("MAX_DEPTH {}", _max_depth);
-					if (_Li_resampling != 0)
-						res.pushBack("USE_Li_RESAMPLING");
-					
+					fillDefinitions(res, Method::PathTracer);
 				},
 				.bindings = {
 					Binding{
@@ -185,10 +172,7 @@ namespace vkl
 					},
 				},
 				.definitions = [this](DefinitionsList& res) {
-					res.clear();
-					res.pushBack(_spectrum_mode_str);
-					if (_compile_time_max_depth)
-						res.pushBackFormatted("MAX_DEPTH {}", _max_depth);
+					fillDefinitions(res, Method::LightTracer);
 				},
 			});
 		}
@@ -205,10 +189,7 @@ namespace vkl
 				.any_hits = ahit_shaders,
 				.hit_groups = hit_groups,
 				.definitions = [this](DefinitionsList& res) {
-					res.clear();
-					res.pushBack(_spectrum_mode_str);
-					if (_compile_time_max_depth)
-						res.pushBackFormatted("MAX_DEPTH {}", _max_depth);
+					fillDefinitions(res, Method::LightTracer);
 				},
 				.bindings = {
 					Binding{
@@ -281,11 +262,7 @@ namespace vkl
 					},
 				},
 				.definitions = [this](DefinitionsList& res) {
-					res.clear();
-					res.pushBack(_target_format_str);
-					res.pushBack(_spectrum_mode_str);
-					if (_compile_time_max_depth)
-						res.pushBackFormatted("MAX_DEPTH {}", _max_depth);
+					fillDefinitions(res, Method::BidirectionalPathTracer);
 				},
 			});
 		}
@@ -302,11 +279,7 @@ namespace vkl
 				.any_hits = ahit_shaders,
 				.hit_groups = hit_groups,
 				.definitions = [this](DefinitionsList& res) {
-					res.clear();
-					res.pushBack(_target_format_str);
-					res.pushBack(_spectrum_mode_str);
-					if (_compile_time_max_depth)
-						res.pushBackFormatted("MAX_DEPTH {}", _max_depth);
+					fillDefinitions(res, Method::BidirectionalPathTracer);
 				},
 				.bindings = {
 					Binding{
@@ -366,21 +339,7 @@ namespace vkl
 				},
 			},
 			.definitions = [this](DefinitionsList& res) {
-				res.clear();
-				res.pushBack(_target_format_str);
-				std::string_view resolve_mode;
-				if (_method == Method::LightTracer)
-				{
-					resolve_mode = "RESOLVE_MODE_OVERWRITE";
-				}
-				else if (_method == Method::BidirectionalPathTracer)
-				{
-					resolve_mode = "RESOLVE_MODE_ADD";
-				}
-				if (!resolve_mode.empty())
-				{
-					res.pushBackFormatted("RESOLVE_MODE {}", resolve_mode);
-				}
+				fillDefinitions(res, _method, true);
 			},
 		});
 
@@ -412,6 +371,85 @@ namespace vkl
 		return _method == Method::LightTracer || _method == Method::BidirectionalPathTracer;
 	}
 
+	ShaderCommand* LightTransport::getMethodCommand(Method method) const
+	{
+		ShaderCommand* res = nullptr;
+		switch (method)
+		{
+		case Method::PathTracer:
+			res = _use_rt_pipelines ? static_cast<ShaderCommand*>(_path_tracer_rt.get()) : static_cast<ShaderCommand*>(_path_tracer_rq.get());
+		break;
+		case Method::LightTracer:
+			res = _use_rt_pipelines ? static_cast<ShaderCommand*>(_light_tracer_rt.get()) : static_cast<ShaderCommand*>(_light_tracer_rq.get());
+		break;
+		case Method::BidirectionalPathTracer:
+			res = _use_rt_pipelines ? static_cast<ShaderCommand*>(_bdpt_rt.get()) : static_cast<ShaderCommand*>(_bdpt_rq.get());
+		break;
+		}
+		return res;
+	}
+
+	void LightTransport::fillDefinitions(DefinitionsList& res, Method method, bool resolve) const
+	{
+		res.clear();
+		if (resolve)
+		{
+			res.pushBack(_target_format_str);
+			std::string_view resolve_mode;
+			if (method == Method::LightTracer)
+			{
+				resolve_mode = "RESOLVE_MODE_OVERWRITE";
+			}
+			else if (method == Method::BidirectionalPathTracer)
+			{
+				resolve_mode = "RESOLVE_MODE_ADD";
+			}
+			if (!resolve_mode.empty())
+			{
+				res.pushBackFormatted("RESOLVE_MODE {}", resolve_mode);
+			}
+		}
+		else
+		{
+			// The light tracer does not write the target
+			if (method != Method::LightTracer)
+			{
+				res.pushBack(_target_format_str);
+			}
+			res.pushBack(_spectrum_mode_str);
+			if (_compile_time_max_depth)
+			{
+				res.pushBackFormatted("MAX_DEPTH {}", _max_depth);
+			}
+			if (method == Method::PathTracer && _Li_resampling != 0)
+			{
+				res.pushBack("USE_Li_RESAMPLING");
+			}
+		}
+	}
+
+	void LightTransport::prepareOtherMethods(UpdateContext& ctx)
+	{
+		static thread_local DefinitionsList speculative_definitions;
+		const Method methods[] = {Method::PathTracer, Method::LightTracer, Method::BidirectionalPathTracer};
+		for (Method method : methods)
+		{
+			ShaderCommand * command = getMethodCommand(method);
+			if (method == _method || !command)
+			{
+				continue;
+			}
+			fillDefinitions(speculative_definitions, method);
+			command->prepareSpeculativeDefinitions(ctx, speculative_definitions);
+			// The light tracing methods also resolve their buffer, with a different mode
+			if (method == Method::LightTracer || method == Method::BidirectionalPathTracer)
+			{
+				fillDefinitions(speculative_definitions, method, true);
+				_resolve_light_tracer->prepareSpeculativeDefinitions(ctx, speculative_definitions);
+			}
+		}
+	}
+
 
 	void LightTransport::updateResources(UpdateContext& ctx)
 	{
@@ -508,6 +546,7 @@ namespace vkl
 				}
 			}
 		}
+		prepareOtherMethods(ctx);
 		VkExtent3D extent = _target->image()->extent().value();
 		_light_tracer_samples = size_t(extent.width * extent.height * _light_tracer_sample_mult);
 	}
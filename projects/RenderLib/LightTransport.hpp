@@ -83,6 +83,14 @@ namespace vkl
 		void createInternals();
 
 		bool usingLightTracer() const;
+
+		ShaderCommand* getMethodCommand(Method method) const;
+
+		// Of the command of the method, or of the resolve of its light tracer buffer
+		void fillDefinitions(DefinitionsList& res, Method method, bool resolve = false) const;
+
+		// Compile in the background the shaders of the methods that are not currently selected
+		void prepareOtherMethods(UpdateContext& ctx);
 		
 	public:
 
@@ -42,6 +42,8 @@ namespace vkl
 
 		const bool can_multi_draw_indirect = application()->availableFeatures().features2.features.multiDrawIndirect;
 		_use_indirect_rendering = can_multi_draw_indirect;
+		_compact_draw_list = application()->availableFeatures().features_12.drawIndirectCount;
+		_compact_draw_list_def = std::format("COMPACT_DRAW_LIST {}", _compact_draw_list ? 1 : 0);
 
 		const bool can_as = application()->availableFeatures().acceleration_structure_khr.accelerationStructure;
 		const bool can_rq = application()->availableFeatures().ray_query_khr.rayQuery;
@@ -207,7 +209,8 @@ namespace vkl
 			.name = name() + ".draw_indirect_buffer",
 			.size = [this](){
 				const size_t align = application()->deviceProperties().props2.properties.limits.minStorageBufferOffsetAlignment;
-				return std::alignUp(_model_capacity * (sizeof(VkDrawIndirectCommand) + sizeof(uint32_t)), align) + 4 * sizeof(uint32_t);
+				const Buffer::Range occluded_range = _occluded_objects_segment.range.value();
+				return std::alignUp(occluded_range.begin + occluded_range.len, align) + 4 * sizeof(uint32_t);
 			},
 			.usage = VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
 			.mem_usage = VMA_MEMORY_USAGE_GPU_ONLY,
@@ -223,6 +226,57 @@ namespace vkl
 			.range = [this](){return Buffer::Range{.begin = _vk_draw_params_segment.range.value().len, .len = _model_capacity * sizeof(uint32_t)};}
 		};
 
+		_vk_static_draw_params_segment = BufferAndRange{
+			.buffer = _draw_indexed_indirect_buffer,
+			.range = [this](){
+				const size_t align = application()->deviceProperties().props2.properties.limits.minStorageBufferOffsetAlignment;
+				return Buffer::Range{.begin = std::alignUp(_model_capacity * (sizeof(VkDrawIndirectCommand) + sizeof(uint32_t)), align), .len = _model_capacity * sizeof(VkDrawIndirectCommand)};
+			},
+		};
+
+		_vk_dynamic_draw_params_segment = BufferAndRange{
+			.buffer = _draw_indexed_indirect_buffer,
+			.range = [this](){
+				const size_t align = application()->deviceProperties().props2.properties.limits.minStorageBufferOffsetAlignment;
+				const Buffer::Range static_range = _vk_static_draw_params_segment.range.value();
+				return Buffer::Range{.begin = std::alignUp(static_range.begin + static_range.len, align), .len = _model_capacity * sizeof(VkDrawIndirectCommand)};
+			},
+		};
+
+		_vk_camera_draw_params_segment = BufferAndRange{
+			.buffer = _draw_indexed_indirect_buffer,
+			.range = [this](){
+				const size_t align = application()->deviceProperties().props2.properties.limits.minStorageBufferOffsetAlignment;
+				const Buffer::Range dynamic_range = _vk_dynamic_draw_params_segment.range.value();
+				return Buffer::Range{.begin = std::alignUp(dynamic_range.begin + dynamic_range.len, align), .len = _model_capacity * sizeof(VkDrawIndirectCommand)};
+			},
+		};
+
+		_occluded_objects_segment = BufferAndRange{
+			.buffer = _draw_indexed_indirect_buffer,
+			.range = [this](){
+				const size_t align = application()->deviceProperties().props2.properties.limits.minStorageBufferOffsetAlignment;
+				const Buffer::Range camera_range = _vk_camera_draw_params_segment.range.value();
+				return Buffer::Range{.begin = std::alignUp(camera_range.begin + camera_range.len, align), .len = _model_capacity * sizeof(uint32_t)};
+			},
+		};
+
+		_shadow_casters_draws_buffer = std::make_shared<HostManagedBuffer>(HostManagedBuffer::CI{
+			.app = application(),
+			.name = name() + ".shadow_casters_draws",
+			.size = sizeof(VkDrawIndirectCommand) * 256,
+			.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+			.mem_usage = VMA_MEMORY_USAGE_GPU_ONLY,
+		});
+
+		_instance_xform_ids_buffer = std::make_shared<HostManagedBuffer>(HostManagedBuffer::CI{
+			.app = application(),
+			.name = name() + ".instance_xform_ids",
+			.size = sizeof(uint32_t) * 256,
+			.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+			.mem_usage = VMA_MEMORY_USAGE_GPU_ONLY,
+		});
+
 		_atomic_counter_segment = BufferAndRange{
 			.buffer = _draw_indexed_indirect_buffer,
 			.range = [this](){return Buffer::Range{.begin = _draw_indexed_indirect_buffer->size().value() - 4 * sizeof(uint32_t), .len = 4 * sizeof(uint32_t)};},
@@ -241,6 +295,13 @@ namespace vkl
 
 		const std::filesystem::path shaders = "RenderLibShaders:/RenderLib/";
 
+		_depth_pyramid = std::make_shared<DepthPyramid>(DepthPyramid::CI{
+			.app = application(),
+			.name = name() + ".DepthPyramid",
+			.sets_layouts = _sets_layouts,
+			.depth = _depth,
+		});
+
 		_prepare_draw_list = std::make_shared<ComputeCommand>(ComputeCommand::CI{
 			.app = application(),
 			.name = name() + ".PrepareDrawList",
@@ -259,7 +320,28 @@ namespace vkl
 					.buffer = _atomic_counter_segment,
 					.binding = 2,
 				},
+				Binding{
+					.buffer = _vk_static_draw_params_segment,
+					.binding = 3,
+				},
+				Binding{
+					.buffer = _vk_dynamic_draw_params_segment,
+					.binding = 4,
+				},
+				Binding{
+					.buffer = _vk_camera_draw_params_segment,
+					.binding = 5,
+				},
+				Binding{
+					.image = _depth_pyramid->pyramid(),
+					.binding = 6,
+				},
+				Binding{
+					.buffer = _occluded_objects_segment,
+					.binding = 7,
+				},
 			},
+			.definitions = [this](DefinitionsList & res) {res = {_compact_draw_list_def};},
 		});
 
 		_forward_pipeline.render_pass = std::make_shared<RenderPass>(RenderPass::CI{
@@ -292,6 +374,36 @@ namespace vkl
 			.attachments = {_render_target, _depth},
 		});
 
+		_forward_pipeline.load_render_pass = std::make_shared<RenderPass>(RenderPass::CI{
+			.app = application(),
+			.name = name() + ".DirectPipeline.LoadRenderPass",
+			.attachments = {
+				AttachmentDescription2{
+					.flags = AttachmentDescription2::Flags::Blend,
+					.format = _render_target->format(),
+					.samples = _render_target->image()->sampleCount(),
+				},
+				AttachmentDescription2{
+					.flags = AttachmentDescription2::Flags::Blend,
+					.format = _depth->format(),
+					.samples = _depth->image()->sampleCount(),
+				},
+			},
+			.subpasses = {
+				SubPassDescription2{
+					.colors = {AttachmentReference2{.index = 0}},
+					.depth_stencil = AttachmentReference2{.index = 1},
+				}
+			},
+		});
+
+		_forward_pipeline.load_framebuffer = std::make_shared<Framebuffer>(Framebuffer::CI{
+			.app = application(),
+			.name = name() + ".DirectPipeline.LoadFramebuffer",
+			.render_pass = _forward_pipeline.load_render_pass,
+			.attachments = {_render_target, _depth},
+		});
+
 		Dyn<VkCompareOp> compare_op = [this]() {
 			return _use_reverse_depth ? VK_COMPARE_OP_GREATER : VK_COMPARE_OP_LESS;
 		};
@@ -306,6 +418,10 @@ namespace vkl
 				.cull_mode = VK_CULL_MODE_BACK_BIT,
 				.sets_layouts = (_sets_layouts + std::pair{model_set, model_layout[model_type]}),
 				.bindings = {
+					Binding{
+						.buffer = BufferAndRange{.buffer = _instance_xform_ids_buffer->buffer()},
+						.binding = 0,
+					},
 				},
 				.extern_render_pass = _forward_pipeline.render_pass,
 				.write_depth = true,
@@ -409,6 +525,33 @@ namespace vkl
 				.attachments = {_fat_deferred_pipeline.albedo, _fat_deferred_pipeline.position, _fat_deferred_pipeline.normal, _fat_deferred_pipeline.tangent, _depth},
 				.hold_instance = hold_fat_deferred,
 			});
+
+			_fat_deferred_pipeline.load_render_pass = std::make_shared<RenderPass>(RenderPass::CI{
+				.app = application(),
+				.name = name() + ".Deferred.FatLoadRenderPass",
+				.attachments = {
+					AttachmentDescription2::MakeFrom(AttachmentDescription2::Flags::Blend, _fat_deferred_pipeline.albedo),
+					AttachmentDescription2::MakeFrom(AttachmentDescription2::Flags::Blend, _fat_deferred_pipeline.position),
+					AttachmentDescription2::MakeFrom(AttachmentDescription2::Flags::Blend, _fat_deferred_pipeline.normal),
+					AttachmentDescription2::MakeFrom(AttachmentDescription2::Flags::Blend, _fat_deferred_pipeline.tangent),
+					AttachmentDescription2::MakeFrom(AttachmentDescription2::Flags::Blend, _depth),
+				},
+				.subpasses = {
+					SubPassDescription2{
+						.colors = {AttachmentReference2{.index = 0}, AttachmentReference2{.index = 1}, AttachmentReference2{.index = 2}, AttachmentReference2{.index = 3}},
+						.depth_stencil = AttachmentReference2{.index = 4},
+					}
+				},
+				.hold_instance = hold_fat_deferred,
+			});
+
+			_fat_deferred_pipeline.load_framebuffer = std::make_shared<Framebuffer>(Framebuffer::CI{
+				.app = application(),
+				.name = name() + ".Deferred.FatLoadFramebuffer",
+				.render_pass = _fat_deferred_pipeline.load_render_pass,
+				.attachments = {_fat_deferred_pipeline.albedo, _fat_deferred_pipeline.position, _fat_deferred_pipeline.normal, _fat_deferred_pipeline.tangent, _depth},
+				.hold_instance = hold_fat_deferred,
+			});
 			
 
 			_minimal_deferred_pipeline.ids = std::make_shared<ImageView>(Image::CI{
@@ -458,6 +601,31 @@ namespace vkl
 				.hold_instance = hold_minimal_deferred,
 			});
 
+			_minimal_deferred_pipeline.load_render_pass = std::make_shared<RenderPass>(RenderPass::CI{
+				.app = application(),
+				.name = name() + ".Deferred.MinimalLoadRenderPass",
+				.attachments = {
+					AttachmentDescription2::MakeFrom(AttachmentDescription2::Flags::Blend, _minimal_deferred_pipeline.ids),
+					AttachmentDescription2::MakeFrom(AttachmentDescription2::Flags::Blend, _minimal_deferred_pipeline.uvs),
+					AttachmentDescription2::MakeFrom(AttachmentDescription2::Flags::Blend, _depth),
+				},
+				.subpasses = {
+					SubPassDescription2{
+						.colors = {AttachmentReference2{.index = 0}, AttachmentReference2{.index = 1}},
+						.depth_stencil = AttachmentReference2{.index = 2},
+					}
+				},
+				.hold_instance = hold_minimal_deferred,
+			});
+
+			_minimal_deferred_pipeline.load_framebuffer = std::make_shared<Framebuffer>(Framebuffer::CI{
+				.app = application(),
+				.name = name() + ".Deferred.MinimalLoadFramebuffer",
+				.render_pass = _minimal_deferred_pipeline.load_render_pass,
+				.attachments = {_minimal_deferred_pipeline.ids, _minimal_deferred_pipeline.uvs, _depth},
+				.hold_instance = hold_minimal_deferred,
+			});
+
 			const Dyn<DefinitionsList> fat_definitions = [this](DefinitionsList& res)
 			{
 				res.clear();
@@ -529,6 +697,12 @@ namespace vkl
 					.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
 					.cull_mode = VK_CULL_MODE_BACK_BIT,
 					.sets_layouts = (_sets_layouts + std::pair{model_set, model_layout[model_type]}),
+					.bindings = {
+						Binding{
+							.buffer = BufferAndRange{.buffer = _instance_xform_ids_buffer->buffer()},
+							.binding = 0,
+						},
+					},
 					.write_depth = true,
 					.depth_compare_op = compare_op,
 					.vertex_shader_path = shaders / "RasterGBuffer.vert",
@@ -580,6 +754,7 @@ namespace vkl
 				.positions = _fat_deferred_pipeline.position,
 				.normals = _fat_deferred_pipeline.normal,
 				.can_rt = can_as && (can_rt || can_rq),
+				.depth_pyramid = _depth_pyramid,
 			});
 
 			_depth_of_field = std::make_shared<DepthOfField>(DepthOfField::CI{
@@ -591,6 +766,20 @@ namespace vkl
 				.sets_layouts = _sets_layouts,
 			});
 
+			// Lifetimes in passes of the frame: 0: raster G-buffer, 1: AO, 2: shade from G-buffer, 3: post processing
+			_transient_images = std::make_shared<TransientImageAllocator>(TransientImageAllocator::CI{
+				.app = application(),
+				.name = name() + ".TransientImages",
+			});
+			_transient_images->declare(_fat_deferred_pipeline.albedo->image(), { .first = 0, .last = 2 });
+			_transient_images->declare(_fat_deferred_pipeline.position->image(), { .first = 0, .last = 2 });
+			_transient_images->declare(_fat_deferred_pipeline.normal->image(), { .first = 0, .last = 2 });
+			_transient_images->declare(_fat_deferred_pipeline.tangent->image(), { .first = 0, .last = 2 });
+			_transient_images->declare(_minimal_deferred_pipeline.ids->image(), { .first = 0, .last = 2 });
+			_transient_images->declare(_minimal_deferred_pipeline.uvs->image(), { .first = 0, .last = 2 });
+			_transient_images->declare(_ambient_occlusion->target()->image(), { .first = 1, .last = 2 });
+			_transient_images->declare(_depth_of_field->targetCopy()->image(), { .first = 3, .last = 3 });
+
 			std::shared_ptr<Sampler> bilinear_sampler = application()->getSamplerLibrary().getSampler(SamplerLibrary::SamplerInfo{
 				.filter = VK_FILTER_LINEAR,
 				.address_mode = VK_SAMPLER_ADDRESS_MODE_MIRROR_CLAMP_TO_EDGE,
@@ -726,6 +915,27 @@ namespace vkl
 				.fragment_shader_path = shaders / "RasterSceneDepth.frag.slang",
 				.definitions = Dyn<DefinitionsList>({"TARGET_CUBE 1"}),
 			});
+
+			_spot_light_load_render_pass = std::make_shared<RenderPass>(RenderPass::SPCI{
+				.app = application(),
+				.name = name() + ".SpotLightLoadRenderPass",
+				.depth_stencil = AttachmentDescription2{
+					.flags = AttachmentDescription2::Flags::Blend,
+					.format = [this]() {return _scene->lightDepthFormat(); },
+					.samples = [this]() {return _scene->lightDepthSamples(); },
+				},
+			});
+
+			_point_light_load_render_pass = std::make_shared<RenderPass>(RenderPass::SPCI{
+				.app = application(),
+				.name = name() + ".PointLightLoadRenderPass",
+				.view_mask = 0b111111,
+				.depth_stencil = AttachmentDescription2{
+					.flags = AttachmentDescription2::Flags::Blend,
+					.format = [this]() {return _scene->lightDepthFormat(); },
+					.samples = [this]() {return _scene->lightDepthSamples(); },
+				},
+			});
 		}
 
 		if (application()->availableFeatures().acceleration_structure_khr.accelerationStructure)
@@ -771,46 +981,328 @@ namespace vkl
 		_scene->getTree()->iterateOnDag(process_mesh);
 	}
 
+	void SimpleRenderer::gatherInstanceGroups()
+	{
+		_instance_groups.clear();
+		_instance_group_index.clear();
+		_instance_refs.clear();
+		// TODO handle the inheritted visibility
+		auto add_instance = [&](std::shared_ptr<Scene::Node> const& node, Scene::DAG::RobustNodePath const& path, Matrix3x4f const& matrix, uint32_t flags)
+		{
+			std::shared_ptr<Model> const& model = node->model();
+			if (node->visible() && model && model->isReadyToDraw())
+			{
+				// The xform of the instance is registered by the scene
+				auto found = _scene->_unique_models.find(path);
+				if (found != _scene->_unique_models.end())
+				{
+					uint32_t group_index = _instance_groups.size32();
+					if (_auto_instancing)
+					{
+						auto [it, inserted] = _instance_group_index.emplace(model.get(), group_index);
+						group_index = it->second;
+					}
+					if (group_index == _instance_groups.size32())
+					{
+						_instance_groups.push_back(InstanceGroup{
+							.model = model,
+						});
+					}
+					++_instance_groups[group_index].count;
+					_instance_refs.push_back(InstanceRef{
+						.group = group_index,
+						.xform_id = found->second.xform_unique_index,
+					});
+				}
+			}
+			return node->visible();
+		};
+		_scene->getTree()->iterateOnDag(add_instance);
+
+		// Contiguous xform ids per group
+		uint32_t offset = 0;
+		for (InstanceGroup & group : _instance_groups)
+		{
+			group.first = offset;
+			offset += group.count;
+			group.count = 0;
+		}
+		_instance_xform_ids.resize(offset);
+		for (InstanceRef const& ref : _instance_refs)
+		{
+			InstanceGroup & group = _instance_groups[ref.group];
+			_instance_xform_ids[group.first + group.count] = ref.xform_id;
+			++group.count;
+		}
+	}
+
 	void SimpleRenderer::generateVertexDrawList(MultiVertexDrawCallList & res)
 	{
 		static thread_local VertexDrawCallInfo _vr;
 		VertexDrawCallInfo & vr = _vr;
 		vr.clear();
-		// TODO handle the inheritted visibility
-		auto add_model = [&res, &vr](std::shared_ptr<Scene::Node> const& node, Matrix3x4f const& matrix, uint32_t flags)
+		struct InstancePC
 		{
-			if (node->visible() && node->model() && node->model()->isReadyToDraw())
+			uint32_t instance_offset;
+			// Instances of the model itself, drawn for each xform
+			uint32_t instances_per_xform;
+		};
+		for (InstanceGroup const& group : _instance_groups)
+		{
+			std::shared_ptr<Model> const& model = group.model;
+			if (group.count && model->isReadyToDraw())
 			{
 				vr.clear();
-				const uint32_t model_type = node->model()->type();
-				node->model()->fillVertexDrawCallInfo(vr);
+				const uint32_t model_type = model->type();
+				model->fillVertexDrawCallInfo(vr);
+				const InstancePC pc{
+					.instance_offset = group.first,
+					.instances_per_xform = vr.instance_count,
+				};
 				
 				auto & res_model_type = res[model_type];
 				res_model_type.draw_type = DrawType::DrawIndexed;
 				res_model_type.pushBack(VertexCommand::DrawCallInfo{
-					.name = node->name(),
-					.pc_data = &matrix,
-					.pc_size = sizeof(matrix),
+					.name = model->name(),
+					.pc_data = &pc,
+					.pc_size = sizeof(pc),
 					.draw_count = vr.draw_count,
-					.instance_count = vr.instance_count,
+					.instance_count = vr.instance_count * group.count,
 					.index_buffer = vr.index_buffer,
 					.index_type = vr.index_type,
 					.num_vertex_buffers = vr.vertex_buffers.size32(),
 					.vertex_buffers = vr.vertex_buffers.data(),
-					.set = node->model()->setAndPool(),
+					.set = model->setAndPool(),
+					.first_index = vr.first_index,
+					.vertex_offset = vr.vertex_offset,
 				});
 			}
-			return node->visible();
-		};
-		_scene->getTree()->iterateOnDag(add_model);
+		}
 		vr.clear();
 	}
 
 	struct LightInstanceData : public Scene::LightInstanceSpecificData
 	{
 		std::shared_ptr<Framebuffer> framebuffer;
+
+		// Shadow map cache
+		std::weak_ptr<FramebufferInstance> rendered_framebuffer = {};
+		LightGLSL rendered_light = {};
+		bool valid = false;
+
+		// Static casters layer, copied to the shadow map before rendering the dynamic casters over it
+		std::shared_ptr<Framebuffer> load_framebuffer = nullptr;
+		std::shared_ptr<ImageView> static_layer = nullptr;
+		std::shared_ptr<Framebuffer> static_layer_framebuffer = nullptr;
+		std::weak_ptr<FramebufferInstance> rendered_static_layer = {};
+		bool static_layer_valid = false;
+
+		// Range in _shadow_casters_draws: the static casters, then the dynamic casters
+		bool culled_casters = false;
+		uint32_t casters_begin = 0;
+		uint32_t static_casters = 0;
+		uint32_t dynamic_casters = 0;
 	};
 
+	namespace
+	{
+		// Conservative bounds of what the shadow map of a light can see
+		struct ShadowCasterVolume
+		{
+			LightType type;
+			vec3 position;
+			// Beyond it, a caster can only shadow receivers which get less than the min irradiance
+			float radius;
+			// Spot lights
+			FrustumPlanes frustum = {};
+
+			ShadowCasterVolume(LightType type, LightGLSL const& light, float min_irradiance) :
+				type(type),
+				position(light.position)
+			{
+				const float intensity = light.emission.maxCoeff();
+				radius = (min_irradiance > 0.0f) ? std::sqrt(intensity / min_irradiance) : std::numeric_limits<float>::infinity();
+				if (type == LightType::Spot)
+				{
+					const vec3 direction = Normalize(light.direction);
+					const vec3 right = Normalize(Cross(direction, light.spot.up));
+					const vec3 up = Cross(right, direction);
+					const float tan_x = light.spot.tan_half_fov * light.spot.aspect;
+					const float tan_y = light.spot.tan_half_fov;
+					const auto add_plane = [&](vec3 const& normal)
+					{
+						frustum.addPlane(normal, -Dot(normal, position));
+					};
+					// In the light frame: z >= z_near, |x| <= z * tan_x, |y| <= z * tan_y
+					frustum.addPlane(direction, -Dot(direction, position) - light.z_near);
+					add_plane(vec3(direction * tan_x + right));
+					add_plane(vec3(direction * tan_x - right));
+					add_plane(vec3(direction * tan_y + up));
+					add_plane(vec3(direction * tan_y - up));
+					if (std::isfinite(radius))
+					{
+						frustum.addPlane(-direction, Dot(direction, position) + radius);
+					}
+				}
+			}
+
+			bool mayContain(AABB3f const& box) const
+			{
+				const BVHBox b = BVHBox::From(box);
+				if (type == LightType::Spot)
+				{
+					return BoundingVolumeHierarchy::OverlapFrustum(b, frustum);
+				}
+				else
+				{
+					alignas(16) const float c[4] = {position[0], position[1], position[2], 0.0f};
+					return BoundingVolumeHierarchy::OverlapSphere(b, c, radius * radius);
+				}
+			}
+
+			template <class ItemCallback>
+			void query(BoundingVolumeHierarchy const& bvh, ItemCallback const& callback) const
+			{
+				if (type == LightType::Spot)
+				{
+					bvh.queryFrustum(frustum, callback);
+				}
+				else
+				{
+					bvh.querySphere(position, radius, callback);
+				}
+			}
+		};
+
+		// Conservative: false only if none of the boxes can be seen by the light
+		bool ShadowMapMayBeAffected(ShadowCasterVolume const& volume, MyVector<AABB3f> const& boxes)
+		{
+			return std::any_of(boxes.begin(), boxes.end(), [&](AABB3f const& box) {return volume.mayContain(box); });
+		}
+	}
+
+	void SimpleRenderer::cullShadowCasters(FramePerfCounters * fpc)
+	{
+		std::TickTock_hrc tick_tock;
+		tick_tock.tick();
+		_shadow_casters_draws.clear();
+		_shadow_casters_stats = {};
+		MyVector<Scene::ShadowCaster> const& casters = _scene->shadowCasters();
+		BoundingVolumeHierarchy const& bvh = _scene->shadowCastersBVH();
+		MyVector<VkDrawIndirectCommand> dynamic_draws;
+		for (auto& [path, lid] : _scene->_unique_light_instances)
+		{
+			LightInstanceData * my_lid = dynamic_cast<LightInstanceData*>(lid.specific_data.get());
+			if (!my_lid)
+			{
+				continue;
+			}
+			my_lid->culled_casters = false;
+			std::shared_ptr<Light> const& light = path.path.back()->light();
+			if (!_cull_shadow_casters || !my_lid->framebuffer || ((lid.flags & 1) == 0))
+			{
+				continue;
+			}
+			const ShadowCasterVolume volume(light->type(), _scene->_lights_buffer->get<LightGLSL>(lid.frame_light_id), _shadow_caster_min_irradiance);
+			my_lid->casters_begin = _shadow_casters_draws.size32();
+			dynamic_draws.clear();
+			volume.query(bvh, [&](uint32_t index)
+			{
+				Scene::ShadowCaster const& caster = casters[index];
+				const VkDrawIndirectCommand draw{
+					.vertexCount = caster.num_indices,
+					.instanceCount = 1,
+					.firstVertex = 0,
+					.firstInstance = caster.model_unique_index,
+				};
+				if (caster.dynamic)
+				{
+					dynamic_draws.push_back(draw);
+				}
+				else
+				{
+					_shadow_casters_draws.push_back(draw);
+				}
+			});
+			my_lid->static_casters = _shadow_casters_draws.size32() - my_lid->casters_begin;
+			my_lid->dynamic_casters = dynamic_draws.size32();
+			_shadow_casters_draws.insert(_shadow_casters_draws.end(), dynamic_draws.begin(), dynamic_draws.end());
+			my_lid->culled_casters = true;
+
+			const uint32_t light_casters = my_lid->static_casters + my_lid->dynamic_casters;
+			++_shadow_casters_stats.lights;
+			_shadow_casters_stats.casters += light_casters;
+			_shadow_casters_stats.max_casters = std::max(_shadow_casters_stats.max_casters, light_casters);
+		}
+		if (!_shadow_casters_draws.empty())
+		{
+			_shadow_casters_draws_buffer->setIFN(0, _shadow_casters_draws.data(), _shadow_casters_draws.size() * sizeof(VkDrawIndirectCommand));
+		}
+		if (fpc)
+		{
+			fpc->shadow_casters = _shadow_casters_stats.casters;
+			fpc->shadow_casters_cull_time = tick_tock.tockd().count();
+		}
+	}
+
+	void SimpleRenderer::updateTexturesStreamingPriorities()
+	{
+		for (auto & [texture, tc] : _textures_coverage)
+		{
+			tc.coverage = 0.0f;
+		}
+		const vec3 camera_position = _camera->position();
+		const float inv_tan_half_fov = rcp(TanHalfFOV(_camera->fov()));
+		for (auto & [path, mi] : _scene->_unique_models)
+		{
+			// Only the visible instances with a ready mesh have a world AABB
+			if (!mi.caster_mesh)
+			{
+				continue;
+			}
+			std::shared_ptr<Model> const& model = path.path.back()->model();
+			if (!model || !model->material())
+			{
+				continue;
+			}
+			// Angular radius of the bounding sphere, relative to the half field of view
+			const auto sphere = mi.world_aabb.getContainingSphere();
+			const float distance = (sphere.center() - camera_position).norm();
+			const float coverage = (distance > sphere.radius()) ? std::min(sphere.radius() / distance * inv_tan_half_fov, 1.0f) : 1.0f;
+			for (std::shared_ptr<Texture> const& texture : model->material()->textures())
+			{
+				if (!texture)
+				{
+					continue;
+				}
+				auto found = _textures_coverage.find(texture.get());
+				if (found == _textures_coverage.end())
+				{
+					std::shared_ptr<TextureFromFile> tff = std::dynamic_pointer_cast<TextureFromFile>(texture);
+					if (!tff)
+					{
+						continue;
+					}
+					found = _textures_coverage.emplace(texture.get(), TextureCoverage{.texture = std::move(tff)}).first;
+				}
+				found->second.coverage = std::max(found->second.coverage, coverage);
+			}
+		}
+		auto it = _textures_coverage.begin();
+		while (it != _textures_coverage.end())
+		{
+			it->second.texture->setStreamingPriority(it->second.coverage);
+			if (it->second.coverage == 0.0f)
+			{
+				it = _textures_coverage.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+
 	void SimpleRenderer::preUpdate(UpdateContext& ctx)
 	{
 		updateMaintainRT();
@@ -821,6 +1313,8 @@ namespace vkl
 	{
 		render_pass->updateResources(ctx);
 		ctx.resourcesToUpdateLater() += framebuffer;
+		load_render_pass->updateResources(ctx);
+		ctx.resourcesToUpdateLater() += load_framebuffer;
 		if (update_direct)
 		{
 			for (auto& [m, cmd] : render_scene_direct)
@@ -838,6 +1332,8 @@ namespace vkl
 	{
 		render_pass->updateResources(ctx);
 		ctx.resourcesToUpdateLater() += framebuffer;
+		load_render_pass->updateResources(ctx);
+		ctx.resourcesToUpdateLater() += load_framebuffer;
 		if (update_direct)
 		{
 			for (auto& [m, cmd] : raster_gbuffer)
@@ -877,6 +1373,9 @@ namespace vkl
 		_use_ao_glsl_def.back() = '0' + (_ambient_occlusion->enable() ? 1 : 0);
 		_shadow_method_glsl_def.back() = '0' + _shadow_method.index();
 
+		// Before the transient images are updated
+		_transient_images->updateResources(ctx);
+
 		_taau->updateResources(ctx);
 		_render_target->updateResource(ctx);
 		_depth->updateResource(ctx);
@@ -889,12 +1388,31 @@ namespace vkl
 				_model_capacity = new_size;
 			}
 		}
+		// Bound by the draw list preparation and the AO
+		if (_use_indirect_rendering || RenderPipeline(_pipeline_selection.index()) == RenderPipeline::Deferred || update_all_anyway)
+		{
+			_depth_pyramid->updateResources(ctx);
+		}
 		if (_use_indirect_rendering || update_all_anyway)
 		{
 			_draw_indexed_indirect_buffer->updateResource(ctx);
 			ctx.resourcesToUpdateLater() += _prepare_draw_list;
 		}
 
+		const bool needs_host_draw_list = !_use_indirect_rendering && _pipeline_selection.index() <= size_t(RenderPipeline::Deferred);
+		if (needs_host_draw_list)
+		{
+			gatherInstanceGroups();
+			if (!_instance_xform_ids.empty())
+			{
+				_instance_xform_ids_buffer->setIFN(0, _instance_xform_ids.data(), _instance_xform_ids.size() * sizeof(uint32_t));
+			}
+		}
+		if (needs_host_draw_list || update_all_anyway)
+		{
+			_instance_xform_ids_buffer->updateResources(ctx);
+		}
+
 		if (RenderPipeline(_pipeline_selection.index()) == RenderPipeline::Forward || update_all_anyway)
 		{
 			_forward_pipeline.updateResources(ctx, !_use_indirect_rendering || update_all_anyway, _use_indirect_rendering || update_all_anyway);
@@ -923,6 +1441,11 @@ namespace vkl
 			_point_light_render_pass->updateResources(ctx);
 			ctx.resourcesToUpdateLater() += _render_spot_light_depth;
 			ctx.resourcesToUpdateLater() += _render_point_light_depth;
+			if (_shadow_map_dynamic_layer)
+			{
+				_spot_light_load_render_pass->updateResources(ctx);
+				_point_light_load_render_pass->updateResources(ctx);
+			}
 		}
 		else
 		{
@@ -966,10 +1489,61 @@ namespace vkl
 									},
 								});
 							}
+							if (_shadow_map_dynamic_layer && !my_lid->static_layer)
+							{
+								const bool is_point = light->type() == LightType::Point;
+								std::shared_ptr<Image> depth_image = lid.depth_view->image();
+								std::shared_ptr<Image> static_layer_image = std::make_shared<Image>(Image::CI{
+									.app = application(),
+									.name = lid.depth_view->name() + ".static_layer",
+									.flags = depth_image->flags(),
+									.type = VK_IMAGE_TYPE_2D,
+									.format = [this]() {return _scene->lightDepthFormat(); },
+									.extent = [depth_image]() {
+										return depth_image->extent().value();
+									},
+									.layers = depth_image->layers(),
+									.samples = [this]() {return _scene->lightDepthSamples(); },
+									.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+									.mem_usage = VMA_MEMORY_USAGE_GPU_ONLY,
+								});
+								my_lid->static_layer = std::make_shared<ImageView>(ImageView::CI{
+									.app = application(),
+									.name = static_layer_image->name() + ".view",
+									.image = static_layer_image,
+									.type = lid.depth_view->type(),
+								});
+								my_lid->static_layer_framebuffer = std::make_shared<Framebuffer>(Framebuffer::CI{
+									.app = application(),
+									.name = my_lid->static_layer->name(),
+									.render_pass = my_lid->framebuffer->renderPass(),
+									.attachments = {my_lid->static_layer},
+									.extent = [depth_image]() {
+										return depth_image->extent().value();
+									},
+								});
+								my_lid->load_framebuffer = std::make_shared<Framebuffer>(Framebuffer::CI{
+									.app = application(),
+									.name = lid.depth_view->name() + ".load",
+									.render_pass = is_point ? _point_light_load_render_pass : _spot_light_load_render_pass,
+									.attachments = {lid.depth_view},
+									.extent = [depth_image]() {
+										return depth_image->extent().value();
+									},
+								});
+							}
 						}
 						else
 						{
 							my_lid->framebuffer.reset();
+							my_lid->valid = false;
+						}
+						if (!_shadow_map_dynamic_layer || !light->enableShadowMap())
+						{
+							my_lid->static_layer.reset();
+							my_lid->static_layer_framebuffer.reset();
+							my_lid->load_framebuffer.reset();
+							my_lid->static_layer_valid = false;
 						}
 					}
 
@@ -980,11 +1554,32 @@ namespace vkl
 					if (my_lid && my_lid->framebuffer && _use_indirect_rendering)
 					{
 						ctx.resourcesToUpdateLater() += my_lid->framebuffer;
+						if (my_lid->static_layer)
+						{
+							my_lid->static_layer->updateResource(ctx);
+							ctx.resourcesToUpdateLater() += my_lid->static_layer_framebuffer;
+							ctx.resourcesToUpdateLater() += my_lid->load_framebuffer;
+						}
 					}
 				}
 			}
 		}
 
+		if (_use_indirect_rendering)
+		{
+			cullShadowCasters(ctx.getFramePerfCounters());
+			_shadow_casters_draws_buffer->updateResources(ctx);
+		}
+
+		if (_texture_streaming_priorities)
+		{
+			updateTexturesStreamingPriorities();
+		}
+		else
+		{
+			_textures_coverage.clear();
+		}
+
 		_depth_of_field->updateResources(ctx);
 
 		_light_depth_sampler->updateResources(ctx);
@@ -1024,12 +1619,28 @@ namespace vkl
 			.bind_rt = true,
 		});
 
+		_transient_images->recordBeginFrame(exec);
+
 		std::TickTock_hrc tick_tock;
 		MultiVertexDrawCallList & draw_list = _cached_draw_list;
 
 		const bool needs_draw_list = _pipeline_selection.index() <= size_t(RenderPipeline::Deferred);
 		const bool generate_indirect_draw_list = needs_draw_list && _use_indirect_rendering;
 		const bool generate_host_draw_list = needs_draw_list && !_use_indirect_rendering;
+
+		struct PrepareDrawListPC
+		{
+			Matrix4f occlusion_world_to_proj;
+			uint32_t num_objects;
+			uint32_t flags;
+			uint32_t depth_pyramid_levels;
+			uint32_t pad;
+			VkExtent2D depth_pyramid_extent;
+		};
+		const uint32_t num_objects = _scene->objectCount();
+		// Occlusion culling with the pyramid recorded in the previous frame
+		const bool occlusion_culling = generate_indirect_draw_list && _gpu_occlusion_culling && _depth_pyramid->isValid();
+		const bool two_phases_occlusion_culling = occlusion_culling && _two_phases_occlusion_culling;
 		
 		if (generate_indirect_draw_list)
 		{
@@ -1044,12 +1655,18 @@ namespace vkl
 				.value = 0,
 			}));
 
-			const uint32_t num_objects = _scene->objectCount();
-			struct PrepareDrawListPC
-			{
-				uint32_t num_objects;
+			uint32_t flags = 0;
+			if (_gpu_frustum_culling)	flags |= 0x1;
+			if (occlusion_culling)	flags |= 0x2;
+			if (_depth_pyramid_reverse_depth)	flags |= 0x4;
+			if (two_phases_occlusion_culling)	flags |= 0x8;
+			const PrepareDrawListPC pc { 
+				.occlusion_world_to_proj = _depth_pyramid_world_to_proj,
+				.num_objects = num_objects,
+				.flags = flags,
+				.depth_pyramid_levels = _depth_pyramid->levels(),
+				.depth_pyramid_extent = _depth_pyramid->extent(),
 			};
-			const PrepareDrawListPC pc { .num_objects = num_objects };
 			exec(_prepare_draw_list->with(ComputeCommand::SingleDispatchInfo{
 				.extent = VkExtent3D{.width = num_objects, .height = 1, .depth = 1},
 				.dispatch_threads = true,
@@ -1063,9 +1680,19 @@ namespace vkl
 				.indirect_draw_stride = sizeof(VkDrawIndirectCommand),
 				.indirect_draw_buffer = _vk_draw_params_segment,
 			});
+
+			// The camera passes draw the culled list
+			_camera_draw_list.draw_type = _compact_draw_list ? DrawType::IndirectDrawCount : DrawType::IndirectDraw;
+			_camera_draw_list.pushBack(VertexCommand::DrawCallInfo{
+				.draw_count = num_objects,
+				.indirect_draw_stride = sizeof(VkDrawIndirectCommand),
+				.indirect_draw_buffer = _vk_camera_draw_params_segment,
+				.indirect_draw_count_buffer = _compact_draw_list ? _atomic_counter_segment : BufferAndRange{},
+			});
 		}
 		else if(generate_host_draw_list)
 		{
+			_instance_xform_ids_buffer->recordTransferIFN(exec);
 			tick_tock.tick();
 			generateVertexDrawList(draw_list);
 			if (exec.framePerfCounters())
@@ -1101,6 +1728,11 @@ namespace vkl
 					.depthStencil = {.depth = 0.0f},
 				};
 				
+				const BufferAndRange full_draw_params = my_draw_list.calls.front().indirect_draw_buffer;
+				const uint32_t full_draw_count = my_draw_list.calls.front().draw_count;
+				FramePerfCounters * fpc = exec.framePerfCounters();
+				_shadow_casters_draws_buffer->recordTransferIFN(exec);
+
 				for (auto& [path, lid] : _scene->_unique_light_instances)
 				{
 					std::shared_ptr<Light> const& light = path.path.back()->light();
@@ -1110,27 +1742,116 @@ namespace vkl
 						const uint32_t pc = lid.frame_light_id;
 						my_draw_list.setPushConstant(&pc, sizeof(pc));
 
-						render_pass.clear();
-						render_pass.ptr_clear_values = &clear;
-						render_pass.clear_value_count = 1;
-						render_pass.framebuffer = my_lid->framebuffer->instance();
+						// Draws of the light: the whole scene list, or its culled casters
+						struct CastersDraws
+						{
+							BufferAndRange draw_params;
+							uint32_t draw_count;
+						};
+						const auto culled_draws = [&](uint32_t begin, uint32_t count)
+						{
+							return CastersDraws{
+								.draw_params = BufferAndRange{
+									.buffer = _shadow_casters_draws_buffer->buffer(),
+									.range = Buffer::Range{.begin = begin * sizeof(VkDrawIndirectCommand), .len = count * sizeof(VkDrawIndirectCommand)},
+								},
+								.draw_count = count,
+							};
+						};
+						CastersDraws all_casters = { .draw_params = full_draw_params, .draw_count = full_draw_count };
+						CastersDraws static_casters = { .draw_params = _vk_static_draw_params_segment, .draw_count = full_draw_count };
+						CastersDraws dynamic_casters = { .draw_params = _vk_dynamic_draw_params_segment, .draw_count = full_draw_count };
+						if (my_lid->culled_casters)
+						{
+							all_casters = culled_draws(my_lid->casters_begin, my_lid->static_casters + my_lid->dynamic_casters);
+							static_casters = culled_draws(my_lid->casters_begin, my_lid->static_casters);
+							dynamic_casters = culled_draws(my_lid->casters_begin + my_lid->static_casters, my_lid->dynamic_casters);
+						}
+
+						const auto render_casters = [&](std::shared_ptr<FramebufferInstance> const& framebuffer, bool clear_depth, CastersDraws const& draws)
+						{
+							render_pass.clear();
+							if (clear_depth)
+							{
+								render_pass.ptr_clear_values = &clear;
+								render_pass.clear_value_count = 1;
+							}
+							render_pass.framebuffer = framebuffer;
+							my_draw_list.calls.front().indirect_draw_buffer = draws.draw_params;
+							my_draw_list.calls.front().draw_count = draws.draw_count;
+
+							exec.beginRenderPass(render_pass);
+
+							if (draws.draw_count != 0)
+							{
+								if (light->type() == LightType::Spot)
+								{
+									exec(_render_spot_light_depth->with(my_draw_list));
+								}
+								else if (light->type() == LightType::Point)
+								{
+									exec(_render_point_light_depth->with(my_draw_list));
+								}
+							}
+
+							exec.endRenderPass();
+						};
 
-						exec.beginRenderPass(render_pass);
+						const LightGLSL & light_glsl = _scene->_lights_buffer->get<LightGLSL>(lid.frame_light_id);
+						const ShadowCasterVolume volume(light->type(), light_glsl, _shadow_caster_min_irradiance);
+						std::shared_ptr<FramebufferInstance> framebuffer = my_lid->framebuffer->instance();
+						const bool light_changed = !_cache_shadow_maps || _invalidate_shadow_maps || !my_lid->valid ||
+							(my_lid->rendered_framebuffer.lock() != framebuffer) ||
+							(std::memcmp(&my_lid->rendered_light, &light_glsl, sizeof(LightGLSL)) != 0);
+						const bool render = light_changed || ShadowMapMayBeAffected(volume, _scene->shadowCastersChanges());
 
-						if (light->type() == LightType::Spot)
+						if (my_lid->static_layer)
 						{
-							exec(_render_spot_light_depth->with(my_draw_list));
+							std::shared_ptr<FramebufferInstance> static_layer_framebuffer = my_lid->static_layer_framebuffer->instance();
+							const bool render_static_layer = light_changed || !my_lid->static_layer_valid ||
+								(my_lid->rendered_static_layer.lock() != static_layer_framebuffer) ||
+								ShadowMapMayBeAffected(volume, _scene->staticShadowCastersChanges());
+							if (render_static_layer)
+							{
+								render_casters(static_layer_framebuffer, true, static_casters);
+								my_lid->rendered_static_layer = static_layer_framebuffer;
+								my_lid->static_layer_valid = true;
+								if (fpc)
+								{
+									++fpc->shadow_map_static_layers_rendered;
+								}
+							}
+							if (render || render_static_layer)
+							{
+								exec(application()->getPrebuiltTransferCommands().copy_image(CopyImage::CopyInfo{
+									.src = my_lid->static_layer,
+									.dst = lid.depth_view,
+								}));
+								render_casters(my_lid->load_framebuffer->instance(), false, dynamic_casters);
+							}
 						}
-						else if (light->type() == LightType::Point)
+						else if (render)
 						{
-							exec(_render_point_light_depth->with(my_draw_list));
+							render_casters(framebuffer, true, all_casters);
 						}
 
-						exec.endRenderPass();
-					}	
+						if (render)
+						{
+							my_lid->rendered_framebuffer = framebuffer;
+							my_lid->rendered_light = light_glsl;
+							my_lid->valid = true;
+						}
+						if (fpc)
+						{
+							++(render ? fpc->shadow_maps_rendered : fpc->shadow_maps_reused);
+						}
+					}
 				}
+				_invalidate_shadow_maps = false;
 
 				exec.popDebugLabel();
+				my_draw_list.calls.front().indirect_draw_buffer = full_draw_params;
+				my_draw_list.calls.front().draw_count = full_draw_count;
 				my_draw_list.pc_begin = previous_pc_begin;
 				my_draw_list.pc_size = previous_pc_size;
 			}
@@ -1138,6 +1859,48 @@ namespace vkl
 
 		VkClearValue clear_depth = VkClearValue{ .depthStencil = VkClearDepthStencilValue{.depth = _use_reverse_depth ? 0.0f : 1.0f} };
 
+		// Once the camera depth is rastered, for the occlusion culling of the next frame and the AO
+		const auto record_depth_pyramid_IFN = [&](bool needed_by_ao)
+		{
+			if ((_use_indirect_rendering && _gpu_occlusion_culling) || needed_by_ao)
+			{
+				_depth_pyramid->record(exec);
+				_depth_pyramid_world_to_proj = _camera->getWorldToProj();
+				_depth_pyramid_reverse_depth = _camera->hasReverseDepth();
+			}
+		};
+
+		// Second occlusion culling phase, once the first phase draws are rastered:
+		// The objects occluded in the previous frame pyramid are tested again against the pyramid of the first phase depth
+		// The visible ones are appended to the camera draw list, then drawn over the first phase (with load_framebuffer)
+		const auto record_second_occlusion_phase = [&](std::shared_ptr<Framebuffer> const& load_framebuffer, std::shared_ptr<VertexCommand> const& raster)
+		{
+			exec.pushDebugLabel("SecondOcclusionPhase", true);
+			_depth_pyramid->record(exec);
+			uint32_t flags = 0x2 | 0x10;
+			if (_camera->hasReverseDepth())	flags |= 0x4;
+			const PrepareDrawListPC pc{
+				.occlusion_world_to_proj = _camera->getWorldToProj(),
+				.num_objects = num_objects,
+				.flags = flags,
+				.depth_pyramid_levels = _depth_pyramid->levels(),
+				.depth_pyramid_extent = _depth_pyramid->extent(),
+			};
+			exec(_prepare_draw_list->with(ComputeCommand::SingleDispatchInfo{
+				.extent = VkExtent3D{.width = num_objects, .height = 1, .depth = 1},
+				.dispatch_threads = true,
+				.pc_data = &pc,
+				.pc_size = sizeof(pc),
+			}));
+			RenderPassBeginInfo render_pass{
+				.framebuffer = load_framebuffer->instance(),
+			};
+			exec.beginRenderPass(render_pass);
+			exec(raster->with(_camera_draw_list));
+			exec.endRenderPass();
+			exec.popDebugLabel();
+		};
+
 		if (!draw_list.empty() && _pipeline_selection.index() < 2)
 		{
 			const RenderPipeline selected_pipeline = static_cast<RenderPipeline>(_pipeline_selection.index());
@@ -1157,8 +1920,7 @@ namespace vkl
 				exec.beginRenderPass(render_pass);
 				if (_use_indirect_rendering)
 				{
-					VertexCommand::DrawInfo& my_draw_list = (_cached_draw_list.begin())->second;
-					exec(_forward_pipeline.render_scene_indirect->with(my_draw_list));
+					exec(_forward_pipeline.render_scene_indirect->with(_camera_draw_list));
 				}
 				else
 				{
@@ -1172,11 +1934,19 @@ namespace vkl
 				}
 
 				exec.endRenderPass();
+
+				if (two_phases_occlusion_culling)
+				{
+					record_second_occlusion_phase(_forward_pipeline.load_framebuffer, _forward_pipeline.render_scene_indirect);
+				}
 				
 				if (exec.framePerfCounters())
 				{
 					exec.framePerfCounters()->render_draw_list_time = tick_tock.tockd().count();
 				}
+
+				record_depth_pyramid_IFN(false);
+
 				exec.popDebugLabel();
 			}
 			else if(selected_pipeline == RenderPipeline::Deferred)
@@ -1221,10 +1991,7 @@ namespace vkl
 				
 				if (_use_indirect_rendering)
 				{
-					VertexCommand::DrawInfo & my_draw_list = (_cached_draw_list.begin())->second;
-					{
-						exec(gbuffer->raster_gbuffer_indirect->with(my_draw_list));
-					}
+					exec(gbuffer->raster_gbuffer_indirect->with(_camera_draw_list));
 				}
 				else
 				{
@@ -1238,12 +2005,19 @@ namespace vkl
 				}
 
 				exec.endRenderPass();
+
+				if (two_phases_occlusion_culling)
+				{
+					record_second_occlusion_phase(gbuffer->load_framebuffer, gbuffer->raster_gbuffer_indirect);
+				}
 				
 				if (exec.framePerfCounters())
 				{
 					exec.framePerfCounters()->render_draw_list_time = tick_tock.tockd().count();
 				}
 
+				record_depth_pyramid_IFN(_ambient_occlusion->needsDepthPyramid());
+
 				_ambient_occlusion->execute(exec, *_camera);
 
 				exec(gbuffer->shade_from_gbuffer);
@@ -1267,6 +2041,7 @@ namespace vkl
 			{
 				vl.clear();
 			}
+			_camera_draw_list.clear();
 		}
 
 		exec.bindSet(BindSetInfo{
@@ -1291,6 +2066,31 @@ namespace vkl
 			ImGui::Checkbox("Indirect Draw", &_use_indirect_rendering);
 			ImGui::EndDisabled();
 
+			ImGui::BeginDisabled(!_use_indirect_rendering);
+			ImGui::Checkbox("GPU Frustum Culling", &_gpu_frustum_culling);
+			ImGui::SetItemTooltip("Cull the draws of the camera against its frustum when preparing the indirect draw list.\n%s",
+				_compact_draw_list ? "The visible draws are compacted (draw indirect count)." : "Culled draws are left empty (draw indirect count is not available).");
+			ImGui::Checkbox("GPU Occlusion Culling", &_gpu_occlusion_culling);
+			ImGui::SetItemTooltip("Cull the draws of the camera hidden in the depth pyramid of the previous frame.");
+			ImGui::BeginDisabled(!_gpu_occlusion_culling);
+			ImGui::Checkbox("Two Phases Occlusion Culling", &_two_phases_occlusion_culling);
+			ImGui::SetItemTooltip("Test the culled draws again against the depth pyramid of the visible draws, and draw the ones it reveals.\nOtherwise an object revealed by a motion may appear a frame late.");
+			ImGui::EndDisabled();
+			ImGui::EndDisabled();
+
+			ImGui::BeginDisabled(_use_indirect_rendering);
+			ImGui::Checkbox("Auto Instancing", &_auto_instancing);
+			ImGui::SetItemTooltip("Draw the instances of a model with a single instanced draw call.");
+			if (!_use_indirect_rendering)
+			{
+				ImGui::SameLine();
+				ImGui::Text("%u draws, %u instances", _instance_groups.size32(), _instance_xform_ids.size32());
+			}
+			ImGui::EndDisabled();
+
+			ImGui::Checkbox("Texture Streaming Priorities", &_texture_streaming_priorities);
+			ImGui::SetItemTooltip("Stream the mips of the textures by screen coverage of the closest instance using them.");
+
 			_pipeline_selection.declare();
 
 			RenderPipeline render_pipeline = RenderPipeline(_pipeline_selection.index());
@@ -1319,6 +2119,27 @@ namespace vkl
 			
 			ImGui::PushID("shadow");
 			_shadow_method.declare();
+			if (_shadow_method.index() == size_t(ShadowMethod::ShadowMap))
+			{
+				ImGui::BeginDisabled(!_use_indirect_rendering);
+				ImGui::Checkbox("Cache shadow maps", &_cache_shadow_maps);
+				ImGui::SetItemTooltip("Re-render a shadow map only when its light or a shadow caster in its range changed.");
+				ImGui::Checkbox("Static / dynamic layers", &_shadow_map_dynamic_layer);
+				ImGui::SetItemTooltip("Keep a layer of the static casters per shadow map, so moving objects only re-render the dynamic casters.");
+				_invalidate_shadow_maps |= ImGui::Checkbox("Cull shadow casters", &_cull_shadow_casters);
+				ImGui::SetItemTooltip("Draw in each shadow map only the casters which can be seen by its light.");
+				_invalidate_shadow_maps |= ImGui::SliderFloat("Caster min irradiance", &_shadow_caster_min_irradiance, 0.0f, 0.1f, "%.5f", ImGuiSliderFlags_Logarithmic);
+				ImGui::SetItemTooltip("Casters which cannot receive more irradiance from a light are culled. 0 gives an infinite range to the lights.");
+				if (_cull_shadow_casters && _shadow_casters_stats.lights != 0)
+				{
+					ImGui::Text("Casters per light: %.1f avg, %u max (%u in the scene)", float(_shadow_casters_stats.casters) / float(_shadow_casters_stats.lights), _shadow_casters_stats.max_casters, _scene->shadowCasters().size32());
+				}
+				if (ImGui::Button("Invalidate shadow maps"))
+				{
+					_invalidate_shadow_maps = true;
+				}
+				ImGui::EndDisabled();
+			}
 			ImGui::PopID();
 
 			ImGui::Separator();
@@ -1334,6 +2155,12 @@ namespace vkl
 				_depth_of_field->declareGUI(ctx);
 				ImGui::Separator();
 			}
+
+			if (ImGui::CollapsingHeader("Transient Images"))
+			{
+				_transient_images->declareGUI(ctx);
+				ImGui::Separator();
+			}
 		}
 		ImGui::PopID();
 	}
@@ -2,6 +2,7 @@
 
 #include <vkl/Execution/Executor.hpp>
 #include <vkl/Execution/Module.hpp>
+#include <vkl/Execution/TransientImageAllocator.hpp>
 
 #include <vkl/Commands/GraphicsCommand.hpp>
 #include <vkl/Commands/ComputeCommand.hpp>
@@ -11,6 +12,7 @@
 #include <vkl/Rendering/RenderObjects.hpp>
 #include <vkl/Rendering/Scene.hpp>
 #include <vkl/Rendering/Camera.hpp>
+#include <vkl/Rendering/TextureFromFile.hpp>
 
 #include <vkl/IO/ImGuiUtils.hpp>
 #include <vkl/IO/GuiContext.hpp>
@@ -19,6 +21,7 @@
 #include "TemporalAntiAliasingAndUpscaler.hpp"
 #include "DepthOfField.hpp"
 #include "LightTransport.hpp"
+#include "DepthPyramid.hpp"
 
 #include <vkl/Commands/AccelerationStructureCommands.hpp>
 
@@ -65,12 +68,27 @@ namespace vkl
 		std::shared_ptr<Buffer> _draw_indexed_indirect_buffer = nullptr;
 		BufferAndRange _vk_draw_params_segment;
 		BufferAndRange _model_indices_segment;
+		// Same draws, split between the static and the dynamic objects
+		BufferAndRange _vk_static_draw_params_segment;
+		BufferAndRange _vk_dynamic_draw_params_segment;
+		// Draws of the objects seen by the camera (compacted, with their count in the atomic counter, if the device can draw indirect count)
+		BufferAndRange _vk_camera_draw_params_segment;
+		// Per object: occluded in the first occlusion culling phase
+		BufferAndRange _occluded_objects_segment;
 		BufferAndRange _atomic_counter_segment;
 
 		std::shared_ptr<DescriptorSetLayout> _set_layout;
 		std::shared_ptr<DescriptorSetAndPool> _set;
 
 		std::shared_ptr<ComputeCommand> _prepare_draw_list = nullptr;
+		bool _gpu_frustum_culling = true;
+		// Against the depth pyramid of the previous frame (without the second phase, an object revealed by the motion may appear a frame late)
+		bool _gpu_occlusion_culling = false;
+		// Second phase: the objects occluded in the previous frame pyramid are tested again against the pyramid of the first phase draws
+		bool _two_phases_occlusion_culling = true;
+		bool _compact_draw_list = false;
+		std::string _compact_draw_list_def;
+		VertexCommand::DrawInfo _camera_draw_list = {};
 		
 
 		ImGuiListSelection _pipeline_selection;
@@ -82,6 +100,9 @@ namespace vkl
 		{
 			std::shared_ptr<RenderPass> render_pass = nullptr;
 			std::shared_ptr<Framebuffer> framebuffer = nullptr;
+			// Draws of the second occlusion culling phase, over the first one
+			std::shared_ptr<RenderPass> load_render_pass = nullptr;
+			std::shared_ptr<Framebuffer> load_framebuffer = nullptr;
 			std::map<uint32_t, std::shared_ptr<VertexCommand>> render_scene_direct;
 			std::shared_ptr<VertexCommand> render_scene_indirect;
 			struct RenderSceneDirectPC
@@ -101,6 +122,9 @@ namespace vkl
 			};
 			std::shared_ptr<RenderPass> render_pass = nullptr;
 			std::shared_ptr<Framebuffer> framebuffer = nullptr;
+			// Draws of the second occlusion culling phase, over the first one
+			std::shared_ptr<RenderPass> load_render_pass = nullptr;
+			std::shared_ptr<Framebuffer> load_framebuffer = nullptr;
 
 			std::map<uint32_t, RasterCommands> raster_gbuffer;
 			std::shared_ptr<VertexCommand> raster_gbuffer_indirect;
@@ -158,10 +182,57 @@ namespace vkl
 		std::shared_ptr<VertexCommand> _render_spot_light_depth = nullptr;
 		std::shared_ptr<RenderPass> _point_light_render_pass = nullptr;
 		std::shared_ptr<VertexCommand> _render_point_light_depth = nullptr;
+		// Compatible with the clear render passes, to render the dynamic casters over the static layer
+		std::shared_ptr<RenderPass> _spot_light_load_render_pass = nullptr;
+		std::shared_ptr<RenderPass> _point_light_load_render_pass = nullptr;
+
+		// Re-render a shadow map only if its light or the casters in its range changed
+		bool _cache_shadow_maps = true;
+		// Keep a static casters layer per shadow map, so a moving object only costs a copy and the draw of the dynamic casters
+		bool _shadow_map_dynamic_layer = false;
+		bool _invalidate_shadow_maps = false;
+
+		// Per light shadow casters culling (on the CPU, with the scene casters BVH)
+		bool _cull_shadow_casters = true;
+		// Casters which cannot receive more irradiance than this from a light are culled (gives a range to the lights)
+		float _shadow_caster_min_irradiance = 1.0f / 1024.0f;
+		// Compacted draws of all the lights, which carry the model index in their first instance
+		MyVector<VkDrawIndirectCommand> _shadow_casters_draws = {};
+		std::shared_ptr<HostManagedBuffer> _shadow_casters_draws_buffer = nullptr;
+		struct ShadowCastersStats
+		{
+			uint32_t lights = 0;
+			uint32_t casters = 0;
+			uint32_t max_casters = 0;
+		};
+		ShadowCastersStats _shadow_casters_stats = {};
+
+		void cullShadowCasters(FramePerfCounters * fpc);
+
+		// Drive the streaming priority of the scene textures with the screen coverage of the instances using them
+		bool _texture_streaming_priorities = true;
+		struct TextureCoverage
+		{
+			std::shared_ptr<TextureFromFile> texture = nullptr;
+			float coverage = 0.0f;
+		};
+		// Textures seen during the latest update (reset to 0 once when they are not seen anymore)
+		std::unordered_map<const Texture*, TextureCoverage> _textures_coverage = {};
+
+		void updateTexturesStreamingPriorities();
+
+		// Of the camera depth, for the occlusion culling and the AO
+		std::shared_ptr<DepthPyramid> _depth_pyramid = nullptr;
+		// View of the latest recorded depth pyramid
+		Matrix4f _depth_pyramid_world_to_proj = Matrix4f::Identity();
+		bool _depth_pyramid_reverse_depth = false;
 
 		std::shared_ptr<AmbientOcclusion> _ambient_occlusion = nullptr;
 		std::shared_ptr<DepthOfField> _depth_of_field = nullptr;
 
+		// The G-buffer, the AO target and the DoF copy do not keep their content from a frame to the next
+		std::shared_ptr<TransientImageAllocator> _transient_images = nullptr;
+
 		MultiDescriptorSetsLayouts _sets_layouts;
 
 		std::shared_ptr<HostManagedBuffer> _ubo_buffer;
@@ -185,6 +256,29 @@ namespace vkl
 		MultiVertexDrawCallList _cached_draw_list;
 		void generateVertexDrawList(MultiVertexDrawCallList & res);
 
+		// Host draw list: the instances of a model are drawn with a single instanced draw
+		// The draws read the xform ids of their instances in _instance_xform_ids_buffer
+		bool _auto_instancing = true;
+		struct InstanceGroup
+		{
+			std::shared_ptr<Model> model = nullptr;
+			// Range in _instance_xform_ids
+			uint32_t first = 0;
+			uint32_t count = 0;
+		};
+		MyVector<InstanceGroup> _instance_groups = {};
+		std::unordered_map<const Model*, uint32_t> _instance_group_index = {};
+		struct InstanceRef
+		{
+			uint32_t group;
+			uint32_t xform_id;
+		};
+		MyVector<InstanceRef> _instance_refs = {};
+		MyVector<uint32_t> _instance_xform_ids = {};
+		std::shared_ptr<HostManagedBuffer> _instance_xform_ids_buffer = nullptr;
+
+		void gatherInstanceGroups();
+
 		void createInternalResources();
 
 		void updateMaintainRT();
@@ -248,6 +342,12 @@ namespace vkl
 			return res;
 		}
 
+		// Must be suspended to read the G-buffer or the AO target after execute() (their memory is aliased)
+		std::shared_ptr<TransientImageAllocator> const& transientImages() const
+		{
+			return _transient_images;
+		}
+
 		std::shared_ptr<ImageView> const& getPositionImage() const
 		{
 			return _fat_deferred_pipeline.position;
@@ -4,6 +4,15 @@
 
 #include "common.glsl"
 
+#define BIND_SCENE 1
+#include <ShaderLib:/Rendering/Scene/Scene.glsl>
+
+// xform ids of the instances of the draw calls
+layout(SHADER_DESCRIPTOR_BINDING + 0) buffer restrict readonly InstanceXFormIdsBinding
+{
+	uint ids[];
+} instance_xform_ids;
+
 layout(location = 0) in vec3 a_position;
 layout(location = 1) in vec3 a_normal;
 layout(location = 2) in vec3 a_tangent;
@@ -16,13 +25,15 @@ layout(location = 3) out vec3 v_w_tangent;
 
 layout(push_constant) uniform PushConstant
 {
-	mat4 object_to_world;
+	uint instance_offset;
+	uint instances_per_xform;
 } _pc;
 
 void main()
 {	
 	const mat4 w2p = GetCameraWorldToProj(ubo.camera);
-	const mat4 o2w = _pc.object_to_world;
+	const uint xform_id = instance_xform_ids.ids[_pc.instance_offset + (gl_InstanceIndex / _pc.instances_per_xform)];
+	const mat4 o2w = mat4(readSceneMatrix(xform_id));
 	const mat4 o2p = w2p * o2w;
 	
 	vec3 m_position = a_position;
@@ -41,7 +41,7 @@ void main()
 	if(material_id != uint(-1))
 	{
 		textures = scene_pb_materials_textures.ids[material_id];
-		material_props = scene_pb_materials[material_id].props;
+		material_props = scene_pb_materials.props[material_id];
 	}
 	else
 	{
@@ -46,7 +46,7 @@ struct GeometryShadingInfo
 
 PBMaterialSampleData readMaterial(uint material_id, vec2 uv)
 {
-	const PBMaterialProperties props = scene_pb_materials[material_id].props;
+	const PBMaterialProperties props = scene_pb_materials.props[material_id];
 	PBMaterialSampleData res;
 	res.flags = props.flags;
 	res.albedo = 0..xxx;
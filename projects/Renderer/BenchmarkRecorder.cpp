@@ -0,0 +1,266 @@
+#include "BenchmarkRecorder.hpp"
+
+#include <vkl/Execution/ExecutionStackReport.hpp>
+#include <vkl/Utils/TickTock.hpp>
+
+#include <fstream>
+#include <unordered_map>
+#include <cmath>
+#include <format>
+
+namespace vkl
+{
+	namespace
+	{
+		bool IsTimeCounter(std::string_view name)
+		{
+			return name.ends_with("_time");
+		}
+
+		std::string EscapeJSON(std::string_view s)
+		{
+			std::string res;
+			res.reserve(s.size());
+			for (char c : s)
+			{
+				if (c == '"' || c == '\\')
+				{
+					res += '\\';
+					res += c;
+				}
+				else if (static_cast<unsigned char>(c) < 0x20)
+				{
+					res += std::format("\\u{:04x}", static_cast<unsigned int>(c));
+				}
+				else
+				{
+					res += c;
+				}
+			}
+			return res;
+		}
+
+		std::string EscapeCSV(std::string_view s)
+		{
+			std::string res = "\"";
+			for (char c : s)
+			{
+				if (c == '"')
+				{
+					res += '"';
+				}
+				res += c;
+			}
+			res += '"';
+			return res;
+		}
+	}
+
+	BenchmarkRecorder::BenchmarkRecorder()
+	{
+		using TimeCountClock = std::TickTock_hrc::Clock_t;
+		using r = std::ratio_divide<TimeCountClock::period, std::milli>;
+		_time_to_ms = double(r::num) / double(r::den);
+	}
+
+	BenchmarkRecorder::Frame * BenchmarkRecorder::findFrame(size_t index)
+	{
+		Frame * res = nullptr;
+		// Frames are added in order, the timings arrive a frame or two later
+		for (size_t i = _frames.size(); i > 0; --i)
+		{
+			if (_frames[i - 1].index == index)
+			{
+				res = &_frames[i - 1];
+				break;
+			}
+		}
+		return res;
+	}
+
+	void BenchmarkRecorder::addFrame(size_t index, Vector3f const& camera_position, FramePerfCounters const& counters)
+	{
+		_frames.push_back(Frame{
+			.index = index,
+			.camera_position = camera_position,
+			.counters = counters,
+		});
+	}
+
+	void BenchmarkRecorder::setTimings(size_t index, ExecutionStackReport const& report)
+	{
+		Frame * frame = findFrame(index);
+		if (!frame)
+		{
+			return;
+		}
+		MyVector<ExecutionStackReport::Segment> const& segments = report.segments();
+		frame->timings.resize(segments.size());
+		for (size_t i = 0; i < segments.size(); ++i)
+		{
+			ExecutionStackReport::Segment const& seg = segments[i];
+			SegmentTiming & timing = frame->timings[i];
+			// Parents are pushed before their children
+			if (seg.parent != ExecutionStackReport::Index(-1))
+			{
+				timing.path = frame->timings[seg.parent].path + "/";
+			}
+			else
+			{
+				timing.path.clear();
+			}
+			timing.path += report.getSegmentName(seg);
+			timing.cpu_ms = seg.cpu_duration_ns * 1e-6;
+			timing.gpu_ms = seg.gpu_duration_ns * 1e-6;
+		}
+	}
+
+	bool BenchmarkRecorder::writeJSON(std::ostream & out) const
+	{
+		const auto number = [](double d)
+		{
+			return std::isfinite(d) ? std::format("{}", d) : std::string("null");
+		};
+		out << "{\n\t\"frames\": [";
+		for (size_t f = 0; f < _frames.size(); ++f)
+		{
+			const Frame & frame = _frames[f];
+			out << (f ? ",\n" : "\n");
+			out << "\t\t{\n";
+			out << "\t\t\t\"index\": " << frame.index << ",\n";
+			out << std::format("\t\t\t\"camera_position\": [{}, {}, {}],\n", frame.camera_position[0], frame.camera_position[1], frame.camera_position[2]);
+			out << "\t\t\t\"counters\": {";
+			bool first = true;
+			frame.counters.forEach([&](std::string_view name, size_t value)
+			{
+				out << (first ? "" : ", ");
+				first = false;
+				if (IsTimeCounter(name))
+				{
+					out << "\"" << name << "_ms\": " << number(double(value) * _time_to_ms);
+				}
+				else
+				{
+					out << "\"" << name << "\": " << value;
+				}
+			});
+			out << "},\n";
+			out << "\t\t\t\"timings\": [";
+			for (size_t t = 0; t < frame.timings.size(); ++t)
+			{
+				const SegmentTiming & timing = frame.timings[t];
+				out << (t ? ",\n" : "\n");
+				out << "\t\t\t\t{\"label\": \"" << EscapeJSON(timing.path) << "\", \"cpu_ms\": " << number(timing.cpu_ms) << ", \"gpu_ms\": " << number(timing.gpu_ms) << "}";
+			}
+			out << (frame.timings.empty() ? "]\n" : "\n\t\t\t]\n");
+			out << "\t\t}";
+		}
+		out << "\n\t]\n}\n";
+		return out.good();
+	}
+
+	bool BenchmarkRecorder::writeCSV(std::ostream & out) const
+	{
+		// Segments columns, in order of first appearance (the recorded commands may differ between frames)
+		MyVector<std::string> segment_columns;
+		// The keys point to the strings of the frames
+		std::unordered_map<std::string_view, size_t> segment_column_index;
+		for (const Frame & frame : _frames)
+		{
+			for (const SegmentTiming & timing : frame.timings)
+			{
+				if (!segment_column_index.contains(timing.path))
+				{
+					segment_column_index[timing.path] = segment_columns.size();
+					segment_columns.push_back(timing.path);
+				}
+			}
+		}
+
+		out << "frame,camera_x,camera_y,camera_z";
+		FramePerfCounters().forEach([&](std::string_view name, size_t)
+		{
+			out << "," << name << (IsTimeCounter(name) ? "_ms" : "");
+		});
+		for (std::string const& column : segment_columns)
+		{
+			out << "," << EscapeCSV(column + " cpu_ms") << "," << EscapeCSV(column + " gpu_ms");
+		}
+		out << "\n";
+
+		MyVector<const SegmentTiming *> row(segment_columns.size());
+		for (const Frame & frame : _frames)
+		{
+			out << frame.index << "," << frame.camera_position[0] << "," << frame.camera_position[1] << "," << frame.camera_position[2];
+			frame.counters.forEach([&](std::string_view name, size_t value)
+			{
+				if (IsTimeCounter(name))
+				{
+					out << "," << (double(value) * _time_to_ms);
+				}
+				else
+				{
+					out << "," << value;
+				}
+			});
+			std::fill(row.begin(), row.end(), nullptr);
+			for (const SegmentTiming & timing : frame.timings)
+			{
+				// A label can appear several times in a frame: keep the first
+				const SegmentTiming *& cell = row[segment_column_index.at(timing.path)];
+				if (!cell)
+				{
+					cell = &timing;
+				}
+			}
+			for (const SegmentTiming * timing : row)
+			{
+				out << ",";
+				if (timing && std::isfinite(timing->cpu_ms))	out << timing->cpu_ms;
+				out << ",";
+				if (timing && std::isfinite(timing->gpu_ms))	out << timing->gpu_ms;
+			}
+			out << "\n";
+		}
+		return out.good();
+	}
+
+	bool BenchmarkRecorder::write(std::filesystem::path const& path) const
+	{
+		if (path.has_parent_path())
+		{
+			std::filesystem::create_directories(path.parent_path());
+		}
+		std::ofstream file(path, std::ios::trunc);
+		if (!file)
+		{
+			return false;
+		}
+		bool res;
+		if (path.extension() == ".csv")
+		{
+			res = writeCSV(file);
+		}
+		else
+		{
+			res = writeJSON(file);
+		}
+		return res;
+	}
+
+	void BenchmarkRecorder::getFrameTimeStats(double & mean_ms, double & max_ms) const
+	{
+		mean_ms = 0;
+		max_ms = 0;
+		for (const Frame & frame : _frames)
+		{
+			const double t = double(frame.counters.frame_time) * _time_to_ms;
+			mean_ms += t;
+			max_ms = std::max(max_ms, t);
+		}
+		if (!_frames.empty())
+		{
+			mean_ms /= double(_frames.size());
+		}
+	}
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vkl/Execution/FramePerformanceCounters.hpp>
+#include <vkl/Maths/Types.hpp>
+#include <vkl/Utils/MyVector.hpp>
+
+#include <filesystem>
+#include <string>
+
+namespace vkl
+{
+	class ExecutionStackReport;
+
+	// Per frame FramePerfCounters and ExecutionStackReport timings of a headless benchmark run
+	// Written as JSON (one object per frame) or CSV (one row per frame, one column per counter and per segment)
+	class BenchmarkRecorder
+	{
+	public:
+
+		struct SegmentTiming
+		{
+			// Labels of the parents and of the segment, separated by '/'
+			std::string path = {};
+			double cpu_ms = 0;
+			// NaN if not available
+			double gpu_ms = 0;
+		};
+
+		struct Frame
+		{
+			size_t index = 0;
+			Vector3f camera_position = Vector3f::Zero();
+			FramePerfCounters counters = {};
+			MyVector<SegmentTiming> timings = {};
+		};
+
+	protected:
+
+		MyVector<Frame> _frames = {};
+
+		// FramePerfCounters times are std::TickTock_hrc counts
+		double _time_to_ms = 1;
+
+		Frame * findFrame(size_t index);
+
+		bool writeJSON(std::ostream & out) const;
+
+		bool writeCSV(std::ostream & out) const;
+
+	public:
+
+		BenchmarkRecorder();
+
+		void addFrame(size_t index, Vector3f const& camera_position, FramePerfCounters const& counters);
+
+		// The report must be ready (FramePerfReport::ready_for_display)
+		void setTimings(size_t index, ExecutionStackReport const& report);
+
+		MyVector<Frame> const& frames() const
+		{
+			return _frames;
+		}
+
+		// Format from the extension: ".csv" or JSON otherwise
+		bool write(std::filesystem::path const& path) const;
+
+		// Mean and max of the CPU frame time (ms)
+		void getFrameTimeStats(double & mean_ms, double & max_ms) const;
+	};
+}
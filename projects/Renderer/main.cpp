@@ -16,6 +16,9 @@
 #include <vkl/Execution/Module.hpp>
 #include <vkl/Execution/ResourcesManager.hpp>
 #include <vkl/Execution/PerformanceReport.hpp>
+#include <vkl/Execution/MemoryTelemetry.hpp>
+#include <vkl/Execution/FramePerfReport.hpp>
+#include <vkl/Execution/ExecutionStackReport.hpp>
 #include <vkl/Execution/CommonUBO.hpp>
 
 #include <vkl/Utils/TickTock.hpp>
@@ -33,6 +36,7 @@
 #include <vkl/Rendering/ColorCorrection.hpp>
 #include <vkl/Rendering/ImagePicker.hpp>
 #include <vkl/Rendering/ImageSaver.hpp>
+#include <vkl/Rendering/GeometryArena.hpp>
 
 #include <vkl/Maths/Transforms.hpp>
 #include <vkl/Maths/AffineXForm.hpp>
@@ -42,9 +46,14 @@
 #include <iostream>
 #include <chrono>
 #include <random>
+#include <numbers>
 
 #include "Renderer.hpp"
 #include "PicInPic.hpp"
+#include "BenchmarkRecorder.hpp"
+#include "DepthPyramid.hpp"
+
+#include <vkl/Maths/ViewCulling.hpp>
 
 namespace vkl
 {
@@ -590,6 +599,75 @@ namespace vkl
 		}));
 	}
 
+	// Heavy DAG instancing: a grid of few models, each instanced thousands of times through shared nodes
+	static void LoadInstancedGrid(std::shared_ptr<Scene>& scene)
+	{
+		VkApplication* app = scene->application();
+		std::shared_ptr<Scene::Node> root = scene->getRootNode();
+
+		scene->setEnvironment(
+			vec3(0.5, 0.8, 1) * 2,
+			vec2(Radians(15.0f), Radians(60.0f)),
+			Radians(0.5f),
+			5500, 20
+		);
+
+		std::shared_ptr<RigidMesh> box_mesh = RigidMesh::MakeCube(RigidMesh::CubeMakeInfo{
+			.app = app,
+			.name = "Cube",
+			.wireframe = false,
+			.face_normal = true,
+		});
+		std::shared_ptr<RigidMesh> sphere_mesh = RigidMesh::MakeSphere(RigidMesh::SphereMakeInfo{
+			.app = app,
+			.name = "Sphere",
+		});
+
+		auto MakeMaterial = [&](std::string_view name, vec3 const& color, float roughness, float metallic)
+		{
+			return std::make_shared<PBMaterial>(PBMaterial::CI{
+				.app = app,
+				.name = std::string(name),
+				.albedo = color,
+				.metallic = metallic,
+				.roughness = roughness,
+				.is_dielectric = false,
+				.sample_spectral = false,
+			});
+		};
+
+		// A cell of the grid: a box and a sphere
+		std::shared_ptr<Scene::Node> cell = std::make_shared<Scene::Node>(Scene::Node::CI{
+			.name = "Cell",
+		});
+		cell->addChild(MakeModelNode("Box", box_mesh, MakeMaterial("Box.Material", vec3(0.9, 0.6, 0.1), 0.5, 0), ScalingMatrix(Vector3f::Constant(0.3f).eval())));
+		cell->addChild(MakeModelNode("Sphere", sphere_mesh, MakeMaterial("Sphere.Material", vec3(0.5, 0.5, 1.0), 0.2, 0.8), TranslationMatrix(Vector3f(0, 0, 0.5)) * ScalingMatrix(Vector3f::Constant(0.2f).eval())));
+
+		// Each level repeats the previous one along an axis: n^3 cells (~10k of each model)
+		const int n = 22;
+		const float spacing = 1.5f;
+		std::shared_ptr<Scene::Node> level = cell;
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			std::shared_ptr<Scene::Node> next_level = std::make_shared<Scene::Node>(Scene::Node::CI{
+				.name = std::format("Grid{}", axis),
+			});
+			for (int i = 0; i < n; ++i)
+			{
+				Vector3f t = Vector3f::Zero();
+				t[axis] = (i - n / 2) * spacing;
+				std::shared_ptr<Scene::Node> instance = std::make_shared<Scene::Node>(Scene::Node::CI{
+					.name = std::format("Grid{}_{}", axis, i),
+					.matrix = TranslationMatrix(t),
+				});
+				instance->addChild(level);
+				next_level->addChild(instance);
+			}
+			level = next_level;
+		}
+		root->addChild(level);
+	}
+
 	static void LoadTestScene(std::shared_ptr<Scene>& scene, int preset)
 	{
 		VkApplication * app = scene->application();
@@ -605,6 +683,10 @@ namespace vkl
 		{
 			LoadCornellBox(scene, preset - 5);
 		}
+		else if (preset == 13)
+		{
+			LoadInstancedGrid(scene);
+		}
 	}
 
 
@@ -620,6 +702,47 @@ namespace vkl
 		static void FillArgs(argparse::ArgumentParser& args_parser)
 		{
 			AppWithImGui::FillArgs(args_parser);
+
+			args_parser.add_argument("--parallel_update")
+				.help("Update the resources (commands, descriptor sets, ...) in parallel on the thread pool")
+				.default_value(false)
+				.implicit_value(true)
+			;
+
+			// Headless benchmark (with --headless)
+			args_parser.add_argument("--scene")
+				.help("Index of the test scene loaded by the headless benchmark (1: Sponza, 5: Cornell Box, 13: Instanced grid, ...)")
+				.default_value(1)
+				.scan<'d', int>()
+			;
+			args_parser.add_argument("--frames")
+				.help("Number of frames recorded by the headless benchmark")
+				.default_value(300)
+				.scan<'d', int>()
+			;
+			args_parser.add_argument("--warmup_frames")
+				.help("Number of frames rendered before the headless benchmark starts recording (loading, shaders compilation)")
+				.default_value(120)
+				.scan<'d', int>()
+			;
+			args_parser.add_argument("--benchmark_output")
+				.help("Per frame counters and timings of the headless benchmark (.json or .csv)")
+				.default_value("benchmark.json"s)
+			;
+			args_parser.add_argument("--memory_report")
+				.help("JSON memory report (heap budgets, memory per category) written at the end of the headless benchmark (none if empty)")
+				.default_value(""s)
+			;
+			args_parser.add_argument("--check_depth_pyramid")
+				.help("Instead of the headless benchmark, compare the GPU depth pyramid with its CPU reference on a few non power of two extents")
+				.default_value(false)
+				.implicit_value(true)
+			;
+			args_parser.add_argument("--compare_frame_graph")
+				.help("Record the frames of the headless benchmark twice (node by node, then with the frame graph) and report the barriers per frame of both")
+				.default_value(false)
+				.implicit_value(true)
+			;
 		}
 
 	protected:
@@ -673,13 +796,463 @@ namespace vkl
 				.args = args,
 			})
 		{
+			_parallel_update = args.get<bool>("--parallel_update");
+			_benchmark = BenchmarkOptions{
+				.scene = args.get<int>("--scene"),
+				.frames = static_cast<size_t>(std::max(args.get<int>("--frames"), 0)),
+				.warmup_frames = static_cast<size_t>(std::max(args.get<int>("--warmup_frames"), 0)),
+				.output = args.get<std::string>("--benchmark_output"),
+				.memory_report = args.get<std::string>("--memory_report"),
+				.compare_frame_graph = args.get<bool>("--compare_frame_graph"),
+				.check_depth_pyramid = args.get<bool>("--check_depth_pyramid"),
+			};
+		}
+
+	protected:
+
+		bool _parallel_update = false;
+
+		struct BenchmarkOptions
+		{
+			int scene = 1;
+			size_t frames = 300;
+			size_t warmup_frames = 120;
+			std::filesystem::path output = {};
+			std::filesystem::path memory_report = {};
+			bool compare_frame_graph = false;
+			bool check_depth_pyramid = false;
+		};
+		BenchmarkOptions _benchmark = {};
+
+		// Renders the scene to an offscreen image (no window, no swapchain) along a scripted camera path
+		// and writes the per frame perf counters and execution stack timings
+		// Can run on a software implementation (eg lavapipe), to track the CPU side on machines without GPU
+		void runHeadless()
+		{
+			ResourcesManager resources_manager = ResourcesManager::CreateInfo{
+				.app = this,
+				.name = "ResourcesManager",
+				.auto_file_check_period = 1s,
+				.parallel_update = _parallel_update,
+			};
+
+			LinearExecutor exec(LinearExecutor::CI{
+				.app = this,
+				.name = "exec",
+				.window = nullptr,
+				.common_definitions = resources_manager.commonDefinitions(),
+				.common_ubo_size = sizeof(CommonUBO),
+				.use_ImGui = false,
+				.use_debug_renderer = false,
+			});
+
+			const VkExtent2D resolution = {
+				.width = static_cast<uint32_t>(_desired_window_options.resolution.x()),
+				.height = static_cast<uint32_t>(_desired_window_options.resolution.y()),
+			};
+
+			Camera camera(Camera::CreateInfo{
+				.resolution = resolution,
+				.znear = 0.01,
+				.zfar = 100,
+			});
+
+			std::shared_ptr<ImageView> final_image = std::make_shared<ImageView>(Image::CI{
+				.app = this,
+				.name = "Final Image",
+				.type = VK_IMAGE_TYPE_2D,
+				.format = VK_FORMAT_R16G16B16A16_SFLOAT,
+				.extent = VkExtent3D{.width = resolution.width, .height = resolution.height, .depth = 1},
+				.usage = VK_IMAGE_USAGE_TRANSFER_BITS | VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+				.mem_usage = VMA_MEMORY_USAGE_GPU_ONLY,
+			});
+			ResourcesLists script_resources;
+			script_resources += final_image;
+
+			std::shared_ptr<Scene> scene = std::make_shared<Scene>(Scene::CI{
+				.app = this,
+				.name = "scene",
+			});
+
+			MultiDescriptorSetsLayouts sets_layouts;
+			sets_layouts += {0, exec.getCommonSetLayout()};
+			sets_layouts += {1, scene->setLayout()};
+
+			SimpleRenderer renderer(SimpleRenderer::CI{
+				.app = this,
+				.name = "Renderer",
+				.sets_layouts = sets_layouts,
+				.scene = scene,
+				.target = final_image,
+				.camera = &camera,
+			});
+
+			ColorCorrection color_correction = ColorCorrection::CI{
+				.app = this,
+				.name = "ColorCorrection",
+				.dst = final_image,
+				.sets_layouts = sets_layouts,
+			};
+
+			exec.init();
+
+			LoadTestScene(scene, _benchmark.scene);
+
+			BenchmarkRecorder recorder;
+			FramePerfCounters frame_counters = {};
+			CommonUBO common_ubo = {};
+
+			// Fixed time step, so the runs are reproducible
+			const double dt = 1.0 / 60.0;
+			// Same camera path for each pass
+			const size_t passes = _benchmark.compare_frame_graph ? 2 : 1;
+			const size_t total_frames = _benchmark.warmup_frames + _benchmark.frames * passes;
+
+			// Of the recorded frames of each pass (0: node by node, 1: frame graph)
+			struct BarrierTotals
+			{
+				size_t frames = 0;
+				size_t pipeline_barriers = 0;
+				size_t buffer_barriers = 0;
+				size_t image_barriers = 0;
+			};
+			std::array<BarrierTotals, 2> barrier_totals = {};
+
+			// Orbit around the scene, fitted to the scene bounds when the recording starts (the scene loads asynchronously)
+			Vector3f orbit_center = Vector3f::Zero();
+			float orbit_radius = 2;
+			float orbit_height = 1;
+
+			// The report of a frame is ready one frame later (once the submissions of the frame completed)
+			std::shared_ptr<FramePerfReport> previous_report = nullptr;
+			size_t previous_report_frame = 0;
+			const auto collect_report = [&](std::chrono::milliseconds timeout)
+			{
+				if (previous_report)
+				{
+					const auto deadline = std::chrono::steady_clock::now() + timeout;
+					while (!previous_report->ready_for_display && std::chrono::steady_clock::now() < deadline)
+					{
+						std::this_thread::sleep_for(50us);
+					}
+					if (previous_report->ready_for_display)
+					{
+						recorder.setTimings(previous_report_frame, *previous_report->report);
+					}
+					previous_report = nullptr;
+				}
+			};
+
+			logger()(std::format("Headless benchmark: {} warmup frames, {} recorded frames at {}x{}", _benchmark.warmup_frames, _benchmark.frames, resolution.width, resolution.height), Logger::Options::TagInfo);
+
+			std::TickTock_hrc frame_tick_tock;
+			frame_tick_tock.tick();
+			size_t dynamic_value_evaluations = DynamicValueStats::LambdaEvaluations();
+			for (size_t frame_index = 0; frame_index < total_frames; ++frame_index)
+			{
+				const double t = double(frame_index) * dt;
+				const bool record = frame_index >= _benchmark.warmup_frames;
+				const size_t recorded_index = record ? (frame_index - _benchmark.warmup_frames) : 0;
+				const size_t pass = recorded_index / std::max<size_t>(_benchmark.frames, 1);
+				if (_benchmark.compare_frame_graph)
+				{
+					exec.setUseFrameGraph(pass == 1);
+				}
+				if (frame_index == _benchmark.warmup_frames && !scene->aabb().empty())
+				{
+					const AABB3f & aabb = scene->aabb();
+					orbit_center = aabb.center();
+					orbit_radius = 0.35f * Vector2f(aabb.diagonal()[0], aabb.diagonal()[2]).norm();
+					orbit_height = 0.1f * aabb.diagonal()[1];
+				}
+				{
+					const float angle = 2.0f * std::numbers::pi_v<float> * float(recorded_index % std::max<size_t>(_benchmark.frames, 1)) / float(std::max<size_t>(_benchmark.frames, 1));
+					camera.position() = orbit_center + Vector3f(orbit_radius * std::cos(angle), orbit_height, orbit_radius * std::sin(angle));
+					camera.direction() = orbit_center - camera.position();
+					camera.computeInternal();
+				}
+
+				frame_counters.reset();
+				FillCommonUBO(common_ubo, t, dt, size_t(t * 1e9), frame_index);
+
+				std::shared_ptr<UpdateContext> update_context = resources_manager.beginUpdateCycle();
+				update_context->setFramePerfCounters(&frame_counters);
+				{
+					getSamplerLibrary().updateResources(*update_context);
+					{
+						std::TickTock_hrc prepare_scene_tt;
+						prepare_scene_tt.tick();
+						scene->updateInternal();
+						frame_counters.prepare_scene_time = prepare_scene_tt.tockd().count();
+					}
+
+					std::TickTock_hrc exec_tt;
+					exec_tt.tick();
+					exec.updateResources(*update_context);
+					update_context->resourcesToUpload().addBuffer(exec.getCommonUBO()->instance(), &common_ubo, sizeof(CommonUBO), false);
+					frame_counters.exec_update_time = exec_tt.tockd().count();
+
+					renderer.preUpdate(*update_context);
+					if (GeometryArena * geometry_arena = geometryArena())
+					{
+						// Before the meshes: the relocated ones transmit their new ranges in the same frame
+						geometry_arena->updateResources(*update_context);
+					}
+					{
+						std::TickTock_hrc update_scene_tt;
+						update_scene_tt.tick();
+						scene->updateResources(*update_context);
+						frame_counters.update_scene_time = update_scene_tt.tockd().count();
+					}
+					textureFileCache().updateResources(*update_context);
+
+					std::TickTock_hrc modules_tt;
+					modules_tt.tick();
+					renderer.updateResources(*update_context);
+					color_correction.updateResources(*update_context);
+					script_resources.update(*update_context);
+					resources_manager.finishUpdateCycle(update_context);
+					frame_counters.main_script_modules_time = modules_tt.tockd().count();
+				}
+				frame_counters.update_time = update_context->tickTock().tockd().count();
+
+				std::TickTock_hrc render_tick_tock;
+				render_tick_tock.tick();
+				{
+					exec.beginFrame(record);
+					exec.performSynchTransfers(*update_context, true);
+
+					ExecutionThread* ptr_exec_thread = exec.beginCommandBuffer();
+					ExecutionThread& exec_thread = *ptr_exec_thread;
+					exec_thread.setFramePerfCounters(&frame_counters);
+
+					exec.performAsynchMipsCompute(*update_context->mipsQueue());
+
+					exec_thread.bindSet(BindSetInfo{
+						.index = 1,
+						.set = scene->set(),
+					});
+					if (GeometryArena * geometry_arena = geometryArena())
+					{
+						geometry_arena->recordTransferIFN(exec_thread);
+					}
+					scene->prepareForRendering(exec_thread);
+					renderer.execute(exec_thread, t, dt, frame_index);
+					color_correction.execute(exec_thread);
+					exec_thread.bindSet(BindSetInfo{
+						.index = 1,
+						.set = nullptr,
+					});
+					exec.endCommandBuffer(ptr_exec_thread);
+
+					// No presentation: the frame ends with the submission
+					exec.submit();
+					exec.endFrame();
+				}
+				frame_counters.render_time = render_tick_tock.tockd().count();
+				frame_counters.frame_time = frame_tick_tock.tockd().count();
+				frame_tick_tock.tick();
+				{
+					const size_t evaluations = DynamicValueStats::LambdaEvaluations();
+					frame_counters.dynamic_value_evaluations = evaluations - dynamic_value_evaluations;
+					dynamic_value_evaluations = evaluations;
+				}
+
+				collect_report(1s);
+				if (record)
+				{
+					BarrierTotals & totals = barrier_totals[std::min<size_t>(pass, 1)];
+					++totals.frames;
+					totals.pipeline_barriers += frame_counters.pipeline_barriers;
+					totals.buffer_barriers += frame_counters.buffer_barriers;
+					totals.image_barriers += frame_counters.image_barriers;
+					recorder.addFrame(frame_index, camera.position(), frame_counters);
+					previous_report = exec.getPendingFrameReport();
+					previous_report_frame = frame_index;
+				}
+			}
+			exec.waitForAllCompletion();
+			VK_CHECK(deviceWaitIdle(), "Failed to wait for completion.");
+			collect_report(1s);
+
+			double mean_ms, max_ms;
+			recorder.getFrameTimeStats(mean_ms, max_ms);
+			logger()(std::format("Headless benchmark: {} frames, CPU frame time: mean {:.3f}ms, max {:.3f}ms", recorder.frames().size(), mean_ms, max_ms), Logger::Options::TagSuccess);
+			for (size_t p = 0; p < passes; ++p)
+			{
+				const BarrierTotals & totals = barrier_totals[p];
+				const double n = double(std::max<size_t>(totals.frames, 1));
+				const std::string_view path = (p == 1 || exec.useFrameGraph()) ? "frame graph" : "node by node";
+				logger()(std::format("Headless benchmark ({}): per frame: {:.1f} pipeline barriers, {:.1f} buffer barriers, {:.1f} image barriers", path, double(totals.pipeline_barriers) / n, double(totals.buffer_barriers) / n, double(totals.image_barriers) / n), Logger::Options::TagInfo);
+			}
+			if (recorder.write(_benchmark.output))
+			{
+				logger()(std::format("Headless benchmark written to {}", _benchmark.output.string()), Logger::Options::TagSuccess);
+			}
+			else
+			{
+				logger()(std::format("Could not write the headless benchmark to {}", _benchmark.output.string()), Logger::Options::TagError);
+			}
+			if (!_benchmark.memory_report.empty())
+			{
+				memoryTelemetry().sample();
+				memoryTelemetry().dumpReport(_benchmark.memory_report);
+			}
+		}
+
+		// DepthPyramid::record on random depth buffers, each level read back and compared with DepthMinMaxPyramid::Build
+		// The extents cover the edge tiles (not multiple of 64), a single tile, a single row and more levels than a tile
+		// Exact comparison: the min / max are not rounded
+		bool checkDepthPyramid()
+		{
+			const std::vector<VkExtent2D> extents = {{1, 1}, {7, 5}, {64, 64}, {127, 64}, {129, 65}, {333, 197}, {1000, 3}, {1920, 1080}};
+
+			ResourcesManager resources_manager = ResourcesManager::CreateInfo{
+				.app = this,
+				.name = "ResourcesManager",
+			};
 
+			LinearExecutor exec(LinearExecutor::CI{
+				.app = this,
+				.name = "exec",
+				.window = nullptr,
+				.common_definitions = resources_manager.commonDefinitions(),
+				.common_ubo_size = sizeof(CommonUBO),
+				.use_ImGui = false,
+				.use_debug_renderer = false,
+			});
+
+			VkExtent3D depth_extent = makeUniformExtent3D(1);
+			std::shared_ptr<ImageView> depth_view = std::make_shared<ImageView>(Image::CI{
+				.app = this,
+				.name = "Depth",
+				.type = VK_IMAGE_TYPE_2D,
+				.format = VK_FORMAT_R32_SFLOAT,
+				.extent = &depth_extent,
+				.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+				.mem_usage = VMA_MEMORY_USAGE_GPU_ONLY,
+			});
+
+			MultiDescriptorSetsLayouts sets_layouts;
+			sets_layouts += {0, exec.getCommonSetLayout()};
+
+			DepthPyramid depth_pyramid(DepthPyramid::CI{
+				.app = this,
+				.name = "DepthPyramid",
+				.sets_layouts = sets_layouts,
+				.depth = depth_view,
+			});
+
+			exec.init();
+
+			CommonUBO common_ubo = {};
+			std::mt19937 rng(42);
+			std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+			bool res = true;
+			for (size_t i = 0; i < extents.size(); ++i)
+			{
+				const VkExtent2D extent = extents[i];
+				depth_extent = VkExtent3D{.width = extent.width, .height = extent.height, .depth = 1};
+				MyVector<float> depth(extent.width * extent.height);
+				for (float& d : depth)	d = unit(rng);
+
+				FillCommonUBO(common_ubo, 0, 0, 0, i);
+				std::shared_ptr<UpdateContext> update_context = resources_manager.beginUpdateCycle();
+				{
+					exec.updateResources(*update_context);
+					update_context->resourcesToUpload().addBuffer(exec.getCommonUBO()->instance(), &common_ubo, sizeof(CommonUBO), false);
+					depth_view->updateResource(*update_context);
+					depth_pyramid.updateResources(*update_context);
+					update_context->resourcesToUpload() += ResourcesToUpload::ImageUpload{
+						.data = depth.data(),
+						.size = depth.byte_size(),
+						.copy_data = false,
+						.dst = depth_view->instance(),
+					};
+					resources_manager.finishUpdateCycle(update_context);
+				}
+
+				const uint32_t levels = depth_pyramid.levels();
+				MyVector<MyVector<Vector2f>> gpu_levels(levels);
+				{
+					exec.beginFrame(false);
+					exec.performSynchTransfers(*update_context, true);
+					ExecutionThread* ptr_exec_thread = exec.beginCommandBuffer();
+					ExecutionThread& exec_thread = *ptr_exec_thread;
+
+					depth_pyramid.record(exec_thread);
+
+					DownloadImage & downloader = getPrebuiltTransferCommands().download_image;
+					for (uint32_t level = 0; level < levels; ++level)
+					{
+						const VkExtent2D le = {.width = std::max(extent.width >> level, 1u), .height = std::max(extent.height >> level, 1u)};
+						gpu_levels[level].resize(le.width * le.height);
+						exec_thread(downloader(DownloadImage::DownloadInfo{
+							.src = depth_pyramid.levelView(level),
+							.dst = gpu_levels[level].data(),
+							.size = gpu_levels[level].byte_size(),
+						}));
+					}
+
+					exec.endCommandBuffer(ptr_exec_thread);
+					exec.submit();
+					exec.endFrame();
+				}
+				// The downloads are copied to gpu_levels by the completion callbacks
+				exec.waitForAllCompletion();
+
+				const DepthMinMaxPyramid reference = DepthMinMaxPyramid::Build(depth.data(), extent, levels);
+				uint32_t errors = 0;
+				uint32_t first_error_level = levels;
+				for (uint32_t level = 0; level < levels; ++level)
+				{
+					const VkExtent2D le = reference.levelExtent(level);
+					for (uint32_t y = 0; y < le.height; ++y)
+					{
+						for (uint32_t x = 0; x < le.width; ++x)
+						{
+							if (gpu_levels[level][x + y * le.width] != reference.fetch(level, x, y))
+							{
+								++errors;
+								first_error_level = std::min(first_error_level, level);
+							}
+						}
+					}
+				}
+				const std::string msg = std::format("Depth pyramid {}x{}, {} levels: {} errors", extent.width, extent.height, levels, errors);
+				if (errors)
+				{
+					logger()(std::format("{} (from level {})", msg, first_error_level), Logger::Options::TagError);
+					res = false;
+				}
+				else
+				{
+					logger()(msg, Logger::Options::TagSuccess);
+				}
+			}
+			return res;
 		}
 
+	public:
+
 		virtual void run() final override
 		{
 			VkApplication::init();
 
+			if (options().headless && _benchmark.check_depth_pyramid)
+			{
+				checkDepthPyramid();
+				VK_CHECK(deviceWaitIdle(), "Failed to wait for completion.");
+				return;
+			}
+
+			if (options().headless)
+			{
+				runHeadless();
+				VK_CHECK(deviceWaitIdle(), "Failed to wait for completion.");
+				return;
+			}
+
 			_desired_window_options.name = PROJECT_NAME;
 			_desired_window_options.queue_families_indices = std::set<uint32_t>({desiredQueuesIndices()[0].family});
 			_desired_window_options.resizeable = true;
@@ -694,6 +1267,7 @@ namespace vkl
 				.app = this,
 				.name = "ResourcesManager",
 				.auto_file_check_period = 1s,
+				.parallel_update = _parallel_update,
 			};
 
 			LinearExecutor exec(LinearExecutor::CI{
@@ -868,6 +1442,9 @@ namespace vkl
 					ImGuiListSelection::Option{
 						.name = "Cornell Box Gem Show",
 					},
+					ImGuiListSelection::Option{
+						.name = "Instanced grid",
+					},
 				},
 			};
 			std::optional<uint> load_scene_index = {};
@@ -879,6 +1456,19 @@ namespace vkl
 				.memory = 256,
 			});
 			FramePerfCounters & frame_counters = perf_reporter->framePerfCounter();
+			memoryTelemetry().createStatRecords(*perf_reporter->statRecords());
+
+			// When the device memory gets tight, give back the excess from the streamed textures
+			const uint32_t over_budget_callback = memoryTelemetry().addOverBudgetCallback([this](MemoryTelemetry::OverBudget const& ob)
+			{
+				if (ob.budget.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+				{
+					const size_t min_budget = 64 * 1024 * 1024;
+					const size_t excess = ob.budget.usage - ob.threshold;
+					const size_t budget = textureFileCache().residencyBudget();
+					textureFileCache().setResidencyBudget(std::max(budget > excess ? budget - excess : 0, min_budget));
+				}
+			});
 
 			//for (int jid = 0; jid <= GLFW_JOYSTICK_LAST; ++jid)
 			//{
@@ -910,6 +1500,7 @@ namespace vkl
 
 			std::TickTock_hrc frame_tick_tock;
 			frame_tick_tock.tick();
+			size_t dynamic_value_evaluations = DynamicValueStats::LambdaEvaluations();
 
 			std::TickTock_hrc tt;
 			bool log = false;
@@ -1034,6 +1625,28 @@ namespace vkl
 					if(ImGui::Begin("Performances"))
 					{
 						perf_reporter->declareGUI(*gui_ctx);
+						bool use_frame_graph = exec.useFrameGraph();
+						if (ImGui::Checkbox("Frame graph (batched barriers)", &use_frame_graph))
+						{
+							exec.setUseFrameGraph(use_frame_graph);
+						}
+						bool parallel_update = resources_manager.parallelUpdate();
+						if (ImGui::Checkbox("Parallel resources update", &parallel_update))
+						{
+							resources_manager.setParallelUpdate(parallel_update);
+						}
+						if (ImGui::CollapsingHeader("Textures streaming"))
+						{
+							textureFileCache().declareGUI(*gui_ctx);
+						}
+						if (geometryArena() && ImGui::CollapsingHeader("Geometry arena"))
+						{
+							geometryArena()->declareGUI(*gui_ctx);
+						}
+						if (ImGui::CollapsingHeader("Device memory"))
+						{
+							memoryTelemetry().declareGUI(*gui_ctx);
+						}
 					}
 					ImGui::End();
 
@@ -1067,6 +1680,7 @@ namespace vkl
 				}
 
 				std::shared_ptr<UpdateContext> update_context = resources_manager.beginUpdateCycle();
+				update_context->setFramePerfCounters(&frame_counters);
 				{
 					getSamplerLibrary().updateResources(*update_context);
 					{
@@ -1085,15 +1699,26 @@ namespace vkl
 					frame_counters.exec_update_time = exec_tt.tockd().count();
 
 					renderer.preUpdate(*update_context);
+					if (GeometryArena * geometry_arena = geometryArena())
+					{
+						// Before the meshes: the relocated ones transmit their new ranges in the same frame
+						geometry_arena->updateResources(*update_context);
+					}
 					{
 						std::TickTock_hrc update_scene_tt;
 						update_scene_tt.tick();
 						scene->updateResources(*update_context);
 						frame_counters.update_scene_time = update_scene_tt.tockd().count();
 					}
+					textureFileCache().updateResources(*update_context);
 					
 					std::TickTock_hrc modules_tt;
 					modules_tt.tick();
+					{
+						// The G-buffer and AO sources are read after the renderer: their memory must not be aliased
+						const size_t picked = image_picker.index();
+						renderer.transientImages()->setSuspended(picked >= 2 && picked <= 5);
+					}
 					renderer.updateResources(*update_context);
 					color_correction.updateResources(*update_context);
 					pip.updateResources(*update_context);
@@ -1129,6 +1754,10 @@ namespace vkl
 						.index = 1, 
 						.set = scene->set(),
 					});
+					if (GeometryArena * geometry_arena = geometryArena())
+					{
+						geometry_arena->recordTransferIFN(exec_thread);
+					}
 					scene->prepareForRendering(exec_thread);
 					renderer.execute(exec_thread, t, dt, frame_index);
 
@@ -1194,11 +1823,18 @@ namespace vkl
 				frame_counters.frame_time = frame_tick_tock.tockd().count();
 				frame_tick_tock.tick();
 				{
+					const size_t evaluations = DynamicValueStats::LambdaEvaluations();
+					frame_counters.dynamic_value_evaluations = evaluations - dynamic_value_evaluations;
+					dynamic_value_evaluations = evaluations;
+				}
+				{
+					memoryTelemetry().sample();
 					perf_reporter->setFramePerfReport(exec.getPendingFrameReport());
 					perf_reporter->advance();
 				}
 			}
 			exec.waitForAllCompletion();
+			memoryTelemetry().removeOverBudgetCallback(over_budget_callback);
 
 			VK_CHECK(deviceWaitIdle(), "Failed to wait for completion.");
 
@@ -12,7 +12,9 @@
 #include <vkl/Execution/ThreadPool.hpp>
 
 #include <vkl/Utils/UniqueIndexAllocator.hpp>
+#include <vkl/Utils/RangeAllocator.hpp>
 #include <random>
+#include <bit>
 
 #include <that/math/Half.hpp>
 
@@ -20,6 +22,15 @@
 
 #include <vkl/Maths/Transforms.hpp>
 
+#include <vkl/Utils/ImageConversion.hpp>
+#include <vkl/Utils/TickTock.hpp>
+#include <vkl/Maths/BoundingVolumeHierarchy.hpp>
+#include <vkl/Maths/AABBTransform.hpp>
+#include <vkl/Maths/ViewCulling.hpp>
+#include <vkl/Utils/ShardedCache.hpp>
+#include <vkl/VkObjects/GenericCache.hpp>
+#include <that/img/ImRead.hpp>
+
 void TestUniqueIdAllocator()
 {
 	vkl::UniqueIndexAllocator pool(vkl::UniqueIndexAllocator::Policy::FitCapacity);
@@ -51,6 +62,85 @@ void TestUniqueIdAllocator()
 	}
 }
 
+void TestRangeAllocator(uint32_t iterations = 100'000)
+{
+	using namespace vkl;
+	using Offset = RangeAllocator::Offset;
+	const Offset capacity = 64 * 1024 * 1024;
+	RangeAllocator allocator(capacity);
+	std::mt19937 rng(42);
+	// Mesh like sizes and alignments (vertex size x storage buffer alignment)
+	std::uniform_int_distribution<Offset> size_distrib(256, 512 * 1024);
+	const Offset alignments[] = { 16, 64, 192, 256 };
+
+	std::vector<Offset> live;
+	size_t failed_allocations = 0;
+	bool ok = true;
+	for (uint32_t i = 0; i < iterations; ++i)
+	{
+		if (live.empty() || (rng() % 3) != 0)
+		{
+			const Offset alignment = alignments[rng() % std::size(alignments)];
+			const Offset offset = allocator.allocate(size_distrib(rng), alignment);
+			if (offset == RangeAllocator::InvalidOffset)
+			{
+				++failed_allocations;
+			}
+			else
+			{
+				ok &= (offset % alignment) == 0;
+				live.push_back(offset);
+			}
+		}
+		else
+		{
+			const size_t index = rng() % live.size();
+			allocator.release(live[index]);
+			live[index] = live.back();
+			live.pop_back();
+		}
+		if ((i % 1024) == 0)
+		{
+			ok &= allocator.checkIntegrity();
+		}
+	}
+
+	const auto print_stats = [](std::string_view label, RangeAllocator::Stats const& s)
+	{
+		std::cout << label << ": " << s.allocations << " allocations, " << (double(s.used) / double(s.capacity) * 100.0) << "% used, " << s.free_segments << " free segments, largest: " << s.largest_free_segment << ", fragmentation: " << s.fragmentation() << std::endl;
+	};
+	print_stats("Before compaction", allocator.stats());
+
+	// Some allocations stay in place
+	for (size_t i = 0; i < live.size(); i += 16)
+	{
+		allocator.setPinned(live[i], true);
+	}
+	const MyVector<RangeAllocator::Move> moves = allocator.compact();
+	ok &= allocator.checkIntegrity();
+	for (RangeAllocator::Move const& move : moves)
+	{
+		ok &= move.dst < move.src;
+		auto it = std::find(live.begin(), live.end(), move.src);
+		ok &= (it != live.end());
+		if (it != live.end())
+		{
+			*it = move.dst;
+		}
+	}
+	print_stats("After compaction", allocator.stats());
+
+	for (Offset offset : live)
+	{
+		ok &= allocator.isAllocated(offset);
+		allocator.release(offset);
+	}
+	const RangeAllocator::Stats end_stats = allocator.stats();
+	ok &= allocator.empty() && (end_stats.free_segments == 1) && (end_stats.largest_free_segment == capacity);
+
+	std::cout << "RangeAllocator: " << iterations << " operations, " << failed_allocations << " failed allocations, " << moves.size() << " moves: " << (ok ? "OK" : "FAILED") << std::endl;
+}
+
 void TestHalf()
 {
 	using float16_t = that::math::float16_t;
@@ -166,6 +256,594 @@ void StressTestParallelDynamicValue(int count = 1024)
 	}
 }
 
+// Measures the throughput of the texture loading conversion stage (RGB8 -> RGBA8 and RGBA8 -> RGBA32F)
+// on every image of a folder (e.g. assets/models/sponza)
+void BenchmarkImageConversion(std::filesystem::path const& folder, int iterations = 4)
+{
+	using namespace vkl;
+	DelayedTaskExecutor* pool = DelayedTaskExecutor::MakeNew(DelayedTaskExecutor::MakeInfo{
+		.multi_thread = true,
+		.n_threads = 0,
+	});
+
+	MyVector<that::img::FormatedImage> images;
+	for (auto const& entry : std::filesystem::recursive_directory_iterator(folder))
+	{
+		if (!entry.is_regular_file())	continue;
+		std::filesystem::path path = entry.path();
+		that::img::FormatedImage image;
+		that::img::io::ReadImageInfo read_info{
+			.path = &path,
+			.target = &image,
+		};
+		if (that::img::io::ReadFormatedImage(read_info) == that::Result::Success && image.format().elem_size == 1)
+		{
+			images.push_back(std::move(image));
+		}
+	}
+
+	const auto run = [&](uint32_t dst_elem_size, that::ElementType dst_type, DelayedTaskExecutor* executor)
+	{
+		size_t bytes = 0;
+		std::vector<uint8_t> dst;
+		std::TickTock<> tt;
+		std::chrono::nanoseconds total = {};
+		for (int it = 0; it < iterations; ++it)
+		{
+			for (const that::img::FormatedImage& image : images)
+			{
+				that::FormatInfo dst_format = image.format();
+				dst_format.channels = 4;
+				dst_format.elem_size = dst_elem_size;
+				dst_format.type = dst_type;
+				const size_t pixels = size_t(image.width()) * size_t(image.height());
+				dst.resize(pixels * dst_format.channels * dst_format.elem_size);
+				tt.tick();
+				ConvertImage(ImageConversionInfo{
+					.src = image.rawData(),
+					.src_format = image.format(),
+					.dst = dst.data(),
+					.dst_format = dst_format,
+					.pixel_count = pixels,
+					.executor = executor,
+				});
+				total += tt.tockd();
+				bytes += image.byteSize() + dst.size();
+			}
+		}
+		const double seconds = std::chrono::duration<double>(total).count();
+		return double(bytes) / (1024.0 * 1024.0) / std::max(seconds, 1e-9);
+	};
+
+	std::cout << "Image conversion on " << images.size() << " images from " << folder << std::endl;
+	std::cout << "  -> RGBA8,   1 thread : " << run(1, that::ElementType::sRGB, nullptr) << " MB/s" << std::endl;
+	std::cout << "  -> RGBA8,   parallel : " << run(1, that::ElementType::sRGB, pool) << " MB/s" << std::endl;
+	std::cout << "  -> RGBA32F, 1 thread : " << run(4, that::ElementType::FLOAT, nullptr) << " MB/s" << std::endl;
+	std::cout << "  -> RGBA32F, parallel : " << run(4, that::ElementType::FLOAT, pool) << " MB/s" << std::endl;
+
+	delete pool;
+}
+
+void BenchmarkBVH(std::vector<uint32_t> const& sizes = {10'000, 100'000, 1'000'000})
+{
+	using namespace vkl;
+	std::TickTock<> tt;
+	const auto ms = [&tt]() {return std::chrono::duration<double, std::milli>(tt.tockd()).count(); };
+	std::mt19937 rng(42);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	for (uint32_t n : sizes)
+	{
+		// Boxes scattered in a cube, with a constant density
+		const float scene_size = 10.0f * std::cbrt(float(n));
+		const auto random_box = [&]()
+		{
+			const Vector3f p(unit(rng) * scene_size, unit(rng) * scene_size, unit(rng) * scene_size);
+			const Vector3f e(0.5f + 2.0f * unit(rng), 0.5f + 2.0f * unit(rng), 0.5f + 2.0f * unit(rng));
+			return AABB3f(p - e, p + e);
+		};
+		MyVector<AABB3f> boxes(n);
+		for (AABB3f & b : boxes)	b = random_box();
+
+		BoundingVolumeHierarchy bvh;
+		tt.tick();
+		bvh.build(BoundingVolumeHierarchy::BuildInfo{ .boxes = boxes.data(), .count = n });
+		const double build_time = ms();
+
+		// Move 10% of the boxes
+		const uint32_t moved = n / 10;
+		tt.tick();
+		for (uint32_t i = 0; i < moved; ++i)
+		{
+			const uint32_t item = rng() % n;
+			const Vector3f offset(unit(rng) - 0.5f, unit(rng) - 0.5f, unit(rng) - 0.5f);
+			boxes[item] = AABB3f(boxes[item].bottom() + offset, boxes[item].top() + offset);
+			bvh.setItemBox(item, boxes[item]);
+		}
+		bvh.refit();
+		const double refit_time = ms();
+
+		const uint32_t queries = 1000;
+		size_t found = 0, found_linear = 0;
+		MyVector<AABB3f> query_boxes(queries);
+		for (AABB3f & q : query_boxes)
+		{
+			const Vector3f p(unit(rng) * scene_size, unit(rng) * scene_size, unit(rng) * scene_size);
+			q = AABB3f(p - Vector3f::Constant(10), p + Vector3f::Constant(10));
+		}
+
+		tt.tick();
+		for (AABB3f const& q : query_boxes)
+		{
+			bvh.queryAABB(q, [&](uint32_t) {++found; });
+		}
+		const double aabb_time = ms();
+
+		tt.tick();
+		for (AABB3f const& q : query_boxes)
+		{
+			const BVHBox qb = BVHBox::From(q);
+			for (AABB3f const& b : boxes)
+			{
+				found_linear += BoundingVolumeHierarchy::Overlap(BVHBox::From(b), qb) ? 1 : 0;
+			}
+		}
+		const double linear_time = ms();
+
+		size_t found_sphere = 0;
+		tt.tick();
+		for (AABB3f const& q : query_boxes)
+		{
+			bvh.querySphere(q.center(), 10.0f, [&](uint32_t) {++found_sphere; });
+		}
+		const double sphere_time = ms();
+
+		size_t found_frustum = 0;
+		tt.tick();
+		for (AABB3f const& q : query_boxes)
+		{
+			// Narrow frustum looking along +x
+			const Vector3f o = q.center();
+			FrustumPlanes frustum;
+			frustum.addPlane(Vector3f(1, 0, 0), -o[0] - 0.1f);
+			frustum.addPlane(Vector3f(0.1f, 1, 0), -Dot(Vector3f(0.1f, 1, 0), o));
+			frustum.addPlane(Vector3f(0.1f, -1, 0), -Dot(Vector3f(0.1f, -1, 0), o));
+			frustum.addPlane(Vector3f(0.1f, 0, 1), -Dot(Vector3f(0.1f, 0, 1), o));
+			frustum.addPlane(Vector3f(0.1f, 0, -1), -Dot(Vector3f(0.1f, 0, -1), o));
+			frustum.addPlane(Vector3f(-1, 0, 0), o[0] + 100.0f);
+			bvh.queryFrustum(frustum, [&](uint32_t) {++found_frustum; });
+		}
+		const double frustum_time = ms();
+
+		size_t rays_hit = 0;
+		tt.tick();
+		for (AABB3f const& q : query_boxes)
+		{
+			const BVHRay ray{
+				.origin = q.center(),
+				.direction = Normalize(Vector3f(unit(rng) - 0.5f, unit(rng) - 0.5f, unit(rng) - 0.5f)),
+			};
+			// Closest box
+			float closest = std::numeric_limits<float>::infinity();
+			bvh.queryRay(ray, [&](uint32_t, float t) {closest = std::min(closest, t); return closest; });
+			rays_hit += std::isfinite(closest) ? 1 : 0;
+		}
+		const double ray_time = ms();
+
+		std::cout << "BVH of " << n << " boxes: " << bvh.nodeCount() << " nodes, SAH cost " << bvh.builtSahCost() << " (" << bvh.sahCost() << " after refit)" << std::endl;
+		std::cout << "  Build: " << build_time << "ms, refit of " << moved << " moved boxes: " << refit_time << "ms" << std::endl;
+		std::cout << "  " << queries << " AABB queries: " << aabb_time << "ms (" << found << " found), linear: " << linear_time << "ms (" << found_linear << " found), x" << (linear_time / aabb_time) << std::endl;
+		std::cout << "  " << queries << " sphere queries: " << sphere_time << "ms (" << found_sphere << " found)" << std::endl;
+		std::cout << "  " << queries << " frustum queries: " << frustum_time << "ms (" << found_frustum << " found)" << std::endl;
+		std::cout << "  " << queries << " closest box rays: " << ray_time << "ms (" << rays_hit << " hits)" << std::endl;
+	}
+}
+
+void BenchmarkAABBTransform(size_t n = 1'000'000)
+{
+	using namespace vkl;
+	std::mt19937 rng(42);
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+	MyVector<AABB3f> boxes(n);
+	MyVector<Matrix3x4f> xforms(n);
+	for (size_t i = 0; i < n; ++i)
+	{
+		const Vector3f c(unit(rng), unit(rng), unit(rng));
+		const Vector3f e = Vector3f(unit(rng), unit(rng), unit(rng)).cwiseAbs();
+		boxes[i] = AABB3f(c - e, c + e);
+		for (int r = 0; r < 3; ++r)
+		{
+			for (int col = 0; col < 4; ++col)
+			{
+				xforms[i](r, col) = unit(rng) * (col == 3 ? 100.0f : 2.0f);
+			}
+		}
+	}
+	MyVector<AABB3f> results(n);
+
+	std::unique_ptr<DelayedTaskExecutor> pool = std::unique_ptr<DelayedTaskExecutor>(DelayedTaskExecutor::MakeNew(DelayedTaskExecutor::MakeInfo{
+		.multi_thread = true,
+		.n_threads = 0,
+	}));
+
+	std::TickTock<> tt;
+	const auto ms = [&tt]() {return std::chrono::duration<double, std::milli>(tt.tockd()).count(); };
+
+	tt.tick();
+	AABB3f corners = {};
+	for (size_t i = 0; i < n; ++i)
+	{
+		boxes[i].getContainingAABB(xforms[i], corners);
+	}
+	const double corners_time = ms();
+
+	tt.tick();
+	AABB3f scalar = {};
+	for (size_t i = 0; i < n; ++i)
+	{
+		scalar += TransformAABB(boxes[i], xforms[i]);
+	}
+	const double scalar_time = ms();
+
+	tt.tick();
+	const AABB3f simd = TransformAABBs(AABBTransformInfo{
+		.boxes = boxes.data(),
+		.xforms = xforms.data(),
+		.count = n,
+	});
+	const double simd_time = ms();
+
+	tt.tick();
+	const AABB3f simd_with_results = TransformAABBs(AABBTransformInfo{
+		.boxes = boxes.data(),
+		.xforms = xforms.data(),
+		.count = n,
+		.results = results.data(),
+	});
+	const double simd_results_time = ms();
+
+	tt.tick();
+	const AABB3f parallel = TransformAABBs(AABBTransformInfo{
+		.boxes = boxes.data(),
+		.xforms = xforms.data(),
+		.count = n,
+		.executor = pool.get(),
+	});
+	const double parallel_time = ms();
+
+	float max_error = 0;
+	const auto check = [&](AABB3f const& a, AABB3f const& b)
+	{
+		max_error = std::max(max_error, (a.bottom() - b.bottom()).cwiseAbs().maxCoeff());
+		max_error = std::max(max_error, (a.top() - b.top()).cwiseAbs().maxCoeff());
+	};
+	check(corners, scalar);
+	check(corners, simd);
+	check(corners, simd_with_results);
+	check(corners, parallel);
+	for (size_t i = 0; i < n; i += 997)
+	{
+		check(boxes[i].getContainingAABB(xforms[i]), results[i]);
+	}
+
+	std::cout << "Transform " << n << " AABBs and reduce (max error vs corners: " << max_error << ")" << std::endl;
+	std::cout << "  8 corners: " << corners_time << "ms" << std::endl;
+	std::cout << "  Center / extent scalar: " << scalar_time << "ms, x" << (corners_time / scalar_time) << std::endl;
+	std::cout << "  Center / extent SoA SIMD: " << simd_time << "ms, x" << (corners_time / simd_time) << " (" << simd_results_time << "ms writing the boxes)" << std::endl;
+	std::cout << "  Center / extent SoA SIMD, parallel: " << parallel_time << "ms, x" << (corners_time / parallel_time) << std::endl;
+}
+
+// Many loader threads looking up a few keys (like samplers or set layouts), the first lookups of each key create the value
+void BenchmarkCacheContention(uint32_t threads = std::thread::hardware_concurrency(), uint32_t keys = 64, uint32_t lookups = 1'000'000)
+{
+	using namespace vkl;
+	struct Value
+	{
+		uint32_t key;
+	};
+	std::atomic<uint32_t> creations = 0;
+	const auto create = [&](uint32_t key)
+	{
+		++creations;
+		// Like creating a Vulkan object
+		std::this_thread::sleep_for(std::chrono::microseconds(50));
+		return std::make_shared<Value>(Value{.key = key});
+	};
+
+	const auto run = [&](const char * name, auto const& lookup)
+	{
+		creations = 0;
+		std::atomic<uint32_t> errors = 0;
+		std::TickTock_hrc tt;
+		tt.tick();
+		{
+			MyVector<std::jthread> workers;
+			for (uint32_t t = 0; t < threads; ++t)
+			{
+				workers.push_back(std::jthread([&, t]()
+				{
+					std::mt19937 rng(t);
+					std::uniform_int_distribution<uint32_t> key_distribution(0, keys - 1);
+					for (uint32_t i = 0; i < lookups; ++i)
+					{
+						const uint32_t key = key_distribution(rng);
+						if (lookup(key)->key != key)
+						{
+							++errors;
+						}
+					}
+				}));
+			}
+		}
+		const double ms = std::chrono::duration<double, std::milli>(tt.tockd()).count();
+		std::cout << "  " << name << ": " << ms << "ms, " << creations << " creations, " << errors << " errors" << std::endl;
+	};
+
+	std::cout << "Cache contention: " << threads << " threads, " << keys << " keys, " << lookups << " lookups per thread" << std::endl;
+
+	{
+		std::mutex mutex;
+		std::unordered_map<uint32_t, std::shared_ptr<Value>> map;
+		run("Locked map", [&](uint32_t key)
+		{
+			std::unique_lock lock(mutex);
+			if (!map.contains(key))
+			{
+				map[key] = create(key);
+			}
+			return map[key];
+		});
+	}
+
+	{
+		GenericCacheImpl<uint32_t, Value> cache;
+		run("GenericCacheImpl (linear)", [&](uint32_t key)
+		{
+			return cache.findOrEmplace(key, [&]() {return create(key); });
+		});
+	}
+
+	{
+		struct HashedKey
+		{
+			uint32_t key;
+
+			constexpr bool operator==(HashedKey const& o) const
+			{
+				return key == o.key;
+			}
+
+			constexpr size_t hash() const
+			{
+				return key;
+			}
+		};
+		GenericCacheImpl<HashedKey, Value> cache;
+		run("GenericCacheImpl (hashed)", [&](uint32_t key)
+		{
+			return cache.findOrEmplace(HashedKey{.key = key}, [&]() {return create(key); });
+		});
+		const auto stats = cache.stats();
+		std::cout << "    " << stats.hits << " hits, " << stats.misses << " misses" << std::endl;
+	}
+
+	{
+		ShardedCache<uint32_t, Value> cache;
+		run("ShardedCache", [&](uint32_t key)
+		{
+			return cache.findOrEmplace(key, [&]() {return create(key); });
+		});
+	}
+}
+
+// The depth pyramid against the (min, max) of the level 0 texels covered by each texel,
+// and the 64x64 tiles of the single pass generation: each level of a tile only reads the previous level of the same tile
+// The GPU pass itself is checked against this reference by the Renderer: --headless --check_depth_pyramid
+void TestDepthPyramid(std::vector<VkExtent2D> const& extents = {{1, 1}, {7, 5}, {64, 64}, {127, 64}, {129, 65}, {333, 197}, {1000, 3}, {1920, 1080}})
+{
+	using namespace vkl;
+	std::mt19937 rng(42);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	for (VkExtent2D const& extent : extents)
+	{
+		MyVector<float> depth(extent.width * extent.height);
+		for (float& d : depth)	d = unit(rng);
+		const uint32_t levels = std::bit_width(std::max(extent.width, extent.height));
+		const DepthMinMaxPyramid pyramid = DepthMinMaxPyramid::Build(depth.data(), extent, levels);
+
+		uint32_t value_errors = 0;
+		for (uint32_t level = 0; level < levels; ++level)
+		{
+			const VkExtent2D le = pyramid.levelExtent(level);
+			for (uint32_t y = 0; y < le.height; ++y)
+			{
+				for (uint32_t x = 0; x < le.width; ++x)
+				{
+					// The last texel of a row (or column) covers the end of the level 0
+					const uint32_t x1 = (x == le.width - 1) ? extent.width - 1 : ((x + 1) << level) - 1;
+					const uint32_t y1 = (y == le.height - 1) ? extent.height - 1 : ((y + 1) << level) - 1;
+					Vector2f expected(1.0f, 0.0f);
+					for (uint32_t py = y << level; py <= y1; ++py)
+					{
+						for (uint32_t px = x << level; px <= x1; ++px)
+						{
+							const float d = depth[px + py * extent.width];
+							expected[0] = std::min(expected[0], d);
+							expected[1] = std::max(expected[1], d);
+						}
+					}
+					value_errors += (pyramid.fetch(level, x, y) != expected) ? 1 : 0;
+				}
+			}
+		}
+
+		// Tiles of the GPU pass, the last one of a row (or column) also covers the remaining texels
+		const uint32_t tiles_x = std::max(extent.width / 64, 1u);
+		const uint32_t tiles_y = std::max(extent.height / 64, 1u);
+		const auto tile_range = [&](uint32_t tile, uint32_t tiles, uint32_t size, uint32_t level)
+		{
+			const uint32_t level_size = std::max(size >> level, 1u);
+			const uint32_t begin = tile * (64 >> level);
+			const uint32_t end = (tile == tiles - 1) ? level_size : begin + (64 >> level);
+			return std::pair<uint32_t, uint32_t>(begin, end);
+		};
+		const auto tile_of = [&](uint32_t p, uint32_t tiles, uint32_t size, uint32_t level)
+		{
+			for (uint32_t t = 0; t < tiles; ++t)
+			{
+				const auto [b, e] = tile_range(t, tiles, size, level);
+				if (p >= b && p < e)	return t;
+			}
+			return tiles;
+		};
+		uint32_t tile_errors = 0;
+		for (uint32_t level = 1; level < std::min(levels, 7u); ++level)
+		{
+			for (uint32_t axis = 0; axis < 2; ++axis)
+			{
+				const uint32_t size = axis == 0 ? extent.width : extent.height;
+				const uint32_t tiles = axis == 0 ? tiles_x : tiles_y;
+				const uint32_t level_size = std::max(size >> level, 1u);
+				const uint32_t prev_size = std::max(size >> (level - 1), 1u);
+				for (uint32_t p = 0; p < level_size; ++p)
+				{
+					const uint32_t tile = tile_of(p, tiles, size, level);
+					const uint32_t p1 = (p == level_size - 1) ? prev_size - 1 : std::min(2 * p + 1, prev_size - 1);
+					for (uint32_t q = std::min(2 * p, prev_size - 1); q <= p1; ++q)
+					{
+						tile_errors += (tile_of(q, tiles, size, level - 1) != tile) ? 1 : 0;
+					}
+				}
+			}
+		}
+
+		std::cout << "Depth pyramid " << extent.width << "x" << extent.height << ", " << levels << " levels, " << tiles_x << "x" << tiles_y << " tiles: "
+			<< value_errors << " value errors, " << tile_errors << " tile errors" << std::endl;
+	}
+}
+
+// Conservativeness of the CPU reference of the GPU culling, with a standard and a reversed depth
+void TestViewCulling(uint32_t n = 100'000, VkExtent2D extent = VkExtent2D{.width = 333, .height = 197})
+{
+	using namespace vkl;
+	std::mt19937 rng(42);
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+	MyVector<AABB3f> boxes(n);
+	for (size_t i = 0; i < n; ++i)
+	{
+		const Vector3f c(unit(rng) * 30.0f, unit(rng) * 30.0f, unit(rng) * 60.0f + 40.0f);
+		const Vector3f e = Vector3f(unit(rng), unit(rng), unit(rng)).cwiseAbs() * 2.0f;
+		boxes[i] = AABB3f(c - e, c + e);
+	}
+
+	// Occluders layer: one depth per block of 16x16 pixels
+	MyVector<float> occluders_z(extent.width * extent.height);
+	{
+		std::uniform_real_distribution<float> z_distribution(10.0f, 200.0f);
+		const uint32_t blocks_x = std::divCeil(extent.width, 16u);
+		MyVector<float> block_z(blocks_x * std::divCeil(extent.height, 16u));
+		for (float& z : block_z)	z = z_distribution(rng);
+		for (uint32_t y = 0; y < extent.height; ++y)
+		{
+			for (uint32_t x = 0; x < extent.width; ++x)
+			{
+				occluders_z[x + y * extent.width] = block_z[(x / 16) + (y / 16) * blocks_x];
+			}
+		}
+	}
+
+	const Matrix3x4f identity = Matrix3x4f::Identity();
+
+	for (bool reverse_depth : {false, true})
+	{
+		// Camera at the origin looking at +Z, world = camera space
+		const float near = 0.1f, far = 150.0f, f = 1.5f, aspect = float(extent.width) / float(extent.height);
+		Matrix4f world_to_proj = Matrix4f::Zero();
+		world_to_proj(0, 0) = f / aspect;
+		world_to_proj(1, 1) = f;
+		world_to_proj(3, 2) = 1.0f;
+		if (reverse_depth)
+		{
+			world_to_proj(2, 2) = -near / (far - near);
+			world_to_proj(2, 3) = near * far / (far - near);
+		}
+		else
+		{
+			world_to_proj(2, 2) = far / (far - near);
+			world_to_proj(2, 3) = -near * far / (far - near);
+		}
+		const auto depth_of = [&](float z)
+		{
+			return (world_to_proj(2, 2) * z + world_to_proj(2, 3)) / z;
+		};
+
+		MyVector<float> depth(occluders_z.size());
+		for (size_t i = 0; i < occluders_z.size(); ++i)
+		{
+			depth[i] = std::clamp(depth_of(occluders_z[i]), 0.0f, 1.0f);
+		}
+		const uint32_t levels = std::bit_width(std::max(extent.width, extent.height));
+		const DepthMinMaxPyramid min_max_pyramid = DepthMinMaxPyramid::Build(depth.data(), extent, levels);
+		const DepthPyramidView pyramid = min_max_pyramid.farthestDepthView(reverse_depth);
+		const CullingView view = CullingView::Make(world_to_proj, reverse_depth, &pyramid);
+
+		uint32_t counts[3] = {0, 0, 0};
+		uint32_t frustum_errors = 0;
+		uint32_t occlusion_errors = 0;
+		std::TickTock_hrc tt;
+		tt.tick();
+		for (size_t i = 0; i < n; ++i)
+		{
+			const CullingResult result = CullObject(boxes[i], identity, view);
+			++counts[static_cast<uint32_t>(result)];
+		}
+		const double ms = std::chrono::duration<double, std::milli>(tt.tockd()).count();
+
+		for (size_t i = 0; i < n; ++i)
+		{
+			const AABB3f& box = boxes[i];
+			const CullingResult result = CullObject(box, identity, view);
+			if (result == CullingResult::OutsideFrustum)
+			{
+				// No point of the box may be inside the clip volume
+				for (uint32_t s = 0; s < 27; ++s)
+				{
+					const Vector3f t(float(s % 3) * 0.5f, float((s / 3) % 3) * 0.5f, float(s / 9) * 0.5f);
+					const Vector3f p = box.bottom() + t.cwiseProduct(box.top() - box.bottom());
+					const Vector4f clip = world_to_proj * Vector4f(p[0], p[1], p[2], 1.0f);
+					const float w = clip[3];
+					if (std::abs(clip[0]) < w && std::abs(clip[1]) < w && clip[2] > 0.0f && clip[2] < w)
+					{
+						++frustum_errors;
+						break;
+					}
+				}
+			}
+			else if (result == CullingResult::Occluded)
+			{
+				// Every texel of the footprint must be closer than the box
+				const ProjectedAABB projected = ProjectAABB(box, world_to_proj, reverse_depth);
+				const auto texel = [](float uv, uint32_t size) {return std::min(static_cast<uint32_t>(uv * static_cast<float>(size)), size - 1); };
+				bool error = false;
+				for (uint32_t y = texel(projected.uv_min[1], extent.height); y <= texel(projected.uv_max[1], extent.height); ++y)
+				{
+					for (uint32_t x = texel(projected.uv_min[0], extent.width); x <= texel(projected.uv_max[0], extent.width); ++x)
+					{
+						const float d = depth[x + y * extent.width];
+						error |= reverse_depth ? (d <= projected.closest_depth) : (d >= projected.closest_depth);
+					}
+				}
+				occlusion_errors += error ? 1 : 0;
+			}
+		}
+
+		std::cout << "View culling of " << n << " boxes (" << (reverse_depth ? "reversed" : "standard") << " depth, " << levels << " pyramid levels): " << ms << "ms" << std::endl;
+		std::cout << "  " << counts[0] << " visible, " << counts[1] << " outside the frustum, " << counts[2] << " occluded" << std::endl;
+		std::cout << "  " << frustum_errors << " frustum errors, " << occlusion_errors << " occlusion errors" << std::endl;
+	}
+}
 
 int main(int argc, const char** argv)
 {
@@ -193,6 +871,21 @@ int main(int argc, const char** argv)
 
 	//TestHalf();
 
+	//TestRangeAllocator();
+
+	//BenchmarkImageConversion("assets/models/sponza");
+
+
+	//BenchmarkBVH();
+
+	//BenchmarkAABBTransform();
+
+	//BenchmarkCacheContention();
+
+	//TestDepthPyramid();
+
+	//TestViewCulling();
+
 	Dyn<VkExtent3D> ex = makeUniformExtent3D(0);
 
 	Dyn<float> pi = 3.14f;
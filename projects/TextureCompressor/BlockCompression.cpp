@@ -0,0 +1,284 @@
+#include "BlockCompression.hpp"
+
+#include <cstring>
+#include <cmath>
+#include <array>
+
+namespace vkl
+{
+	namespace bc
+	{
+		namespace
+		{
+			uint16_t Pack565(const int * c)
+			{
+				const int r = (c[0] * 31 + 127) / 255;
+				const int g = (c[1] * 63 + 127) / 255;
+				const int b = (c[2] * 31 + 127) / 255;
+				return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+			}
+
+			void Unpack565(uint16_t c, int * res)
+			{
+				const int r = (c >> 11) & 31;
+				const int g = (c >> 5) & 63;
+				const int b = c & 31;
+				res[0] = (r << 3) | (r >> 2);
+				res[1] = (g << 2) | (g >> 4);
+				res[2] = (b << 3) | (b >> 2);
+			}
+
+			void WriteU16(uint8_t * dst, uint16_t v)
+			{
+				dst[0] = static_cast<uint8_t>(v & 0xFF);
+				dst[1] = static_cast<uint8_t>(v >> 8);
+			}
+		}
+
+		void EncodeBC1Block(const uint8_t * rgba, uint8_t * dst)
+		{
+			int min_c[3] = { 255, 255, 255 };
+			int max_c[3] = { 0, 0, 0 };
+			for (uint32_t i = 0; i < 16; ++i)
+			{
+				for (uint32_t c = 0; c < 3; ++c)
+				{
+					min_c[c] = std::min<int>(min_c[c], rgba[4 * i + c]);
+					max_c[c] = std::max<int>(max_c[c], rgba[4 * i + c]);
+				}
+			}
+			// Inset the bounding box to reduce the error of the interpolated colors
+			for (uint32_t c = 0; c < 3; ++c)
+			{
+				const int inset = (max_c[c] - min_c[c]) / 16;
+				min_c[c] += inset;
+				max_c[c] -= inset;
+			}
+
+			uint16_t c0 = Pack565(max_c);
+			uint16_t c1 = Pack565(min_c);
+			if (c0 < c1)
+			{
+				std::swap(c0, c1);
+			}
+			WriteU16(dst + 0, c0);
+			WriteU16(dst + 2, c1);
+
+			uint32_t indices = 0;
+			if (c0 != c1)
+			{
+				// 4 colors mode (c0 > c1)
+				int palette[4][3];
+				Unpack565(c0, palette[0]);
+				Unpack565(c1, palette[1]);
+				for (uint32_t c = 0; c < 3; ++c)
+				{
+					palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+					palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+				}
+				for (uint32_t i = 0; i < 16; ++i)
+				{
+					uint32_t best = 0;
+					int best_d = std::numeric_limits<int>::max();
+					for (uint32_t p = 0; p < 4; ++p)
+					{
+						int d = 0;
+						for (uint32_t c = 0; c < 3; ++c)
+						{
+							const int diff = int(rgba[4 * i + c]) - palette[p][c];
+							d += diff * diff;
+						}
+						if (d < best_d)
+						{
+							best_d = d;
+							best = p;
+						}
+					}
+					indices |= best << (2 * i);
+				}
+			}
+			std::memcpy(dst + 4, &indices, sizeof(indices));
+		}
+
+		void EncodeBC4Block(const uint8_t * rgba, uint32_t channel, uint8_t * dst)
+		{
+			int a0 = 0;
+			int a1 = 255;
+			for (uint32_t i = 0; i < 16; ++i)
+			{
+				a0 = std::max<int>(a0, rgba[4 * i + channel]);
+				a1 = std::min<int>(a1, rgba[4 * i + channel]);
+			}
+			dst[0] = static_cast<uint8_t>(a0);
+			dst[1] = static_cast<uint8_t>(a1);
+			uint64_t indices = 0;
+			if (a0 != a1)
+			{
+				// 8 values mode (a0 > a1): 0 -> a0, 1 -> a1, 2..7 -> interpolated from a0 to a1
+				std::array<int, 8> palette;
+				palette[0] = a0;
+				palette[1] = a1;
+				for (int k = 1; k < 7; ++k)
+				{
+					palette[k + 1] = ((7 - k) * a0 + k * a1 + 3) / 7;
+				}
+				for (uint32_t i = 0; i < 16; ++i)
+				{
+					const int v = rgba[4 * i + channel];
+					uint64_t best = 0;
+					int best_d = std::numeric_limits<int>::max();
+					for (uint32_t p = 0; p < 8; ++p)
+					{
+						const int d = std::abs(v - palette[p]);
+						if (d < best_d)
+						{
+							best_d = d;
+							best = p;
+						}
+					}
+					indices |= best << (3 * i);
+				}
+			}
+			for (uint32_t b = 0; b < 6; ++b)
+			{
+				dst[2 + b] = static_cast<uint8_t>((indices >> (8 * b)) & 0xFF);
+			}
+		}
+
+		void EncodeBC3Block(const uint8_t * rgba, uint8_t * dst)
+		{
+			EncodeBC4Block(rgba, 3, dst);
+			EncodeBC1Block(rgba, dst + 8);
+		}
+
+		void EncodeBC5Block(const uint8_t * rgba, uint8_t * dst)
+		{
+			EncodeBC4Block(rgba, 0, dst);
+			EncodeBC4Block(rgba, 1, dst + 8);
+		}
+
+		bool CanEncode(VkFormat format)
+		{
+			bool res = false;
+			switch (format)
+			{
+				case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+				case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+				case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+				case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+				case VK_FORMAT_BC3_UNORM_BLOCK:
+				case VK_FORMAT_BC3_SRGB_BLOCK:
+				case VK_FORMAT_BC4_UNORM_BLOCK:
+				case VK_FORMAT_BC5_UNORM_BLOCK:
+					res = true;
+				break;
+				default:
+				break;
+			}
+			return res;
+		}
+
+		std::vector<uint8_t> Encode(VkFormat format, const uint8_t * rgba, uint32_t width, uint32_t height)
+		{
+			std::vector<uint8_t> res;
+			if (!CanEncode(format))
+			{
+				return res;
+			}
+			const bool is_16_bytes = (format == VK_FORMAT_BC3_UNORM_BLOCK || format == VK_FORMAT_BC3_SRGB_BLOCK || format == VK_FORMAT_BC5_UNORM_BLOCK);
+			const size_t block_size = is_16_bytes ? 16 : 8;
+			const uint32_t bw = std::divCeil(width, 4u);
+			const uint32_t bh = std::divCeil(height, 4u);
+			res.resize(size_t(bw) * size_t(bh) * block_size);
+
+			uint8_t block[16 * 4];
+			for (uint32_t by = 0; by < bh; ++by)
+			{
+				for (uint32_t bx = 0; bx < bw; ++bx)
+				{
+					for (uint32_t y = 0; y < 4; ++y)
+					{
+						const uint32_t sy = std::min(by * 4 + y, height - 1);
+						for (uint32_t x = 0; x < 4; ++x)
+						{
+							const uint32_t sx = std::min(bx * 4 + x, width - 1);
+							std::memcpy(block + 4 * (y * 4 + x), rgba + 4 * (size_t(sy) * width + sx), 4);
+						}
+					}
+					uint8_t * dst = res.data() + (size_t(by) * bw + bx) * block_size;
+					switch (format)
+					{
+						case VK_FORMAT_BC3_UNORM_BLOCK:
+						case VK_FORMAT_BC3_SRGB_BLOCK:
+							EncodeBC3Block(block, dst);
+						break;
+						case VK_FORMAT_BC4_UNORM_BLOCK:
+							EncodeBC4Block(block, 0, dst);
+						break;
+						case VK_FORMAT_BC5_UNORM_BLOCK:
+							EncodeBC5Block(block, dst);
+						break;
+						default:
+							EncodeBC1Block(block, dst);
+						break;
+					}
+				}
+			}
+			return res;
+		}
+
+		std::vector<uint8_t> DownsampleRGBA8(const uint8_t * rgba, uint32_t width, uint32_t height, bool srgb)
+		{
+			static const std::array<float, 256> s_srgb_to_linear = []()
+			{
+				std::array<float, 256> res;
+				for (uint32_t i = 0; i < 256; ++i)
+				{
+					const float c = float(i) / 255.0f;
+					res[i] = (c <= 0.04045f) ? (c / 12.92f) : std::pow((c + 0.055f) / 1.055f, 2.4f);
+				}
+				return res;
+			}();
+			const auto linear_to_srgb = [](float c)
+			{
+				const float s = (c <= 0.0031308f) ? (c * 12.92f) : (1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f);
+				return static_cast<uint8_t>(std::clamp(s, 0.0f, 1.0f) * 255.0f + 0.5f);
+			};
+
+			const uint32_t w = std::max(width / 2, 1u);
+			const uint32_t h = std::max(height / 2, 1u);
+			std::vector<uint8_t> res(size_t(w) * size_t(h) * 4);
+			for (uint32_t y = 0; y < h; ++y)
+			{
+				const uint32_t y0 = std::min(2 * y, height - 1);
+				const uint32_t y1 = std::min(2 * y + 1, height - 1);
+				for (uint32_t x = 0; x < w; ++x)
+				{
+					const uint32_t x0 = std::min(2 * x, width - 1);
+					const uint32_t x1 = std::min(2 * x + 1, width - 1);
+					const uint8_t * p[4] = {
+						rgba + 4 * (size_t(y0) * width + x0),
+						rgba + 4 * (size_t(y0) * width + x1),
+						rgba + 4 * (size_t(y1) * width + x0),
+						rgba + 4 * (size_t(y1) * width + x1),
+					};
+					uint8_t * d = res.data() + 4 * (size_t(y) * w + x);
+					for (uint32_t c = 0; c < 4; ++c)
+					{
+						// Alpha is always linear
+						if (srgb && c < 3)
+						{
+							const float l = 0.25f * (s_srgb_to_linear[p[0][c]] + s_srgb_to_linear[p[1][c]] + s_srgb_to_linear[p[2][c]] + s_srgb_to_linear[p[3][c]]);
+							d[c] = linear_to_srgb(l);
+						}
+						else
+						{
+							d[c] = static_cast<uint8_t>((uint32_t(p[0][c]) + p[1][c] + p[2][c] + p[3][c] + 2) / 4);
+						}
+					}
+				}
+			}
+			return res;
+		}
+	}
+}
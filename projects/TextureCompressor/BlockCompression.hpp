@@ -0,0 +1,29 @@
+#pragma once
+
+#include <vkl/Core/VulkanCommons.hpp>
+
+namespace vkl
+{
+	// Simple (bounding box) BCn encoders, fast and good enough for offline caches of textures
+	// Blocks are 4x4 RGBA8 pixels, row major
+	namespace bc
+	{
+		void EncodeBC1Block(const uint8_t * rgba, uint8_t * dst);
+
+		void EncodeBC4Block(const uint8_t * rgba, uint32_t channel, uint8_t * dst);
+
+		void EncodeBC3Block(const uint8_t * rgba, uint8_t * dst);
+
+		void EncodeBC5Block(const uint8_t * rgba, uint8_t * dst);
+
+		// BC1, BC3, BC4 and BC5 (UNORM or sRGB, the sRGB tag does not change the encoding)
+		bool CanEncode(VkFormat format);
+
+		// rgba: tightly packed RGBA8 image, edges are clamped for partial blocks
+		// Returns the blocks, row major
+		std::vector<uint8_t> Encode(VkFormat format, const uint8_t * rgba, uint32_t width, uint32_t height);
+
+		// 2x2 box filter (in linear space if srgb) of a RGBA8 image
+		std::vector<uint8_t> DownsampleRGBA8(const uint8_t * rgba, uint32_t width, uint32_t height, bool srgb);
+	}
+}
@@ -0,0 +1,297 @@
+#define SDL_MAIN_HANDLED
+
+// Offline converter: writes a block compressed DDS (with its mip chain) next to each source image
+// TextureFileCache loads them instead of the source images when they are up to date
+
+#include <vkl/Core/VulkanCommons.hpp>
+#include <vkl/IO/CompressedImage.hpp>
+#include <vkl/Utils/ImageConversion.hpp>
+#include <vkl/Execution/ThreadPool.hpp>
+
+#include <that/img/ImRead.hpp>
+#include <that/IO/File.hpp>
+
+#include <vulkan/vk_enum_string_helper.h>
+
+#include <argparse/argparse.hpp>
+
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <format>
+
+#include "BlockCompression.hpp"
+
+namespace vkl
+{
+	struct ConvertOptions
+	{
+		bool force = false;
+		bool linear = false;
+		bool normal_map = false;
+	};
+
+	struct ConvertStats
+	{
+		bool converted = false;
+		std::string message = {};
+		size_t source_file_size = 0;
+		// Uncompressed RGBA8 with all mips, as TextureFromFile would allocate it
+		size_t uncompressed_size = 0;
+		size_t compressed_size = 0;
+		std::chrono::duration<double, std::milli> decode_time = {};
+		std::chrono::duration<double, std::milli> encode_time = {};
+		std::chrono::duration<double, std::milli> compressed_load_time = {};
+	};
+
+	static bool IsSourceImage(std::filesystem::path const& path)
+	{
+		std::string ext = path.extension().string();
+		std::transform(ext.begin(), ext.end(), ext.begin(), [](char c) {return static_cast<char>(std::tolower(c)); });
+		return ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".tga" || ext == ".bmp";
+	}
+
+	static VkFormat ChooseFormat(that::img::FormatedImage const& image, const uint8_t * rgba, ConvertOptions const& options)
+	{
+		VkFormat res = VK_FORMAT_UNDEFINED;
+		const uint32_t channels = image.format().channels;
+		if (options.normal_map || channels == 2)
+		{
+			res = VK_FORMAT_BC5_UNORM_BLOCK;
+		}
+		else if (channels == 1)
+		{
+			res = VK_FORMAT_BC4_UNORM_BLOCK;
+		}
+		else
+		{
+			bool opaque = true;
+			if (channels == 4)
+			{
+				const size_t pixels = size_t(image.width()) * size_t(image.height());
+				for (size_t i = 0; i < pixels && opaque; ++i)
+				{
+					opaque = rgba[4 * i + 3] == 255;
+				}
+			}
+			if (opaque)
+			{
+				res = options.linear ? VK_FORMAT_BC1_RGB_UNORM_BLOCK : VK_FORMAT_BC1_RGB_SRGB_BLOCK;
+			}
+			else
+			{
+				res = options.linear ? VK_FORMAT_BC3_UNORM_BLOCK : VK_FORMAT_BC3_SRGB_BLOCK;
+			}
+		}
+		return res;
+	}
+
+	static ConvertStats ConvertFile(std::filesystem::path const& src_path, ConvertOptions const& options, DelayedTaskExecutor * executor)
+	{
+		using Clock = std::chrono::high_resolution_clock;
+		ConvertStats res;
+		std::filesystem::path dst_path = src_path;
+		dst_path.replace_extension(".dds");
+
+		if (!options.force && std::filesystem::exists(dst_path) && std::filesystem::last_write_time(dst_path) >= std::filesystem::last_write_time(src_path))
+		{
+			res.message = "up to date";
+			return res;
+		}
+		res.source_file_size = std::filesystem::file_size(src_path);
+
+		auto t0 = Clock::now();
+		std::filesystem::path path = src_path;
+		that::img::FormatedImage image;
+		that::img::io::ReadImageInfo read_info{
+			.path = &path,
+			.target = &image,
+		};
+		if (that::img::io::ReadFormatedImage(read_info) != that::Result::Success)
+		{
+			res.message = "could not read the image";
+			return res;
+		}
+		const uint32_t width = static_cast<uint32_t>(image.width());
+		const uint32_t height = static_cast<uint32_t>(image.height());
+		that::FormatInfo rgba8_format{
+			.type = that::ElementType::UNORM,
+			.elem_size = 1,
+			.channels = 4,
+		};
+		std::vector<uint8_t> rgba(size_t(width) * size_t(height) * 4);
+		const bool converted = ConvertImage(ImageConversionInfo{
+			.src = image.rawData(),
+			.src_format = image.format(),
+			.dst = rgba.data(),
+			.dst_format = rgba8_format,
+			.pixel_count = size_t(width) * size_t(height),
+			.executor = executor,
+		});
+		if (!converted)
+		{
+			res.message = "unsupported pixel format";
+			return res;
+		}
+		auto t1 = Clock::now();
+		res.decode_time = t1 - t0;
+
+		const VkFormat format = ChooseFormat(image, rgba.data(), options);
+		const bool srgb = (format == VK_FORMAT_BC1_RGB_SRGB_BLOCK || format == VK_FORMAT_BC3_SRGB_BLOCK);
+		const VkExtent3D extent = { .width = width, .height = height, .depth = 1 };
+
+		std::vector<std::vector<uint8_t>> mips;
+		{
+			std::vector<uint8_t> level = std::move(rgba);
+			uint32_t w = width, h = height;
+			while (true)
+			{
+				res.uncompressed_size += level.size();
+				mips.push_back(bc::Encode(format, level.data(), w, h));
+				res.compressed_size += mips.back().size();
+				if (w == 1 && h == 1)
+				{
+					break;
+				}
+				level = bc::DownsampleRGBA8(level.data(), w, h, srgb);
+				w = std::max(w / 2, 1u);
+				h = std::max(h / 2, 1u);
+			}
+		}
+
+		DDSWriteInfo write_info{
+			.format = format,
+			.extent = extent,
+		};
+		for (std::vector<uint8_t> const& mip : mips)
+		{
+			write_info.mips.push_back(std::span<const uint8_t>(mip.data(), mip.size()));
+		}
+		const std::string dds = SerializeDDS(write_info);
+		{
+			std::ofstream file(dst_path, std::ios::binary | std::ios::trunc);
+			if (!file)
+			{
+				res.message = std::format("could not write {}", dst_path.string());
+				return res;
+			}
+			file.write(dds.data(), dds.size());
+		}
+		auto t2 = Clock::now();
+		res.encode_time = t2 - t1;
+
+		// Time TextureFromFile takes to get the compressed data ready to upload
+		{
+			std::string content;
+			CompressedImage loaded;
+			if (that::ReadFileToString(dst_path, content) == that::Result::Success && ParseCompressedImage(std::move(content), CompressedImageContainer::DDS, loaded))
+			{
+				res.compressed_load_time = Clock::now() - t2;
+			}
+		}
+
+		res.converted = true;
+		res.message = std::format("{}, {} mips", string_VkFormat(format), mips.size());
+		return res;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	using namespace vkl;
+	argparse::ArgumentParser args(PROJECT_NAME);
+	// Converts images to block compressed DDS (BC1 / BC3 / BC4 / BC5) with a full mip chain, written next to the source images
+	args.add_argument("--force")
+		.help("Convert even if the DDS is up to date")
+		.default_value(false)
+		.implicit_value(true)
+	;
+	args.add_argument("--linear")
+		.help("Use UNORM instead of sRGB for color images")
+		.default_value(false)
+		.implicit_value(true)
+	;
+	args.add_argument("--normal")
+		.help("Encode the RG channels to BC5 (normal maps)")
+		.default_value(false)
+		.implicit_value(true)
+	;
+	args.add_argument("inputs")
+		.help("Image files or folders (searched recursively)")
+		.remaining()
+	;
+
+	try
+	{
+		args.parse_args(argc, argv);
+	}
+	catch (std::exception const& e)
+	{
+		std::cerr << e.what() << std::endl;
+		std::cerr << args << std::endl;
+		return -1;
+	}
+
+	const ConvertOptions options{
+		.force = args.get<bool>("--force"),
+		.linear = args.get<bool>("--linear"),
+		.normal_map = args.get<bool>("--normal"),
+	};
+
+	std::vector<std::filesystem::path> files;
+	for (std::string const& input : args.get<std::vector<std::string>>("inputs"))
+	{
+		const std::filesystem::path p = input;
+		if (std::filesystem::is_directory(p))
+		{
+			for (auto const& entry : std::filesystem::recursive_directory_iterator(p))
+			{
+				if (entry.is_regular_file() && IsSourceImage(entry.path()))
+				{
+					files.push_back(entry.path());
+				}
+			}
+		}
+		else if (std::filesystem::is_regular_file(p))
+		{
+			files.push_back(p);
+		}
+	}
+
+	std::unique_ptr<DelayedTaskExecutor> pool = std::unique_ptr<DelayedTaskExecutor>(DelayedTaskExecutor::MakeNew(DelayedTaskExecutor::MakeInfo{
+		.multi_thread = true,
+		.n_threads = 0,
+	}));
+
+	ConvertStats total;
+	size_t converted_count = 0;
+	const double MiB = 1024.0 * 1024.0;
+	for (std::filesystem::path const& file : files)
+	{
+		const ConvertStats stats = ConvertFile(file, options, pool.get());
+		std::cout << file.string() << ": " << stats.message << std::endl;
+		if (stats.converted)
+		{
+			++converted_count;
+			std::cout << std::format("    file {:.2f} MiB, RGBA8 + mips {:.2f} MiB -> compressed {:.2f} MiB | decode {:.1f} ms, encode {:.1f} ms, compressed load {:.1f} ms",
+				double(stats.source_file_size) / MiB, double(stats.uncompressed_size) / MiB, double(stats.compressed_size) / MiB,
+				stats.decode_time.count(), stats.encode_time.count(), stats.compressed_load_time.count()) << std::endl;
+			total.source_file_size += stats.source_file_size;
+			total.uncompressed_size += stats.uncompressed_size;
+			total.compressed_size += stats.compressed_size;
+			total.decode_time += stats.decode_time;
+			total.encode_time += stats.encode_time;
+			total.compressed_load_time += stats.compressed_load_time;
+		}
+	}
+
+	if (converted_count > 0)
+	{
+		std::cout << std::format("Converted {} / {} images", converted_count, files.size()) << std::endl;
+		std::cout << std::format("    Source files: {:.2f} MiB, VRAM uncompressed (RGBA8 + mips): {:.2f} MiB, VRAM compressed: {:.2f} MiB ({:.1f}x smaller)",
+			double(total.source_file_size) / MiB, double(total.uncompressed_size) / MiB, double(total.compressed_size) / MiB, double(total.uncompressed_size) / std::max(double(total.compressed_size), 1.0)) << std::endl;
+		std::cout << std::format("    Load time: decoding sources {:.1f} ms (+ runtime mips generation), reading compressed {:.1f} ms",
+			total.decode_time.count(), total.compressed_load_time.count()) << std::endl;
+	}
+	return 0;
+}
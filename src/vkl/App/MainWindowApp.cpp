@@ -40,7 +40,7 @@ namespace vkl
 	VkApplication::DesiredQueuesInfo MainWindowApp::getDesiredQueuesInfo()
 	{
 		DesiredQueuesInfo res = VkApplication::getDesiredQueuesInfo();
-		res.need_presentation = true;
+		res.need_presentation = !_options.headless;
 		return res;
 	}
 }
\ No newline at end of file
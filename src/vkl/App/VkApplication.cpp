@@ -7,10 +7,13 @@
 #include <vkl/VkObjects/Queue.hpp>
 #include <vkl/VkObjects/DescriptorSetLayout.hpp>
 #include <vkl/VkObjects/VulkanExtensionsSet.hpp>
+#include <vkl/VkObjects/Shader.hpp>
 
 #include <vkl/Execution/SamplerLibrary.hpp>
+#include <vkl/Execution/MemoryTelemetry.hpp>
 
 #include <vkl/Rendering/TextureFromFile.hpp>
+#include <vkl/Rendering/GeometryArena.hpp>
 
 #include <vkl/Commands/PrebuiltTransferCommands.hpp>
 
@@ -89,6 +92,18 @@ namespace vkl
 			.scan<'d', int>()
 		;
 
+		args.add_argument("--headless")
+			.help("Run without window nor presentation (no video subsystem, no surface and swapchain extensions)")
+			.default_value(false)
+			.implicit_value(true)
+		;
+
+		args.add_argument("--geometry_arena")
+			.help("Sub-allocate the meshes from shared geometry buffers (0: one buffer per mesh)")
+			.default_value(1)
+			.scan<'d', int>()
+		;
+
 		args.add_argument("--image_layout")
 			.help("Select which image layout to use, possible values are: 'specific', 'general', 'auto' or a bit mask per usage (0 for specfic, 1 for general)")
 			.default_value("specific")
@@ -189,6 +204,7 @@ namespace vkl
 			VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME,
 			VK_EXT_ROBUSTNESS_2_EXTENSION_NAME,
 			VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME,
+			VK_EXT_MEMORY_BUDGET_EXTENSION_NAME,
 			
 			VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME,
 			VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME,
@@ -210,6 +226,7 @@ namespace vkl
 		const VkBool32 f = VK_FALSE;
 		
 		features.features_13.synchronization2 = t;
+		features.features_12.timelineSemaphore = t;
 		features.swapchain_maintenance1_ext.swapchainMaintenance1 = t;
 		features.present_id_khr.presentId = t;
 
@@ -222,9 +239,12 @@ namespace vkl
 		features.features2.features.geometryShader = t;
 
 		features.features2.features.samplerAnisotropy = t;
+		features.features2.features.shaderStorageImageExtendedFormats = t; // rg32f storage (depth pyramid)
+		features.features2.features.textureCompressionBC = t;
 		features.features_12.samplerMirrorClampToEdge = t;
 
 		features.features2.features.multiDrawIndirect = t;
+		features.features_12.drawIndirectCount = t;
 		features.features_11.shaderDrawParameters = t;
 
 
@@ -276,17 +296,24 @@ namespace vkl
 
 	std::set<std::string_view> VkApplication::getInstanceExtensions()
 	{
-		uint32_t sdl_ext_count = 0;
-		const char* const * sdl_extensions_ptr = SDL_Vulkan_GetInstanceExtensions(&sdl_ext_count);
-		std::set<std::string_view> res(sdl_extensions_ptr, sdl_extensions_ptr + sdl_ext_count);
+		std::set<std::string_view> res;
+		if (!_options.headless)
+		{
+			uint32_t sdl_ext_count = 0;
+			const char* const * sdl_extensions_ptr = SDL_Vulkan_GetInstanceExtensions(&sdl_ext_count);
+			res.insert(sdl_extensions_ptr, sdl_extensions_ptr + sdl_ext_count);
+		}
 		
 		if (_options.enable_validation || _options.enable_object_naming || _options.enable_command_buffer_labels)
 		{
 			res.insert(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
 		}
-		res.insert(VK_EXT_SWAPCHAIN_COLOR_SPACE_EXTENSION_NAME);
-		res.insert(VK_KHR_GET_SURFACE_CAPABILITIES_2_EXTENSION_NAME);
-		res.insert(VK_EXT_SURFACE_MAINTENANCE_1_EXTENSION_NAME);
+		if (!_options.headless)
+		{
+			res.insert(VK_EXT_SWAPCHAIN_COLOR_SPACE_EXTENSION_NAME);
+			res.insert(VK_KHR_GET_SURFACE_CAPABILITIES_2_EXTENSION_NAME);
+			res.insert(VK_EXT_SURFACE_MAINTENANCE_1_EXTENSION_NAME);
+		}
 		
 		return res;
 	}
@@ -587,6 +614,8 @@ namespace vkl
 		res &= candidate.props.props2.properties.apiVersion >= min_version;
 
 		res &= candidate.features.features_13.synchronization2 != VK_FALSE;
+		// Used by the executors to track the submissions
+		res &= candidate.features.features_12.timelineSemaphore != VK_FALSE;
 
 		return res;
 	}
@@ -880,6 +909,11 @@ namespace vkl
 		{
 			flags |= VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
 		}
+		if (_device_extensions->contains(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME))
+		{
+			// Budgets reported by the driver, instead of estimated
+			flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+		}
 		VmaAllocatorCreateInfo alloc_ci{
 			.flags = flags,
 			.physicalDevice = _physical_device,
@@ -888,6 +922,11 @@ namespace vkl
 			.vulkanApiVersion = VK_API_VERSION_1_3,
 		};
 		vmaCreateAllocator(&alloc_ci, &_allocator);
+
+		_memory_telemetry = std::make_unique<MemoryTelemetry>(MemoryTelemetry::CI{
+			.app = this,
+			.name = "MemoryTelemetry",
+		});
 	}
 
 	void VkApplication::nameVkObjectIFP(VkDebugUtilsObjectNameInfoEXT const& object_to_name)
@@ -1150,15 +1189,22 @@ namespace vkl
 	void VkApplication::initSDL()
 	{
 		uint32_t init = 0;
-		init |= SDL_INIT_VIDEO;
+		// Headless: no display is needed (eg CI machines with a software Vulkan implementation)
+		if (!_options.headless)
+		{
+			init |= SDL_INIT_VIDEO;
+			init |= SDL_INIT_GAMEPAD;
+		}
 		init |= SDL_INIT_EVENTS;
-		init |= SDL_INIT_GAMEPAD;
 		if (!SDL_Init(init))
 		{
 			std::cout << SDL_GetError() << std::endl;
 			exit(-1);
 		}
-		SDL_Vulkan_LoadLibrary(nullptr);
+		if (!_options.headless)
+		{
+			SDL_Vulkan_LoadLibrary(nullptr);
+		}
 	}
 
 	VkApplication::VkApplication(CreateInfo const& ci) :
@@ -1190,6 +1236,8 @@ namespace vkl
 			.shaderc_optimization_level = ci.args.get<int>("--shaderc_optimization_level"),
 			.slang_optiomization_level = ci.args.get<int>("--slang_optimization_level"),
 		};
+		_options.headless = ci.args.get<bool>("--headless");
+		_options.use_geometry_arena = intToBool(ci.args.get<int>("--geometry_arena"));
 
 		std::string arg_image_layout = ci.args.get<std::string>("image_layout");
 		_options.use_general_image_layout_bits = 0;
@@ -1279,6 +1327,19 @@ namespace vkl
 			.name = "TextureFileCache",
 		});
 
+		if (_options.use_geometry_arena)
+		{
+			_geometry_arena = std::make_unique<GeometryArena>(GeometryArena::CI{
+				.app = this,
+				.name = "GeometryArena",
+			});
+		}
+
+		_shader_instance_registry = std::make_unique<ShaderInstanceRegistry>(ShaderInstanceRegistry::CI{
+			.app = this,
+			.name = "ShaderInstanceRegistry",
+		});
+
 		_prebuilt_transfer_commands = std::make_unique<PrebuilTransferCommands>(this);		
 	}
 
@@ -1294,6 +1355,8 @@ namespace vkl
 
 		_prebuilt_transfer_commands.reset();
 		_texture_file_cache.reset();
+		_geometry_arena.reset();
+		_shader_instance_registry.reset();
 		_sampler_library.reset();
 
 		_empty_set_layout = nullptr;
@@ -1317,7 +1380,10 @@ namespace vkl
 
 		vkDestroyInstance(_instance, nullptr);
 
-		SDL_Vulkan_UnloadLibrary();
+		if (!_options.headless)
+		{
+			SDL_Vulkan_UnloadLibrary();
+		}
 		SDL_Quit();
 		
 		_dependencies_tracker.reset();
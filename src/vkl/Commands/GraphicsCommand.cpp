@@ -523,6 +523,13 @@ namespace vkl
 		CommandBuffer & cmd = *ctx.getCommandBuffer();
 		const uint32_t set_index = application()->descriptorBindingGlobalOptions().set_bindings[static_cast<uint32_t>(DescriptorSetName::invocation)].set;
 		const std::shared_ptr<PipelineLayoutInstance>& layout = _pipeline->program()->pipelineLayout();
+
+		// Binds of the previous draw
+		VkBuffer bound_index_buffer = VK_NULL_HANDLE;
+		VkDeviceSize bound_index_offset = 0;
+		VkIndexType bound_index_type = VK_INDEX_TYPE_MAX_ENUM;
+		_vb_bind.clear();
+		_vb_offsets.clear();
 		
 		for (DrawCallInfo& to_draw : _draw_list)
 		{
@@ -544,19 +551,32 @@ namespace vkl
 			if (to_draw.index_buffer.buffer)
 			{
 				const BufferAndRangeInstance & bari = to_draw.index_buffer;
-				vkCmdBindIndexBuffer(cmd, bari.buffer->handle(), bari.range.begin, to_draw.index_type);
+				const VkBuffer handle = bari.buffer->handle();
+				// Draws of meshes of the same geometry arena block share the binds
+				if (handle != bound_index_buffer || bari.range.begin != bound_index_offset || to_draw.index_type != bound_index_type)
+				{
+					vkCmdBindIndexBuffer(cmd, handle, bari.range.begin, to_draw.index_type);
+					bound_index_buffer = handle;
+					bound_index_offset = bari.range.begin;
+					bound_index_type = to_draw.index_type;
+				}
 			}
 			if (to_draw.num_vertex_buffers > 0)
 			{
+				bool same_vertex_buffers = (to_draw.num_vertex_buffers == _vb_bind.size());
 				_vb_bind.resize(to_draw.num_vertex_buffers);
 				_vb_offsets.resize(to_draw.num_vertex_buffers);
 				for (size_t i = 0; i < _vb_bind.size(); ++i)
 				{
 					const BufferAndRangeInstance & bari = _vertex_buffers.data()[to_draw.vertex_buffer_begin + i];
+					same_vertex_buffers &= (_vb_bind[i] == bari.buffer->handle()) && (_vb_offsets[i] == bari.range.begin);
 					_vb_bind[i] = bari.buffer->handle();
 					_vb_offsets[i] = bari.range.begin;
 				}
-				vkCmdBindVertexBuffers(cmd, 0, to_draw.num_vertex_buffers, _vb_bind.data(), _vb_offsets.data());
+				if (!same_vertex_buffers)
+				{
+					vkCmdBindVertexBuffers(cmd, 0, to_draw.num_vertex_buffers, _vb_bind.data(), _vb_offsets.data());
+				}
 			}
 
 			switch (_draw_type)
@@ -565,7 +585,7 @@ namespace vkl
 				vkCmdDraw(cmd, to_draw.draw_count, to_draw.instance_count, 0, 0);
 				break;
 			case DrawType::DrawIndexed:
-				vkCmdDrawIndexed(cmd, to_draw.draw_count, to_draw.instance_count, 0, 0, 0);
+				vkCmdDrawIndexed(cmd, to_draw.draw_count, to_draw.instance_count, to_draw.first_index, to_draw.vertex_offset, 0);
 				break;
 			case DrawType::IndirectDraw:
 				vkCmdDrawIndirect(cmd, to_draw.indirect_draw_buffer.buffer->handle(), to_draw.indirect_draw_buffer.range.begin, to_draw.draw_count, to_draw.indirect_draw_stride);
@@ -573,6 +593,12 @@ namespace vkl
 			case DrawType::IndirectDrawIndexed:
 				vkCmdDrawIndexedIndirect(cmd, to_draw.indirect_draw_buffer.buffer->handle(), to_draw.indirect_draw_buffer.range.begin, to_draw.draw_count, to_draw.indirect_draw_stride);
 				break;
+			case DrawType::IndirectDrawCount:
+				vkCmdDrawIndirectCount(cmd, to_draw.indirect_draw_buffer.buffer->handle(), to_draw.indirect_draw_buffer.range.begin, to_draw.indirect_draw_count_buffer.buffer->handle(), to_draw.indirect_draw_count_buffer.range.begin, to_draw.draw_count, to_draw.indirect_draw_stride);
+				break;
+			case DrawType::IndirectDrawCountIndexed:
+				vkCmdDrawIndexedIndirectCount(cmd, to_draw.indirect_draw_buffer.buffer->handle(), to_draw.indirect_draw_buffer.range.begin, to_draw.indirect_draw_count_buffer.buffer->handle(), to_draw.indirect_draw_count_buffer.range.begin, to_draw.draw_count, to_draw.indirect_draw_stride);
+				break;
 			default:
 				assertm(false, "Unsupported draw call type");
 				break;
@@ -727,10 +753,13 @@ namespace vkl
 				.instance_count = dci.instance_count,
 				.indirect_draw_stride = dci.indirect_draw_stride,
 				.indirect_draw_buffer = dci.indirect_draw_buffer,
+				.indirect_draw_count_buffer = dci.indirect_draw_count_buffer,
 				.index_buffer = dci.index_buffer,
 				.index_type = dci.index_type,
 				.num_vertex_buffers = dci.num_vertex_buffers,
 				.set = std::forward<std::shared_ptr<DescriptorSetAndPool>>(dci.set),
+				.first_index = dci.first_index,
+				.vertex_offset = dci.vertex_offset,
 			});
 			VertexCommand::MyDrawCallInfo& mdci = that.calls.back();
 			if (!dci.name.empty())
@@ -791,6 +820,7 @@ namespace vkl
 				node_to_draw.indirect_draw_stride = to_draw.indirect_draw_stride;
 				
 				node_to_draw.indirect_draw_buffer = to_draw.indirect_draw_buffer.getInstance();
+				node_to_draw.indirect_draw_count_buffer = to_draw.indirect_draw_count_buffer.getInstance();
 
 				node_to_draw.index_buffer = to_draw.index_buffer.getInstance();
 				
@@ -798,6 +828,8 @@ namespace vkl
 				node_to_draw.num_vertex_buffers = to_draw.num_vertex_buffers;
 
 				node_to_draw.vertex_buffer_begin = to_draw.vertex_buffer_begin;
+				node_to_draw.first_index = to_draw.first_index;
+				node_to_draw.vertex_offset = to_draw.vertex_offset;
 
 				if (layout)
 				{
@@ -828,6 +860,17 @@ namespace vkl
 						.usage = VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
 					};
 				}
+				if (node_to_draw.indirect_draw_count_buffer.buffer)
+				{
+					node.resources() += BufferUsage{
+						.bari = node_to_draw.indirect_draw_count_buffer,
+						.begin_state = ResourceState2{
+							.access = VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT,
+							.stage = VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT,
+						},
+						.usage = VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+					};
+				}
 				for (uint32_t i = 0; i < node_to_draw.num_vertex_buffers; ++i)
 				{
 					node.resources() += BufferUsage{
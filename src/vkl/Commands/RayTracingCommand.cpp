@@ -101,7 +101,7 @@ namespace vkl
 		auto addShader = [&](RTShader const& s, VkShaderStageFlagBits stage) -> std::shared_ptr<Shader>
 		{
 			DefinitionsList defs = s.definitions;
-			return std::make_shared<Shader>(Shader::CI{
+			std::shared_ptr<Shader> res = std::make_shared<Shader>(Shader::CI{
 				.app = application(),
 				.name = name() + ".Shader_" + std::to_string(stage),
 				.source_path = s.path,
@@ -117,6 +117,11 @@ namespace vkl
 				},
 				.hold_instance = ci.hold_instance,
 			});
+			_shaders_definitions.push_back(ShaderAndDefinitions{
+				.shader = res,
+				.definitions = std::move(defs),
+			});
+			return res;
 		};
 
 		auto addShaders = [&](MyVector<RTShader> const& rt_shaders, VkShaderStageFlagBits stage) -> MyVector<std::shared_ptr<Shader>>
@@ -220,6 +225,18 @@ namespace vkl
 		return res;
 	}
 
+	void RayTracingCommand::prepareSpeculativeDefinitions(UpdateContext& ctx, DefinitionsList const& definitions)
+	{
+		using namespace std::containers_append_operators;
+		static thread_local DefinitionsList shader_definitions;
+		for (ShaderAndDefinitions const& sd : _shaders_definitions)
+		{
+			shader_definitions = sd.definitions;
+			shader_definitions += definitions;
+			sd.shader->prepareSpeculativeDefinitions(ctx, shader_definitions);
+		}
+	}
+
 	void RayTracingCommand::TraceInfo::clear()
 	{
 		ShaderCommandList::clear();
@@ -233,4 +233,15 @@ namespace vkl
 
 		return res;
 	}
-}
\ No newline at end of file
+
+	void ShaderCommand::prepareSpeculativeDefinitions(UpdateContext& ctx, DefinitionsList const& definitions)
+	{
+		if (_pipeline && _pipeline->program())
+		{
+			for (std::shared_ptr<Shader> const& shader : _pipeline->program()->shaders())
+			{
+				shader->prepareSpeculativeDefinitions(ctx, definitions);
+			}
+		}
+	}
+}
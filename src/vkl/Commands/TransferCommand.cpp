@@ -1576,6 +1576,14 @@ namespace vkl
 				const ResourcesToUpload::ImageUpload & iu = resources.images[i];
 				const void * src_data = resources.getSrcData(iu);
 				std::memcpy(data + _extra_image_info[i].staging_offset, src_data, iu.size);
+				// Copy to the base mip of the view (usually 0, except when uploading a loaded mip chain)
+				const uint32_t mip = iu.dst->createInfo().subresourceRange.baseMipLevel;
+				const VkExtent3D image_extent = iu.dst->image()->createInfo().extent;
+				const VkExtent3D mip_extent{
+					.width = std::max(image_extent.width >> mip, 1u),
+					.height = std::max(image_extent.height >> mip, 1u),
+					.depth = std::max(image_extent.depth >> mip, 1u),
+				};
 				const VkBufferImageCopy2 region{
 					.sType = VK_STRUCTURE_TYPE_BUFFER_IMAGE_COPY_2,
 					.pNext = nullptr,
@@ -1584,7 +1592,7 @@ namespace vkl
 					.bufferImageHeight = iu.buffer_image_height,
 					.imageSubresource = getImageLayersFromRange(iu.dst->createInfo().subresourceRange), // Copy to base mip only
 					.imageOffset = makeUniformOffset3D(0),
-					.imageExtent = iu.dst->image()->createInfo().extent,
+					.imageExtent = mip_extent,
 				};
 				const VkCopyBufferToImageInfo2 info{
 					.sType = VK_STRUCTURE_TYPE_COPY_BUFFER_TO_IMAGE_INFO_2,
@@ -1918,6 +1926,8 @@ namespace vkl
 	struct DownloadImageNode : public ExecutionNode
 	{
 		std::shared_ptr<ImageViewInstance> _src = nullptr;
+		// Of the base mip of the view
+		VkExtent3D _extent = {};
 		void* _dst = nullptr;
 		size_t _size = 0;
 		uint32_t _buffer_row_length = 0;
@@ -1945,6 +1955,7 @@ namespace vkl
 		{
 			ExecutionNode::clear();
 			_src.reset();
+			_extent = {};
 			_dst = nullptr;
 			_size = 0;
 			_buffer_row_length = 0;
@@ -1960,11 +1971,21 @@ namespace vkl
 			_dst = di.dst;
 			_completion_callback = di.completion_callback;
 
+			{
+				const VkExtent3D image_extent = _src->image()->createInfo().extent;
+				const uint32_t mip = _src->createInfo().subresourceRange.baseMipLevel;
+				_extent = VkExtent3D{
+					.width = std::max(image_extent.width >> mip, 1u),
+					.height = std::max(image_extent.height >> mip, 1u),
+					.depth = std::max(image_extent.depth >> mip, 1u),
+				};
+			}
+
 			_size = di.size;
 
 			if (_size == 0)
 			{
-				const VkExtent3D extent = _src->image()->createInfo().extent;
+				const VkExtent3D extent = _extent;
 				const size_t num_pixels = extent.width * extent.height * extent.depth;
 				const DetailedVkFormat detailed_format = DetailedVkFormat::Find(_src->createInfo().format);
 				size_t pixel_size = detailed_format.pack_bits;
@@ -2028,7 +2049,7 @@ namespace vkl
 				.bufferImageHeight = _buffer_image_height,
 				.imageSubresource = getImageLayersFromRange(_src->createInfo().subresourceRange),
 				.imageOffset = makeUniformOffset3D(0),
-				.imageExtent = _src->image()->createInfo().extent,
+				.imageExtent = _extent,
 			};
 
 			VkCopyImageToBufferInfo2 info{
@@ -14,6 +14,60 @@ namespace vkl
 		_images.reserve(N);
 	}
 
+	void DescriptorWriter::append(DescriptorWriter const& other)
+	{
+		using namespace std::containers_append_operators;
+		// The infos are referenced by index until record()
+		const std::uintptr_t images_offset = _images.size();
+		const std::uintptr_t buffers_offset = _buffers.size();
+		const std::uintptr_t tlas_writes_offset = _tlas_writes.size();
+		const std::uintptr_t tlas_offset = _tlas.size();
+
+		_writes.reserve(_writes.size() + other._writes.size());
+		for (VkWriteDescriptorSet write : other._writes)
+		{
+			switch (write.descriptorType)
+			{
+				case VK_DESCRIPTOR_TYPE_SAMPLER:
+				case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+				case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+				case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+				case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+				{
+					std::uintptr_t & index = (std::uintptr_t&)write.pImageInfo;
+					index += images_offset;
+				}
+				break;
+				case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+				case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+				case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+				case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+				{
+					std::uintptr_t & index = (std::uintptr_t&)write.pBufferInfo;
+					index += buffers_offset;
+				}
+				break;
+				case VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR:
+				{
+					std::uintptr_t & index = (std::uintptr_t&)write.pNext;
+					index += tlas_writes_offset;
+				}
+				break;
+			}
+			_writes.push_back(write);
+		}
+		_images += other._images;
+		_buffers += other._buffers;
+		_tlas_writes.reserve(_tlas_writes.size() + other._tlas_writes.size());
+		for (VkWriteDescriptorSetAccelerationStructureKHR tlas_write : other._tlas_writes)
+		{
+			std::uintptr_t & index = (std::uintptr_t&)tlas_write.pAccelerationStructures;
+			index += tlas_offset;
+			_tlas_writes.push_back(tlas_write);
+		}
+		_tlas += other._tlas;
+	}
+
 	void DescriptorWriter::record()
 	{
 		
@@ -139,6 +139,9 @@ namespace vkl
 				}
 			}();
 			const std::string_view label = _strings.get(_stack[i].label_range);
+			seg.name_range = seg.label_range;
+			seg.cpu_duration_ns = cpu_duration_ns;
+			seg.gpu_duration_ns = gpu_duration_ns;
 			
 			_strings.printf(false, "%s: ", label.data());
 			textTimeNs(cpu_duration_ns);
@@ -0,0 +1,454 @@
+#include <vkl/Execution/FrameGraph.hpp>
+#include <vkl/Execution/SynchronizationHelper.hpp>
+
+#include <unordered_map>
+#include <algorithm>
+
+namespace vkl
+{
+	namespace
+	{
+		constexpr uint64_t RangeEnd(uint64_t begin, uint64_t len, uint64_t remaining)
+		{
+			return (len == remaining) ? std::numeric_limits<uint64_t>::max() : (begin + len);
+		}
+
+		constexpr bool RangesOverlap(uint64_t b0, uint64_t e0, uint64_t b1, uint64_t e1)
+		{
+			return (b0 < e1) && (b1 < e0);
+		}
+
+		constexpr bool RangeContains(uint64_t b0, uint64_t e0, uint64_t b1, uint64_t e1)
+		{
+			return (b0 <= b1) && (e1 <= e0);
+		}
+
+		// a contains b (of the same resource)
+		bool AccessContains(FrameGraphAccess const& a, FrameGraphAccess const& b)
+		{
+			bool res;
+			if (a.isImage())
+			{
+				const VkImageSubresourceRange & ra = a.image_range;
+				const VkImageSubresourceRange & rb = b.image_range;
+				res = (ra.aspectMask & rb.aspectMask) == rb.aspectMask;
+				res = res && RangeContains(ra.baseMipLevel, RangeEnd(ra.baseMipLevel, ra.levelCount, VK_REMAINING_MIP_LEVELS), rb.baseMipLevel, RangeEnd(rb.baseMipLevel, rb.levelCount, VK_REMAINING_MIP_LEVELS));
+				res = res && RangeContains(ra.baseArrayLayer, RangeEnd(ra.baseArrayLayer, ra.layerCount, VK_REMAINING_ARRAY_LAYERS), rb.baseArrayLayer, RangeEnd(rb.baseArrayLayer, rb.layerCount, VK_REMAINING_ARRAY_LAYERS));
+			}
+			else
+			{
+				res = RangeContains(a.buffer_range.begin, RangeEnd(a.buffer_range.begin, a.buffer_range.len, VK_WHOLE_SIZE), b.buffer_range.begin, RangeEnd(b.buffer_range.begin, b.buffer_range.len, VK_WHOLE_SIZE));
+			}
+			return res;
+		}
+
+		struct ResourceKey
+		{
+			uint64_t handle = 0;
+			uint32_t type = 0;
+
+			ResourceKey(FrameGraphAccess const& access)
+			{
+				if (access.buffer)
+				{
+					handle = reinterpret_cast<uint64_t>(access.buffer);
+					type = 0;
+				}
+				else if (access.image)
+				{
+					handle = reinterpret_cast<uint64_t>(access.image);
+					type = 1;
+				}
+				else
+				{
+					handle = reinterpret_cast<uint64_t>(access.memory);
+					type = 2;
+				}
+			}
+
+			bool operator==(ResourceKey const&) const = default;
+		};
+
+		struct ResourceKeyHash
+		{
+			size_t operator()(ResourceKey const& key) const
+			{
+				return std::hash<uint64_t>{}(key.handle) ^ key.type;
+			}
+		};
+	}
+
+	bool FrameGraphAccess::modifiesResource() const
+	{
+		bool res = accessIsWrite2(state.access);
+		if (end_state.has_value())
+		{
+			res |= !(end_state.value() == state);
+		}
+		return res;
+	}
+
+	bool FrameGraphAccess::overlaps(FrameGraphAccess const& o) const
+	{
+		bool res = sameResource(o);
+		if (res)
+		{
+			if (isImage())
+			{
+				const VkImageSubresourceRange & a = image_range;
+				const VkImageSubresourceRange & b = o.image_range;
+				res = (a.aspectMask & b.aspectMask) != 0;
+				res = res && RangesOverlap(a.baseMipLevel, RangeEnd(a.baseMipLevel, a.levelCount, VK_REMAINING_MIP_LEVELS), b.baseMipLevel, RangeEnd(b.baseMipLevel, b.levelCount, VK_REMAINING_MIP_LEVELS));
+				res = res && RangesOverlap(a.baseArrayLayer, RangeEnd(a.baseArrayLayer, a.layerCount, VK_REMAINING_ARRAY_LAYERS), b.baseArrayLayer, RangeEnd(b.baseArrayLayer, b.layerCount, VK_REMAINING_ARRAY_LAYERS));
+			}
+			else
+			{
+				res = RangesOverlap(buffer_range.begin, RangeEnd(buffer_range.begin, buffer_range.len, VK_WHOLE_SIZE), o.buffer_range.begin, RangeEnd(o.buffer_range.begin, o.buffer_range.len, VK_WHOLE_SIZE));
+			}
+		}
+		return res;
+	}
+
+	bool FrameGraphAccess::conflictsWith(FrameGraphAccess const& o) const
+	{
+		bool res = false;
+		if (overlaps(o))
+		{
+			res = modifiesResource() || o.modifiesResource();
+			if (isImage())
+			{
+				// Two reads in different layouts
+				res |= (state.layout != o.state.layout);
+			}
+		}
+		return res;
+	}
+
+
+
+	void FrameGraphCompiler::clear()
+	{
+		_accesses.clear();
+		_nodes.clear();
+		_order.clear();
+		_batches.clear();
+		_node_batch.clear();
+		_dependencies = 0;
+	}
+
+	uint32_t FrameGraphCompiler::addNode()
+	{
+		const uint32_t res = _nodes.size32();
+		_nodes.push_back(Range32u{
+			.begin = _accesses.size32(),
+			.len = 0,
+		});
+		return res;
+	}
+
+	void FrameGraphCompiler::addAccess(FrameGraphAccess const& access)
+	{
+		assert(!_nodes.empty());
+		_accesses.push_back(access);
+		++_nodes.back().len;
+	}
+
+	void FrameGraphCompiler::addAccesses(ResourceUsageList const& resources)
+	{
+		resources.iterateOnBuffers([this](std::shared_ptr<BufferInstance> const& bi, const BufferSubRangeState * states, size_t count)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				addAccess(FrameGraphAccess{
+					.buffer = bi->handle(),
+					.buffer_range = states[i].range,
+					.state = states[i].state,
+					.end_state = states[i].end_state,
+				});
+			}
+		});
+		resources.iterateOnImages([this](std::shared_ptr<ImageInstance> const& ii, const ImageSubRangeState * states, size_t count)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				addAccess(FrameGraphAccess{
+					.image = ii->handle(),
+					.image_range = states[i].range,
+					.state = states[i].state,
+					.end_state = states[i].end_state,
+				});
+			}
+			if (ii->isPlaced())
+			{
+				// Aliased images: the accesses of the same memory must stay in order
+				ImageMemoryPlacement const& placement = ii->placement();
+				for (size_t i = 0; i < count; ++i)
+				{
+					addAccess(FrameGraphAccess{
+						.memory = placement.block.get(),
+						.buffer_range = Buffer::Range{.begin = placement.offset, .len = placement.size},
+						.state = states[i].state,
+						.end_state = states[i].end_state,
+						.ordering_only = true,
+					});
+				}
+			}
+		});
+	}
+
+	void FrameGraphCompiler::compile()
+	{
+		_order.clear();
+		_batches.clear();
+		_dependencies = 0;
+		_node_batch.resize(_nodes.size());
+
+		// Accesses of each resource, indexed in a single pass over the nodes:
+		// A non modifying access only has to be compared with the modifying accesses and the reads in other layouts,
+		// so the many reads of a hot resource (e.g. a uniform buffer) are not compared with each other
+		// The accesses contained in a later modifying access are dropped: a later access conflicting with them conflicts with it
+		struct PreviousAccess
+		{
+			uint32_t node;
+			uint32_t access;
+		};
+		struct ReadGroup
+		{
+			VkImageLayout layout;
+			MyVector<PreviousAccess> accesses;
+		};
+		struct ResourceAccesses
+		{
+			MyVector<PreviousAccess> modifying;
+			MyVector<ReadGroup> reads;
+		};
+		static thread_local std::unordered_map<ResourceKey, ResourceAccesses, ResourceKeyHash> previous_accesses;
+		previous_accesses.clear();
+
+		uint32_t batch_count = 0;
+		for (uint32_t n = 0; n < _nodes.size32(); ++n)
+		{
+			const Range32u node = _nodes[n];
+			uint32_t batch = 0;
+			const auto check = [&](FrameGraphAccess const& access, MyVector<PreviousAccess> const& list)
+			{
+				for (PreviousAccess const& prev : list)
+				{
+					if (prev.node != n && _accesses[prev.access].conflictsWith(access))
+					{
+						batch = std::max(batch, _node_batch[prev.node] + 1);
+						++_dependencies;
+					}
+				}
+			};
+			for (uint32_t a = node.begin; a < node.end(); ++a)
+			{
+				const FrameGraphAccess & access = _accesses[a];
+				auto found = previous_accesses.find(ResourceKey(access));
+				if (found != previous_accesses.end())
+				{
+					ResourceAccesses const& ra = found->second;
+					const bool modifies = access.modifiesResource();
+					check(access, ra.modifying);
+					for (ReadGroup const& group : ra.reads)
+					{
+						if (modifies || (access.isImage() && group.layout != access.state.layout))
+						{
+							check(access, group.accesses);
+						}
+					}
+				}
+			}
+			_node_batch[n] = batch;
+			batch_count = std::max(batch_count, batch + 1);
+
+			for (uint32_t a = node.begin; a < node.end(); ++a)
+			{
+				const FrameGraphAccess & access = _accesses[a];
+				ResourceAccesses & ra = previous_accesses[ResourceKey(access)];
+				const PreviousAccess pa{
+					.node = n,
+					.access = a,
+				};
+				if (access.modifiesResource())
+				{
+					const auto contained = [&](PreviousAccess const& prev)
+					{
+						return AccessContains(access, _accesses[prev.access]);
+					};
+					std::erase_if(ra.modifying, contained);
+					for (ReadGroup & group : ra.reads)
+					{
+						std::erase_if(group.accesses, contained);
+					}
+					ra.modifying.push_back(pa);
+				}
+				else
+				{
+					const VkImageLayout layout = access.isImage() ? access.state.layout : VK_IMAGE_LAYOUT_UNDEFINED;
+					auto group = std::find_if(ra.reads.begin(), ra.reads.end(), [&](ReadGroup const& g) {return g.layout == layout; });
+					if (group == ra.reads.end())
+					{
+						ra.reads.push_back(ReadGroup{ .layout = layout });
+						group = ra.reads.end() - 1;
+					}
+					group->accesses.push_back(pa);
+				}
+			}
+		}
+
+		// Counting sort of the nodes by batch (stable)
+		_batches.resize(batch_count);
+		for (Range32u & b : _batches)
+		{
+			b = Range32u{ .begin = 0, .len = 0 };
+		}
+		for (uint32_t n = 0; n < _nodes.size32(); ++n)
+		{
+			++_batches[_node_batch[n]].len;
+		}
+		uint32_t offset = 0;
+		for (Range32u & b : _batches)
+		{
+			b.begin = offset;
+			offset += b.len;
+			b.len = 0;
+		}
+		_order.resize(_nodes.size());
+		for (uint32_t n = 0; n < _nodes.size32(); ++n)
+		{
+			Range32u & b = _batches[_node_batch[n]];
+			_order[b.end()] = n;
+			++b.len;
+		}
+	}
+
+	FrameGraphBarrierCounts FrameGraphCompiler::countBarriers(bool compiled) const
+	{
+		FrameGraphBarrierCounts res;
+		std::unordered_map<ResourceKey, DoubleResourceState2, ResourceKeyHash> states;
+		MyVector<VkBufferMemoryBarrier2> buffer_barriers;
+		MyVector<VkImageMemoryBarrier2> image_barriers;
+
+		const auto synch_node = [&](uint32_t n)
+		{
+			const Range32u node = _nodes[n];
+			for (uint32_t a = node.begin; a < node.end(); ++a)
+			{
+				const FrameGraphAccess & access = _accesses[a];
+				if (access.ordering_only)
+				{
+					continue;
+				}
+				DoubleResourceState2 & prev = states[ResourceKey(access)];
+				const ResourceState2 & next = access.state;
+				bool add_barrier = false;
+				ResourceState2 synch_from;
+				if (accessIsReadonly2(next.access))
+				{
+					const bool access_already_synch = (next.access & prev.read_only_state.access) == next.access;
+					const bool stage_already_synch = (next.stage & prev.read_only_state.stage) == next.stage;
+					const bool same_layout = !access.isImage() || (next.layout == prev.read_only_state.layout);
+					if (!(access_already_synch && stage_already_synch && same_layout))
+					{
+						synch_from = prev.write_state;
+						if (!same_layout)
+						{
+							synch_from = synch_from | prev.read_only_state;
+						}
+						synch_from.layout = prev.read_only_state.layout;
+						add_barrier = true;
+					}
+				}
+				else
+				{
+					synch_from = prev.read_only_state | prev.write_state;
+					add_barrier = true;
+				}
+
+				if (add_barrier)
+				{
+					if (access.isImage())
+					{
+						image_barriers.push_back(VkImageMemoryBarrier2{
+							.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+							.srcStageMask = synch_from.stage,
+							.srcAccessMask = synch_from.access,
+							.dstStageMask = next.stage,
+							.dstAccessMask = next.access,
+							.oldLayout = synch_from.layout,
+							.newLayout = next.layout,
+							.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+							.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+							.image = access.image,
+							.subresourceRange = access.image_range,
+						});
+					}
+					else
+					{
+						buffer_barriers.push_back(VkBufferMemoryBarrier2{
+							.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+							.srcStageMask = synch_from.stage,
+							.srcAccessMask = synch_from.access,
+							.dstStageMask = next.stage,
+							.dstAccessMask = next.access,
+							.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+							.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+							.buffer = access.buffer,
+							.offset = access.buffer_range.begin,
+							.size = access.buffer_range.len,
+						});
+					}
+				}
+
+				const ResourceState2 end_state = access.end_state.value_or(next);
+				if (accessIsReadonly2(end_state.access))
+				{
+					prev.read_only_state = end_state | prev.read_only_state;
+				}
+				else
+				{
+					prev.write_state = end_state;
+					prev.read_only_state = ResourceState2{ .layout = end_state.layout };
+				}
+			}
+		};
+
+		const auto record = [&](bool merge)
+		{
+			if (merge)
+			{
+				MergeBarriers(buffer_barriers, image_barriers);
+			}
+			if (buffer_barriers || image_barriers)
+			{
+				++res.pipeline_barriers;
+				res.buffer_barriers += buffer_barriers.size();
+				res.image_barriers += image_barriers.size();
+			}
+			buffer_barriers.clear();
+			image_barriers.clear();
+		};
+
+		if (compiled)
+		{
+			for (Range32u const& batch : _batches)
+			{
+				for (uint32_t i = batch.begin; i < batch.end(); ++i)
+				{
+					synch_node(_order[i]);
+				}
+				record(true);
+			}
+		}
+		else
+		{
+			for (uint32_t n = 0; n < _nodes.size32(); ++n)
+			{
+				synch_node(n);
+				record(false);
+			}
+		}
+		return res;
+	}
+}
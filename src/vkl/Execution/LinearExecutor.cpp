@@ -18,7 +18,6 @@
 namespace vkl
 {
 	const bool log = false;
-	const bool use_swapchain_signal_fence = true;
 	const bool use_only_fifo_fence = false;
 
 	ExecutionThread::ExecutionThread(CreateInfo const& ci):
@@ -97,7 +96,6 @@ namespace vkl
 		break;
 		case CommandEvent::Type::PushDebugLabel:
 		case CommandEvent::Type::InsertDebugLabel:
-		break;
 		{
 			DebugLabelEvent & dle = _debug_labels.data()[event.index];
 			std::string_view sv = _strings.get(Range32u{ .begin = dle.string_index, .len = dle.string_len });
@@ -255,6 +253,7 @@ namespace vkl
 			.type = CommandEvent::Type::BeginRenderPass,
 			.index = _current_render_pass_index,
 		};
+		_current_render_pass_command_index = _commands.size32();
 		_commands.push_back(ce);
 
 		if (!_deferred_record)
@@ -314,6 +313,7 @@ namespace vkl
 				.type = CommandEvent::Type::NextSubPass,
 				.flags = flags,
 			};
+			_commands.push_back(event);
 		}
 		else 
 		{
@@ -359,29 +359,7 @@ namespace vkl
 				_synch.record();
 				_render_pass_resources.clear();
 				
-				_info.ptr_clear_values = _clear_values.data() + reinterpret_cast<uintptr_t>(_info.ptr_clear_values);
-				_info.recordBegin(*_context, rp_event.flags | RenderPassBeginInfo::Flags::ContentsInline);
-
-				uint32_t index = _current_render_pass_index + 1;
-				while(index < _commands.size32())
-				{
-					CommandEvent & ce = _commands[index];
-					if (ce.type == CommandEvent::Type::EndRenderPass)
-					{
-						break;
-					}
-					if (ce.type == CommandEvent::Type::NextSubPass)
-					{
-						_info.recordNextSubpass(*_context, ce.flags);
-					}
-					else
-					{
-						recordEventNotRenderPass(index, false);
-					}
-					++index;
-				}
-
-				_info.recordEnd(*_context);
+				recordRenderPass(_current_render_pass_command_index);
 			}
 			else
 			{
@@ -391,6 +369,45 @@ namespace vkl
 		}
 
 		_current_render_pass_index = uint32_t(-1);
+		_current_render_pass_command_index = uint32_t(-1);
+	}
+
+	uint32_t ExecutionThread::recordRenderPass(uint32_t command_index)
+	{
+		BeginRenderPassEvent& rp_event = _begin_render_passes.data()[_commands[command_index].index];
+		RenderPassBeginInfo& _info = rp_event.info;
+
+		uint32_t index = command_index + 1;
+		if (_info.render_pass->handle())
+		{
+			_info.ptr_clear_values = _clear_values.data() + reinterpret_cast<uintptr_t>(_info.ptr_clear_values);
+			_info.recordBegin(*_context, rp_event.flags | RenderPassBeginInfo::Flags::ContentsInline);
+
+			while (index < _commands.size32())
+			{
+				CommandEvent & ce = _commands[index];
+				if (ce.type == CommandEvent::Type::EndRenderPass)
+				{
+					break;
+				}
+				if (ce.type == CommandEvent::Type::NextSubPass)
+				{
+					_info.recordNextSubpass(*_context, ce.flags);
+				}
+				else
+				{
+					recordEventNotRenderPass(index, false);
+				}
+				++index;
+			}
+
+			_info.recordEnd(*_context);
+		}
+		else
+		{
+			NOT_YET_IMPLEMENTED;
+		}
+		return index;
 	}
 
 	void ExecutionThread::pushDebugLabel(std::string_view const& label, vec4 const& color, bool timestamp)
@@ -451,10 +468,110 @@ namespace vkl
 		}
 	}
 
+	uint32_t ExecutionThread::recordFrameGraphSegment(uint32_t begin)
+	{
+		_frame_graph.clear();
+		_frame_graph_items.clear();
+		uint32_t render_passes = 0;
+
+		uint32_t index = begin;
+		while (index < _commands.size32())
+		{
+			const CommandEvent & event = _commands[index];
+			if (event.type == CommandEvent::Type::ExecNode)
+			{
+				const ResourceUsageList & resources = _nodes.data()[event.index].node->resources();
+				_frame_graph.addNode();
+				_frame_graph.addAccesses(resources);
+				_frame_graph_items.push_back(FrameGraphItem{
+					.command_index = index,
+					.resources = &resources,
+				});
+				++index;
+			}
+			else if (event.type == CommandEvent::Type::BeginRenderPass)
+			{
+				// A render pass is synchronized as a whole, before it begins
+				if (render_passes == _frame_graph_render_passes_resources.size32())
+				{
+					_frame_graph_render_passes_resources.push_back(std::make_unique<ResourceUsageList>());
+				}
+				ResourceUsageList & resources = *_frame_graph_render_passes_resources[render_passes];
+				++render_passes;
+				resources.clear();
+				_begin_render_passes.data()[event.index].info.exportResources(resources, !_render_pass_synch_subpass);
+				uint32_t end = index + 1;
+				while (end < _commands.size32() && _commands[end].type != CommandEvent::Type::EndRenderPass)
+				{
+					if (_commands[end].type == CommandEvent::Type::ExecNode)
+					{
+						resources += _nodes.data()[_commands[end].index].node->resources();
+					}
+					++end;
+				}
+				_frame_graph.addNode();
+				_frame_graph.addAccesses(resources);
+				_frame_graph_items.push_back(FrameGraphItem{
+					.command_index = index,
+					.resources = &resources,
+				});
+				index = end + 1;
+			}
+			else
+			{
+				break;
+			}
+		}
+
+		_frame_graph.compile();
+
+		_synch.setMergeBarriers(true);
+		for (Range32u const& batch : _frame_graph.batches())
+		{
+			_synch.reset(_context);
+			for (uint32_t i = batch.begin; i < batch.end(); ++i)
+			{
+				_synch.commit(*_frame_graph_items[_frame_graph.order()[i]].resources);
+			}
+			_synch.record();
+
+			for (uint32_t i = batch.begin; i < batch.end(); ++i)
+			{
+				const uint32_t command_index = _frame_graph_items[_frame_graph.order()[i]].command_index;
+				if (_commands[command_index].type == CommandEvent::Type::ExecNode)
+				{
+					recordEventNotRenderPass(command_index, false);
+				}
+				else
+				{
+					recordRenderPass(command_index);
+				}
+			}
+		}
+		_synch.setMergeBarriers(false);
+
+		return std::min(index, _commands.size32());
+	}
+
 	void ExecutionThread::recordCommands()
 	{
 		// Assume the command pool mutex is owned
-		uint32_t index;
+		assert(_current_render_pass_index == uint32_t(-1));
+		uint32_t index = 0;
+		while (index < _commands.size32())
+		{
+			const CommandEvent::Type type = _commands[index].type;
+			if (type == CommandEvent::Type::ExecNode || type == CommandEvent::Type::BeginRenderPass)
+			{
+				index = recordFrameGraphSegment(index);
+			}
+			else
+			{
+				recordEventNotRenderPass(index, true);
+				++index;
+			}
+		}
+		clearDeferedLists();
 	}
 
 
@@ -464,11 +581,20 @@ namespace vkl
 		std::shared_ptr<CommandBuffer> cb = nullptr;
 		Queue * queue = nullptr;
 
+		// Binary semaphores (swapchain aquisition)
 		MyVector<std::shared_ptr<Semaphore>> wait_semaphores = {};
-		// Can be multiple because VkSemaphore can be consumed only ONCE (WTF who designed that???)
+		struct TimelineWait
+		{
+			std::shared_ptr<TimelineSemaphore> semaphore = nullptr;
+			uint64_t value = 0;
+		};
+		// Submissions of other queues
+		MyVector<TimelineWait> wait_timelines = {};
+		// Binary semaphores (presentation), signaled in addition to the timeline
 		MyVector<std::shared_ptr<Semaphore>> signal_semaphores = {};
 
-		std::shared_ptr<Fence> signal_fence = nullptr;
+		uint32_t timeline_index = 0;
+		uint64_t timeline_value = 0;
 
 		MyVector<std::shared_ptr<VkObject>> dependecies = {};
 		MyVector<CompletionCallback> completion_callbacks = {};
@@ -477,34 +603,18 @@ namespace vkl
 		{
 			VkApplication * app = nullptr;
 			std::string name = {};
-			bool create_fence = false;
-			uint32_t create_semaphore = 0;
 		};
 		using CI = CreateInfo;
 
 		CommandBufferSubmission(CreateInfo const& ci) :
 			VkObject(ci.app, ci.name)
-		{
-			if (ci.create_fence)
-			{
-				signal_fence = std::make_shared<Fence>(application(), this->name() + ".SignalFence");
-			}
-			if (ci.create_semaphore)
-			{
-				signal_semaphores.resize(ci.create_semaphore);
-				for (uint32_t i = 0; i < ci.create_semaphore; ++i)
-				{
-					signal_semaphores[i] = std::make_shared<Semaphore>(application(), this->name() + ".SignalSemaphore_"s + std::to_string(i));
-				}
-			}
-		}
+		{}
 
 		virtual ~CommandBufferSubmission() override
 		{
 			wait_semaphores.clear();
+			wait_timelines.clear();
 			signal_semaphores.clear();
-			
-			signal_fence.reset();
 			VKL_BREAKPOINT_HANDLE;
 		}
 
@@ -548,6 +658,7 @@ namespace vkl
 			std::string name = {};
 			std::shared_ptr<SwapchainInstance> swapchain = nullptr;
 			uint32_t index = 0;
+			SynchObjectsPool * synch_pool = nullptr;
 			bool create_aquire_semaphore = false;
 			bool create_aquire_fence = false;
 			bool create_present_fence = false;
@@ -558,9 +669,9 @@ namespace vkl
 			VkObject(ci.app, ci.name),
 			swapchain(ci.swapchain),
 			index(ci.index), 
-			aquire_signal_semaphore(ci.create_aquire_semaphore ? std::make_shared<Semaphore>(application(), this->name() + ".AquireSignalSemaphore") : nullptr),
-			aquire_signal_fence(ci.create_aquire_fence ? std::make_shared<Fence>(application(), this->name() + ".AquireSignalFence") : nullptr),
-			present_signal_fence(ci.create_present_fence ? std::make_shared<Fence>(application(), this->name() + ".PresentSignalFence") : nullptr)
+			aquire_signal_semaphore(ci.create_aquire_semaphore ? ci.synch_pool->getSemaphore() : nullptr),
+			aquire_signal_fence(ci.create_aquire_fence ? ci.synch_pool->getFence() : nullptr),
+			present_signal_fence(ci.create_present_fence ? ci.synch_pool->getFence() : nullptr)
 		{}
 
 		virtual ~SwapchainEvent() override
@@ -583,7 +694,8 @@ namespace vkl
 			.app = application(),
 			.name = name() + ".exec_context",
 			.resource_tid = 0,
-		})
+		}),
+		_use_frame_graph(ci.use_frame_graph)
 	{
 		// TODO better later
 		_main_queue = application()->queuesByFamily().front().front();
@@ -626,6 +738,36 @@ namespace vkl
 			.name = name() + ".ExecutionThread",
 			.context = &_context,
 		});
+
+		_synch_objects_pool = std::make_shared<SynchObjectsPool>(SynchObjectsPool::CI{
+			.app = application(),
+			.name = name() + ".SynchObjectsPool",
+		});
+		// All the timelines are created up front: _queue_timelines is not resized afterwards, so it can be read without locking
+		for (auto const& family_queues : application()->queuesByFamily())
+		{
+			for (std::shared_ptr<Queue> const& queue : family_queues)
+			{
+				const uint32_t index = _queue_timelines.size32();
+				_queue_timelines.push_back(QueueTimeline{
+					.queue = queue.get(),
+					.semaphore = std::make_shared<TimelineSemaphore>(application(), name() + ".Timeline_" + std::to_string(index), 0),
+				});
+			}
+		}
+	}
+
+	uint32_t LinearExecutor::getQueueTimelineIndex(Queue * queue)
+	{
+		for (uint32_t i = 0; i < _queue_timelines.size32(); ++i)
+		{
+			if (_queue_timelines[i].queue == queue)
+			{
+				return i;
+			}
+		}
+		assert(false && "Queue of another application");
+		return 0;
 	}
 
 	LinearExecutor::~LinearExecutor()
@@ -664,7 +806,7 @@ namespace vkl
 
 	void LinearExecutor::updateResources(UpdateContext & context)
 	{
-		if (_window->updateResources(context))
+		if (_window && _window->updateResources(context))
 		{
 			SwapchainInstance * swapchain = _window->swapchain()->instance().get();
 			if (PresentModeIsFIFO(swapchain->createInfo().presentMode))
@@ -707,6 +849,9 @@ namespace vkl
 		}
 		_frame_tt.tick();
 		++_frame_index;
+		_frame_created_semaphores = _synch_objects_pool->createdSemaphores();
+		_frame_created_fences = _synch_objects_pool->createdFences();
+		_frame_submissions = 0;
 		
 		_context._timestamp_query_count = 0;
 		_context._tick_tock.tick();
@@ -765,6 +910,13 @@ namespace vkl
 		}
 		_timestamp_query_pool_capacity = std::max(_timestamp_query_pool_capacity, _context._timestamp_query_count * 2);
 
+		if (FramePerfCounters * fpc = _context.framePerfCounters())
+		{
+			fpc->submissions = _frame_submissions;
+			fpc->created_semaphores = _synch_objects_pool->createdSemaphores() - _frame_created_semaphores;
+			fpc->created_fences = _synch_objects_pool->createdFences() - _frame_created_fences;
+		}
+
 		_frame_tt.tock();
 		if (log)
 		{
@@ -802,7 +954,7 @@ namespace vkl
 		std::shared_ptr<SwapchainEvent> & event = _latest_swapchain_event;
 		event = std::make_shared<SwapchainEvent>(SwapchainEvent::CI{
 			.app = application(), 
-			.name = name() + ".AquireFrame_" + std::to_string(_frame_index), 
+			.synch_pool = _synch_objects_pool.get(),
 			.create_aquire_semaphore = true,
 			.create_aquire_fence = true, 
 			.create_present_fence = use_specific_present_signal_fence,
@@ -825,10 +977,7 @@ namespace vkl
 					application()->logger()(std::format("FIFO wait: {}us", waited.count()), Logger::Options::TagInfo);
 				}
 			}
-			if (use_swapchain_signal_fence)
-			{
-				fence_to_wait = event->aquire_signal_fence;
-			}
+			fence_to_wait = event->aquire_signal_fence;
 		}
 
 		static std::TickTock_hrc over_frame_tt;
@@ -929,16 +1078,8 @@ namespace vkl
 		assert(_latest_swapchain_event);
 		assert(_latest_swapchain_event->present_queue == nullptr);
 		_latest_synch_cb->wait_semaphores.push_back(_latest_swapchain_event->aquire_signal_semaphore);
-
-		const SwapchainInstance& si = *_window->swapchain()->instance();
-		const VkPresentModeKHR present_mode = si.createInfo().presentMode;
-		if (PresentModeIsFIFO(present_mode))
-		{
-			if (!use_swapchain_signal_fence)
-			{
-				_fifo_aquire_fences[_fifo_fence_to_wait_index] = _latest_synch_cb->signal_fence;
-			}
-		}
+		// The presentation can only wait on a binary semaphore
+		_latest_synch_cb->signal_semaphores.push_back(_synch_objects_pool->getSemaphore());
 
 		{
 			
@@ -953,6 +1094,8 @@ namespace vkl
 				execute(_render_gui->with(ImguiCommand::ExecutionInfo{.index = _latest_swapchain_event->index}));
 			}
 
+			// The deferred commands must be recorded before the inline synchronization
+			_current_thread->recordCommands();
 			InlineSynchronizeImageView(_context, blit_target->instance(), ResourceState2{
 				.access = VK_ACCESS_2_MEMORY_READ_BIT,
 				.stage = VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT | VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT, // Not sure about this one
@@ -974,7 +1117,7 @@ namespace vkl
 		const bool use_signal_fence = useSpecificPresentSignalFence();
 		const bool use_present_id = application()->availableFeatures().present_id_khr.presentId;
 		
-		_latest_swapchain_event->present_wait_semaphores.push_back(_latest_synch_cb->signal_semaphores[0]);
+		_latest_swapchain_event->present_wait_semaphores.push_back(_latest_synch_cb->signal_semaphores.back());
 
 		wait_semaphores.resize(_latest_swapchain_event->present_wait_semaphores.size());
 		for (size_t i = 0; i < _latest_swapchain_event->present_wait_semaphores.size(); ++i)
@@ -1160,19 +1303,23 @@ namespace vkl
 		std::shared_ptr<CommandBufferSubmission> event = std::make_shared<CommandBufferSubmission>(CommandBufferSubmission::CI{
 			.app = application(), 
 			.name = cb->name(), 
-			.create_fence = true, 
-			.create_semaphore = 1,
 		});
 		event->cb = cb;
 		event->queue = _main_queue.get();
+		event->timeline_index = getQueueTimelineIndex(event->queue);
+		event->timeline_value = ++_queue_timelines[event->timeline_index].recorded_value;
 		if (_latest_synch_cb && _latest_synch_cb->queue != event->queue) // No need to synch with a semaphore on the same queue
 		{
-			event->wait_semaphores.push_back(_latest_synch_cb->signal_semaphores[0]);
+			event->wait_timelines.push_back(CommandBufferSubmission::TimelineWait{
+				.semaphore = _queue_timelines[_latest_synch_cb->timeline_index].semaphore,
+				.value = _latest_synch_cb->timeline_value,
+			});
 		}
 		_latest_synch_cb = event;
 		
 		assert(_current_thread == nullptr);
 		_current_thread = _execution_thread.get();
+		_current_thread->setDeferredRecord(_use_frame_graph);
 
 		if (_current_frame_report)
 		{
@@ -1244,6 +1391,7 @@ namespace vkl
 			});
 			exec_thread->popDebugLabel();
 		}
+		exec_thread->recordCommands();
 		assert(_context._debug_stack_depth == 0);
 		std::shared_ptr<CommandBuffer> cb = _context.getCommandBuffer();
 		assert(exec_thread == _current_thread);
@@ -1289,46 +1437,33 @@ namespace vkl
 			{
 				cb_trash_can = &_trash_cbs;
 			}
-			const bool cb_break_on_first_stall = false;
+			// Submissions of a queue complete in order
+			const bool cb_break_on_first_stall = true;
 			// It seems there is a bug with this to true, leading to an accumulation of previous swapchain event
 			const bool swapchain_break_on_first_stall = false;
 			_cb_mutex.lock();
 			{
-				if (cb_break_on_first_stall)
+				// One poll per queue, the values are monotonic
+				for (QueueTimeline & timeline : _queue_timelines)
 				{
-					while (!_previous_cbs.empty())
+					timeline.completed_value = timeline.semaphore->value();
+				}
+				auto it = _previous_cbs.begin();
+				while(it != _previous_cbs.end())
+				{
+					std::shared_ptr<CommandBufferSubmission> & submitted_cb = *it;
+					if (submitted_cb->timeline_value > _queue_timelines[submitted_cb->timeline_index].completed_value)
 					{
-						std::shared_ptr<CommandBufferSubmission>& submitted_cb = _previous_cbs.front();
-						VkResult status = submitted_cb->signal_fence->getStatus();
-						if (status == VK_NOT_READY)
+						if (cb_break_on_first_stall)
 						{
 							break;
 						}
-						else
-						{
-							assert(status == VK_SUCCESS);
-							submitted_cb->finish(status, cb_trash_can);
-							_previous_cbs.pop_front();
-						}
+						++it;
 					}
-				}
-				else
-				{
-					auto it = _previous_cbs.begin();
-					while(it != _previous_cbs.end())
+					else
 					{
-						std::shared_ptr<CommandBufferSubmission> & submitted_cb = *it;
-						VkResult status = submitted_cb->signal_fence->getStatus();
-						if (status == VK_NOT_READY)
-						{
-							++it;
-						}
-						else
-						{
-							assert(status == VK_SUCCESS);
-							submitted_cb->finish(status, cb_trash_can);
-							it = _previous_cbs.erase(it);
-						}
+						submitted_cb->finish(VK_SUCCESS, cb_trash_can);
+						it = _previous_cbs.erase(it);
 					}
 				}
 			}
@@ -1432,57 +1567,89 @@ namespace vkl
 		recyclePreviousEvents();
 		
 		_cb_mutex.lock();
-		static thread_local MyVector<VkSemaphore> vk_semaphores;
-		static thread_local MyVector<VkPipelineStageFlags> stage_to_wait;
+		static thread_local MyVector<VkSemaphoreSubmitInfo> wait_infos;
+		static thread_local MyVector<VkSemaphoreSubmitInfo> signal_infos;
 		// TODO batch all submissions
 		for (size_t i = 0; i < _pending_cbs.size(); ++i)
 		{
 			const std::shared_ptr<CommandBufferSubmission> & pending = _pending_cbs[i];
-			//std::cout << "Submit: " <<std::endl;
-			//std::cout << "Signaling semaphore: " << pending->signal_semaphore->name() <<std::endl;
-			//std::cout << "Waiting on semaphores: ";
-			const uint32_t wait_semaphore_count = pending->wait_semaphores.size32();
-			const uint32_t signal_semaphore_count = pending->signal_semaphores.size32();
-			vk_semaphores.resize(wait_semaphore_count + signal_semaphore_count);
-			stage_to_wait.resize(pending->wait_semaphores.size());
-			for (uint32_t s = 0; s < wait_semaphore_count; ++s)
+			QueueTimeline & timeline = _queue_timelines[pending->timeline_index];
+			wait_infos.clear();
+			signal_infos.clear();
+			for (std::shared_ptr<Semaphore> const& semaphore : pending->wait_semaphores)
 			{
-				vk_semaphores[s] = pending->wait_semaphores[s]->handle();
-				stage_to_wait[s] = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-				//std::cout << pending->wait_semaphores[s]->name() << ", ";
+				wait_infos.push_back(VkSemaphoreSubmitInfo{
+					.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+					.pNext = nullptr,
+					.semaphore = semaphore->handle(),
+					.value = 0,
+					.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+					.deviceIndex = 0,
+				});
 			}
-			for (uint32_t i = 0; i < signal_semaphore_count; ++i)
+			for (CommandBufferSubmission::TimelineWait const& wait : pending->wait_timelines)
+			{
+				wait_infos.push_back(VkSemaphoreSubmitInfo{
+					.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+					.pNext = nullptr,
+					.semaphore = wait.semaphore->handle(),
+					.value = wait.value,
+					.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+					.deviceIndex = 0,
+				});
+			}
+			signal_infos.push_back(VkSemaphoreSubmitInfo{
+				.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+				.pNext = nullptr,
+				.semaphore = timeline.semaphore->handle(),
+				.value = pending->timeline_value,
+				.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+				.deviceIndex = 0,
+			});
+			for (std::shared_ptr<Semaphore> const& semaphore : pending->signal_semaphores)
 			{
-				vk_semaphores[i + wait_semaphore_count] = pending->signal_semaphores[i]->handle();
+				signal_infos.push_back(VkSemaphoreSubmitInfo{
+					.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+					.pNext = nullptr,
+					.semaphore = semaphore->handle(),
+					.value = 0,
+					.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+					.deviceIndex = 0,
+				});
 			}
-			//std::cout << std::endl;
-			VkCommandBuffer vk_cb = pending->cb->handle();
-			VkSemaphore * sem_to_wait = vk_semaphores.data();
-			VkSemaphore * sem_to_signal = vk_semaphores.data() + wait_semaphore_count;
-
-			VkSubmitInfo submission{
-				.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-				.waitSemaphoreCount = wait_semaphore_count,
-				.pWaitSemaphores = sem_to_wait,
-				.pWaitDstStageMask = stage_to_wait.data(),
-				.commandBufferCount = 1,
-				.pCommandBuffers = &vk_cb,
-				.signalSemaphoreCount = signal_semaphore_count,
-				.pSignalSemaphores = sem_to_signal,
+			VkCommandBufferSubmitInfo cb_info{
+				.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO,
+				.pNext = nullptr,
+				.commandBuffer = pending->cb->handle(),
+				.deviceMask = 0,
+			};
+
+			VkSubmitInfo2 submission{
+				.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
+				.pNext = nullptr,
+				.flags = 0,
+				.waitSemaphoreInfoCount = wait_infos.size32(),
+				.pWaitSemaphoreInfos = wait_infos.data(),
+				.commandBufferInfoCount = 1,
+				.pCommandBufferInfos = &cb_info,
+				.signalSemaphoreInfoCount = signal_infos.size32(),
+				.pSignalSemaphoreInfos = signal_infos.data(),
 			};
-			VkFence fence_to_signal = pending->signal_fence->handle();
 			assert(pending->queue);
 			pending->queue->mutex().lock();
 			std::TickTock_hrc tt;
 			tt.tick();
-			VkResult res = vkQueueSubmit(pending->queue->handle(), 1, &submission, fence_to_signal);
+			VkResult res = vkQueueSubmit2(pending->queue->handle(), 1, &submission, VK_NULL_HANDLE);
 			tt.tock();
 			pending->queue->mutex().unlock();
 			VK_CHECK(res, "Failed submission");
+			assert(pending->timeline_value > timeline.submitted_value);
+			timeline.submitted_value = pending->timeline_value;
+			++_frame_submissions;
 			if (log)
 			{
 				std::chrono::microseconds waited = std::chrono::duration_cast<std::chrono::microseconds>(tt.duration());
-				application()->logger()(std::format("Submitted (latency = {}us)", waited.count()), Logger::Options::TagInfo);
+				application()->logger()(std::format("Submitted (value = {}, latency = {}us)", pending->timeline_value, waited.count()), Logger::Options::TagInfo);
 			}
 
 			application()->deviceWaitIdle();
@@ -1492,6 +1659,23 @@ namespace vkl
 		_cb_mutex.unlock();
 	}
 
+	uint64_t LinearExecutor::latestSubmissionValue(Queue * queue)
+	{
+		return _queue_timelines[getQueueTimelineIndex(queue ? queue : _main_queue.get())].submitted_value;
+	}
+
+	bool LinearExecutor::submissionIsComplete(uint64_t value, Queue * queue)
+	{
+		return _queue_timelines[getQueueTimelineIndex(queue ? queue : _main_queue.get())].semaphore->reached(value);
+	}
+
+	VkResult LinearExecutor::waitForSubmission(uint64_t value, Queue * queue, uint64_t timeout)
+	{
+		const QueueTimeline & timeline = _queue_timelines[getQueueTimelineIndex(queue ? queue : _main_queue.get())];
+		assert(value <= timeline.submitted_value);
+		return timeline.semaphore->wait(value, timeout);
+	}
+
 	static thread_local MyVector<VkFence> _fences;
 
 	void LinearExecutor::waitOnCommandCompletion(bool global_wait, uint64_t timeout)
@@ -1505,25 +1689,36 @@ namespace vkl
 		}
 		else
 		{
-			_fences.clear();
-			for (auto it = _previous_cbs.begin(), end = _previous_cbs.end(); it != end; ++it)
-			{
-				_fences.push_back(it->get()->signal_fence->handle());
-			}
-			if (_fences)
+			static thread_local MyVector<VkSemaphore> semaphores;
+			static thread_local MyVector<uint64_t> values;
+			semaphores.clear();
+			values.clear();
+			for (QueueTimeline const& timeline : _queue_timelines)
 			{
-				result = vkWaitForFences(device(), _fences.size32(), _fences.data(), VK_TRUE, timeout);
+				semaphores.push_back(timeline.semaphore->handle());
+				values.push_back(timeline.submitted_value);
 			}
+			VkSemaphoreWaitInfo wait_info{
+				.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+				.pNext = nullptr,
+				.flags = 0,
+				.semaphoreCount = semaphores.size32(),
+				.pSemaphores = semaphores.data(),
+				.pValues = values.data(),
+			};
+			result = vkWaitSemaphores(device(), &wait_info, timeout);
 		}
 		VK_CHECK(result, "Failed to wait for all completion");
 
 		for (auto it = _previous_cbs.begin(), end = _previous_cbs.end(); it != end; ++it)
 		{
-			VkResult result = it->get()->signal_fence->getStatus();
-			//assert(result != VK_NOT_READY);
 			it->get()->finish(result);
 		}
 		_previous_cbs.clear();
+		for (QueueTimeline & timeline : _queue_timelines)
+		{
+			timeline.completed_value = timeline.submitted_value;
+		}
 		_cb_mutex.unlock();
 	}
 
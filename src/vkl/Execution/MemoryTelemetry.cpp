@@ -0,0 +1,327 @@
+#include <vkl/Execution/MemoryTelemetry.hpp>
+
+#include <vkl/Utils/StatRecorder.hpp>
+#include <vkl/IO/GuiContext.hpp>
+
+#include <fstream>
+#include <format>
+
+namespace vkl
+{
+	const char * GetMemoryCategoryName(MemoryCategory category)
+	{
+		const char * res = "";
+		switch (category)
+		{
+		case MemoryCategory::Auto:
+			res = "Auto";
+			break;
+		case MemoryCategory::Mesh:
+			res = "Mesh";
+			break;
+		case MemoryCategory::Texture:
+			res = "Texture";
+			break;
+		case MemoryCategory::RenderTarget:
+			res = "RenderTarget";
+			break;
+		case MemoryCategory::Staging:
+			res = "Staging";
+			break;
+		case MemoryCategory::Uniform:
+			res = "Uniform";
+			break;
+		case MemoryCategory::AccelerationStructure:
+			res = "AccelerationStructure";
+			break;
+		case MemoryCategory::Other:
+			res = "Other";
+			break;
+		}
+		return res;
+	}
+
+	MemoryCategory DeduceBufferMemoryCategory(VkBufferUsageFlags usage, VmaMemoryUsage mem_usage)
+	{
+		MemoryCategory res = MemoryCategory::Other;
+		const bool host_visible = (mem_usage == VMA_MEMORY_USAGE_CPU_ONLY) || (mem_usage == VMA_MEMORY_USAGE_CPU_TO_GPU) || (mem_usage == VMA_MEMORY_USAGE_GPU_TO_CPU) || (mem_usage == VMA_MEMORY_USAGE_CPU_COPY);
+		if (usage & VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR)
+		{
+			res = MemoryCategory::AccelerationStructure;
+		}
+		else if (usage & (VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT))
+		{
+			res = MemoryCategory::Mesh;
+		}
+		else if (host_visible && (usage & (VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT)))
+		{
+			res = MemoryCategory::Staging;
+		}
+		else if (usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
+		{
+			res = MemoryCategory::Uniform;
+		}
+		return res;
+	}
+
+	MemoryCategory DeduceImageMemoryCategory(VkImageUsageFlags usage)
+	{
+		MemoryCategory res = MemoryCategory::Other;
+		if (usage & (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_STORAGE_BIT))
+		{
+			res = MemoryCategory::RenderTarget;
+		}
+		else if (usage & VK_IMAGE_USAGE_SAMPLED_BIT)
+		{
+			res = MemoryCategory::Texture;
+		}
+		return res;
+	}
+
+	MemoryTelemetry::MemoryTelemetry(CreateInfo const& ci) :
+		VkObject(ci.app, ci.name),
+		_over_budget_threshold(ci.over_budget_threshold),
+		_report_path(ci.report_path)
+	{}
+
+	MemoryTelemetry::~MemoryTelemetry()
+	{
+		_over_budget_callbacks.clear();
+	}
+
+	void MemoryTelemetry::onAllocate(MemoryCategory category, VkDeviceSize size)
+	{
+		assert(category < MemoryCategory::MAX_ENUM);
+		CategoryCounters & counters = _categories[size_t(category)];
+		const VkDeviceSize bytes = counters.bytes.fetch_add(size) + size;
+		++counters.allocations;
+		VkDeviceSize peak = counters.peak_bytes.load();
+		while (peak < bytes && !counters.peak_bytes.compare_exchange_weak(peak, bytes));
+	}
+
+	void MemoryTelemetry::onFree(MemoryCategory category, VkDeviceSize size)
+	{
+		assert(category < MemoryCategory::MAX_ENUM);
+		CategoryCounters & counters = _categories[size_t(category)];
+		counters.bytes -= size;
+		--counters.allocations;
+	}
+
+	MemoryTelemetry::CategoryStats MemoryTelemetry::categoryStats(MemoryCategory category) const
+	{
+		CategoryCounters const& counters = _categories[size_t(category)];
+		return CategoryStats{
+			.bytes = counters.bytes.load(),
+			.peak_bytes = counters.peak_bytes.load(),
+			.allocations = counters.allocations.load(),
+		};
+	}
+
+	void MemoryTelemetry::sample()
+	{
+		const VkPhysicalDeviceMemoryProperties * props = nullptr;
+		vmaGetMemoryProperties(application()->allocator(), &props);
+		std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets;
+		vmaGetHeapBudgets(application()->allocator(), budgets.data());
+
+		MyVector<OverBudget> over_budgets;
+		{
+			std::unique_lock lock(_mutex);
+			_heaps.resize(props->memoryHeapCount);
+			_heaps_over_budget.resize(props->memoryHeapCount, 0);
+			for (uint32_t h = 0; h < props->memoryHeapCount; ++h)
+			{
+				VmaBudget const& b = budgets[h];
+				HeapBudget & heap = _heaps[h];
+				heap = HeapBudget{
+					.flags = props->memoryHeaps[h].flags,
+					.usage = b.usage,
+					.budget = b.budget,
+					.block_bytes = b.statistics.blockBytes,
+					.allocation_bytes = b.statistics.allocationBytes,
+					.block_count = b.statistics.blockCount,
+					.allocation_count = b.statistics.allocationCount,
+				};
+				const VkDeviceSize threshold = static_cast<VkDeviceSize>(double(heap.budget) * double(_over_budget_threshold));
+				const bool over = heap.usage > threshold;
+				if (over && !_heaps_over_budget[h])
+				{
+					over_budgets.push_back(OverBudget{
+						.heap = h,
+						.budget = heap,
+						.threshold = threshold,
+					});
+				}
+				_heaps_over_budget[h] = over ? 1 : 0;
+			}
+			++_samples;
+		}
+
+		for (OverBudget const& ob : over_budgets)
+		{
+			const double MiB = 1024.0 * 1024.0;
+			application()->logger()(std::format("{}: heap {} over budget: {:.1f} MiB used / {:.1f} MiB", name(), ob.heap, double(ob.budget.usage) / MiB, double(ob.budget.budget) / MiB), Logger::Options::TagWarning);
+			for (auto const& [id, callback] : _over_budget_callbacks)
+			{
+				callback(ob);
+			}
+		}
+	}
+
+	MyVector<MemoryTelemetry::HeapBudget> MemoryTelemetry::heapBudgets() const
+	{
+		std::unique_lock lock(_mutex);
+		return _heaps;
+	}
+
+	uint32_t MemoryTelemetry::addOverBudgetCallback(OverBudgetCallback const& callback)
+	{
+		const uint32_t res = _callback_counter;
+		++_callback_counter;
+		_over_budget_callbacks[res] = callback;
+		return res;
+	}
+
+	void MemoryTelemetry::removeOverBudgetCallback(uint32_t id)
+	{
+		_over_budget_callbacks.erase(id);
+	}
+
+	void MemoryTelemetry::createStatRecords(StatRecords & records)
+	{
+		const double MiB_scale = 1.0 / (1024.0 * 1024.0);
+		const VkPhysicalDeviceMemoryProperties * props = nullptr;
+		vmaGetMemoryProperties(application()->allocator(), &props);
+		for (uint32_t h = 0; h < props->memoryHeapCount; ++h)
+		{
+			const bool device_local = props->memoryHeaps[h].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT;
+			StatRecord<uint64_t> * budget_record = records.createRecord<uint64_t>({
+				.name = std::format("Heap {} Budget{}", h, device_local ? " (device local)" : ""),
+				.scale = MiB_scale,
+				.provider = [this, h]() -> uint64_t {return (h < _heaps.size32()) ? _heaps[h].budget : 0; },
+				.unit = "MiB",
+			});
+			budget_record->createChildRecord<uint64_t>({
+				.name = "Usage",
+				.scale = MiB_scale,
+				.provider = [this, h]() -> uint64_t {return (h < _heaps.size32()) ? _heaps[h].usage : 0; },
+				.unit = "MiB",
+			});
+		}
+		StatRecord<uint64_t> * tracked_record = records.createRecord<uint64_t>({
+			.name = "Tracked Memory",
+			.scale = MiB_scale,
+			.provider = [this]() -> uint64_t {
+				uint64_t res = 0;
+				for (CategoryCounters const& counters : _categories)
+				{
+					res += counters.bytes.load();
+				}
+				return res;
+			},
+			.unit = "MiB",
+		});
+		for (size_t c = size_t(MemoryCategory::Auto) + 1; c < size_t(MemoryCategory::MAX_ENUM); ++c)
+		{
+			tracked_record->createChildRecord<uint64_t>({
+				.name = GetMemoryCategoryName(MemoryCategory(c)),
+				.scale = MiB_scale,
+				.provider = [this, c]() -> uint64_t {return _categories[c].bytes.load(); },
+				.unit = "MiB",
+			});
+		}
+	}
+
+	void MemoryTelemetry::writeReport(std::ostream & out) const
+	{
+		const MyVector<HeapBudget> heaps = heapBudgets();
+		out << "{\n\t\"heaps\": [";
+		for (uint32_t h = 0; h < heaps.size32(); ++h)
+		{
+			HeapBudget const& heap = heaps[h];
+			out << (h ? ",\n" : "\n");
+			out << std::format("\t\t{{\"index\": {}, \"device_local\": {}, \"usage\": {}, \"budget\": {}, \"block_bytes\": {}, \"allocation_bytes\": {}, \"block_count\": {}, \"allocation_count\": {}}}",
+				h, (heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) ? "true" : "false", heap.usage, heap.budget, heap.block_bytes, heap.allocation_bytes, heap.block_count, heap.allocation_count);
+		}
+		out << (heaps.empty() ? "],\n" : "\n\t],\n");
+		out << "\t\"categories\": [";
+		for (size_t c = size_t(MemoryCategory::Auto) + 1; c < size_t(MemoryCategory::MAX_ENUM); ++c)
+		{
+			const CategoryStats stats = categoryStats(MemoryCategory(c));
+			out << (c > 1 ? ",\n" : "\n");
+			out << std::format("\t\t{{\"name\": \"{}\", \"bytes\": {}, \"peak_bytes\": {}, \"allocations\": {}}}", GetMemoryCategoryName(MemoryCategory(c)), stats.bytes, stats.peak_bytes, stats.allocations);
+		}
+		out << "\n\t],\n";
+		// Already JSON
+		char * vma_stats = nullptr;
+		vmaBuildStatsString(application()->allocator(), &vma_stats, VK_FALSE);
+		out << "\t\"vma\": " << (vma_stats ? vma_stats : "null") << "\n}\n";
+		if (vma_stats)
+		{
+			vmaFreeStatsString(application()->allocator(), vma_stats);
+		}
+	}
+
+	bool MemoryTelemetry::dumpReport(std::filesystem::path const& path)
+	{
+		std::ofstream file(path, std::ios::trunc);
+		bool res = file.is_open();
+		if (res)
+		{
+			writeReport(file);
+			res = file.good();
+		}
+		if (res)
+		{
+			application()->logger()(std::format("{}: memory report written to {}", name(), path.string()), Logger::Options::TagSuccess);
+		}
+		else
+		{
+			application()->logger()(std::format("{}: could not write the memory report to {}", name(), path.string()), Logger::Options::TagError);
+		}
+		return res;
+	}
+
+	void MemoryTelemetry::declareGUI(GuiContext & ctx)
+	{
+		ImGui::PushID(this);
+		const double MiB = 1024.0 * 1024.0;
+		const MyVector<HeapBudget> heaps = heapBudgets();
+		for (uint32_t h = 0; h < heaps.size32(); ++h)
+		{
+			HeapBudget const& heap = heaps[h];
+			const float fraction = heap.budget ? float(double(heap.usage) / double(heap.budget)) : 0.0f;
+			ImGui::Text("Heap %u%s: %.1f / %.1f MiB", h, (heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) ? " (device local)" : "", double(heap.usage) / MiB, double(heap.budget) / MiB);
+			ImGui::ProgressBar(fraction);
+		}
+		ImGui::SliderFloat("Over budget threshold", &_over_budget_threshold, 0.5f, 1.0f);
+		if (ImGui::BeginTable("categories", 4))
+		{
+			ImGui::TableSetupColumn("Category");
+			ImGui::TableSetupColumn("MiB");
+			ImGui::TableSetupColumn("Peak MiB");
+			ImGui::TableSetupColumn("Allocations");
+			ImGui::TableHeadersRow();
+			for (size_t c = size_t(MemoryCategory::Auto) + 1; c < size_t(MemoryCategory::MAX_ENUM); ++c)
+			{
+				const CategoryStats stats = categoryStats(MemoryCategory(c));
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				ImGui::Text("%s", GetMemoryCategoryName(MemoryCategory(c)));
+				ImGui::TableNextColumn();
+				ImGui::Text("%.2f", double(stats.bytes) / MiB);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.2f", double(stats.peak_bytes) / MiB);
+				ImGui::TableNextColumn();
+				ImGui::Text("%u", stats.allocations);
+			}
+			ImGui::EndTable();
+		}
+		if (ImGui::Button("Dump memory report"))
+		{
+			dumpReport(_report_path);
+		}
+		ImGui::SetItemTooltip("%s", _report_path.string().c_str());
+		ImGui::PopID();
+	}
+}
@@ -8,46 +8,139 @@
 #include <vkl/Commands/Command.hpp>
 #include <vkl/Execution/DescriptorSetsManager.hpp>
 #include <vkl/VkObjects/Framebuffer.hpp>
+#include <vkl/Execution/UpdateContext.hpp>
+#include <vkl/Execution/ThreadPool.hpp>
+
+#include <unordered_set>
 
 namespace vkl
 {
-	void ResourcesLists::update(UpdateContext& context)
+	namespace
 	{
-		for (auto& image_view : images)
+		// Smaller phases are updated serially
+		constexpr size_t MinParallelUpdateObjects = 32;
+		constexpr size_t MinObjectsPerChunk = 8;
+
+		template <class T, class UpdateFunction>
+		void UpdateInParallel(MyVector<std::shared_ptr<T>> const& objects, UpdateContext & context, DelayedTaskExecutor & executor, UpdateFunction const& update)
 		{
-			assert(!!image_view);
-			const bool invalidated = image_view->updateResource(context);
+			// An object can be listed several times, it must not be updated concurrently
+			MyVector<T*> unique_objects;
+			unique_objects.reserve(objects.size());
+			{
+				std::unordered_set<T*> seen;
+				seen.reserve(objects.size());
+				for (std::shared_ptr<T> const& object : objects)
+				{
+					assert(!!object);
+					if (seen.insert(object.get()).second)
+					{
+						unique_objects.push_back(object.get());
+					}
+				}
+			}
+
+			const size_t n = unique_objects.size();
+			const size_t max_chunks = 4 * (executor.maxCapacity() + 1);
+			const size_t chunk_size = std::max(std::divCeil(n, max_chunks), MinObjectsPerChunk);
+			const size_t chunks = std::divCeil(n, chunk_size);
+
+			// One context per chunk, merged in order: the parent context receives the same lists as with a serial update
+			struct Shard
+			{
+				std::unique_ptr<DescriptorWriter> descriptor_writer = nullptr;
+				std::unique_ptr<UpdateContext> context = nullptr;
+				// Summed in the parent counters by the merge
+				std::unique_ptr<FramePerfCounters> frame_perf_counters = nullptr;
+			};
+			MyVector<Shard> shards(chunks);
+
+			ProcessInParallel(&executor, chunks, "ResourcesLists::update", [&](size_t chunk)
+			{
+				Shard & shard = shards[chunk];
+				shard.descriptor_writer = std::make_unique<DescriptorWriter>(DescriptorWriter::CI{
+					.app = context.application(),
+					.name = context.name() + ".DescriptorWriter",
+				});
+				shard.context = std::make_unique<UpdateContext>(context, *shard.descriptor_writer);
+				if (context.getFramePerfCounters())
+				{
+					shard.frame_perf_counters = std::make_unique<FramePerfCounters>();
+					shard.context->setFramePerfCounters(shard.frame_perf_counters.get());
+				}
+				const size_t begin = chunk * chunk_size;
+				const size_t end = std::min(begin + chunk_size, n);
+				for (size_t i = begin; i < end; ++i)
+				{
+					update(*unique_objects[i], *shard.context);
+				}
+			});
+
+			for (Shard & shard : shards)
+			{
+				context.merge(std::move(*shard.context));
+			}
 		}
 
-		for (auto& buffer : buffers)
+		template <class T, class UpdateFunction>
+		void UpdatePhase(MyVector<std::shared_ptr<T>> const& objects, UpdateContext & context, DelayedTaskExecutor * executor, size_t FramePerfCounters::* time_counter, UpdateFunction const& update)
 		{
-			assert(!!buffer);
-			const bool invalidated = buffer->updateResource(context);
+			if (objects.empty())
+			{
+				return;
+			}
+			std::TickTock_hrc tt;
+			tt.tick();
+			if (executor && executor->isMultiThreaded() && objects.size() >= MinParallelUpdateObjects)
+			{
+				UpdateInParallel(objects, context, *executor, update);
+			}
+			else
+			{
+				for (std::shared_ptr<T> const& object : objects)
+				{
+					assert(!!object);
+					update(*object, context);
+				}
+			}
+			if (FramePerfCounters * fpc = context.getFramePerfCounters())
+			{
+				fpc->*time_counter += tt.tockd().count();
+			}
 		}
+	}
 
-		for (auto& sampler : samplers)
+	void ResourcesLists::update(UpdateContext& context, DelayedTaskExecutor * executor)
+	{
+		UpdatePhase(images, context, nullptr, &FramePerfCounters::update_images_time, [](ImageView & image_view, UpdateContext & ctx)
 		{
-			assert(!!sampler);
-			const bool invalidated = sampler->updateResources(context);
-		}
+			const bool invalidated = image_view.updateResource(ctx);
+		});
 
-		for (auto& command : commands)
+		UpdatePhase(buffers, context, executor, &FramePerfCounters::update_buffers_time, [](Buffer & buffer, UpdateContext & ctx)
 		{
-			assert(!!command);
-			const bool invalidated = command->updateResources(context);
-		}
+			const bool invalidated = buffer.updateResource(ctx);
+		});
 
-		for (auto& set : sets)
+		UpdatePhase(samplers, context, nullptr, &FramePerfCounters::update_samplers_time, [](Sampler & sampler, UpdateContext & ctx)
 		{
-			assert(!!set);
-			const bool invalidated = set->updateResources(context);
-		}
+			const bool invalidated = sampler.updateResources(ctx);
+		});
 
-		for (auto& fb : framebuffers)
+		UpdatePhase(commands, context, executor, &FramePerfCounters::update_commands_time, [](Command & command, UpdateContext & ctx)
 		{
-			assert(fb);
-			const bool invalidated = fb->updateResources(context);
-		}
+			const bool invalidated = command.updateResources(ctx);
+		});
+
+		UpdatePhase(sets, context, executor, &FramePerfCounters::update_sets_time, [](DescriptorSetAndPool & set, UpdateContext & ctx)
+		{
+			const bool invalidated = set.updateResources(ctx);
+		});
+
+		UpdatePhase(framebuffers, context, nullptr, &FramePerfCounters::update_framebuffers_time, [](Framebuffer & fb, UpdateContext & ctx)
+		{
+			const bool invalidated = fb.updateResources(ctx);
+		});
 	}
 
 	void ResourcesLists::clear()
@@ -70,6 +163,7 @@ namespace vkl
 		samplers += o.samplers;
 		sets += o.sets;
 		commands += o.commands;
+		framebuffers += o.framebuffers;
 		return *this;
 	}
 
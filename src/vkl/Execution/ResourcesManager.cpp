@@ -20,7 +20,8 @@ namespace vkl
 		_descriptor_writer(DescriptorWriter::CI{
 			.app = application(),
 			.name = name() + ".DescriptorWriter",
-		})
+		}),
+		_parallel_update(ci.parallel_update)
 	{
 		assert(!application()->dependenciesTracker());
 		application()->dependenciesTrackerRef() = std::make_unique<DependencyTracker>(DependencyTracker::CI{
@@ -46,6 +47,8 @@ namespace vkl
 	std::shared_ptr<UpdateContext> ResourcesManager::beginUpdateCycle()
 	{
 		++_update_tick;
+		// Memoized DynamicValues are re-evaluated at most once per update cycle
+		DynamicValueEpoch::Global().advance();
 
 		{
 			application()->fileSystem()->resetCache();
@@ -71,7 +74,7 @@ namespace vkl
 	{
 		assert(context);
 		ResourcesLists & resources_to_update = context->resourcesToUpdateLater();
-		resources_to_update.update(*context);
+		resources_to_update.update(*context, _parallel_update ? &application()->threadPool() : nullptr);
 
 		_descriptor_writer.record();
 	}
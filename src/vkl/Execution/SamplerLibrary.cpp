@@ -34,11 +34,10 @@ namespace vkl
 
 	std::shared_ptr<Sampler> SamplerLibrary::getSampler(SamplerInfo const& si)
 	{
-		std::unique_lock lock(_mutex);
-		if (!_map.contains(si))
+		return _cache.findOrEmplace(si, [&]()
 		{
 			const size_t i = _sampler_count.fetch_add(1);
-			std::shared_ptr<Sampler> res = std::make_shared<Sampler>(Sampler::CI{
+			return std::make_shared<Sampler>(Sampler::CI{
 				.app = application(),
 				.name = name() + ".sampler#"s + std::to_string(i),
 				.flags = si.flags,
@@ -48,10 +47,7 @@ namespace vkl
 				.border_color = si.border_color,
 				.unnormalized_coordinates = si.unnormalized_coordinates,
 			});
-			_map[si] = res;
-			return res;
-		}
-		return _map[si];
+		});
 	}
 
 	std::shared_ptr<Sampler> SamplerLibrary::getNamedSampler(std::string const& name) const
@@ -69,11 +65,12 @@ namespace vkl
 
 	void SamplerLibrary::updateResources(UpdateContext& ctx)
 	{
-		std::unique_lock lock(_mutex);
-		for (auto& [si, s] : _map)
+		_cache.reclaim();
+		_cache.forEach([&](SamplerInfo const& si, std::shared_ptr<Sampler> const& s)
 		{
 			s->updateResources(ctx);
-		}
+		});
+		std::unique_lock lock(_mutex);
 		for (auto& [n, s] : _named_samplers)
 		{
 			s->updateResources(ctx);
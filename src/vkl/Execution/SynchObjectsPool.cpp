@@ -0,0 +1,91 @@
+#include <vkl/Execution/SynchObjectsPool.hpp>
+
+namespace vkl
+{
+	SynchObjectsPool::SynchObjectsPool(CreateInfo const& ci) :
+		VkObject(ci.app, ci.name)
+	{}
+
+	SynchObjectsPool::~SynchObjectsPool()
+	{
+		_free_semaphores.clear();
+		_free_fences.clear();
+	}
+
+	void SynchObjectsPool::release(Semaphore * semaphore)
+	{
+		std::unique_lock lock(_mutex);
+		_free_semaphores.push_back(std::unique_ptr<Semaphore>(semaphore));
+	}
+
+	void SynchObjectsPool::release(Fence * fence)
+	{
+		// A fence released before being submitted is still unsignaled
+		if (fence->getStatus() == VK_SUCCESS)
+		{
+			fence->reset();
+		}
+		std::unique_lock lock(_mutex);
+		_free_fences.push_back(std::unique_ptr<Fence>(fence));
+	}
+
+	std::shared_ptr<Semaphore> SynchObjectsPool::getSemaphore()
+	{
+		Semaphore * semaphore = nullptr;
+		{
+			std::unique_lock lock(_mutex);
+			if (!_free_semaphores.empty())
+			{
+				semaphore = _free_semaphores.back().release();
+				_free_semaphores.pop_back();
+			}
+			else
+			{
+				semaphore = new Semaphore(application(), name() + ".Semaphore_" + std::to_string(_created_semaphores));
+				++_created_semaphores;
+			}
+		}
+		std::weak_ptr<SynchObjectsPool> pool = weak_from_this();
+		return std::shared_ptr<Semaphore>(semaphore, [pool](Semaphore * s)
+		{
+			if (std::shared_ptr<SynchObjectsPool> p = pool.lock())
+			{
+				p->release(s);
+			}
+			else
+			{
+				delete s;
+			}
+		});
+	}
+
+	std::shared_ptr<Fence> SynchObjectsPool::getFence()
+	{
+		Fence * fence = nullptr;
+		{
+			std::unique_lock lock(_mutex);
+			if (!_free_fences.empty())
+			{
+				fence = _free_fences.back().release();
+				_free_fences.pop_back();
+			}
+			else
+			{
+				fence = new Fence(application(), name() + ".Fence_" + std::to_string(_created_fences));
+				++_created_fences;
+			}
+		}
+		std::weak_ptr<SynchObjectsPool> pool = weak_from_this();
+		return std::shared_ptr<Fence>(fence, [pool](Fence * f)
+		{
+			if (std::shared_ptr<SynchObjectsPool> p = pool.lock())
+			{
+				p->release(f);
+			}
+			else
+			{
+				delete f;
+			}
+		});
+	}
+}
@@ -862,6 +862,138 @@ namespace vkl
 
 
 
+	namespace
+	{
+		constexpr uint64_t BarrierRangeEnd(uint64_t begin, uint64_t len, uint64_t remaining)
+		{
+			return (len == remaining) ? std::numeric_limits<uint64_t>::max() : (begin + len);
+		}
+
+		// Contiguous or overlapping [b0, e0) and [b1, e1) -> union in [b0, e0)
+		template <class UInt>
+		bool UniteRanges(UInt & base, UInt & count, UInt other_base, UInt other_count, UInt remaining)
+		{
+			const uint64_t e0 = BarrierRangeEnd(base, count, remaining);
+			const uint64_t e1 = BarrierRangeEnd(other_base, other_count, remaining);
+			bool res = (base <= e1) && (other_base <= e0);
+			if (res)
+			{
+				const uint64_t e = std::max(e0, e1);
+				base = std::min(base, other_base);
+				count = (e == std::numeric_limits<uint64_t>::max()) ? remaining : static_cast<UInt>(e - base);
+			}
+			return res;
+		}
+
+		template <class Barrier>
+		void CombineMasks(Barrier & a, Barrier const& b)
+		{
+			a.srcStageMask |= b.srcStageMask;
+			a.srcAccessMask |= b.srcAccessMask;
+			a.dstStageMask |= b.dstStageMask;
+			a.dstAccessMask |= b.dstAccessMask;
+		}
+
+		template <class Barrier>
+		bool SameMasks(Barrier const& a, Barrier const& b)
+		{
+			return a.srcStageMask == b.srcStageMask && a.srcAccessMask == b.srcAccessMask && a.dstStageMask == b.dstStageMask && a.dstAccessMask == b.dstAccessMask
+				&& a.srcQueueFamilyIndex == b.srcQueueFamilyIndex && a.dstQueueFamilyIndex == b.dstQueueFamilyIndex;
+		}
+
+		bool TryMergeBarrier(VkBufferMemoryBarrier2 & a, VkBufferMemoryBarrier2 const& b)
+		{
+			bool res = false;
+			if (a.buffer == b.buffer && a.srcQueueFamilyIndex == b.srcQueueFamilyIndex && a.dstQueueFamilyIndex == b.dstQueueFamilyIndex)
+			{
+				if (a.offset == b.offset && a.size == b.size)
+				{
+					CombineMasks(a, b);
+					res = true;
+				}
+				else if (SameMasks(a, b))
+				{
+					res = UniteRanges<VkDeviceSize>(a.offset, a.size, b.offset, b.size, VK_WHOLE_SIZE);
+				}
+			}
+			return res;
+		}
+
+		bool TryMergeBarrier(VkImageMemoryBarrier2 & a, VkImageMemoryBarrier2 const& b)
+		{
+			bool res = false;
+			if (a.image == b.image && a.srcQueueFamilyIndex == b.srcQueueFamilyIndex && a.dstQueueFamilyIndex == b.dstQueueFamilyIndex && a.subresourceRange.aspectMask == b.subresourceRange.aspectMask)
+			{
+				const VkImageSubresourceRange & ra = a.subresourceRange;
+				const VkImageSubresourceRange & rb = b.subresourceRange;
+				const bool same_mips = ra.baseMipLevel == rb.baseMipLevel && ra.levelCount == rb.levelCount;
+				const bool same_layers = ra.baseArrayLayer == rb.baseArrayLayer && ra.layerCount == rb.layerCount;
+				if (same_mips && same_layers)
+				{
+					// Layout transitions of the same subresource in the same barrier would not be ordered
+					if (a.newLayout == b.newLayout)
+					{
+						if (a.oldLayout == b.oldLayout || b.oldLayout == b.newLayout)
+						{
+							CombineMasks(a, b);
+							res = true;
+						}
+						else if (a.oldLayout == a.newLayout)
+						{
+							CombineMasks(a, b);
+							a.oldLayout = b.oldLayout;
+							res = true;
+						}
+					}
+				}
+				else if (SameMasks(a, b) && a.oldLayout == b.oldLayout && a.newLayout == b.newLayout)
+				{
+					VkImageSubresourceRange & r = a.subresourceRange;
+					if (same_mips)
+					{
+						res = UniteRanges<uint32_t>(r.baseArrayLayer, r.layerCount, rb.baseArrayLayer, rb.layerCount, VK_REMAINING_ARRAY_LAYERS);
+					}
+					else if (same_layers)
+					{
+						res = UniteRanges<uint32_t>(r.baseMipLevel, r.levelCount, rb.baseMipLevel, rb.levelCount, VK_REMAINING_MIP_LEVELS);
+					}
+				}
+			}
+			return res;
+		}
+
+		template <class Barrier>
+		void MergeBarriersImpl(MyVector<Barrier> & barriers)
+		{
+			size_t i = 0;
+			while (i < barriers.size())
+			{
+				bool merged = false;
+				for (size_t j = i + 1; j < barriers.size(); ++j)
+				{
+					if (TryMergeBarrier(barriers[i], barriers[j]))
+					{
+						barriers[j] = barriers.back();
+						barriers.pop_back();
+						merged = true;
+						break;
+					}
+				}
+				// Otherwise barriers[i] grew: try again, including with the barriers that were rejected before
+				if (!merged)
+				{
+					++i;
+				}
+			}
+		}
+	}
+
+	void MergeBarriers(MyVector<VkBufferMemoryBarrier2>& buffers, MyVector<VkImageMemoryBarrier2>& images)
+	{
+		MergeBarriersImpl(buffers);
+		MergeBarriersImpl(images);
+	}
+
 	void SynchronizationHelper::reset(ExecutionContext* ctx)
 	{
 		_ctx = ctx;
@@ -1018,6 +1150,10 @@ namespace vkl
 
 	void SynchronizationHelper::record()
 	{
+		if (_merge_barriers)
+		{
+			MergeBarriers(_buffers, _images);
+		}
 		if (_buffers || _images)
 		{
 			assert(_ctx);
@@ -1,6 +1,7 @@
 #include <vkl/Execution/ThreadPool.hpp>
 #include <cassert>
 #include <algorithm>
+#include <exception>
 
 #include <iostream>
 
@@ -318,6 +319,30 @@ namespace vkl
 		_aquire_task_condition.notify_one();
 	}
 
+	void ThreadPool::promoteTask(std::shared_ptr<AsynchTask> const& task, TaskPriority priority)
+	{
+		assert(!!task);
+		if (task->priority() >= priority)
+		{
+			return;
+		}
+		// Same order as transferPendingTasks
+		std::unique_lock pending_lock(_pending_mutex);
+		std::unique_lock ready_lock(_ready_mutex);
+		auto it = std::find(_ready_tasks.begin(), _ready_tasks.end(), task);
+		const bool was_ready = (it != _ready_tasks.end());
+		if (was_ready)
+		{
+			_ready_tasks.erase(it);
+		}
+		// Tasks in the other queues are sorted in the ready queue when they become ready
+		task->raisePriority(priority);
+		if (was_ready)
+		{
+			insertSortedTask(_ready_tasks, task);
+		}
+	}
+
 	void ThreadPool::pushTasks(const std::shared_ptr<AsynchTask>* tasks, size_t n)
 	{
 		std::unique_lock lock(_just_pushed_mutex);
@@ -444,4 +469,102 @@ namespace vkl
 	}
 	
 
+	void ProcessInParallel(DelayedTaskExecutor * executor, size_t count, std::string const& name, std::function<void(size_t)> const& process)
+	{
+		// Owned by the helpers too: they can start (or finish taking an index) after this function returned
+		struct SharedState
+		{
+			const std::function<void(size_t)> * process = nullptr;
+			size_t count = 0;
+			std::atomic<size_t> next = 0;
+			std::atomic<size_t> done = 0;
+			// The first exception thrown by process, rethrown by the caller
+			std::mutex error_mutex;
+			std::exception_ptr error = nullptr;
+			std::atomic<bool> failed = false;
+
+			void run()
+			{
+				while (true)
+				{
+					const size_t i = next.fetch_add(1);
+					if (i >= count)
+					{
+						break;
+					}
+					// The remaining indices are skipped after a failure (but still counted, the caller waits for all of them)
+					if (!failed.load(std::memory_order_relaxed))
+					{
+						try
+						{
+							// Valid: the caller waits for all the taken indices
+							(*process)(i);
+						}
+						catch (...)
+						{
+							std::unique_lock lock(error_mutex);
+							if (!error)
+							{
+								error = std::current_exception();
+							}
+							failed = true;
+						}
+					}
+					if (done.fetch_add(1) + 1 == count)
+					{
+						done.notify_all();
+					}
+				}
+			}
+		};
+
+		if (count == 0)
+		{
+			return;
+		}
+
+		std::shared_ptr<SharedState> state = std::make_shared<SharedState>();
+		state->process = &process;
+		state->count = count;
+
+		if (executor && executor->isMultiThreaded() && count > 1)
+		{
+			const size_t n_helpers = std::min<size_t>(count - 1, executor->maxCapacity());
+			std::vector<std::shared_ptr<AsynchTask>> helpers(n_helpers);
+			for (size_t i = 0; i < n_helpers; ++i)
+			{
+				helpers[i] = std::make_shared<AsynchTask>(AsynchTask::CI{
+					.name = name,
+					.verbosity = AsynchTask::Verbosity::None,
+					.priority = TaskPriority::ASAP(),
+					.lambda = [state]() {
+						state->run();
+						return AsynchTask::ReturnType{
+							.success = true,
+						};
+					},
+				});
+			}
+			executor->pushTasks(helpers.data(), helpers.size());
+		}
+
+		// The calling thread (possibly itself a worker of the executor) takes part in the work,
+		// so it finishes even if no worker is available for the helpers
+		state->run();
+
+		// Indices taken by the helpers that are still running
+		size_t done = state->done.load();
+		while (done != count)
+		{
+			state->done.wait(done);
+			done = state->done.load();
+		}
+
+		// All the indices are done: no helper writes the error anymore
+		if (state->error)
+		{
+			std::rethrow_exception(state->error);
+		}
+	}
+
 } // namespace vkl
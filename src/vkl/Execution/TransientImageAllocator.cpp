@@ -0,0 +1,237 @@
+#include <vkl/Execution/TransientImageAllocator.hpp>
+
+#include <algorithm>
+
+namespace vkl
+{
+	TransientImageAllocator::TransientImageAllocator(CreateInfo const& ci) :
+		VkObject(ci.app, ci.name),
+		_enable(ci.enable)
+	{}
+
+	TransientImageAllocator::~TransientImageAllocator()
+	{
+		for (Entry & entry : _entries)
+		{
+			entry.image->setMemoryPlacement({});
+		}
+		_entries.clear();
+		_block = nullptr;
+	}
+
+	void TransientImageAllocator::declare(std::shared_ptr<Image> const& image, Lifetime const& lifetime)
+	{
+		assert(image);
+		_entries.push_back(Entry{
+			.image = image,
+			.lifetime = lifetime,
+		});
+		_should_plan = true;
+	}
+
+	bool TransientImageAllocator::entryChanged(Entry const& entry) const
+	{
+		const bool held = active() && entry.image->holdInstance().valueOr(false);
+		bool res = (held != entry.held);
+		if (!res && held)
+		{
+			const VkImageCreateInfo ci = entry.image->getInstanceCreateInfo();
+			const VkImageCreateInfo & p = entry.planned_ci;
+			res = (ci.extent.width != p.extent.width) || (ci.extent.height != p.extent.height) || (ci.extent.depth != p.extent.depth) ||
+				(ci.format != p.format) || (ci.mipLevels != p.mipLevels) || (ci.arrayLayers != p.arrayLayers) ||
+				(ci.samples != p.samples) || (ci.usage != p.usage) || (ci.flags != p.flags);
+		}
+		return res;
+	}
+
+	void TransientImageAllocator::plan()
+	{
+		_should_plan = false;
+		MyVector<uint32_t> candidates;
+		uint32_t memory_type_bits = uint32_t(-1);
+		for (uint32_t i = 0; i < _entries.size32(); ++i)
+		{
+			Entry & entry = _entries[i];
+			entry.planned = false;
+			entry.held = active() && entry.image->holdInstance().valueOr(false);
+			if (!entry.held)
+			{
+				continue;
+			}
+			entry.planned_ci = entry.image->getInstanceCreateInfo();
+			const VkDeviceImageMemoryRequirements info{
+				.sType = VK_STRUCTURE_TYPE_DEVICE_IMAGE_MEMORY_REQUIREMENTS,
+				.pNext = nullptr,
+				.pCreateInfo = &entry.planned_ci,
+			};
+			VkMemoryRequirements2 requirements{
+				.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2,
+				.pNext = nullptr,
+			};
+			vkGetDeviceImageMemoryRequirements(device(), &info, &requirements);
+			entry.requirements = requirements.memoryRequirements;
+			// An incompatible image keeps a dedicated allocation
+			if ((memory_type_bits & entry.requirements.memoryTypeBits) != 0)
+			{
+				memory_type_bits &= entry.requirements.memoryTypeBits;
+				entry.planned = true;
+				candidates.push_back(i);
+			}
+		}
+
+		// Largest first, each at the lowest offset not overlapping the memory of an image alive at the same time
+		std::sort(candidates.begin(), candidates.end(), [&](uint32_t a, uint32_t b)
+		{
+			return _entries[a].requirements.size > _entries[b].requirements.size;
+		});
+		Stats stats{
+			.images = candidates.size32(),
+		};
+		VkDeviceSize alignment = 1;
+		for (uint32_t c = 0; c < candidates.size32(); ++c)
+		{
+			Entry & entry = _entries[candidates[c]];
+			const VkDeviceSize size = entry.requirements.size;
+			VkDeviceSize offset = 0;
+			bool moved = true;
+			while (moved)
+			{
+				moved = false;
+				for (uint32_t p = 0; p < c; ++p)
+				{
+					Entry const& other = _entries[candidates[p]];
+					const VkDeviceSize other_end = other.offset + other.requirements.size;
+					if (entry.lifetime.overlaps(other.lifetime) && (offset < other_end) && (other.offset < offset + size))
+					{
+						offset = std::alignUp(other_end, entry.requirements.alignment);
+						moved = true;
+					}
+				}
+			}
+			entry.offset = offset;
+			alignment = std::max(alignment, entry.requirements.alignment);
+			stats.aliased_size = std::max(stats.aliased_size, offset + size);
+			stats.summed_size += size;
+		}
+		_stats = stats;
+
+		// The previous block is kept alive by the previous instances
+		_block = nullptr;
+		if (stats.aliased_size)
+		{
+			_block = std::make_shared<ImageMemoryBlock>(ImageMemoryBlock::CI{
+				.app = application(),
+				.requirements = VkMemoryRequirements{
+					.size = stats.aliased_size,
+					.alignment = alignment,
+					.memoryTypeBits = memory_type_bits,
+				},
+			});
+		}
+
+		for (Entry & entry : _entries)
+		{
+			ImageMemoryPlacement placement = {};
+			if (entry.planned)
+			{
+				placement = ImageMemoryPlacement{
+					.block = _block,
+					.offset = entry.offset,
+					.size = entry.requirements.size,
+				};
+			}
+			entry.image->setMemoryPlacement(placement);
+			// Re-created at the new place by its update
+			entry.image->destroyInstanceIFN();
+		}
+
+		if (_stats.images)
+		{
+			const double MiB = 1024.0 * 1024.0;
+			application()->logger()(std::format("{}: {} transient images, {:.1f} MiB aliased instead of {:.1f} MiB", name(), _stats.images, double(_stats.aliased_size) / MiB, double(_stats.summed_size) / MiB), Logger::Options::TagInfo);
+		}
+	}
+
+	void TransientImageAllocator::updateResources(UpdateContext & ctx)
+	{
+		if (!_should_plan)
+		{
+			for (Entry const& entry : _entries)
+			{
+				if (entryChanged(entry))
+				{
+					_should_plan = true;
+					break;
+				}
+			}
+		}
+		if (_should_plan)
+		{
+			plan();
+		}
+	}
+
+	void TransientImageAllocator::recordBeginFrame(ExecutionRecorder & exec)
+	{
+		if (!_block)
+		{
+			return;
+		}
+		exec([this](RecordContext & ctx)
+		{
+			std::shared_ptr<ExecutionNode> node = _exec_node_cache.getCleanNode([&]()
+			{
+				return std::make_shared<ExecutionNode>(ExecutionNode::CI{
+					.app = application(),
+					.name = name() + ".BeginFrame",
+				});
+			});
+			for (Entry const& entry : _entries)
+			{
+				std::shared_ptr<ImageInstance> const& ii = entry.image->instance();
+				if (entry.planned && ii && ii->isPlaced())
+				{
+					VkImageCreateInfo const& ci = ii->createInfo();
+					// Wait for any previous use of the memory, then forget the content (the next use transitions from the undefined layout)
+					node->resources() += ImageUsage{
+						.ii = ii,
+						.range = VkImageSubresourceRange{
+							.aspectMask = getImageAspectFromFormat(ci.format),
+							.baseMipLevel = 0,
+							.levelCount = ci.mipLevels,
+							.baseArrayLayer = 0,
+							.layerCount = ci.arrayLayers,
+						},
+						.begin_state = ResourceState2{
+							.access = VK_ACCESS_2_MEMORY_WRITE_BIT,
+							.stage = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+							.layout = VK_IMAGE_LAYOUT_GENERAL,
+						},
+						.end_state = ResourceState2{
+							.access = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT,
+							.stage = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+							.layout = VK_IMAGE_LAYOUT_UNDEFINED,
+						},
+					};
+				}
+			}
+			return node;
+		});
+	}
+
+	void TransientImageAllocator::declareGUI(GuiContext & ctx)
+	{
+		ImGui::PushID(this);
+		if (ImGui::Checkbox("Alias transient images", &_enable))
+		{
+			_should_plan = true;
+		}
+		const double MiB = 1024.0 * 1024.0;
+		ImGui::Text("Transient images: %u, %.1f MiB aliased / %.1f MiB", _stats.images, double(_stats.aliased_size) / MiB, double(_stats.summed_size) / MiB);
+		if (_suspended)
+		{
+			ImGui::Text("Suspended");
+		}
+		ImGui::PopID();
+	}
+}
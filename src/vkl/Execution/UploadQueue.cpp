@@ -2,11 +2,13 @@
 
 #include <vkl/VkObjects/ImageView.hpp>
 
+#include <algorithm>
+
 namespace vkl
 {
 	size_t AsynchUpload::getSize() const
 	{
-		size_t res = 0;
+		size_t res = source.size();
 		for (const auto& src : sources)
 		{
 			res += src.obj.size();
@@ -22,22 +24,36 @@ namespace vkl
 
 	void UploadQueue::enqueue(AsynchUpload const& upload)
 	{
-		_mutex.lock();
-		{
-			_queue.push_back(upload);
-		}
-		_mutex.unlock();
+		enqueue(AsynchUpload(upload));
 	}
 
 	void UploadQueue::enqueue(AsynchUpload && upload)
 	{
 		_mutex.lock();
 		{
-			_queue.emplace_back(std::move(upload));
+			// Most uploads are ASAP: fast path to the back of the queue
+			if (_queue.empty() || _queue.back().priority >= upload.priority)
+			{
+				_queue.emplace_back(std::move(upload));
+			}
+			else
+			{
+				auto it = std::upper_bound(_queue.begin(), _queue.end(), upload.priority, [](TaskPriority const& p, AsynchUpload const& u)
+				{
+					return p > u.priority;
+				});
+				_queue.emplace(it, std::move(upload));
+			}
 		}
 		_mutex.unlock();
 	}
 
+	size_t UploadQueue::size()
+	{
+		std::unique_lock lock(_mutex);
+		return _queue.size();
+	}
+
 	ResourcesToUpload UploadQueue::consume(Budget const& b)
 	{
 		Budget total;
@@ -0,0 +1,486 @@
+#include <vkl/IO/CompressedImage.hpp>
+
+#include <cstring>
+#include <cctype>
+#include <algorithm>
+#include <format>
+#include <bit>
+
+namespace vkl
+{
+	namespace
+	{
+		constexpr uint32_t MakeFourCC(char a, char b, char c, char d)
+		{
+			return uint32_t(uint8_t(a)) | (uint32_t(uint8_t(b)) << 8) | (uint32_t(uint8_t(c)) << 16) | (uint32_t(uint8_t(d)) << 24);
+		}
+
+		constexpr uint8_t KTX2Identifier[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+
+		struct KTX2Header
+		{
+			uint32_t vk_format;
+			uint32_t type_size;
+			uint32_t pixel_width;
+			uint32_t pixel_height;
+			uint32_t pixel_depth;
+			uint32_t layer_count;
+			uint32_t face_count;
+			uint32_t level_count;
+			uint32_t supercompression_scheme;
+			uint32_t dfd_byte_offset;
+			uint32_t dfd_byte_length;
+			uint32_t kvd_byte_offset;
+			uint32_t kvd_byte_length;
+			// Followed by sgd_byte_offset and sgd_byte_length (uint64_t), unused since supercompression is not supported
+		};
+		static_assert(sizeof(KTX2Header) == 52);
+
+		struct KTX2LevelIndex
+		{
+			uint64_t byte_offset;
+			uint64_t byte_length;
+			uint64_t uncompressed_byte_length;
+		};
+
+		constexpr uint32_t DDSMagic = MakeFourCC('D', 'D', 'S', ' ');
+
+		struct DDSPixelFormat
+		{
+			uint32_t size;
+			uint32_t flags;
+			uint32_t four_cc;
+			uint32_t rgb_bit_count;
+			uint32_t r_mask;
+			uint32_t g_mask;
+			uint32_t b_mask;
+			uint32_t a_mask;
+		};
+
+		struct DDSHeader
+		{
+			uint32_t size;
+			uint32_t flags;
+			uint32_t height;
+			uint32_t width;
+			uint32_t pitch_or_linear_size;
+			uint32_t depth;
+			uint32_t mip_map_count;
+			uint32_t reserved_1[11];
+			DDSPixelFormat pixel_format;
+			uint32_t caps;
+			uint32_t caps_2;
+			uint32_t caps_3;
+			uint32_t caps_4;
+			uint32_t reserved_2;
+		};
+		static_assert(sizeof(DDSHeader) == 124);
+
+		struct DDSHeaderDX10
+		{
+			uint32_t dxgi_format;
+			uint32_t resource_dimension;
+			uint32_t misc_flag;
+			uint32_t array_size;
+			uint32_t misc_flags_2;
+		};
+
+		constexpr uint32_t DDSD_CAPS = 0x1;
+		constexpr uint32_t DDSD_HEIGHT = 0x2;
+		constexpr uint32_t DDSD_WIDTH = 0x4;
+		constexpr uint32_t DDSD_PIXELFORMAT = 0x1000;
+		constexpr uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+		constexpr uint32_t DDSD_LINEARSIZE = 0x80000;
+		constexpr uint32_t DDPF_FOURCC = 0x4;
+		constexpr uint32_t DDSCAPS_COMPLEX = 0x8;
+		constexpr uint32_t DDSCAPS_TEXTURE = 0x1000;
+		constexpr uint32_t DDSCAPS_MIPMAP = 0x400000;
+		constexpr uint32_t DDSCAPS2_CUBEMAP = 0x200;
+		constexpr uint32_t DDS_DIMENSION_TEXTURE2D = 3;
+		constexpr uint32_t DDS_RESOURCE_MISC_TEXTURECUBE = 0x4;
+
+		struct DXGIFormatPair
+		{
+			uint32_t dxgi;
+			VkFormat vk;
+		};
+		constexpr DXGIFormatPair DXGIFormats[] = {
+			{71, VK_FORMAT_BC1_RGBA_UNORM_BLOCK},
+			{72, VK_FORMAT_BC1_RGBA_SRGB_BLOCK},
+			{77, VK_FORMAT_BC3_UNORM_BLOCK},
+			{78, VK_FORMAT_BC3_SRGB_BLOCK},
+			{80, VK_FORMAT_BC4_UNORM_BLOCK},
+			{81, VK_FORMAT_BC4_SNORM_BLOCK},
+			{83, VK_FORMAT_BC5_UNORM_BLOCK},
+			{84, VK_FORMAT_BC5_SNORM_BLOCK},
+			{98, VK_FORMAT_BC7_UNORM_BLOCK},
+			{99, VK_FORMAT_BC7_SRGB_BLOCK},
+		};
+
+		VkFormat DXGIToVkFormat(uint32_t dxgi)
+		{
+			VkFormat res = VK_FORMAT_UNDEFINED;
+			for (DXGIFormatPair const& p : DXGIFormats)
+			{
+				if (p.dxgi == dxgi)
+				{
+					res = p.vk;
+					break;
+				}
+			}
+			return res;
+		}
+
+		uint32_t VkFormatToDXGI(VkFormat format)
+		{
+			// BC1 RGB and RGBA share the same DXGI format
+			if (format == VK_FORMAT_BC1_RGB_UNORM_BLOCK)	format = VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+			if (format == VK_FORMAT_BC1_RGB_SRGB_BLOCK)	format = VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+			uint32_t res = 0;
+			for (DXGIFormatPair const& p : DXGIFormats)
+			{
+				if (p.vk == format)
+				{
+					res = p.dxgi;
+					break;
+				}
+			}
+			return res;
+		}
+
+		template <class T>
+		bool ReadStruct(std::string const& content, size_t offset, T& res)
+		{
+			if (offset > content.size() || sizeof(T) > content.size() - offset)
+			{
+				return false;
+			}
+			std::memcpy(&res, content.data() + offset, sizeof(T));
+			return true;
+		}
+
+		bool SetError(std::string * error, std::string_view msg)
+		{
+			if (error)
+			{
+				*error = msg;
+			}
+			return false;
+		}
+
+		// Before anything is allocated from the header fields
+		bool CheckExtentMipsLayers(CompressedImage const& res, std::string_view container, std::string * error)
+		{
+			if (res.extent.width == 0 || res.extent.height == 0)
+			{
+				return SetError(error, std::format("Invalid {} extent: {}x{}", container, res.extent.width, res.extent.height));
+			}
+			if (res.mips > CompressedImage::MaxMipsCount(res.extent))
+			{
+				return SetError(error, std::format("Invalid {} mips count: {} (extent {}x{})", container, res.mips, res.extent.width, res.extent.height));
+			}
+			if (res.layers > CompressedImage::MaxLayers)
+			{
+				return SetError(error, std::format("Too many {} layers: {}", container, res.layers));
+			}
+			return true;
+		}
+
+		bool ParseKTX2(CompressedImage & res, std::string * error)
+		{
+			std::string const& content = res.content;
+			if (content.size() < sizeof(KTX2Identifier) || std::memcmp(content.data(), KTX2Identifier, sizeof(KTX2Identifier)) != 0)
+			{
+				return SetError(error, "Not a KTX2 file");
+			}
+			KTX2Header header;
+			if (!ReadStruct(content, sizeof(KTX2Identifier), header))
+			{
+				return SetError(error, "Truncated KTX2 header");
+			}
+			if (header.supercompression_scheme != 0)
+			{
+				return SetError(error, "KTX2 supercompression is not supported");
+			}
+			if (header.face_count > 1 || header.pixel_depth > 1)
+			{
+				return SetError(error, "KTX2 cube maps and 3D images are not supported");
+			}
+			res.format = static_cast<VkFormat>(header.vk_format);
+			if (!CompressedImage::IsSupportedFormat(res.format))
+			{
+				return SetError(error, std::format("Unsupported KTX2 format: {}", header.vk_format));
+			}
+			res.extent = VkExtent3D{ .width = header.pixel_width, .height = std::max(header.pixel_height, 1u), .depth = 1 };
+			res.layers = std::max(header.layer_count, 1u);
+			res.mips = std::max(header.level_count, 1u);
+			if (!CheckExtentMipsLayers(res, "KTX2", error))
+			{
+				return false;
+			}
+
+			const size_t level_index_offset = sizeof(KTX2Identifier) + sizeof(KTX2Header) + 2 * sizeof(uint64_t);
+			res.subresources.resize(res.mips);
+			for (uint32_t m = 0; m < res.mips; ++m)
+			{
+				KTX2LevelIndex level;
+				if (!ReadStruct(content, level_index_offset + m * sizeof(KTX2LevelIndex), level))
+				{
+					return SetError(error, "Truncated KTX2 level index");
+				}
+				const uint64_t expected = uint64_t(CompressedImage::MipByteSize(res.format, res.extent, m)) * uint64_t(res.layers);
+				if (level.byte_offset > content.size() || level.byte_length > content.size() - level.byte_offset || level.byte_length < expected)
+				{
+					return SetError(error, std::format("Invalid KTX2 level {}", m));
+				}
+				res.subresources[m] = CompressedImage::Subresource{
+					.mip = m,
+					.layer = 0,
+					.layer_count = res.layers,
+					.offset = static_cast<size_t>(level.byte_offset),
+					.size = static_cast<size_t>(expected),
+				};
+			}
+			return true;
+		}
+
+		bool ParseDDS(CompressedImage & res, std::string * error)
+		{
+			std::string const& content = res.content;
+			uint32_t magic = 0;
+			DDSHeader header;
+			if (!ReadStruct(content, 0, magic) || magic != DDSMagic || !ReadStruct(content, sizeof(magic), header) || header.size != sizeof(DDSHeader))
+			{
+				return SetError(error, "Not a DDS file");
+			}
+			size_t data_offset = sizeof(magic) + sizeof(DDSHeader);
+			res.layers = 1;
+			if ((header.caps_2 & DDSCAPS2_CUBEMAP) || header.depth > 1)
+			{
+				return SetError(error, "DDS cube maps and 3D images are not supported");
+			}
+			if (!(header.pixel_format.flags & DDPF_FOURCC))
+			{
+				return SetError(error, "Uncompressed DDS are not supported");
+			}
+			const uint32_t four_cc = header.pixel_format.four_cc;
+			if (four_cc == MakeFourCC('D', 'X', '1', '0'))
+			{
+				DDSHeaderDX10 dx10;
+				if (!ReadStruct(content, data_offset, dx10))
+				{
+					return SetError(error, "Truncated DDS DX10 header");
+				}
+				data_offset += sizeof(DDSHeaderDX10);
+				if (dx10.resource_dimension != DDS_DIMENSION_TEXTURE2D || (dx10.misc_flag & DDS_RESOURCE_MISC_TEXTURECUBE))
+				{
+					return SetError(error, "Only 2D DDS are supported");
+				}
+				res.format = DXGIToVkFormat(dx10.dxgi_format);
+				res.layers = std::max(dx10.array_size, 1u);
+			}
+			else if (four_cc == MakeFourCC('D', 'X', 'T', '1'))
+			{
+				res.format = VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+			}
+			else if (four_cc == MakeFourCC('D', 'X', 'T', '5'))
+			{
+				res.format = VK_FORMAT_BC3_UNORM_BLOCK;
+			}
+			else if (four_cc == MakeFourCC('A', 'T', 'I', '1') || four_cc == MakeFourCC('B', 'C', '4', 'U'))
+			{
+				res.format = VK_FORMAT_BC4_UNORM_BLOCK;
+			}
+			else if (four_cc == MakeFourCC('A', 'T', 'I', '2') || four_cc == MakeFourCC('B', 'C', '5', 'U'))
+			{
+				res.format = VK_FORMAT_BC5_UNORM_BLOCK;
+			}
+			if (!CompressedImage::IsSupportedFormat(res.format))
+			{
+				return SetError(error, "Unsupported DDS format");
+			}
+
+			res.extent = VkExtent3D{ .width = header.width, .height = header.height, .depth = 1 };
+			res.mips = (header.flags & DDSD_MIPMAPCOUNT) ? std::max(header.mip_map_count, 1u) : 1;
+			if (!CheckExtentMipsLayers(res, "DDS", error))
+			{
+				return false;
+			}
+
+			// Layer major: each layer stores its full mip chain
+			size_t offset = data_offset;
+			res.subresources.reserve(size_t(res.layers) * size_t(res.mips));
+			for (uint32_t l = 0; l < res.layers; ++l)
+			{
+				for (uint32_t m = 0; m < res.mips; ++m)
+				{
+					const size_t size = CompressedImage::MipByteSize(res.format, res.extent, m);
+					// offset <= content.size() (header read, then previous subresources checked)
+					if (size > content.size() - offset)
+					{
+						return SetError(error, "Truncated DDS data");
+					}
+					res.subresources.push_back(CompressedImage::Subresource{
+						.mip = m,
+						.layer = l,
+						.layer_count = 1,
+						.offset = offset,
+						.size = size,
+					});
+					offset += size;
+				}
+			}
+			return true;
+		}
+	}
+
+	size_t CompressedImage::byteSize() const
+	{
+		size_t res = 0;
+		for (Subresource const& sr : subresources)
+		{
+			res += sr.size;
+		}
+		return res;
+	}
+
+	void CompressedImage::clear()
+	{
+		format = VK_FORMAT_UNDEFINED;
+		extent = {};
+		mips = 0;
+		layers = 0;
+		subresources.clear();
+		content.clear();
+		content.shrink_to_fit();
+	}
+
+	bool CompressedImage::IsSupportedFormat(VkFormat format)
+	{
+		return BlockByteSize(format) != 0;
+	}
+
+	uint32_t CompressedImage::BlockByteSize(VkFormat format)
+	{
+		uint32_t res = 0;
+		switch (format)
+		{
+			case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+			case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+			case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+			case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+			case VK_FORMAT_BC4_UNORM_BLOCK:
+			case VK_FORMAT_BC4_SNORM_BLOCK:
+				res = 8;
+			break;
+			case VK_FORMAT_BC3_UNORM_BLOCK:
+			case VK_FORMAT_BC3_SRGB_BLOCK:
+			case VK_FORMAT_BC5_UNORM_BLOCK:
+			case VK_FORMAT_BC5_SNORM_BLOCK:
+			case VK_FORMAT_BC7_UNORM_BLOCK:
+			case VK_FORMAT_BC7_SRGB_BLOCK:
+				res = 16;
+			break;
+			default:
+			break;
+		}
+		return res;
+	}
+
+	size_t CompressedImage::MipByteSize(VkFormat format, VkExtent3D const& extent, uint32_t mip)
+	{
+		// Shifting a uint32_t by 32 or more is undefined
+		const size_t w = mip < 32 ? std::max(extent.width >> mip, 1u) : 1;
+		const size_t h = mip < 32 ? std::max(extent.height >> mip, 1u) : 1;
+		return std::divCeil<size_t>(w, 4) * std::divCeil<size_t>(h, 4) * BlockByteSize(format);
+	}
+
+	uint32_t CompressedImage::MaxMipsCount(VkExtent3D const& extent)
+	{
+		return static_cast<uint32_t>(std::bit_width(std::max(extent.width, extent.height)));
+	}
+
+	CompressedImageContainer GetCompressedImageContainer(std::filesystem::path const& path)
+	{
+		CompressedImageContainer res = CompressedImageContainer::None;
+		std::string ext = path.extension().string();
+		std::transform(ext.begin(), ext.end(), ext.begin(), [](char c) {return static_cast<char>(std::tolower(c)); });
+		if (ext == ".ktx2")
+		{
+			res = CompressedImageContainer::KTX2;
+		}
+		else if (ext == ".dds")
+		{
+			res = CompressedImageContainer::DDS;
+		}
+		return res;
+	}
+
+	bool ParseCompressedImage(std::string && content, CompressedImageContainer container, CompressedImage & res, std::string * error)
+	{
+		res.clear();
+		res.content = std::move(content);
+		bool ok = false;
+		if (container == CompressedImageContainer::KTX2)
+		{
+			ok = ParseKTX2(res, error);
+		}
+		else if (container == CompressedImageContainer::DDS)
+		{
+			ok = ParseDDS(res, error);
+		}
+		else
+		{
+			SetError(error, "Unknown container");
+		}
+		if (!ok)
+		{
+			res.clear();
+		}
+		return ok;
+	}
+
+	std::string SerializeDDS(DDSWriteInfo const& info)
+	{
+		const uint32_t mips = info.mips.size32();
+		DDSHeader header{
+			.size = sizeof(DDSHeader),
+			.flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_LINEARSIZE | (mips > 1 ? DDSD_MIPMAPCOUNT : 0),
+			.height = info.extent.height,
+			.width = info.extent.width,
+			.pitch_or_linear_size = static_cast<uint32_t>(CompressedImage::MipByteSize(info.format, info.extent, 0)),
+			.depth = 0,
+			.mip_map_count = mips,
+			.reserved_1 = {},
+			.pixel_format = DDSPixelFormat{
+				.size = sizeof(DDSPixelFormat),
+				.flags = DDPF_FOURCC,
+				.four_cc = MakeFourCC('D', 'X', '1', '0'),
+			},
+			.caps = DDSCAPS_TEXTURE | (mips > 1 ? (DDSCAPS_COMPLEX | DDSCAPS_MIPMAP) : 0),
+		};
+		const DDSHeaderDX10 dx10{
+			.dxgi_format = VkFormatToDXGI(info.format),
+			.resource_dimension = DDS_DIMENSION_TEXTURE2D,
+			.misc_flag = 0,
+			.array_size = 1,
+			.misc_flags_2 = 0,
+		};
+		size_t total = sizeof(DDSMagic) + sizeof(header) + sizeof(dx10);
+		for (std::span<const uint8_t> const& mip : info.mips)
+		{
+			total += mip.size();
+		}
+
+		std::string res;
+		res.reserve(total);
+		res.append(reinterpret_cast<const char*>(&DDSMagic), sizeof(DDSMagic));
+		res.append(reinterpret_cast<const char*>(&header), sizeof(header));
+		res.append(reinterpret_cast<const char*>(&dx10), sizeof(dx10));
+		for (std::span<const uint8_t> const& mip : info.mips)
+		{
+			res.append(reinterpret_cast<const char*>(mip.data()), mip.size());
+		}
+		return res;
+	}
+}
@@ -0,0 +1,401 @@
+#include <vkl/IO/SequenceImageFormats.hpp>
+
+#include <vkl/VkObjects/DetailedVkFormat.hpp>
+
+#include <that/math/Half.hpp>
+
+#include <array>
+#include <cstring>
+#include <format>
+#include <vector>
+
+namespace vkl
+{
+	const char * GetSequenceImageFormatName(SequenceImageFormat format)
+	{
+		switch (format)
+		{
+			case SequenceImageFormat::Raw:
+				return "Raw";
+			case SequenceImageFormat::QOI:
+				return "QOI";
+			case SequenceImageFormat::PFM:
+				return "PFM";
+			default:
+				return "";
+		}
+	}
+
+	const char * GetSequenceImageFormatExtension(SequenceImageFormat format)
+	{
+		switch (format)
+		{
+			case SequenceImageFormat::Raw:
+				return ".raw";
+			case SequenceImageFormat::QOI:
+				return ".qoi";
+			case SequenceImageFormat::PFM:
+				return ".pfm";
+			default:
+				return "";
+		}
+	}
+
+	size_t GetRawPixelByteSize(VkFormat format)
+	{
+		const DetailedVkFormat detailed_format = DetailedVkFormat::Find(format);
+		size_t res = std::divUpSafe<size_t>(detailed_format.pack_bits, 8);
+		uint32_t bits = 0;
+		if (detailed_format.aspect & VK_IMAGE_ASPECT_COLOR_BIT)
+		{
+			for (uint32_t i = 0; i < detailed_format.color.channels; ++i)
+			{
+				bits += detailed_format.color.bits[i];
+			}
+		}
+		else if (detailed_format.aspect & VK_IMAGE_ASPECT_DEPTH_BIT)
+		{
+			bits = detailed_format.depth_stencil.depth_bits + detailed_format.depth_stencil.stencil_bits;
+		}
+		res = std::max(res, std::divUpSafe<size_t>(bits, 8));
+		return res;
+	}
+
+	namespace qoi
+	{
+		struct PixelLayout
+		{
+			uint32_t channels = 0;
+			bool bgr = false;
+			bool srgb = false;
+		};
+
+		static bool GetPixelLayout(VkFormat format, PixelLayout & res)
+		{
+			switch (format)
+			{
+				case VK_FORMAT_R8G8B8A8_UNORM:
+					res = PixelLayout{.channels = 4};
+				break;
+				case VK_FORMAT_R8G8B8A8_SRGB:
+					res = PixelLayout{.channels = 4, .srgb = true};
+				break;
+				case VK_FORMAT_B8G8R8A8_UNORM:
+					res = PixelLayout{.channels = 4, .bgr = true};
+				break;
+				case VK_FORMAT_B8G8R8A8_SRGB:
+					res = PixelLayout{.channels = 4, .bgr = true, .srgb = true};
+				break;
+				case VK_FORMAT_R8G8B8_UNORM:
+					res = PixelLayout{.channels = 3};
+				break;
+				case VK_FORMAT_R8G8B8_SRGB:
+					res = PixelLayout{.channels = 3, .srgb = true};
+				break;
+				case VK_FORMAT_B8G8R8_UNORM:
+					res = PixelLayout{.channels = 3, .bgr = true};
+				break;
+				case VK_FORMAT_B8G8R8_SRGB:
+					res = PixelLayout{.channels = 3, .bgr = true, .srgb = true};
+				break;
+				default:
+					return false;
+			}
+			return true;
+		}
+
+		enum Op : uint8_t
+		{
+			Index = 0x00,
+			Diff = 0x40,
+			Luma = 0x80,
+			Run = 0xc0,
+			RGB = 0xfe,
+			RGBA = 0xff,
+		};
+
+		union Pixel
+		{
+			struct
+			{
+				uint8_t r, g, b, a;
+			};
+			uint32_t value;
+		};
+
+		static void PushBE32(uint8_t *& dst, uint32_t v)
+		{
+			*(dst++) = uint8_t(v >> 24);
+			*(dst++) = uint8_t(v >> 16);
+			*(dst++) = uint8_t(v >> 8);
+			*(dst++) = uint8_t(v);
+		}
+
+		// See https://qoiformat.org/qoi-specification.pdf
+		static void Encode(RawImageView const& image, PixelLayout const& layout, bool strip_alpha, std::string & out)
+		{
+			const uint32_t out_channels = (strip_alpha || layout.channels == 3) ? 3 : 4;
+			const size_t pixels = size_t(image.extent.width) * size_t(image.extent.height);
+			const size_t header_size = 14;
+			const size_t end_size = 8;
+			// Worst case: every pixel written with an RGB(A) op
+			const size_t max_size = header_size + pixels * (out_channels + 1) + end_size;
+			const size_t begin = out.size();
+			out.resize(begin + max_size);
+			uint8_t * const dst_begin = reinterpret_cast<uint8_t*>(out.data() + begin);
+			uint8_t * dst = dst_begin;
+
+			std::memcpy(dst, "qoif", 4);
+			dst += 4;
+			PushBE32(dst, image.extent.width);
+			PushBE32(dst, image.extent.height);
+			*(dst++) = uint8_t(out_channels);
+			*(dst++) = layout.srgb ? 0 : 1;
+
+			std::array<Pixel, 64> index;
+			std::memset(index.data(), 0, sizeof(index));
+			Pixel prev = {.value = 0};
+			prev.a = 255;
+			Pixel px = prev;
+			uint32_t run = 0;
+
+			const uint8_t * src = static_cast<const uint8_t*>(image.data);
+			const uint32_t r_offset = layout.bgr ? 2 : 0;
+			const uint32_t b_offset = layout.bgr ? 0 : 2;
+			for (size_t p = 0; p < pixels; ++p)
+			{
+				px.r = src[r_offset];
+				px.g = src[1];
+				px.b = src[b_offset];
+				if (out_channels == 4)
+				{
+					px.a = src[3];
+				}
+				src += layout.channels;
+
+				if (px.value == prev.value)
+				{
+					++run;
+					if (run == 62 || p == pixels - 1)
+					{
+						*(dst++) = uint8_t(Op::Run | (run - 1));
+						run = 0;
+					}
+					continue;
+				}
+
+				if (run > 0)
+				{
+					*(dst++) = uint8_t(Op::Run | (run - 1));
+					run = 0;
+				}
+
+				const uint32_t hash = (uint32_t(px.r) * 3 + uint32_t(px.g) * 5 + uint32_t(px.b) * 7 + uint32_t(px.a) * 11) % 64;
+				if (index[hash].value == px.value)
+				{
+					*(dst++) = uint8_t(Op::Index | hash);
+				}
+				else
+				{
+					index[hash] = px;
+					if (px.a == prev.a)
+					{
+						const int8_t vr = int8_t(px.r - prev.r);
+						const int8_t vg = int8_t(px.g - prev.g);
+						const int8_t vb = int8_t(px.b - prev.b);
+						const int8_t vg_r = int8_t(vr - vg);
+						const int8_t vg_b = int8_t(vb - vg);
+						if (vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2)
+						{
+							*(dst++) = uint8_t(Op::Diff | ((vr + 2) << 4) | ((vg + 2) << 2) | (vb + 2));
+						}
+						else if (vg_r > -9 && vg_r < 8 && vg > -33 && vg < 32 && vg_b > -9 && vg_b < 8)
+						{
+							*(dst++) = uint8_t(Op::Luma | (vg + 32));
+							*(dst++) = uint8_t(((vg_r + 8) << 4) | (vg_b + 8));
+						}
+						else
+						{
+							*(dst++) = Op::RGB;
+							*(dst++) = px.r;
+							*(dst++) = px.g;
+							*(dst++) = px.b;
+						}
+					}
+					else
+					{
+						*(dst++) = Op::RGBA;
+						*(dst++) = px.r;
+						*(dst++) = px.g;
+						*(dst++) = px.b;
+						*(dst++) = px.a;
+					}
+				}
+				prev = px;
+			}
+
+			const std::array<uint8_t, end_size> end = {0, 0, 0, 0, 0, 0, 0, 1};
+			std::memcpy(dst, end.data(), end_size);
+			dst += end_size;
+
+			out.resize(begin + (dst - dst_begin));
+		}
+	}
+
+	namespace pfm
+	{
+		struct PixelLayout
+		{
+			uint32_t channels = 0;
+			bool half = false;
+		};
+
+		static bool GetPixelLayout(VkFormat format, PixelLayout & res)
+		{
+			switch (format)
+			{
+				case VK_FORMAT_R32_SFLOAT:
+					res = PixelLayout{.channels = 1};
+				break;
+				case VK_FORMAT_R32G32B32_SFLOAT:
+					res = PixelLayout{.channels = 3};
+				break;
+				case VK_FORMAT_R32G32B32A32_SFLOAT:
+					res = PixelLayout{.channels = 4};
+				break;
+				case VK_FORMAT_R16_SFLOAT:
+					res = PixelLayout{.channels = 1, .half = true};
+				break;
+				case VK_FORMAT_R16G16B16_SFLOAT:
+					res = PixelLayout{.channels = 3, .half = true};
+				break;
+				case VK_FORMAT_R16G16B16A16_SFLOAT:
+					res = PixelLayout{.channels = 4, .half = true};
+				break;
+				default:
+					return false;
+			}
+			return true;
+		}
+
+		// dst has no alignment guarantee: the rows are converted in a local buffer, then copied
+		template <class T>
+		static void CopyRows(RawImageView const& image, uint32_t in_channels, uint32_t out_channels, char * dst)
+		{
+			const T * src = static_cast<const T*>(image.data);
+			const size_t w = image.extent.width;
+			const size_t h = image.extent.height;
+			const size_t row_size = w * out_channels * sizeof(float);
+			std::vector<float> row_buffer;
+			// PFM rows are stored from the bottom to the top
+			for (size_t y = 0; y < h; ++y)
+			{
+				const T * row = src + (h - 1 - y) * w * in_channels;
+				if constexpr (std::is_same<T, float>::value)
+				{
+					if (in_channels == out_channels)
+					{
+						std::memcpy(dst, row, row_size);
+						dst += row_size;
+						continue;
+					}
+				}
+				row_buffer.resize(w * out_channels);
+				float * row_dst = row_buffer.data();
+				for (size_t x = 0; x < w; ++x)
+				{
+					for (uint32_t c = 0; c < out_channels; ++c)
+					{
+						*(row_dst++) = static_cast<float>(row[x * in_channels + c]);
+					}
+				}
+				std::memcpy(dst, row_buffer.data(), row_size);
+				dst += row_size;
+			}
+		}
+
+		static void Encode(RawImageView const& image, PixelLayout const& layout, std::string & out)
+		{
+			const uint32_t out_channels = (layout.channels == 1) ? 1 : 3;
+			// Negative scale: little endian
+			const std::string header = std::format("{}\n{} {}\n-1.0\n", (out_channels == 1) ? "Pf" : "PF", image.extent.width, image.extent.height);
+			const size_t data_size = size_t(image.extent.width) * size_t(image.extent.height) * out_channels * sizeof(float);
+			const size_t begin = out.size();
+			out.resize(begin + header.size() + data_size);
+			std::memcpy(out.data() + begin, header.data(), header.size());
+			char * dst = out.data() + begin + header.size();
+			if (layout.half)
+			{
+				CopyRows<that::math::float16_t>(image, layout.channels, out_channels, dst);
+			}
+			else
+			{
+				CopyRows<float>(image, layout.channels, out_channels, dst);
+			}
+		}
+	}
+
+	bool CanEncodeSequenceImage(SequenceImageFormat format, VkFormat vk_format)
+	{
+		bool res = false;
+		switch (format)
+		{
+			case SequenceImageFormat::Raw:
+				res = GetRawPixelByteSize(vk_format) != 0;
+			break;
+			case SequenceImageFormat::QOI:
+			{
+				qoi::PixelLayout layout;
+				res = qoi::GetPixelLayout(vk_format, layout);
+			}
+			break;
+			case SequenceImageFormat::PFM:
+			{
+				pfm::PixelLayout layout;
+				res = pfm::GetPixelLayout(vk_format, layout);
+			}
+			break;
+		}
+		return res;
+	}
+
+	bool EncodeSequenceImage(SequenceImageFormat format, RawImageView const& image, bool strip_alpha, std::string & out)
+	{
+		assert(image.data);
+		bool res = false;
+		switch (format)
+		{
+			case SequenceImageFormat::Raw:
+			{
+				const size_t size = image.byteSize();
+				if (size)
+				{
+					out.append(static_cast<const char*>(image.data), size);
+					res = true;
+				}
+			}
+			break;
+			case SequenceImageFormat::QOI:
+			{
+				qoi::PixelLayout layout;
+				res = qoi::GetPixelLayout(image.format, layout);
+				if (res)
+				{
+					qoi::Encode(image, layout, strip_alpha, out);
+				}
+			}
+			break;
+			case SequenceImageFormat::PFM:
+			{
+				pfm::PixelLayout layout;
+				res = pfm::GetPixelLayout(image.format, layout);
+				if (res)
+				{
+					pfm::Encode(image, layout, out);
+				}
+			}
+			break;
+		}
+		return res;
+	}
+}
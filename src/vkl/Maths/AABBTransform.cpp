@@ -0,0 +1,194 @@
+#include <vkl/Maths/AABBTransform.hpp>
+#include <vkl/Execution/ThreadPool.hpp>
+
+
+#if defined(__AVX__) || defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <immintrin.h>
+#endif
+
+namespace vkl
+{
+	namespace
+	{
+#if defined(__AVX__)
+		struct SimdFloat
+		{
+			using Reg = __m256;
+			static constexpr size_t Width = 8;
+			static Reg Load(const float * p) { return _mm256_load_ps(p); }
+			static void Store(float * p, Reg a) { _mm256_store_ps(p, a); }
+			static Reg Set1(float f) { return _mm256_set1_ps(f); }
+			static Reg Add(Reg a, Reg b) { return _mm256_add_ps(a, b); }
+			static Reg Sub(Reg a, Reg b) { return _mm256_sub_ps(a, b); }
+			static Reg Mul(Reg a, Reg b) { return _mm256_mul_ps(a, b); }
+			static Reg Min(Reg a, Reg b) { return _mm256_min_ps(a, b); }
+			static Reg Max(Reg a, Reg b) { return _mm256_max_ps(a, b); }
+			static Reg Abs(Reg a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+		};
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		struct SimdFloat
+		{
+			using Reg = __m128;
+			static constexpr size_t Width = 4;
+			static Reg Load(const float * p) { return _mm_load_ps(p); }
+			static void Store(float * p, Reg a) { _mm_store_ps(p, a); }
+			static Reg Set1(float f) { return _mm_set1_ps(f); }
+			static Reg Add(Reg a, Reg b) { return _mm_add_ps(a, b); }
+			static Reg Sub(Reg a, Reg b) { return _mm_sub_ps(a, b); }
+			static Reg Mul(Reg a, Reg b) { return _mm_mul_ps(a, b); }
+			static Reg Min(Reg a, Reg b) { return _mm_min_ps(a, b); }
+			static Reg Max(Reg a, Reg b) { return _mm_max_ps(a, b); }
+			static Reg Abs(Reg a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+		};
+#else
+		struct SimdFloat
+		{
+			using Reg = float;
+			static constexpr size_t Width = 1;
+			static Reg Load(const float * p) { return *p; }
+			static void Store(float * p, Reg a) { *p = a; }
+			static Reg Set1(float f) { return f; }
+			static Reg Add(Reg a, Reg b) { return a + b; }
+			static Reg Sub(Reg a, Reg b) { return a - b; }
+			static Reg Mul(Reg a, Reg b) { return a * b; }
+			static Reg Min(Reg a, Reg b) { return std::min(a, b); }
+			static Reg Max(Reg a, Reg b) { return std::max(a, b); }
+			static Reg Abs(Reg a) { return std::abs(a); }
+		};
+#endif
+
+		// Boxes are transposed in tiles of this size
+		constexpr size_t SoATileSize = 128;
+		static_assert(SoATileSize % SimdFloat::Width == 0);
+
+		struct SoATile
+		{
+			alignas(32) float center[3][SoATileSize];
+			alignas(32) float extent[3][SoATileSize];
+			// m[row * 4 + col]
+			alignas(32) float m[12][SoATileSize];
+			alignas(32) float bottom[3][SoATileSize];
+			alignas(32) float top[3][SoATileSize];
+		};
+
+		AABB3f TransformRange(AABBTransformInfo const& info, size_t begin, size_t end)
+		{
+			using S = SimdFloat;
+			SoATile tile;
+			S::Reg acc_bottom[3], acc_top[3];
+			for (uint32_t r = 0; r < 3; ++r)
+			{
+				acc_bottom[r] = S::Set1(std::numeric_limits<float>::max());
+				acc_top[r] = S::Set1(std::numeric_limits<float>::lowest());
+			}
+
+			for (size_t tile_begin = begin; tile_begin < end; tile_begin += SoATileSize)
+			{
+				const size_t n = std::min(end - tile_begin, SoATileSize);
+				const size_t padded_n = std::divCeil(n, S::Width) * S::Width;
+				// Transpose, the padding lanes repeat the last box so they don't change the union
+				for (size_t i = 0; i < padded_n; ++i)
+				{
+					const size_t index = tile_begin + std::min(i, n - 1);
+					const AABB3f & box = info.boxes[index];
+					const Matrix3x4f & xform = info.xforms[index];
+					for (uint32_t r = 0; r < 3; ++r)
+					{
+						tile.center[r][i] = 0.5f * box.bottom()[r] + 0.5f * box.top()[r];
+						tile.extent[r][i] = 0.5f * box.top()[r] - 0.5f * box.bottom()[r];
+						for (uint32_t c = 0; c < 4; ++c)
+						{
+							tile.m[r * 4 + c][i] = xform(r, c);
+						}
+					}
+				}
+
+				for (size_t i = 0; i < padded_n; i += S::Width)
+				{
+					const S::Reg cx = S::Load(tile.center[0] + i);
+					const S::Reg cy = S::Load(tile.center[1] + i);
+					const S::Reg cz = S::Load(tile.center[2] + i);
+					const S::Reg ex = S::Load(tile.extent[0] + i);
+					const S::Reg ey = S::Load(tile.extent[1] + i);
+					const S::Reg ez = S::Load(tile.extent[2] + i);
+					for (uint32_t r = 0; r < 3; ++r)
+					{
+						const S::Reg m0 = S::Load(tile.m[r * 4 + 0] + i);
+						const S::Reg m1 = S::Load(tile.m[r * 4 + 1] + i);
+						const S::Reg m2 = S::Load(tile.m[r * 4 + 2] + i);
+						const S::Reg t = S::Load(tile.m[r * 4 + 3] + i);
+						const S::Reg c = S::Add(S::Add(S::Mul(m0, cx), S::Mul(m1, cy)), S::Add(S::Mul(m2, cz), t));
+						const S::Reg e = S::Add(S::Add(S::Mul(S::Abs(m0), ex), S::Mul(S::Abs(m1), ey)), S::Mul(S::Abs(m2), ez));
+						const S::Reg b = S::Sub(c, e);
+						const S::Reg tp = S::Add(c, e);
+						acc_bottom[r] = S::Min(acc_bottom[r], b);
+						acc_top[r] = S::Max(acc_top[r], tp);
+						if (info.results)
+						{
+							S::Store(tile.bottom[r] + i, b);
+							S::Store(tile.top[r] + i, tp);
+						}
+					}
+				}
+
+				if (info.results)
+				{
+					for (size_t i = 0; i < n; ++i)
+					{
+						info.results[tile_begin + i] = AABB3f(
+							Vector3f(tile.bottom[0][i], tile.bottom[1][i], tile.bottom[2][i]),
+							Vector3f(tile.top[0][i], tile.top[1][i], tile.top[2][i])
+						);
+					}
+				}
+			}
+
+			Vector3f bottom, top;
+			for (uint32_t r = 0; r < 3; ++r)
+			{
+				alignas(32) float b[S::Width], t[S::Width];
+				S::Store(b, acc_bottom[r]);
+				S::Store(t, acc_top[r]);
+				bottom[r] = b[0];
+				top[r] = t[0];
+				for (size_t l = 1; l < S::Width; ++l)
+				{
+					bottom[r] = std::min(bottom[r], b[l]);
+					top[r] = std::max(top[r], t[l]);
+				}
+			}
+			return AABB3f(bottom, top);
+		}
+	}
+
+	AABB3f TransformAABBs(AABBTransformInfo const& info)
+	{
+		if (info.count == 0)
+		{
+			return AABB3f();
+		}
+		const size_t tile_size = std::max<size_t>(info.tile_size, SoATileSize);
+		const size_t tiles = std::divCeil(info.count, tile_size);
+
+		// One box per tile, reduced in order at the end (deterministic)
+		MyVector<AABB3f> tiles_bounds(tiles);
+		ProcessInParallel(info.executor, tiles, "TransformAABBs", [&](size_t tile)
+		{
+			const size_t begin = tile * tile_size;
+			const size_t end = std::min(begin + tile_size, info.count);
+			tiles_bounds[tile] = TransformRange(info, begin, end);
+		});
+
+		// Inverted tiles bounds (only empty boxes) don't change the union
+		AABB3f res = tiles_bounds.front();
+		for (size_t t = 1; t < tiles; ++t)
+		{
+			res += tiles_bounds[t];
+		}
+		if (res.bottom()[0] > res.top()[0] || res.bottom()[1] > res.top()[1] || res.bottom()[2] > res.top()[2])
+		{
+			res = AABB3f();
+		}
+		return res;
+	}
+}
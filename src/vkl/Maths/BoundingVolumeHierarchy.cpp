@@ -0,0 +1,335 @@
+#include <vkl/Maths/BoundingVolumeHierarchy.hpp>
+
+#include <algorithm>
+
+namespace vkl
+{
+	FrustumPlanes FrustumPlanes::FromMatrix(Matrix4f const& m, bool far_plane)
+	{
+		FrustumPlanes res;
+		const auto add_plane = [&res](Vector4f const& p)
+		{
+			res.addPlane(Vector3f(p[0], p[1], p[2]), p[3]);
+		};
+		const Vector4f r0 = m.row(0).transpose();
+		const Vector4f r1 = m.row(1).transpose();
+		const Vector4f r2 = m.row(2).transpose();
+		const Vector4f r3 = m.row(3).transpose();
+		add_plane(r3 + r0);
+		add_plane(r3 - r0);
+		add_plane(r3 + r1);
+		add_plane(r3 - r1);
+		add_plane(r2);
+		if (far_plane)
+		{
+			add_plane(r3 - r2);
+		}
+		return res;
+	}
+
+	struct BoundingVolumeHierarchy::BuildContext
+	{
+		MyVector<Vector3f> centers;
+		// Boxes of the items, in item order
+		MyVector<BVHBox> boxes;
+		uint32_t max_leaf_size;
+		uint32_t bins;
+
+		struct Bin
+		{
+			BVHBox box;
+			uint32_t count;
+		};
+		MyVector<Bin> bins_data;
+		MyVector<float> right_costs;
+	};
+
+	void BoundingVolumeHierarchy::clear()
+	{
+		_nodes.clear();
+		_node_boxes.clear();
+		_parents.clear();
+		_items.clear();
+		_item_boxes.clear();
+		_item_slots.clear();
+		_item_leaves.clear();
+		_dirty_leaves.clear();
+		_dirty_flags.clear();
+		_built_sah_cost = 0.0f;
+	}
+
+	void BoundingVolumeHierarchy::build(BuildInfo const& info)
+	{
+		clear();
+		if (info.count == 0)
+		{
+			return;
+		}
+		BuildContext ctx{
+			.max_leaf_size = std::max(info.max_leaf_size, 1u),
+			.bins = std::max(info.sah_bins, 2u),
+		};
+		ctx.centers.resize(info.count);
+		ctx.boxes.resize(info.count);
+		_items.resize(info.count);
+		for (uint32_t i = 0; i < info.count; ++i)
+		{
+			_items[i] = i;
+			ctx.boxes[i] = BVHBox::From(info.boxes[i]);
+			ctx.centers[i] = info.boxes[i].center();
+		}
+		ctx.bins_data.resize(ctx.bins);
+		ctx.right_costs.resize(ctx.bins);
+
+		_nodes.reserve(2 * info.count);
+		_node_boxes.reserve(2 * info.count);
+		_parents.reserve(2 * info.count);
+		_nodes.push_back(Node{});
+		_node_boxes.push_back(BVHBox::Empty());
+		_parents.push_back(uint32_t(-1));
+		buildNode(ctx, 0, 0, info.count, 0);
+
+		_item_boxes.resize(info.count);
+		_item_slots.resize(info.count);
+		_item_leaves.resize(info.count);
+		for (uint32_t slot = 0; slot < info.count; ++slot)
+		{
+			_item_boxes[slot] = ctx.boxes[_items[slot]];
+			_item_slots[_items[slot]] = slot;
+		}
+		for (uint32_t n = 0; n < _nodes.size32(); ++n)
+		{
+			const Node & node = _nodes[n];
+			for (uint32_t slot = node.index; slot < node.index + node.count; ++slot)
+			{
+				_item_leaves[_items[slot]] = n;
+			}
+		}
+		_dirty_flags.resize(_nodes.size(), 0);
+		_built_sah_cost = sahCost();
+	}
+
+	void BoundingVolumeHierarchy::buildNode(BuildContext & ctx, uint32_t node_index, uint32_t begin, uint32_t end, uint32_t depth)
+	{
+		BVHBox box = BVHBox::Empty();
+		AABB3f centers_box = {};
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			box += ctx.boxes[_items[i]];
+			centers_box += ctx.centers[_items[i]];
+		}
+		_node_boxes[node_index] = box;
+
+		const uint32_t count = end - begin;
+		const auto make_leaf = [&]()
+		{
+			_nodes[node_index] = Node{
+				.index = begin,
+				.count = count,
+			};
+		};
+		if (count <= ctx.max_leaf_size)
+		{
+			make_leaf();
+			return;
+		}
+
+		const Vector3f extent = centers_box.diagonal();
+		uint32_t mid = begin + count / 2;
+		// Keep the tree shallow enough for the fixed size traversal stacks
+		const bool median_split = depth >= (MaxDepth / 2);
+		bool split_found = false;
+		if (!median_split)
+		{
+			// Binned SAH over the 3 axes
+			float best_cost = std::numeric_limits<float>::max();
+			uint32_t best_axis = 0;
+			uint32_t best_bin = 0;
+			for (uint32_t axis = 0; axis < 3; ++axis)
+			{
+				if (extent[axis] <= 0.0f)
+				{
+					continue;
+				}
+				const float bin_scale = float(ctx.bins) / extent[axis];
+				const float axis_begin = centers_box.bottom()[axis];
+				const auto bin_of = [&](uint32_t item)
+				{
+					return std::min(static_cast<uint32_t>((ctx.centers[item][axis] - axis_begin) * bin_scale), ctx.bins - 1);
+				};
+				for (BuildContext::Bin & bin : ctx.bins_data)
+				{
+					bin = BuildContext::Bin{ .box = BVHBox::Empty(), .count = 0 };
+				}
+				for (uint32_t i = begin; i < end; ++i)
+				{
+					BuildContext::Bin & bin = ctx.bins_data[bin_of(_items[i])];
+					bin.box += ctx.boxes[_items[i]];
+					++bin.count;
+				}
+				// right_costs[b]: cost of the bins [b, bins)
+				{
+					BVHBox right = BVHBox::Empty();
+					uint32_t right_count = 0;
+					for (uint32_t b = ctx.bins - 1; b > 0; --b)
+					{
+						right += ctx.bins_data[b].box;
+						right_count += ctx.bins_data[b].count;
+						ctx.right_costs[b] = right.halfArea() * float(right_count);
+					}
+				}
+				BVHBox left = BVHBox::Empty();
+				uint32_t left_count = 0;
+				for (uint32_t b = 1; b < ctx.bins; ++b)
+				{
+					left += ctx.bins_data[b - 1].box;
+					left_count += ctx.bins_data[b - 1].count;
+					if (left_count == 0 || left_count == count)
+					{
+						continue;
+					}
+					const float cost = left.halfArea() * float(left_count) + ctx.right_costs[b];
+					if (cost < best_cost)
+					{
+						best_cost = cost;
+						best_axis = axis;
+						best_bin = b;
+					}
+				}
+			}
+
+			if (best_bin != 0)
+			{
+				const float leaf_cost = box.halfArea() * float(count);
+				// Relative cost of traversing the node (vs testing an item)
+				const float traversal_cost = box.halfArea();
+				if (best_cost + traversal_cost >= leaf_cost && count <= 4 * ctx.max_leaf_size)
+				{
+					make_leaf();
+					return;
+				}
+				const float bin_scale = float(ctx.bins) / extent[best_axis];
+				const float axis_begin = centers_box.bottom()[best_axis];
+				auto it = std::partition(_items.begin() + begin, _items.begin() + end, [&](uint32_t item)
+				{
+					return std::min(static_cast<uint32_t>((ctx.centers[item][best_axis] - axis_begin) * bin_scale), ctx.bins - 1) < best_bin;
+				});
+				mid = static_cast<uint32_t>(it - _items.begin());
+				split_found = (mid != begin) && (mid != end);
+			}
+		}
+		if (!split_found)
+		{
+			// Median split on the largest axis (or any split if the centers are all equal)
+			uint32_t axis = 0;
+			if (extent[1] > extent[axis])	axis = 1;
+			if (extent[2] > extent[axis])	axis = 2;
+			mid = begin + count / 2;
+			if (extent[axis] > 0.0f)
+			{
+				std::nth_element(_items.begin() + begin, _items.begin() + mid, _items.begin() + end, [&](uint32_t a, uint32_t b)
+				{
+					return ctx.centers[a][axis] < ctx.centers[b][axis];
+				});
+			}
+		}
+
+		const uint32_t children = _nodes.size32();
+		_nodes.push_back(Node{});
+		_nodes.push_back(Node{});
+		_node_boxes.push_back(BVHBox::Empty());
+		_node_boxes.push_back(BVHBox::Empty());
+		_parents.push_back(node_index);
+		_parents.push_back(node_index);
+		_nodes[node_index] = Node{
+			.index = children,
+			.count = 0,
+		};
+		buildNode(ctx, children, begin, mid, depth + 1);
+		buildNode(ctx, children + 1, mid, end, depth + 1);
+	}
+
+	void BoundingVolumeHierarchy::setItemBox(uint32_t item, AABB3f const& box)
+	{
+		_item_boxes[_item_slots[item]] = BVHBox::From(box);
+		const uint32_t leaf = _item_leaves[item];
+		if (!_dirty_flags[leaf])
+		{
+			_dirty_flags[leaf] = 1;
+			_dirty_leaves.push_back(leaf);
+		}
+	}
+
+	void BoundingVolumeHierarchy::refitNode(uint32_t node_index)
+	{
+		const Node & node = _nodes[node_index];
+		BVHBox box = BVHBox::Empty();
+		if (node.isLeaf())
+		{
+			for (uint32_t slot = node.index; slot < node.index + node.count; ++slot)
+			{
+				box += _item_boxes[slot];
+			}
+		}
+		else
+		{
+			box = _node_boxes[node.index];
+			box += _node_boxes[node.index + 1];
+		}
+		_node_boxes[node_index] = box;
+	}
+
+	void BoundingVolumeHierarchy::refit()
+	{
+		if (_dirty_leaves.empty())
+		{
+			return;
+		}
+		if (_dirty_leaves.size() * 8 < _nodes.size())
+		{
+			// Walk up from the updated leaves
+			for (uint32_t leaf : _dirty_leaves)
+			{
+				uint32_t n = leaf;
+				while (n != uint32_t(-1))
+				{
+					const BVHBox previous = _node_boxes[n];
+					refitNode(n);
+					if (n != leaf && previous == _node_boxes[n])
+					{
+						break;
+					}
+					n = _parents[n];
+				}
+			}
+		}
+		else
+		{
+			// Children are always after their parent
+			for (uint32_t n = _nodes.size32(); n > 0; --n)
+			{
+				refitNode(n - 1);
+			}
+		}
+		for (uint32_t leaf : _dirty_leaves)
+		{
+			_dirty_flags[leaf] = 0;
+		}
+		_dirty_leaves.clear();
+	}
+
+	float BoundingVolumeHierarchy::sahCost() const
+	{
+		float res = 0.0f;
+		if (!_nodes.empty())
+		{
+			const float root_area = std::max(_node_boxes.front().halfArea(), std::numeric_limits<float>::min());
+			for (uint32_t n = 0; n < _nodes.size32(); ++n)
+			{
+				const float area = _node_boxes[n].halfArea() / root_area;
+				res += area * float(_nodes[n].isLeaf() ? _nodes[n].count : 1);
+			}
+		}
+		return res;
+	}
+}
@@ -0,0 +1,202 @@
+#include <vkl/Maths/ViewCulling.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace vkl
+{
+	ProjectedAABB ProjectAABB(AABB3f const& world_box, Matrix4f const& world_to_proj, bool reverse_depth)
+	{
+		ProjectedAABB res;
+		res.valid = true;
+		res.uv_min = Vector2f::Constant(std::numeric_limits<float>::max());
+		res.uv_max = Vector2f::Constant(-std::numeric_limits<float>::max());
+		res.closest_depth = reverse_depth ? 0.0f : 1.0f;
+		const Vector3f bottom = world_box.bottom();
+		const Vector3f top = world_box.top();
+		for (uint32_t c = 0; c < 8; ++c)
+		{
+			const Vector4f corner(
+				(c & 1) ? top[0] : bottom[0],
+				(c & 2) ? top[1] : bottom[1],
+				(c & 4) ? top[2] : bottom[2],
+				1.0f
+			);
+			const Vector4f clip = world_to_proj * corner;
+			// In front of the near plane
+			const bool in_front = (clip[3] > 0.0f) && (reverse_depth ? (clip[2] <= clip[3]) : (clip[2] >= 0.0f));
+			if (!in_front)
+			{
+				res.valid = false;
+				return res;
+			}
+			const float inv_w = 1.0f / clip[3];
+			const Vector2f uv(clip[0] * inv_w * 0.5f + 0.5f, clip[1] * inv_w * 0.5f + 0.5f);
+			res.uv_min = res.uv_min.cwiseMin(uv);
+			res.uv_max = res.uv_max.cwiseMax(uv);
+			const float depth = clip[2] * inv_w;
+			res.closest_depth = reverse_depth ? std::max(res.closest_depth, depth) : std::min(res.closest_depth, depth);
+		}
+		res.uv_min = res.uv_min.cwiseMax(Vector2f::Zero()).cwiseMin(Vector2f::Ones());
+		res.uv_max = res.uv_max.cwiseMax(Vector2f::Zero()).cwiseMin(Vector2f::Ones());
+		return res;
+	}
+
+	namespace
+	{
+		struct TexelRect
+		{
+			uint32_t x0, y0, x1, y1;
+		};
+
+		// Texels of level 0 covered by the footprint (inclusive)
+		TexelRect GetTexelRect(ProjectedAABB const& box, VkExtent2D const& extent)
+		{
+			const auto texel = [](float uv, uint32_t size)
+			{
+				return std::min(static_cast<uint32_t>(uv * static_cast<float>(size)), size - 1);
+			};
+			return TexelRect{
+				.x0 = texel(box.uv_min[0], extent.width),
+				.y0 = texel(box.uv_min[1], extent.height),
+				.x1 = texel(box.uv_max[0], extent.width),
+				.y1 = texel(box.uv_max[1], extent.height),
+			};
+		}
+
+		uint32_t LevelSize(uint32_t size, uint32_t level)
+		{
+			return std::max(size >> level, 1u);
+		}
+	}
+
+	DepthPyramidView DepthMinMaxPyramid::farthestDepthView(bool reverse_depth) const
+	{
+		return DepthPyramidView{
+			.extent = extent,
+			.levels = levels.size32(),
+			.fetch = [this, reverse_depth](uint32_t level, uint32_t x, uint32_t y)
+			{
+				const Vector2f min_max = fetch(level, x, y);
+				return reverse_depth ? min_max[0] : min_max[1];
+			},
+		};
+	}
+
+	DepthMinMaxPyramid DepthMinMaxPyramid::Build(const float * depth, VkExtent2D const& extent, uint32_t levels)
+	{
+		DepthMinMaxPyramid res;
+		res.extent = extent;
+		res.levels.resize(levels);
+		if (levels == 0)
+		{
+			return res;
+		}
+		res.levels[0].resize(extent.width * extent.height);
+		for (uint32_t i = 0; i < res.levels[0].size32(); ++i)
+		{
+			res.levels[0][i] = Vector2f::Constant(depth[i]);
+		}
+		for (uint32_t level = 1; level < levels; ++level)
+		{
+			const VkExtent2D prev = res.levelExtent(level - 1);
+			const VkExtent2D next = res.levelExtent(level);
+			MyVector<Vector2f>& values = res.levels[level];
+			values.resize(next.width * next.height);
+			for (uint32_t y = 0; y < next.height; ++y)
+			{
+				// The last texel also covers the remaining texel of an odd level
+				const uint32_t y1 = (y == next.height - 1) ? prev.height - 1 : std::min(2 * y + 1, prev.height - 1);
+				for (uint32_t x = 0; x < next.width; ++x)
+				{
+					const uint32_t x1 = (x == next.width - 1) ? prev.width - 1 : std::min(2 * x + 1, prev.width - 1);
+					Vector2f min_max(std::numeric_limits<float>::max(), -std::numeric_limits<float>::max());
+					for (uint32_t py = std::min(2 * y, prev.height - 1); py <= y1; ++py)
+					{
+						for (uint32_t px = std::min(2 * x, prev.width - 1); px <= x1; ++px)
+						{
+							const Vector2f& v = res.levels[level - 1][px + py * prev.width];
+							min_max[0] = std::min(min_max[0], v[0]);
+							min_max[1] = std::max(min_max[1], v[1]);
+						}
+					}
+					values[x + y * next.width] = min_max;
+				}
+			}
+		}
+		return res;
+	}
+
+	uint32_t SelectDepthPyramidLevel(ProjectedAABB const& box, VkExtent2D const& extent, uint32_t levels)
+	{
+		const TexelRect r = GetTexelRect(box, extent);
+		for (uint32_t level = 0; level < levels; ++level)
+		{
+			const uint32_t w = LevelSize(extent.width, level);
+			const uint32_t h = LevelSize(extent.height, level);
+			const uint32_t x0 = std::min(r.x0 >> level, w - 1);
+			const uint32_t x1 = std::min(r.x1 >> level, w - 1);
+			const uint32_t y0 = std::min(r.y0 >> level, h - 1);
+			const uint32_t y1 = std::min(r.y1 >> level, h - 1);
+			if ((x1 - x0) <= 1 && (y1 - y0) <= 1)
+			{
+				return level;
+			}
+		}
+		return levels;
+	}
+
+	bool IsOccluded(ProjectedAABB const& box, DepthPyramidView const& pyramid, bool reverse_depth)
+	{
+		if (!box.valid || pyramid.levels == 0 || !pyramid.fetch)
+		{
+			return false;
+		}
+		const uint32_t level = SelectDepthPyramidLevel(box, pyramid.extent, pyramid.levels);
+		if (level == pyramid.levels)
+		{
+			return false;
+		}
+		const TexelRect r = GetTexelRect(box, pyramid.extent);
+		const uint32_t w = LevelSize(pyramid.extent.width, level);
+		const uint32_t h = LevelSize(pyramid.extent.height, level);
+		float farthest = reverse_depth ? 1.0f : 0.0f;
+		for (uint32_t y = std::min(r.y0 >> level, h - 1); y <= std::min(r.y1 >> level, h - 1); ++y)
+		{
+			for (uint32_t x = std::min(r.x0 >> level, w - 1); x <= std::min(r.x1 >> level, w - 1); ++x)
+			{
+				const float d = pyramid.fetch(level, x, y);
+				farthest = reverse_depth ? std::min(farthest, d) : std::max(farthest, d);
+			}
+		}
+		return reverse_depth ? (box.closest_depth < farthest) : (box.closest_depth > farthest);
+	}
+
+	CullingView CullingView::Make(Matrix4f const& world_to_proj, bool reverse_depth, const DepthPyramidView * depth_pyramid)
+	{
+		return CullingView{
+			.world_to_proj = world_to_proj,
+			.frustum = FrustumPlanes::FromMatrix(world_to_proj),
+			.reverse_depth = reverse_depth,
+			.depth_pyramid = depth_pyramid,
+		};
+	}
+
+	CullingResult CullObject(AABB3f const& object_box, Matrix3x4f const& object_to_world, CullingView const& view)
+	{
+		const AABB3f world_box = TransformAABB(object_box, object_to_world);
+		if (world_box.empty() || !BoundingVolumeHierarchy::OverlapFrustum(BVHBox::From(world_box), view.frustum))
+		{
+			return CullingResult::OutsideFrustum;
+		}
+		if (view.depth_pyramid)
+		{
+			const ProjectedAABB projected = ProjectAABB(world_box, view.world_to_proj, view.reverse_depth);
+			if (IsOccluded(projected, *view.depth_pyramid, view.reverse_depth))
+			{
+				return CullingResult::Occluded;
+			}
+		}
+		return CullingResult::Visible;
+	}
+}
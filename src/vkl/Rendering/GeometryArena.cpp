@@ -0,0 +1,273 @@
+#include <vkl/Rendering/GeometryArena.hpp>
+#include <vkl/Commands/PrebuiltTransferCommands.hpp>
+#include <vkl/Execution/Executor.hpp>
+
+namespace vkl
+{
+	GeometryArena::GeometryArena(CreateInfo const& ci) :
+		VkObject(ci.app, ci.name),
+		_block_size(ci.block_size),
+		_defragment_threshold(ci.defragment_threshold)
+	{
+		_usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_BITS | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+		if (application()->availableFeatures().acceleration_structure_khr.accelerationStructure)
+		{
+			_usage |= VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR;
+		}
+	}
+
+	GeometryArena::~GeometryArena()
+	{
+		_blocks.clear();
+	}
+
+	uint32_t GeometryArena::createBlock(VkDeviceSize size)
+	{
+		// Reuse the slot of a released block (the indices of the other blocks must not change)
+		uint32_t res = _blocks.size32();
+		for (uint32_t b = 0; b < _blocks.size32(); ++b)
+		{
+			if (!_blocks[b].buffer)
+			{
+				res = b;
+				break;
+			}
+		}
+		if (res == _blocks.size32())
+		{
+			_blocks.push_back(Block{});
+		}
+		Block & block = _blocks[res];
+		block.allocator = RangeAllocator(size);
+		block.relocation_callbacks.clear();
+		block.prev_instance.reset();
+		block.copies.clear();
+		block.buffer = std::make_shared<Buffer>(Buffer::CI{
+			.app = application(),
+			.name = name() + ".block_" + std::to_string(res),
+			.size = size,
+			.usage = _usage,
+			.mem_usage = VMA_MEMORY_USAGE_GPU_ONLY,
+		});
+		return res;
+	}
+
+	GeometryArena::Allocation GeometryArena::allocate(VkDeviceSize size, VkDeviceSize alignment, RelocationCallback const& on_relocation, bool pinned)
+	{
+		std::unique_lock lock(_mutex);
+		Allocation res;
+		for (uint32_t b = 0; b < _blocks.size32(); ++b)
+		{
+			Block & block = _blocks[b];
+			if (block.buffer && (block.allocator.capacity() - block.allocator.used()) >= size)
+			{
+				const RangeAllocator::Offset offset = block.allocator.allocate(size, alignment);
+				if (offset != RangeAllocator::InvalidOffset)
+				{
+					res = Allocation{ .block = b, .offset = offset, .size = size };
+					break;
+				}
+			}
+		}
+		if (!res.valid())
+		{
+			// A mesh larger than a block gets its own block
+			const uint32_t b = createBlock(std::max(_block_size, size));
+			const RangeAllocator::Offset offset = _blocks[b].allocator.allocate(size, alignment);
+			assert(offset != RangeAllocator::InvalidOffset);
+			res = Allocation{ .block = b, .offset = offset, .size = size };
+		}
+		if (pinned)
+		{
+			_blocks[res.block].allocator.setPinned(res.offset, true);
+		}
+		if (on_relocation)
+		{
+			_blocks[res.block].relocation_callbacks[res.offset] = on_relocation;
+		}
+		return res;
+	}
+
+	void GeometryArena::release(Allocation const& allocation)
+	{
+		std::unique_lock lock(_mutex);
+		assert(allocation.valid());
+		Block & block = _blocks[allocation.block];
+		block.allocator.release(allocation.offset);
+		block.relocation_callbacks.erase(allocation.offset);
+		_released_since_defragment = true;
+	}
+
+	void GeometryArena::setPinned(Allocation const& allocation, bool pinned)
+	{
+		std::unique_lock lock(_mutex);
+		_blocks[allocation.block].allocator.setPinned(allocation.offset, pinned);
+	}
+
+	void GeometryArena::defragmentBlock(Block & block)
+	{
+		const uint32_t block_index = static_cast<uint32_t>(&block - _blocks.data());
+		const MyVector<RangeAllocator::Move> moves = block.allocator.compact();
+		if (moves.empty())
+		{
+			return;
+		}
+
+		// The content is copied on the device to a new instance of the block:
+		// the frames in flight keep reading the previous one, so a released range is never overwritten while in use
+		block.prev_instance = block.buffer->instance();
+		block.buffer->destroyInstanceIFN();
+		// dst -> src
+		std::unordered_map<VkDeviceSize, VkDeviceSize> sources;
+		for (RangeAllocator::Move const& move : moves)
+		{
+			sources[move.dst] = move.src;
+		}
+		block.allocator.forEachAllocation([&](VkDeviceSize offset, VkDeviceSize size)
+		{
+			auto it = sources.find(offset);
+			block.copies.push_back(VkBufferCopy2{
+				.sType = VK_STRUCTURE_TYPE_BUFFER_COPY_2,
+				.pNext = nullptr,
+				.srcOffset = (it != sources.end()) ? it->second : offset,
+				.dstOffset = offset,
+				.size = size,
+			});
+		});
+
+		// Moves are in increasing order and go down: a destination is never the source of a later move
+		for (RangeAllocator::Move const& move : moves)
+		{
+			auto it = block.relocation_callbacks.find(move.src);
+			if (it != block.relocation_callbacks.end())
+			{
+				RelocationCallback callback = std::move(it->second);
+				block.relocation_callbacks.erase(it);
+				callback(Allocation{ .block = block_index, .offset = move.dst, .size = move.size });
+				block.relocation_callbacks[move.dst] = std::move(callback);
+			}
+		}
+		_relocations += moves.size();
+	}
+
+	void GeometryArena::defragment()
+	{
+		std::unique_lock lock(_mutex);
+		for (Block & block : _blocks)
+		{
+			if (!block.buffer)
+			{
+				continue;
+			}
+			if (block.allocator.empty())
+			{
+				// In flight commands keep the buffer instance alive
+				block.buffer = nullptr;
+				block.allocator = RangeAllocator();
+				block.relocation_callbacks.clear();
+				block.prev_instance.reset();
+				block.copies.clear();
+			}
+			else if (!block.allocator.hasPinned() && !block.prev_instance)
+			{
+				defragmentBlock(block);
+			}
+		}
+		_released_since_defragment = false;
+	}
+
+	GeometryArena::Stats GeometryArena::stats() const
+	{
+		std::unique_lock lock(_mutex);
+		Stats res{
+			.relocations = _relocations,
+		};
+		VkDeviceSize free_space = 0;
+		for (Block const& block : _blocks)
+		{
+			if (!block.buffer)
+			{
+				continue;
+			}
+			const RangeAllocator::Stats s = block.allocator.stats();
+			++res.blocks;
+			res.capacity += s.capacity;
+			res.used += s.used;
+			res.allocations += s.allocations;
+			res.free_segments += s.free_segments;
+			res.fragmentation += s.fragmentation() * float(s.capacity - s.used);
+			free_space += (s.capacity - s.used);
+		}
+		if (free_space)
+		{
+			res.fragmentation /= float(free_space);
+		}
+		return res;
+	}
+
+	void GeometryArena::updateResources(UpdateContext & ctx)
+	{
+		if (_defragment_requested)
+		{
+			defragment();
+			_defragment_requested = false;
+		}
+		else if (_defragment_threshold > 0 && _released_since_defragment)
+		{
+			const Stats s = stats();
+			// Not worth it for a few scattered bytes
+			const bool worth_it = (s.capacity - s.used) >= (_block_size / 4);
+			if (worth_it && s.fragmentation > _defragment_threshold)
+			{
+				defragment();
+			}
+		}
+		std::unique_lock lock(_mutex);
+		for (Block & block : _blocks)
+		{
+			if (block.buffer)
+			{
+				// Creates the new instance of a defragmented block
+				block.buffer->updateResource(ctx);
+			}
+		}
+	}
+
+	void GeometryArena::recordTransferIFN(ExecutionRecorder & exec)
+	{
+		std::unique_lock lock(_mutex);
+		for (Block & block : _blocks)
+		{
+			if (block.prev_instance)
+			{
+				if (block.buffer && !block.copies.empty())
+				{
+					CopyBuffer & cp = application()->getPrebuiltTransferCommands().copy_buffer;
+					exec(cp.with(CopyBuffer::CopyInfoInstance{
+						.src = block.prev_instance,
+						.dst = block.buffer->instance(),
+						.regions = std::move(block.copies),
+					}));
+				}
+				block.prev_instance.reset();
+				block.copies.clear();
+			}
+		}
+	}
+
+	void GeometryArena::declareGUI(GuiContext & ctx)
+	{
+		const Stats s = stats();
+		ImGui::PushID(this);
+		const double MiB = 1024.0 * 1024.0;
+		ImGui::Text("Blocks: %u, %.3f MiB used / %.3f MiB", s.blocks, double(s.used) / MiB, double(s.capacity) / MiB);
+		ImGui::Text("Allocations: %u, free segments: %u", s.allocations, s.free_segments);
+		ImGui::Text("Fragmentation: %.3f, relocations: %u", s.fragmentation, static_cast<uint>(s.relocations));
+		ImGui::SliderFloat("Defragment threshold", &_defragment_threshold, 0.0f, 1.0f);
+		if (ImGui::Button("Defragment"))
+		{
+			_defragment_requested = true;
+		}
+		ImGui::PopID();
+	}
+}
@@ -11,7 +11,12 @@
 
 #include <imgui/misc/cpp/imgui_stdlib.h>
 
+#include <vulkan/vk_enum_string_helper.h>
+
+#include <vkl/Utils/TickTock.hpp>
+
 #include <format>
+#include <fstream>
 
 namespace vkl
 {
@@ -32,7 +37,14 @@ namespace vkl
 		Module(ci.app, ci.name),
 		_src(ci.src),
 		_dst_folder(ci.dst_folder),
-		_dst_filename(ci.dst_filename)
+		_dst_filename(ci.dst_filename),
+		_readback_pool(std::make_shared<BufferPool>(BufferPool::CI{
+			.app = application(),
+			.name = name() + ".ReadbackPool",
+			.allocator = application()->allocator(),
+			.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			.mem_usage = VMA_MEMORY_USAGE_GPU_TO_CPU,
+		}))
 	{
 		MyVector<ImGuiListSelection::Option> extensions_options(extensions_list.size() + 1);
 		for (size_t i = 0; i < extensions_list.size(); ++i)
@@ -48,13 +60,38 @@ namespace vkl
 			.options = std::move(extensions_options),
 			.default_index = extensions_list.size(),
 		};
+		MyVector<ImGuiListSelection::Option> sequence_options(size_t(SequenceImageFormat::MAX_ENUM));
+		for (size_t i = 0; i < sequence_options.size(); ++i)
+		{
+			sequence_options[i].name = GetSequenceImageFormatName(static_cast<SequenceImageFormat>(i));
+		}
+		sequence_options[size_t(SequenceImageFormat::Raw)].desc = "Pixels as they are, described by a json file";
+		sequence_options[size_t(SequenceImageFormat::QOI)].desc = "8 bits RGB(A)";
+		sequence_options[size_t(SequenceImageFormat::PFM)].desc = "16 or 32 bits float R or RGB";
+		_gui_sequence_format = ImGuiListSelection::CI{
+			.name = "Sequence format",
+			.mode = ImGuiListSelection::Mode::RadioButtons,
+			.same_line = true,
+			.options = std::move(sequence_options),
+			.default_index = size_t(SequenceImageFormat::QOI),
+		};
 		_dst_folder = std::filesystem::weakly_canonical(_dst_folder);
 		_dst_folder_str = _dst_folder.string();
 	}
 
 	ImageSaver::~ImageSaver()
 	{
-
+		if (_capturing)
+		{
+			stopCapture();
+		}
+		// The pending tasks hold buffers of the readback pool
+		std::unique_lock lock(_mutex);
+		for (std::shared_ptr<AsynchTask> const& task : _pending_tasks)
+		{
+			task->waitIFN();
+		}
+		_pending_tasks.clear();
 	}
 
 	void ImageSaver::setExtension()
@@ -85,17 +122,222 @@ namespace vkl
 				break;
 			}
 		}
-		while(_pending_tasks.size() > _pending_capacity)
+		// When dropping frames, the queue is bounded by the frames in flight
+		if (!(_capturing && _capture_drop_frames))
 		{
-			std::shared_ptr<AsynchTask>& task = _pending_tasks.front();
-			task->waitIFN();
-			_pending_tasks.pop_front();
+			std::TickTock_hrc tt;
+			tt.tick();
+			bool stalled = false;
+			while(_pending_tasks.size() > _pending_capacity)
+			{
+				std::shared_ptr<AsynchTask>& task = _pending_tasks.front();
+				task->waitIFN();
+				_pending_tasks.pop_front();
+				stalled = true;
+			}
+			if (stalled && _capturing)
+			{
+				++_capture_stats.stalls;
+				_capture_stats.stall_ms += std::chrono::duration<double, std::milli>(tt.tockd()).count();
+			}
 		}
 		_mutex.unlock();
 	}
 
+	void ImageSaver::startCapture()
+	{
+		if (!_src->instance())
+		{
+			return;
+		}
+		const SequenceImageFormat format = sequenceFormat();
+		_capture_format = _src->instance()->createInfo().format;
+		_capture_extent = _src->instance()->image()->createInfo().extent;
+		if (!CanEncodeSequenceImage(format, _capture_format))
+		{
+			application()->logger()(std::format("{}: Cannot capture a {} image as {}", name(), string_VkFormat(_capture_format), GetSequenceImageFormatName(format)), Logger::Options::TagWarning);
+			return;
+		}
+		if (_create_folder_ifn)
+		{
+			std::error_code ec;
+			std::filesystem::create_directories(_dst_folder, ec);
+		}
+		_capture_first_index = _index;
+		_capture_stats.begin = CaptureStats::Clock::now();
+		_capture_stats.end = _capture_stats.begin;
+		_capture_stats.captured = 0;
+		_capture_stats.dropped = 0;
+		_capture_stats.stalls = 0;
+		_capture_stats.stall_ms = 0;
+		_capture_stats.max_queue = 0;
+		_capture_stats.encoded = 0;
+		_capture_stats.failed = 0;
+		_capture_stats.bytes = 0;
+		_capture_stats.encode_us = 0;
+		_capturing = true;
+	}
+
+	void ImageSaver::stopCapture()
+	{
+		_capturing = false;
+		_capture_stats.end = CaptureStats::Clock::now();
+		if (sequenceFormat() == SequenceImageFormat::Raw)
+		{
+			writeSequenceDescription();
+		}
+		application()->logger()(std::format("{}: Captured {} frames ({} dropped, {} stalls)", name(), _capture_stats.captured, _capture_stats.dropped, _capture_stats.stalls), Logger::Options::TagInfo);
+	}
+
+	void ImageSaver::writeSequenceDescription()
+	{
+		const std::filesystem::path path = _dst_folder / (_dst_filename + ".json");
+		std::ofstream out(path, std::ios::trunc);
+		if (!out)
+		{
+			application()->logger()(std::format("{}: Failed to write {}", name(), path.string()), Logger::Options::TagWarning);
+			return;
+		}
+		out << "{\n";
+		out << std::format("\t\"format\": \"{}\",\n", string_VkFormat(_capture_format));
+		out << std::format("\t\"pixel_size\": {},\n", GetRawPixelByteSize(_capture_format));
+		out << std::format("\t\"width\": {},\n", _capture_extent.width);
+		out << std::format("\t\"height\": {},\n", _capture_extent.height);
+		out << std::format("\t\"first_index\": {},\n", _capture_first_index);
+		out << std::format("\t\"frames\": {},\n", _index - _capture_first_index);
+		out << std::format("\t\"files\": \"{}%06u{}\"\n", _dst_filename, GetSequenceImageFormatExtension(SequenceImageFormat::Raw));
+		out << "}\n";
+	}
+
+	bool ImageSaver::encodeCapturedFrame(BufferInstance & buffer, std::filesystem::path const& path, SequenceImageFormat format, VkFormat vk_format, VkExtent3D const& extent)
+	{
+		std::TickTock_hrc tt;
+		tt.tick();
+		// The buffer stays mapped while it is recycled by the pool
+		const void * data = buffer.data();
+		if (!data)
+		{
+			data = buffer.map();
+		}
+		buffer.invalidate();
+		const RawImageView image{
+			.format = vk_format,
+			.extent = VkExtent2D{.width = extent.width, .height = extent.height},
+			.data = data,
+		};
+		
+		bool res = true;
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		size_t written = 0;
+		if (format == SequenceImageFormat::Raw)
+		{
+			// Straight from the mapped memory
+			written = image.byteSize();
+			file.write(static_cast<const char*>(data), written);
+		}
+		else
+		{
+			std::string content;
+			res = EncodeSequenceImage(format, image, _strip_alpha, content);
+			if (res)
+			{
+				written = content.size();
+				file.write(content.data(), written);
+			}
+		}
+		res = res && file.good();
+
+		if (res)
+		{
+			++_capture_stats.encoded;
+			_capture_stats.bytes += written;
+		}
+		else
+		{
+			++_capture_stats.failed;
+		}
+		_capture_stats.encode_us += std::chrono::duration_cast<std::chrono::microseconds>(tt.tockd()).count();
+		return res;
+	}
+
+	void ImageSaver::recordCapture(ExecutionRecorder & exec)
+	{
+		const VkFormat vk_format = _src->instance()->createInfo().format;
+		const VkExtent3D extent = _src->instance()->image()->createInfo().extent;
+		if (vk_format != _capture_format || extent.width != _capture_extent.width || extent.height != _capture_extent.height || extent.depth != _capture_extent.depth)
+		{
+			application()->logger()(std::format("{}: The captured image changed, stopping the capture", name()), Logger::Options::TagWarning);
+			stopCapture();
+			return;
+		}
+
+		if (_capture_drop_frames)
+		{
+			_mutex.lock();
+			const size_t queue_size = _pending_tasks.size();
+			_mutex.unlock();
+			if (queue_size >= _pending_capacity)
+			{
+				++_capture_stats.dropped;
+				return;
+			}
+		}
+
+		DownloadImage & downloader = application()->getPrebuiltTransferCommands().download_image;
+		const SequenceImageFormat format = sequenceFormat();
+		std::filesystem::path path = _dst_folder / std::format("{}{:06}{}", _dst_filename, _index, GetSequenceImageFormatExtension(format));
+		++_index;
+		++_capture_stats.captured;
+
+		DownloadCallback callback = [this, path, format, vk_format, extent](int vk_res_int, std::shared_ptr<PooledBuffer> const& buffer_ref)
+		{
+			if (static_cast<VkResult>(vk_res_int) != VK_SUCCESS)
+			{
+				++_capture_stats.failed;
+				return;
+			}
+			std::shared_ptr<PooledBuffer> buffer = buffer_ref;
+			std::shared_ptr<AsynchTask> task = std::make_shared<AsynchTask>(AsynchTask::CI{
+				.name = "Encoding frame "s + path.string(),
+				.verbosity = 1,
+				.priority = TaskPriority::Soon(),
+				.lambda = [this, buffer, path, format, vk_format, extent]() mutable
+				{
+					const bool res = encodeCapturedFrame(*buffer->buffer(), path, format, vk_format, extent);
+					// Back to the pool for the next frames
+					buffer = nullptr;
+					AsynchTask::ReturnType result{
+						.success = res,
+						.can_retry = false,
+					};
+					if (!res)
+					{
+						result.error_title = "Failed to write a captured frame!";
+						result.error_message = "Failed to write VkImage ["s + _src->name() + "] to "s + path.string();
+					}
+					return result;
+				},
+			});
+			application()->threadPool().pushTask(task);
+			_mutex.lock();
+			_pending_tasks.push_back(std::move(task));
+			_capture_stats.max_queue = std::max(_capture_stats.max_queue, _pending_tasks.size());
+			_mutex.unlock();
+		};
+
+		exec(downloader(DownloadImage::DownloadInfo{
+			.src = _src,
+			.staging_pool = _readback_pool,
+			.completion_callback = callback,
+		}));
+	}
+
 	void ImageSaver::execute(ExecutionRecorder& exec)
 	{
+		if (_capturing)
+		{
+			recordCapture(exec);
+		}
 		if (_save_image)
 		{
 			DownloadImage & downloader = application()->getPrebuiltTransferCommands().download_image;
@@ -272,7 +514,41 @@ namespace vkl
 				ImGui::EndDisabled();
 				ImGui::Separator();
 			}
+
+			declareCaptureGUI();
 		}
 		ImGui::PopID();
 	}
+
+	void ImageSaver::declareCaptureGUI()
+	{
+		ImGui::SeparatorText("Sequence");
+		if (_capturing)
+		{
+			if (ImGui::Button("Stop Capture"))
+			{
+				stopCapture();
+			}
+		}
+		else
+		{
+			if (ImGui::Button("Start Capture"))
+			{
+				startCapture();
+			}
+		}
+		ImGui::BeginDisabled(_capturing);
+		_gui_sequence_format.declare();
+		ImGui::EndDisabled();
+		ImGui::Checkbox("Drop frames when the encoders are behind", &_capture_drop_frames);
+		ImGui::SetItemTooltip("Otherwise, wait for them (the queue capacity is the Save Queue Capacity)");
+
+		const CaptureStats::Clock::time_point end = _capturing ? CaptureStats::Clock::now() : _capture_stats.end;
+		const double seconds = std::chrono::duration<double>(end - _capture_stats.begin).count();
+		const size_t encoded = _capture_stats.encoded;
+		const double MB = 1000.0 * 1000.0;
+		ImGui::Text("Captured: %zu, Encoded: %zu, Dropped: %zu, Failed: %zu", _capture_stats.captured, encoded, _capture_stats.dropped, size_t(_capture_stats.failed));
+		ImGui::Text("Stalls: %zu (%.1f ms), Max queue: %zu", _capture_stats.stalls, _capture_stats.stall_ms, _capture_stats.max_queue);
+		ImGui::Text("Encoding: %.2f ms / frame, Written: %.1f MB/s", encoded ? (double(_capture_stats.encode_us) / double(encoded) / 1000.0) : 0.0, seconds > 0 ? (double(_capture_stats.bytes) / MB / seconds) : 0.0);
+	}
 }
\ No newline at end of file
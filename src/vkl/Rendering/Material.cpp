@@ -59,6 +59,11 @@ namespace vkl
 		}
 	}
 
+	void Material::unRegisterFromPropertiesTable(std::shared_ptr<HostManagedBuffer> const& table)
+	{
+		std::erase_if(_registered_tables, [&](TableRegistration const& reg) {return reg.table == table; });
+	}
+
 	void Material::registerTexturesToDescriptorSet(std::shared_ptr<DescriptorSetAndPool> const& set, uint32_t binding, uint32_t array_index, bool stack_on_array)
 	{
 		for (uint32_t i = 0; i < static_cast<uint32_t>(_textures.size()); ++i)
@@ -141,14 +146,6 @@ namespace vkl
 		}
 		_should_update_props_buffer = true;
 
-		_props_buffer = std::make_shared<Buffer>(Buffer::CI{
-			.app = application(),
-			.name = name() + ".props_buffer",
-			.size = sizeof(Properties),
-			.usage = VK_BUFFER_USAGE_TRANSFER_BITS | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-			.mem_usage = VMA_MEMORY_USAGE_GPU_ONLY,
-		});
-
 		if (std::any_of(_textures.begin(), _textures.end(), [](std::shared_ptr<Texture> const& tex){return tex.operator bool();}))
 		{
 			if (!_sampler)
@@ -312,10 +309,9 @@ namespace vkl
 	void PhysicallyBasedMaterial::updateResources(UpdateContext& ctx)
 	{
 		Material::updateResources(ctx);
-		_props_buffer->updateResource(ctx);
 
 		const Properties new_props = getProperties();
-		if (new_props.flags != _cached_props.flags)
+		if (!(new_props == _cached_props))
 		{
 			_should_update_props_buffer = true;
 		}
@@ -323,19 +319,31 @@ namespace vkl
 
 		if (_should_update_props_buffer)
 		{
-			ResourcesToUpload::BufferSource source{
-				.data = &_cached_props,
-				.size = sizeof(_cached_props),
-				.offset = 0,
-				.copy_data = false,
-			};
-			ctx.resourcesToUpload() += ResourcesToUpload::BufferUpload{
-				.sources = &source,
-				.sources_count = 1,
-				.dst = _props_buffer->instance(),
-			};
-			_should_update_props_buffer = false;
+			for (TableRegistration const& reg : _registered_tables)
+			{
+				reg.table->set<Properties>(reg.index, _cached_props);
+			}
 		}
+
+		if (_props_buffer)
+		{
+			_props_buffer->updateResource(ctx);
+			if (_should_update_props_buffer)
+			{
+				ResourcesToUpload::BufferSource source{
+					.data = &_cached_props,
+					.size = sizeof(_cached_props),
+					.offset = 0,
+					.copy_data = false,
+				};
+				ctx.resourcesToUpload() += ResourcesToUpload::BufferUpload{
+					.sources = &source,
+					.sources_count = 1,
+					.dst = _props_buffer->instance(),
+				};
+			}
+		}
+		_should_update_props_buffer = false;
 	}
 
 	MyVector<DescriptorSetLayout::Binding> PhysicallyBasedMaterial::getSetLayoutBindingsStatic(uint32_t offset)
@@ -408,6 +416,18 @@ namespace vkl
 
 	void PhysicallyBasedMaterial::registerToDescriptorSet(std::shared_ptr<DescriptorSetAndPool> const& set, uint32_t binding, uint32_t array_index, bool include_textures)
 	{
+		if (!_props_buffer)
+		{
+			_props_buffer = std::make_shared<Buffer>(Buffer::CI{
+				.app = application(),
+				.name = name() + ".props_buffer",
+				.size = sizeof(Properties),
+				.usage = VK_BUFFER_USAGE_TRANSFER_BITS | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+				.mem_usage = VMA_MEMORY_USAGE_GPU_ONLY,
+			});
+			_should_update_props_buffer = true;
+		}
+
 		DescriptorSetAndPool::Registration reg{
 			.set = set,
 			.binding = binding,
@@ -447,6 +467,15 @@ namespace vkl
 		}
 	}
 
+	void PhysicallyBasedMaterial::registerToPropertiesTable(std::shared_ptr<HostManagedBuffer> const& table, uint32_t index)
+	{
+		table->set<Properties>(index, getProperties());
+		_registered_tables += TableRegistration{
+			.table = table,
+			.index = index,
+		};
+	}
+
 	void PhysicallyBasedMaterial::callResourceUpdateCallbacks()
 	{
 		for (auto& reg : _registered_sets)
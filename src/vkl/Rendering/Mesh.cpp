@@ -169,6 +169,11 @@ namespace vkl
 			_registered_sets.erase(_registered_sets.begin() + i);
 		}
 		_registered_sets.clear();
+
+		if (_device.arena && _device.allocation.valid())
+		{
+			_device.arena->release(_device.allocation);
+		}
 	}
 
 	MeshHeader RigidMesh::getHeader() const
@@ -542,21 +547,6 @@ namespace vkl
 		_device.num_indices = header.num_indices;
 		_device.num_vertices = header.num_vertices;
 		_device.index_type = _host.index_type;
-		
-		bool enable_blas = application()->availableFeatures().acceleration_structure_khr.accelerationStructure;
-		VkBufferUsageFlags buffer_usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_BITS | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
-		if (enable_blas)
-		{
-			buffer_usage |= VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR;
-		}
-		_device.mesh_buffer = std::make_shared<Buffer>(Buffer::CI{
-			.app = _app,
-			.name = name() + ".mesh_buffer",
-			.size = &_device.total_buffer_size,
-			.usage =  buffer_usage,
-			.queues = queues,
-			.mem_usage = VMA_MEMORY_USAGE_GPU_ONLY,
-		});
 
 		_device.index_type_size = [&]() {
 			uint8_t res = 0;
@@ -575,43 +565,130 @@ namespace vkl
 			return res;
 		}();
 
+		// The arena buffers are exclusive to one queue family
+		_device.arena = queues.size() > 1 ? nullptr : application()->geometryArena();
+		if (_device.arena)
+		{
+			// Both the vertex and the index offsets of the draw calls are in elements
+			const size_t align = std::max<size_t>(ssbo_align, sizeof(uint32_t));
+			_device.vertices_size = std::alignUp(header.num_vertices * vertexSize(), align);
+			_device.indices_size = std::alignUp(_host.indexBufferSize(), align);
+			_device.total_buffer_size = _device.header_size + _device.vertices_size + _device.indices_size;
+			_device.allocation = _device.arena->allocate(_device.total_buffer_size, std::lcm(vertexSize(), align), [this](GeometryArena::Allocation const& allocation)
+			{
+				// The arena copies the content on the device (the allocation was not pinned: no pending upload)
+				// Only the ranges change: transmit them again to the descriptors in the same update
+				_device.allocation = allocation;
+				setDeviceRanges();
+				callResourceUpdateCallbacks();
+				if (_blas)
+				{
+					createBLAS();
+				}
+			}, true);
+			_device.pinned = true;
+			// Relocations stay in the same block
+			_device.mesh_buffer = _device.arena->buffer(_device.allocation.block);
+			_device.draw_vertex_buffer = _device.arena->blockBufferAndRange(_device.allocation.block);
+			_device.draw_index_buffer = _device.draw_vertex_buffer;
+		}
+		else
+		{
+			bool enable_blas = application()->availableFeatures().acceleration_structure_khr.accelerationStructure;
+			VkBufferUsageFlags buffer_usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_BITS | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+			if (enable_blas)
+			{
+				buffer_usage |= VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR;
+			}
+			_device.mesh_buffer = std::make_shared<Buffer>(Buffer::CI{
+				.app = _app,
+				.name = name() + ".mesh_buffer",
+				.size = &_device.total_buffer_size,
+				.usage =  buffer_usage,
+				.queues = queues,
+				.mem_usage = VMA_MEMORY_USAGE_GPU_ONLY,
+			});
+		}
+
+		setDeviceRanges();
+
+		if(application()->availableFeatures().acceleration_structure_khr.accelerationStructure)
+		{
+			createBLAS();
+		}
+	}
+
+	void RigidMesh::setDeviceRanges()
+	{
+		if (_device.arena)
+		{
+			// Also called by the relocation callback: must not call the (locked) arena
+			_device.vertices_offset = _device.allocation.offset;
+			_device.indices_offset = _device.vertices_offset + _device.vertices_size;
+			_device.header_offset = _device.indices_offset + _device.indices_size;
+			_device.vertex_offset = static_cast<int32_t>(_device.vertices_offset / vertexSize());
+			_device.first_index = _device.index_type_size ? static_cast<uint32_t>(_device.indices_offset / _device.index_type_size) : 0;
+		}
+		else
+		{
+			_device.header_offset = 0;
+			_device.vertices_offset = _device.header_size;
+			_device.indices_offset = _device.header_size + _device.vertices_size;
+		}
+
 		_device.header_buffer = BufferAndRange{
 			.buffer = _device.mesh_buffer,
-			.range = Buffer::Range{.begin = 0, .len = _device.header_size},
+			.range = Buffer::Range{.begin = _device.header_offset, .len = _device.header_size},
 		};
 		_device.vertex_buffer = BufferAndRange{
 			.buffer = _device.mesh_buffer,
-			.range = Buffer::Range{.begin = _device.header_size, .len = _device.vertices_size},
+			.range = Buffer::Range{.begin = _device.vertices_offset, .len = _device.vertices_size},
 		};
 		_device.index_buffer = BufferAndRange{
 			.buffer = _device.mesh_buffer,
-			.range = Buffer::Range{.begin = _device.header_size + _device.vertices_size, .len = _device.indices_size},
+			.range = Buffer::Range{.begin = _device.indices_offset, .len = _device.indices_size},
 		};
 
-
-		if(enable_blas)
+		if (!_device.arena)
 		{
-			_blas = std::make_shared<BLAS>(BLAS::CI{
-				.app = application(),
-				.name = name() + ".BLAS",
-				.geometry_flags = {},
-				.build_flags = VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR,
-				.geometries = {
-					BLAS::Geometry{
-						.vertex_buffer = _device.vertex_buffer,
-						.vertex_description = VertexDescriptionAS{
-							.format = VK_FORMAT_R32G32B32_SFLOAT,
-							.stride = sizeof(Vertex),
-						},
-						.index_buffer = _device.index_buffer,
-						.index_type = _device.index_type,
-						.capacity = BLAS::Geometry::Capacity{
-							.max_vertex = header.num_vertices,
-							.max_primitives = header.num_primitives,
-						},
-					}
+			_device.draw_vertex_buffer = _device.vertex_buffer;
+			_device.draw_index_buffer = _device.index_buffer;
+			_device.vertex_offset = 0;
+			_device.first_index = 0;
+		}
+	}
+
+	void RigidMesh::createBLAS()
+	{
+		_blas = std::make_shared<BLAS>(BLAS::CI{
+			.app = application(),
+			.name = name() + ".BLAS",
+			.geometry_flags = {},
+			.build_flags = VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR,
+			.geometries = {
+				BLAS::Geometry{
+					.vertex_buffer = _device.vertex_buffer,
+					.vertex_description = VertexDescriptionAS{
+						.format = VK_FORMAT_R32G32B32_SFLOAT,
+						.stride = sizeof(Vertex),
+					},
+					.index_buffer = _device.index_buffer,
+					.index_type = _device.index_type,
+					.capacity = BLAS::Geometry::Capacity{
+						.max_vertex = _device.num_vertices,
+						.max_primitives = getHeader().num_primitives,
+					},
 				}
-			});
+			}
+		});
+	}
+
+	void RigidMesh::setArenaPinned(bool pinned)
+	{
+		if (_device.arena && _device.pinned != pinned)
+		{
+			_device.arena->setPinned(_device.allocation, pinned);
+			_device.pinned = pinned;
 		}
 	}
 
@@ -632,12 +709,13 @@ namespace vkl
 		vr.draw_count = _device.num_indices;
 		vr.instance_count = 1;
 		
-		vr.index_buffer = _device.index_buffer;
+		vr.index_buffer = _device.draw_index_buffer;
 		vr.index_type = _device.index_type;
-		size_t vertex_size = _host.use_full_vertices ? sizeof(Vertex) : (_host.dims * sizeof(float));
 		vr.vertex_buffers = {
-			_device.vertex_buffer,
+			_device.draw_vertex_buffer,
 		};
+		vr.first_index = _device.first_index;
+		vr.vertex_offset = _device.vertex_offset;
 	}
 
 	Mesh::Status RigidMesh::getStatus() const
@@ -732,27 +810,27 @@ namespace vkl
 				const MeshHeader header = getHeader();
 				sources[0] = PositionedObjectView{
 					.obj = header,
-					.pos = 0,
+					.pos = _device.header_offset,
 				};
 
 				if (_host.use_full_vertices)
 				{
 					sources[1] = PositionedObjectView{
 						.obj = _host.vertices,
-						.pos = _device.header_size,
+						.pos = _device.vertices_offset,
 					};
 				}
 				else
 				{
 					sources[1] = PositionedObjectView{
 						.obj = _host.positions,
-						.pos = _device.header_size,
+						.pos = _device.vertices_offset,
 					};
 				}
 
 				sources[2] = PositionedObjectView{
 					.obj = _host.indicesView(),
-					.pos = _device.header_size + _device.vertices_size,
+					.pos = _device.indices_offset,
 				};
 
 				if (synch_upload)
@@ -773,12 +851,15 @@ namespace vkl
 						.dst = _device.mesh_buffer->instance(),
 					};
 					_device.uploaded = true;
+					setArenaPinned(false);
 					callResourceUpdateCallbacks();
 				}
 				else
 				{
 					_device.uploaded = false;
 					_device.just_uploaded = false;
+					// Not relocated while the upload is pending
+					setArenaPinned(true);
 					ctx.uploadQueue()->enqueue(AsynchUpload{
 						.name = name(),
 						.sources = std::move(sources),
@@ -796,6 +877,7 @@ namespace vkl
 				{
 					_device.uploaded = true;
 					_device.just_uploaded = false;
+					setArenaPinned(false);
 					callResourceUpdateCallbacks();
 				}
 			}
@@ -14,6 +14,7 @@
 #include <vkl/Maths/Transforms.hpp>
 
 #include <ShaderLib/Rendering/Scene/SceneFlags.h>
+#include <ShaderLib/Rendering/Scene/SceneDefinitions.h>
 
 namespace vkl
 {
@@ -432,13 +433,11 @@ namespace vkl
 				.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
 			};
 
-			Dyn<uint32_t> material_count = [this](){return _unique_material_index_pool.capacity();};
-			
 			bindings += DescriptorSetLayout::Binding{
 				.name = "ScenePBMaterialsBinding",
 				.binding = _material_bindings_base + 0,
 				.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
-				.count = material_count,
+				.count = 1,
 				.stages = VK_SHADER_STAGE_ALL,
 				.access = VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
 				.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
@@ -540,6 +539,14 @@ namespace vkl
 			.mem_usage = VMA_MEMORY_USAGE_GPU_ONLY,
 		});
 
+		_material_props_buffer = std::make_shared<HostManagedBuffer>(HostManagedBuffer::CI{
+			.app = application(),
+			.name = name() + ".MaterialPropsBuffer",
+			.size = sizeof(PhysicallyBasedMaterial::Properties) * 256,
+			.usage = VK_BUFFER_USAGE_TRANSFER_BITS | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+			.mem_usage = VMA_MEMORY_USAGE_GPU_ONLY,
+		});
+
 		_material_ref_buffer = std::make_shared<HostManagedBuffer>(HostManagedBuffer::CI{
 			.app = application(),
 			.name = name() + ".MaterialRefBuffer",
@@ -613,6 +620,11 @@ namespace vkl
 			.binding = _objects_binding_base + 0,
 		};
 
+		bindings += Binding{
+			.buffer = _material_props_buffer->buffer(),
+			.binding = _material_bindings_base + 0,
+		};
+
 		bindings += Binding{
 			.buffer = _material_ref_buffer->buffer(),
 			.binding = _material_bindings_base + 1,
@@ -676,6 +688,11 @@ namespace vkl
 		static_assert(std::concepts::HashableFromMethod<DirectedAcyclicGraph::RobustNodePath>);
 		
 		_aabb.reset();
+		_instances_local_aabbs.clear();
+		_instances_xforms.clear();
+		_shadow_casters_changes.clear();
+		_static_shadow_casters_changes.clear();
+		++_update_index;
 
 		_tree->iterateOnDag([&](std::shared_ptr<Node> const& node, DirectedAcyclicGraph::RobustNodePath const& path, Mat3x4 const& matrix4, uint32_t flags)
 		{
@@ -717,9 +734,9 @@ namespace vkl
 						}
 					}
 
-					const auto & aabb = mesh->getAABB();
-
-					aabb.getContainingAABB(matrix, _aabb);
+					// Transformed in a batch after the traversal
+					_instances_local_aabbs.push_back(mesh->getAABB());
+					_instances_xforms.push_back(matrix);
 				}
 
 				if(material)
@@ -730,14 +747,16 @@ namespace vkl
 						material_unique_id = _unique_material_index_pool.allocate();
 						_unique_materials[material.get()] = MaterialData{
 							.unique_index = material_unique_id,
+							.material = material,
 						};
-						material->registerToDescriptorSet(_set, _material_bindings_base + 0, material_unique_id, false);
+						material->registerToPropertiesTable(_material_props_buffer, material_unique_id);
 						write_material = true;
 					}
 					else
 					{
 						material_unique_id = _unique_materials[material.get()].unique_index;
 					}
+					_unique_materials[material.get()].update_index = _update_index;
 					const MaterialReference& old_ref = _material_ref_buffer->get<MaterialReference>(material_unique_id);
 
 
@@ -785,11 +804,13 @@ namespace vkl
 				Mat3x4 model_matrix = matrix;
 				if(visible)
 					model_flags |= 1;
+				ModelInstance * model_instance = nullptr;
 				if (!_unique_models.contains(path))
 				{
 					unique_model_id = _unique_model_index_pool.allocate();
 					xform_unique_id = _unique_xform_index_pool.allocate();
-					_unique_models[path] = ModelInstance{
+					model_instance = &_unique_models[path];
+					*model_instance = ModelInstance{
 						.model_unique_index = unique_model_id,
 						.xform_unique_index = xform_unique_id,
 					};
@@ -799,6 +820,7 @@ namespace vkl
 				else
 				{
 					auto & um = _unique_models[path];
+					model_instance = &um;
 					unique_model_id = um.model_unique_index;
 					xform_unique_id = um.xform_unique_index;
 					const ModelReference & mr = _model_references_buffer->get<ModelReference>(unique_model_id);
@@ -814,6 +836,71 @@ namespace vkl
 					set_xform |= changed_xform;
 				}
 
+				{
+					// Track the shadow casters changes, so the shadow maps can be cached
+					ModelInstance & mi = *model_instance;
+					mi.update_index = _update_index;
+					const Mesh * caster_mesh = (visible && mesh && mesh->isReadyToDraw()) ? mesh.get() : nullptr;
+					const bool was_static = mi.frames_since_moved >= _dynamic_caster_frames;
+					if (changed_xform)
+					{
+						mi.frames_since_moved = 0;
+					}
+					else if (mi.frames_since_moved < _dynamic_caster_frames)
+					{
+						++mi.frames_since_moved;
+					}
+					const bool is_static = mi.frames_since_moved >= _dynamic_caster_frames;
+					if (!is_static)
+					{
+						model_flags |= SCENE_OBJECT_FLAG_DYNAMIC_BIT;
+						set_model_reference |= (_model_references_buffer->get<ModelReference>(unique_model_id).flags != model_flags);
+					}
+					else if (!was_static)
+					{
+						set_model_reference = true;
+					}
+					if (caster_mesh != mi.caster_mesh || changed_xform || is_static != was_static)
+					{
+						const AABB3f previous_aabb = mi.world_aabb;
+						AABB3f new_aabb = {};
+						if (caster_mesh)
+						{
+							new_aabb = TransformAABB(caster_mesh->getAABB(), matrix);
+						}
+						if (mi.caster_mesh)
+						{
+							_shadow_casters_changes.push_back(previous_aabb);
+							if (was_static)
+							{
+								_static_shadow_casters_changes.push_back(previous_aabb);
+							}
+						}
+						if (caster_mesh)
+						{
+							_shadow_casters_changes.push_back(new_aabb);
+							if (is_static)
+							{
+								_static_shadow_casters_changes.push_back(new_aabb);
+							}
+						}
+						if (caster_mesh != mi.caster_mesh)
+						{
+							_rebuild_shadow_casters = true;
+						}
+						else if (mi.caster_index != uint32_t(-1) && !_rebuild_shadow_casters)
+						{
+							// Moved: refit the BVH instead of rebuilding it
+							ShadowCaster & caster = _shadow_casters[mi.caster_index];
+							caster.world_aabb = new_aabb;
+							caster.dynamic = !is_static;
+							_shadow_casters_bvh.setItemBox(mi.caster_index, new_aabb);
+						}
+						mi.caster_mesh = caster_mesh;
+						mi.world_aabb = new_aabb;
+					}
+				}
+
 				if (set_model_reference)
 				{
 					_model_references_buffer->set(unique_model_id, ModelReference{
@@ -921,7 +1008,7 @@ namespace vkl
 								.extent = [this](){return VkExtent3D{.width = _light_resolution, .height = _light_resolution, .depth = 1,}; },
 								.layers = layers,
 								.samples = &_light_depth_samples,
-								.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+								.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
 								.mem_usage = VMA_MEMORY_USAGE_GPU_ONLY,
 							});
 							lid->depth_view = std::make_shared<ImageView>(ImageView::CI{
@@ -959,7 +1046,130 @@ namespace vkl
 			return true;
 		});
 
+		removeUnreachedModels();
+		removeUnreachedMaterials();
+
+		_aabb = TransformAABBs(AABBTransformInfo{
+			.boxes = _instances_local_aabbs.data(),
+			.xforms = _instances_xforms.data(),
+			.count = _instances_local_aabbs.size(),
+			.executor = &application()->threadPool(),
+		});
 		_radius = _aabb.getContainingSphere().radius();
+
+		if (_rebuild_shadow_casters)
+		{
+			updateShadowCasters();
+		}
+		else if (_shadow_casters_bvh.needsRefit())
+		{
+			_shadow_casters_bvh.refit();
+			if (_shadow_casters_bvh.shouldRebuild())
+			{
+				buildShadowCastersBVH();
+			}
+		}
+	}
+
+	void Scene::removeUnreachedModels()
+	{
+		auto it = _unique_models.begin();
+		while (it != _unique_models.end())
+		{
+			ModelInstance & mi = it->second;
+			if (mi.update_index == _update_index)
+			{
+				++it;
+				continue;
+			}
+			// Removed from the DAG: the shadow maps it was cast on are invalidated
+			if (mi.caster_mesh)
+			{
+				_shadow_casters_changes.push_back(mi.world_aabb);
+				if (mi.frames_since_moved >= _dynamic_caster_frames)
+				{
+					_static_shadow_casters_changes.push_back(mi.world_aabb);
+				}
+				_rebuild_shadow_casters = true;
+			}
+			// Not drawn anymore, until the index is re-used
+			_model_references_buffer->set(mi.model_unique_index, ModelReference{
+				.mesh_id = uint32_t(-1),
+				.material_id = uint32_t(-1),
+				.xform_id = mi.xform_unique_index,
+				.flags = 0,
+			});
+			if (_maintain_rt)
+			{
+				const uint32_t tlas_geometry_id = 0;
+				if (mi.model_unique_index < _tlas->geometries()[tlas_geometry_id].blases.size() && _tlas->geometries()[tlas_geometry_id].blases[mi.model_unique_index].blas)
+				{
+					_tlas->registerBLAS(tlas_geometry_id, mi.model_unique_index, TLAS::BLASInstance{
+						.blas = nullptr,
+					});
+				}
+			}
+			_unique_model_index_pool.release(mi.model_unique_index);
+			_unique_xform_index_pool.release(mi.xform_unique_index);
+			it = _unique_models.erase(it);
+		}
+	}
+
+	void Scene::removeUnreachedMaterials()
+	{
+		auto it = _unique_materials.begin();
+		while (it != _unique_materials.end())
+		{
+			MaterialData & md = it->second;
+			if (md.update_index == _update_index)
+			{
+				++it;
+				continue;
+			}
+			if (std::shared_ptr<Material> material = md.material.lock())
+			{
+				material->unRegisterFromPropertiesTable(_material_props_buffer);
+			}
+			// The slot is re-written by the next material using it, the textures ids are only written when they differ
+			_material_ref_buffer->set(md.unique_index, MaterialReference{});
+			_unique_material_index_pool.release(md.unique_index);
+			it = _unique_materials.erase(it);
+		}
+	}
+
+	void Scene::updateShadowCasters()
+	{
+		_rebuild_shadow_casters = false;
+		_shadow_casters.clear();
+		for (auto & [path, mi] : _unique_models)
+		{
+			mi.caster_index = uint32_t(-1);
+			if (mi.caster_mesh && mi.caster_mesh->type() == Mesh::Type::Rigid)
+			{
+				const RigidMesh * mesh = static_cast<const RigidMesh*>(mi.caster_mesh);
+				mi.caster_index = _shadow_casters.size32();
+				_shadow_casters.push_back(ShadowCaster{
+					.world_aabb = mi.world_aabb,
+					.model_unique_index = mi.model_unique_index,
+					.num_indices = mesh->getHeader().num_indices,
+					.dynamic = mi.frames_since_moved < _dynamic_caster_frames,
+				});
+			}
+		}
+		buildShadowCastersBVH();
+	}
+
+	void Scene::buildShadowCastersBVH()
+	{
+		MyVector<AABB3f> boxes(_shadow_casters.size());
+		for (size_t i = 0; i < _shadow_casters.size(); ++i)
+		{
+			boxes[i] = _shadow_casters[i].world_aabb;
+		}
+		_shadow_casters_bvh.build(BoundingVolumeHierarchy::BuildInfo{
+			.boxes = boxes.data(),
+			.count = boxes.size32(),
+		});
 	}
 
 	void Scene::setMaintainRT(bool value)
@@ -975,6 +1185,7 @@ namespace vkl
 		_ubo_buffer->updateResource(ctx);
 		_lights_buffer->updateResources(ctx);
 		_model_references_buffer->updateResources(ctx);
+		_material_props_buffer->updateResources(ctx);
 		_material_ref_buffer->updateResources(ctx);
 		_xforms_buffer->updateResources(ctx);
 		_prev_xforms_buffer->updateResource(ctx);
@@ -1021,6 +1232,7 @@ namespace vkl
 		_xforms_buffer->recordTransferIFN(exec);
 		_lights_buffer->recordTransferIFN(exec);
 		_model_references_buffer->recordTransferIFN(exec);
+		_material_props_buffer->recordTransferIFN(exec);
 		_material_ref_buffer->recordTransferIFN(exec);
 	}
 
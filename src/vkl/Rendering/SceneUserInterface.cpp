@@ -238,6 +238,8 @@ namespace vkl
 						.index_type = vdcr.index_type,
 						.num_vertex_buffers = vdcr.vertex_buffers.size32(),
 						.vertex_buffers = vdcr.vertex_buffers.data(),
+						.first_index = vdcr.first_index,
+						.vertex_offset = vdcr.vertex_offset,
 					});
 					
 					vdcr.clear();
@@ -563,6 +565,13 @@ ITERATE_OVER_RIGID_MESH_MAKE_TYPE(REGISTER_OPTION)
 			vec3 center = _scene->_aabb.center();
 			ImGui::Text("Center: (%f, %f, %f)", center.x(), center.y(), center.z());
 			ImGui::Text("Radius: %f", _scene->_radius);
+
+			ImGui::SeparatorText("Resources");
+			ImGui::Text("Meshes: %u, Materials: %u, Textures: %u", static_cast<uint>(_scene->_unique_meshes.size()), static_cast<uint>(_scene->_unique_materials.size()), static_cast<uint>(_scene->_unique_textures.size()));
+			if (_scene->_material_props_buffer)
+			{
+				ImGui::Text("Material properties table: %.1f KiB (1 descriptor)", double(_scene->_material_props_buffer->byteSize()) / 1024.0);
+			}
 			
 			ImGui::Checkbox("show world 3D basis", &_show_world_basis);
 			ImGui::Checkbox("show view 3D basis", &_show_view_basis);
@@ -3,12 +3,14 @@
 #include <that/img/ImRead.hpp>
 
 #include <chrono>
+#include <optional>
 
 #include <imgui/misc/cpp/imgui_stdlib.h>
 
 #include <vulkan/vk_enum_string_helper.h>
 
 #include <vkl/IO/DependencyTracker.hpp>
+#include <vkl/Utils/ImageConversion.hpp>
 
 namespace vkl
 {
@@ -60,11 +62,7 @@ namespace vkl
 	{
 		if (!_path.empty())
 		{
-			that::img::io::ReadImageInfo read_info{
-				.path = &_path,
-				.filesystem = application()->fileSystem(),
-				.target = &_host_image,
-			};
+			const auto begin = std::chrono::high_resolution_clock::now();
 			auto latest_file_time = application()->fileSystem()->getFileLastWriteTime(_resolved_cannon_path, FileSystem::Hint::PathIsCannon | FileSystem::Hint::PathIsNative);
 			if (latest_file_time.result == that::Result::Success)
 			{
@@ -74,60 +72,408 @@ namespace vkl
 			{
 				_instance_time = FileSystem::TimePoint::min();
 			}
-			that::Result read_result = that::img::io::ReadFormatedImage(read_info);
-			if (read_result != that::Result::Success)
+
+			if (GetCompressedImageContainer(_path) != CompressedImageContainer::None)
 			{
-				application()->logger()(std::format("Could not read texture image: {}", _path.string()), Logger::Options::TagLowWarning);
-				_host_image = {};
+				loadCompressedImage();
 			}
 			else
 			{
-				that::FormatInfo retarget_format = _host_image.format();
-				
-				if (_desired_format.vk_format != VK_FORMAT_UNDEFINED)
-				{
-					retarget_format.type = _desired_format.getImgFormatInfo().type;
-				}
-				else if (_host_image.format().type == that::ElementType::UNORM)
-				{
-					retarget_format.type = that::ElementType::sRGB;
-				}
-				if (retarget_format != _host_image.format())
-				{
-					that::FormatInfo new_format = _host_image.format();
-					new_format.type = retarget_format.type;
-					_host_image.setFormat(new_format, _host_image.rowMajor());
-					
-					if (retarget_format.channels != new_format.channels)
+				loadFormatedImage();
+			}
+			_load_duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - begin);
+		}
+	}
+
+	void TextureFromFile::loadFormatedImage()
+	{
+		_compressed_image.clear();
+		that::img::FormatedImage decoded;
+		that::img::io::ReadImageInfo read_info{
+			.path = &_path,
+			.filesystem = application()->fileSystem(),
+			.target = &decoded,
+		};
+		that::Result read_result = that::img::io::ReadFormatedImage(read_info);
+		if (read_result != that::Result::Success)
+		{
+			application()->logger()(std::format("Could not read texture image: {}", _path.string()), Logger::Options::TagLowWarning);
+			_host_image = {};
+			return;
+		}
+		
+		that::FormatInfo retarget_format = decoded.format();
+		if (_desired_format.vk_format != VK_FORMAT_UNDEFINED)
+		{
+			retarget_format.type = _desired_format.getImgFormatInfo().type;
+		}
+		else if (decoded.format().type == that::ElementType::UNORM)
+		{
+			retarget_format.type = that::ElementType::sRGB;
+		}
+		_original_format = retarget_format;
+
+		if (_desired_format.vk_format == VK_FORMAT_UNDEFINED || _desired_format.vk_format == VK_FORMAT_MAX_ENUM)
+		{
+			_desired_format = retarget_format;
+			_desired_format.determineVkFormatFromInfo();
+		}
+
+		_image_format = findFormatForVkImage(_desired_format);
+
+		const that::FormatInfo src_format = decoded.format();
+		const that::FormatInfo dst_format = _image_format.getImgFormatInfo();
+		const auto is_unorm_or_srgb = [](that::ElementType t)
+		{
+			return t == that::ElementType::UNORM || t == that::ElementType::sRGB;
+		};
+		const bool same_layout = (src_format.channels == dst_format.channels) && (src_format.elem_size == dst_format.elem_size) && 
+			((src_format.type == dst_format.type) || (is_unorm_or_srgb(src_format.type) && is_unorm_or_srgb(dst_format.type)));
+		
+		if (same_layout)
+		{
+			// Only re-tag (e.g. UNORM -> sRGB), no copy
+			decoded.setFormat(dst_format, decoded.rowMajor());
+			_host_image = std::move(decoded);
+		}
+		else if (CanConvertImage(src_format, dst_format))
+		{
+			// Channels expansion and type conversion in a single pass, directly into the image that will be uploaded
+			_host_image = that::img::FormatedImage(decoded.width(), decoded.height(), dst_format, decoded.rowMajor());
+			ConvertImage(ImageConversionInfo{
+				.src = decoded.rawData(),
+				.src_format = src_format,
+				.dst = _host_image.rawData(),
+				.dst_format = dst_format,
+				.pixel_count = size_t(decoded.width()) * size_t(decoded.height()),
+				.executor = &application()->threadPool(),
+			});
+		}
+		else
+		{
+			that::FormatInfo new_format = src_format;
+			new_format.type = retarget_format.type;
+			decoded.setFormat(new_format, decoded.rowMajor());
+			if (_image_format.vk_format != _desired_format.vk_format)
+			{
+				decoded.reFormat(dst_format);
+			}
+			_host_image = std::move(decoded);
+		}
+	}
+
+	void TextureFromFile::loadCompressedImage()
+	{
+		_host_image = {};
+		_compressed_image.clear();
+
+		std::string content;
+		that::Result read_result = that::Result::MAX;
+		if (!_resolved_cannon_path.empty())
+		{
+			read_result = application()->fileSystem()->readFile(FileSystem::ReadFileInfo{
+				.hint = FileSystem::Hint::PathIsNative | FileSystem::Hint::PathIsCannon,
+				.path = &_resolved_cannon_path,
+				.result_string = &content,
+			});
+		}
+		if (read_result != that::Result::Success)
+		{
+			application()->logger()(std::format("Could not read texture image: {}", _path.string()), Logger::Options::TagLowWarning);
+			return;
+		}
+
+		std::string error;
+		if (!ParseCompressedImage(std::move(content), GetCompressedImageContainer(_path), _compressed_image, &error))
+		{
+			application()->logger()(std::format("Could not load compressed texture {}: {}", _path.string(), error), Logger::Options::TagLowWarning);
+			return;
+		}
+		if (!application()->availableFeatures().features2.features.textureCompressionBC)
+		{
+			application()->logger()(std::format("Could not load compressed texture {}: BC compression is not supported by the device", _path.string()), Logger::Options::TagLowWarning);
+			_compressed_image.clear();
+			return;
+		}
+
+		const VkFormat format = _compressed_image.format;
+		_original_format = that::FormatInfo{
+			.type = (format == VK_FORMAT_BC1_RGB_SRGB_BLOCK || format == VK_FORMAT_BC1_RGBA_SRGB_BLOCK || format == VK_FORMAT_BC3_SRGB_BLOCK || format == VK_FORMAT_BC7_SRGB_BLOCK) ? that::ElementType::sRGB : that::ElementType::UNORM,
+			.elem_size = 1,
+			.channels = 4,
+		};
+		switch (format)
+		{
+			// Assume BC1 is used for opaque images (1 bit alpha is rarely used)
+			case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+			case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+			case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+			case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+				_original_format.channels = 3;
+			break;
+			case VK_FORMAT_BC4_UNORM_BLOCK:
+			case VK_FORMAT_BC4_SNORM_BLOCK:
+				_original_format.channels = 1;
+			break;
+			case VK_FORMAT_BC5_UNORM_BLOCK:
+			case VK_FORMAT_BC5_SNORM_BLOCK:
+				_original_format.channels = 2;
+			break;
+			default:
+			break;
+		}
+	}
+
+	size_t TextureFromFile::hostByteSize() const
+	{
+		return isCompressed() ? _compressed_image.byteSize() : _host_image.byteSize();
+	}
+
+	size_t TextureFromFile::residentByteSize(uint32_t first_mip) const
+	{
+		size_t res = 0;
+		for (CompressedImage::Subresource const& sr : _compressed_image.subresources)
+		{
+			if (sr.mip >= first_mip)
+			{
+				res += sr.size;
+			}
+		}
+		return res;
+	}
+
+	size_t TextureFromFile::deviceByteSize() const
+	{
+		size_t res = 0;
+		if (isCompressed())
+		{
+			if (_image)
+			{
+				res += residentByteSize(_resident_mip);
+			}
+			if (_streaming_image)
+			{
+				res += residentByteSize(_streaming_image->first_mip);
+			}
+		}
+		else if (_image)
+		{
+			res = _host_image.byteSize();
+			if (_all_mips_view != _top_mip_view)
+			{
+				res += res / 3;
+			}
+		}
+		return res;
+	}
+
+	void TextureFromFile::setTargetResidentMip(uint32_t mip)
+	{
+		_target_resident_mip = std::min(mip, _min_resident_mip);
+	}
+
+	void TextureFromFile::StreamingImage::updateResources(UpdateContext& ctx)
+	{
+		image->updateResource(ctx);
+		view->updateResource(ctx);
+		for (std::shared_ptr<ImageView> const& subresource_view : subresources_views)
+		{
+			subresource_view->updateResource(ctx);
+		}
+	}
+
+	std::shared_ptr<TextureFromFile::StreamingImage> TextureFromFile::createStreamingImage(uint32_t first_mip)
+	{
+		std::shared_ptr<StreamingImage> res = std::make_shared<StreamingImage>();
+		res->first_mip = first_mip;
+		const VkExtent3D extent = VkExtent3D{
+			.width = std::max(_compressed_image.extent.width >> first_mip, 1u),
+			.height = std::max(_compressed_image.extent.height >> first_mip, 1u),
+			.depth = 1,
+		};
+		res->image = std::make_shared<Image>(Image::CI{
+			.app = application(),
+			.name = name(),
+			.type = VK_IMAGE_TYPE_2D,
+			.format = _compressed_image.format,
+			.extent = extent,
+			.mips = _compressed_image.mips - first_mip,
+			.layers = _compressed_image.layers,
+			.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+			.mem_usage = VMA_MEMORY_USAGE_GPU_ONLY,
+		});
+
+		VkImageViewType view_type = VK_IMAGE_VIEW_TYPE_MAX_ENUM;
+		if (_compressed_image.layers > 1)
+		{
+			view_type = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+		}
+
+		res->view = std::make_shared<ImageView>(ImageView::CI{
+			.app = application(),
+			.name = name() + "_all_mip"s,
+			.image = res->image,
+			.type = view_type,
+		});
+
+		for (uint32_t i = 0; i < _compressed_image.subresources.size32(); ++i)
+		{
+			CompressedImage::Subresource const& sr = _compressed_image.subresources[i];
+			if (sr.mip < first_mip)
+			{
+				continue;
+			}
+			res->subresources.push_back(i);
+			res->subresources_views.push_back(std::make_shared<ImageView>(ImageView::CI{
+				.app = application(),
+				.name = name() + std::format("_mip{}_layer{}", sr.mip, sr.layer),
+				.image = res->image,
+				.type = view_type,
+				.range = VkImageSubresourceRange{
+					.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+					.baseMipLevel = sr.mip - first_mip,
+					.levelCount = 1,
+					.baseArrayLayer = sr.layer,
+					.layerCount = sr.layer_count,
+				},
+			}));
+		}
+		return res;
+	}
+
+	void TextureFromFile::createCompressedDeviceImage()
+	{
+		const VkExtent3D & extent = _compressed_image.extent;
+		_min_resident_mip = 0;
+		while ((_min_resident_mip + 1) < _compressed_image.mips && std::max(extent.width >> _min_resident_mip, extent.height >> _min_resident_mip) > StreamingTailResolution)
+		{
+			++_min_resident_mip;
+		}
+		_target_resident_mip = std::min(_target_resident_mip, _min_resident_mip);
+		
+		// Asynch textures start with the smallest mips, the others are streamed in when the texture is ready
+		const uint32_t first_mip = _is_synch ? _target_resident_mip : _min_resident_mip;
+		_streaming_image = createStreamingImage(first_mip);
+		_should_upload = true;
+	}
+
+	void TextureFromFile::enqueueStreamingUploads(UpdateContext& ctx, bool synch)
+	{
+		StreamingImage & si = *_streaming_image;
+		si.updateResources(ctx);
+		si.uploads_enqueued = true;
+		if (synch)
+		{
+			for (size_t k = 0; k < si.subresources.size(); ++k)
+			{
+				CompressedImage::Subresource const& sr = _compressed_image.subresources[si.subresources[k]];
+				ResourcesToUpload::ImageUpload up{
+					.data = _compressed_image.data(sr),
+					.size = sr.size,
+					.copy_data = false,
+					.dst = si.subresources_views[k]->instance(),
+				};
+				ctx.resourcesToUpload() += std::move(up);
+			}
+			si.pending_uploads = 0;
+		}
+		else
+		{
+			// The first mips are needed to display anything, the other ones are streamed by priority
+			TaskPriority priority = TaskPriority::ASAP();
+			if (_is_ready)
+			{
+				priority = TaskPriority{
+					.priority = static_cast<size_t>(double(_streaming_priority) * double(TaskPriority::Soon().priority)),
+				};
+			}
+			si.pending_uploads = si.subresources.size32();
+			// Smallest mips first
+			for (size_t k = si.subresources.size(); k-- > 0;)
+			{
+				CompressedImage::Subresource const& sr = _compressed_image.subresources[si.subresources[k]];
+				AsynchUpload up{
+					.name = name(),
+					.source = ObjectView(_compressed_image.data(sr), sr.size),
+					.target_view = si.subresources_views[k]->instance(),
+					.completion_callback = [streaming_image = _streaming_image](int ret)
 					{
-						new_format.channels = retarget_format.channels;
-						_host_image.reFormat(new_format);
-					}
-				}
-				_original_format = _host_image.format();
+						if (ret != 0)
+						{
+							++streaming_image->failed_uploads;
+						}
+						--streaming_image->pending_uploads;
+					},
+					.priority = priority,
+				};
+				ctx.uploadQueue()->enqueue(std::move(up));
 			}
+		}
+	}
+
+	void TextureFromFile::swapStreamingImage()
+	{
+		_image = std::move(_streaming_image->image);
+		_all_mips_view = std::move(_streaming_image->view);
+		_top_mip_view = _all_mips_view;
+		_resident_mip = _streaming_image->first_mip;
+		_streaming_image = nullptr;
+
+		_view = _all_mips_view;
+		_is_ready = true;
+		callResourceUpdateCallbacks();
+	}
+
+	void TextureFromFile::updateStreaming(UpdateContext& ctx)
+	{
+		if (ctx.updateTick() <= _latest_streaming_tick)
+		{
+			return;
+		}
+		_latest_streaming_tick = ctx.updateTick();
+
+		if (_load_image_task && !_load_image_task->StatusIsFinish(_load_image_task->getStatus()))
+		{
+			return;
+		}
+
+		if (isCompressed() && _is_ready && !_streaming_image && _target_resident_mip != _resident_mip)
+		{
+			_streaming_image = createStreamingImage(_target_resident_mip);
+		}
+
+		if (_streaming_image)
+		{
+			_streaming_image->updateResources(ctx);
 
-			if (!_host_image.empty())
+			StreamingImage & si = *_streaming_image;
+			if (si.uploads_enqueued && si.pending_uploads == 0 && si.failed_uploads != 0)
 			{
-				if (_desired_format.vk_format == VK_FORMAT_UNDEFINED || _desired_format.vk_format == VK_FORMAT_MAX_ENUM)
-				{
-					_desired_format = _host_image.format();
-					_desired_format.determineVkFormatFromInfo();
-				}
+				// Some subresources are missing: upload all of them again
+				si.uploads_enqueued = false;
+				si.failed_uploads = 0;
+				enqueueStreamingUploads(ctx, _is_synch || ctx.uploadQueue() == nullptr);
+			}
 
-				_image_format = findFormatForVkImage(_desired_format);
+			if (_is_ready && !si.uploads_enqueued)
+			{
+				enqueueStreamingUploads(ctx, _is_synch || ctx.uploadQueue() == nullptr);
+			}
 
-				if (_image_format.vk_format != _desired_format.vk_format)
-				{
-					_host_image.reFormat(_image_format.getImgFormatInfo());
-				}
+			if (streamingImageIsComplete())
+			{
+				swapStreamingImage();
 			}
 		}
 	}
 
 	void TextureFromFile::createDeviceImage()
 	{
-		if (!_host_image.empty())
+		if (isCompressed())
+		{
+			createCompressedDeviceImage();
+		}
+		else if (!_host_image.empty())
 		{
 			VkExtent3D extent = VkExtent3D{ .width = static_cast<uint32_t>(_host_image.width()), .height = static_cast<uint32_t>(_host_image.height()), .depth = 1 };
 			if (_desired_layers > 1)
@@ -226,6 +572,8 @@ namespace vkl
 		_image.reset();
 		_all_mips_view.reset();
 		_top_mip_view.reset();
+		_streaming_image.reset();
+		_resident_mip = 0;
 		_view.reset();
 		callResourceUpdateCallbacks();
 
@@ -297,6 +645,8 @@ namespace vkl
 			_all_mips_view->updateResource(ctx);
 		}
 
+		updateStreaming(ctx);
+
 		if (_should_upload)
 		{
 			_should_upload = false;
@@ -307,20 +657,31 @@ namespace vkl
 			}
 			if (synch_upload)
 			{
-				ResourcesToUpload::ImageUpload up{
-					.data = _host_image.rawData(),
-					.size = _host_image.byteSize(),
-					.copy_data = false,
-					.dst = _top_mip_view->instance(),
-				};
-				ctx.resourcesToUpload() += std::move(up);
-				_upload_done = true;
+				if (isCompressed())
+				{
+					enqueueStreamingUploads(ctx, true);
+				}
+				else
+				{
+					ResourcesToUpload::ImageUpload up{
+						.data = _host_image.rawData(),
+						.size = _host_image.byteSize(),
+						.copy_data = false,
+						.dst = _top_mip_view->instance(),
+					};
+					ctx.resourcesToUpload() += std::move(up);
+					_upload_done = true;
+				}
 			}
 			else
 			{
 				if (_load_image_task && _load_image_task->StatusIsFinish(_load_image_task->getStatus()))
 				{
-					if (_load_image_task->isSuccess())
+					if (_load_image_task->isSuccess() && isCompressed())
+					{
+						enqueueStreamingUploads(ctx, false);
+					}
+					else if (_load_image_task->isSuccess())
 					{
 						_upload_done = false;
 						AsynchUpload up{
@@ -345,6 +706,7 @@ namespace vkl
 						_image = nullptr;
 						_top_mip_view = nullptr;
 						_all_mips_view = nullptr;
+						_streaming_image = nullptr;
 						callResourceUpdateCallbacks();
 					}
 					_load_image_task = nullptr;
@@ -378,6 +740,11 @@ namespace vkl
 		}
 		
 
+		if (streamingImageIsComplete())
+		{
+			swapStreamingImage();
+		}
+
 		if (_mips_done)
 		{
 			_view = _all_mips_view;
@@ -550,7 +917,7 @@ namespace vkl
 			}
 			else
 			{
-				if (_host_image.empty())
+				if (_host_image.empty() && !isCompressed())
 				{
 					if (_path.empty())
 					{
@@ -591,6 +958,19 @@ namespace vkl
 			ImGui::InputInt3("Resolution", (int*)&extent.width, ImGuiInputTextFlags_ReadOnly);
 			ImGui::InputInt("Mips", (int*) &mips, 0, 0, ImGuiInputTextFlags_ReadOnly);
 			ImGui::InputInt("Layers", (int*)&layers, 0, 0, ImGuiInputTextFlags_ReadOnly);
+			const double MiB = 1024.0 * 1024.0;
+			ImGui::Text("Host data: %.3f MiB%s, loaded in %.3f ms", double(hostByteSize()) / MiB, isCompressed() ? " (block compressed, with mips)" : "", double(_load_duration.count()) / 1000.0);
+			if (isStreamable())
+			{
+				const uint32_t total_mips = _compressed_image.mips;
+				ImGui::Text("Resident mips: %u / %u (target: %u, min: %u)", total_mips - _resident_mip, total_mips, total_mips - _target_resident_mip, total_mips - _min_resident_mip);
+				ImGui::Text("Device memory: %.3f MiB / %.3f MiB", double(residentByteSize(_resident_mip)) / MiB, double(residentByteSize(0)) / MiB);
+				if (_streaming_image)
+				{
+					ImGui::Text("Streaming mips from %u: %u uploads pending", _streaming_image->first_mip, _streaming_image->pending_uploads);
+				}
+				ImGui::SliderFloat("Streaming priority", &_streaming_priority, 0.0f, 1.0f);
+			}
 		}
 		ImGui::PopID();
 	}
@@ -600,9 +980,48 @@ namespace vkl
 
 
 	TextureFileCache::TextureFileCache(CreateInfo const& ci):
-		VkObject(ci.app, ci.name)
+		VkObject(ci.app, ci.name),
+		_prefer_compressed(ci.prefer_compressed),
+		_residency_budget(ci.residency_budget),
+		_unused_ticks(ci.unused_ticks)
 	{}
 
+	FileSystem::Path TextureFileCache::findCompressedCacheIFN(FileSystem::Path const& path) const
+	{
+		FileSystem::Path res = path;
+		const bool can_use_compressed = application()->availableFeatures().features2.features.textureCompressionBC;
+		if (_prefer_compressed && can_use_compressed && GetCompressedImageContainer(path) == CompressedImageContainer::None)
+		{
+			FileSystem * fs = application()->fileSystem();
+			const auto get_time = [fs](FileSystem::Path const& p) -> std::optional<FileSystem::TimePoint>
+			{
+				std::optional<FileSystem::TimePoint> res;
+				auto cannon = fs->resolveAndCannonize(p);
+				if (cannon.result == that::Result::Success)
+				{
+					auto time = fs->getFileLastWriteTime(cannon.value, FileSystem::Hint::PathIsCannon | FileSystem::Hint::PathIsNative);
+					if (time.result == that::Result::Success)
+					{
+						res = time.value;
+					}
+				}
+				return res;
+			};
+			const std::optional<FileSystem::TimePoint> source_time = get_time(path);
+			for (const char * ext : {".ktx2", ".dds"})
+			{
+				FileSystem::Path candidate = path;
+				candidate.replace_extension(ext);
+				const std::optional<FileSystem::TimePoint> candidate_time = get_time(candidate);
+				if (candidate_time.has_value() && (!source_time.has_value() || candidate_time.value() >= source_time.value()))
+				{
+					res = std::move(candidate);
+					break;
+				}
+			}
+		}
+		return res;
+	}
 
 	std::shared_ptr<TextureFromFile> TextureFileCache::getTexture(FileSystem::Path const& path, VkFormat desired_format)
 	{
@@ -610,10 +1029,12 @@ namespace vkl
 		std::shared_ptr<TextureFromFile> res;
 		if (!_cache.contains(path))
 		{
+			// A compressed image can't be converted to the desired format
+			const FileSystem::Path load_path = (desired_format == VK_FORMAT_UNDEFINED) ? findCompressedCacheIFN(path) : path;
 			res = std::make_shared<TextureFromFile>(TextureFromFile::CI{
 				.app = application(),
 				.name = path.string(),
-				.path = path,
+				.path = load_path,
 				.desired_format = desired_format,
 			});
 			_cache[path] = res;
@@ -625,6 +1046,90 @@ namespace vkl
 		return res;
 	}
 
+	void TextureFileCache::updateResidency(UpdateContext & ctx)
+	{
+		struct Candidate
+		{
+			TextureFromFile * texture;
+			bool used;
+			uint32_t target;
+		};
+		static thread_local MyVector<Candidate> candidates;
+		candidates.clear();
+
+		_resident_bytes = 0;
+		_fixed_bytes = 0;
+		_unused_textures = 0;
+		for (auto & [path, texture] : _cache)
+		{
+			if (!texture->isReady())
+			{
+				continue;
+			}
+			_resident_bytes += texture->deviceByteSize();
+			if (texture->isStreamable())
+			{
+				const bool used = (texture->latestUpdateTick() + _unused_ticks) >= ctx.updateTick();
+				if (!used)
+				{
+					++_unused_textures;
+				}
+				candidates.push_back(Candidate{
+					.texture = texture.get(),
+					.used = used,
+					.target = texture->minResidentMip(),
+				});
+				_fixed_bytes += texture->residentByteSize(texture->minResidentMip());
+			}
+			else
+			{
+				_fixed_bytes += texture->deviceByteSize();
+			}
+		}
+		_streamed_textures = candidates.size();
+
+		std::sort(candidates.begin(), candidates.end(), [](Candidate const& a, Candidate const& b)
+		{
+			if (a.used != b.used)
+			{
+				return a.used;
+			}
+			return a.texture->streamingPriority() > b.texture->streamingPriority();
+		});
+
+		// The unused textures only keep their smallest mips
+		// The used ones get one more mip at a time, by priority, so the budget is shared evenly
+		size_t available = (_residency_budget > _fixed_bytes) ? (_residency_budget - _fixed_bytes) : 0;
+		bool progress = true;
+		while (progress)
+		{
+			progress = false;
+			for (Candidate & c : candidates)
+			{
+				if (!c.used || c.target == 0)
+				{
+					continue;
+				}
+				const size_t mip_bytes = c.texture->residentByteSize(c.target - 1) - c.texture->residentByteSize(c.target);
+				if (mip_bytes <= available)
+				{
+					available -= mip_bytes;
+					--c.target;
+					progress = true;
+				}
+			}
+		}
+
+		_target_bytes = _fixed_bytes;
+		for (Candidate const& c : candidates)
+		{
+			c.texture->setTargetResidentMip(c.target);
+			_target_bytes += c.texture->residentByteSize(c.target) - c.texture->residentByteSize(c.texture->minResidentMip());
+			// The unused textures are not updated by their users
+			c.texture->updateStreaming(ctx);
+		}
+	}
+
 	void TextureFileCache::updateResources(UpdateContext & ctx)
 	{
 		std::unique_lock lock(_mutex);
@@ -645,5 +1150,21 @@ namespace vkl
 			}
 		}
 
+		updateResidency(ctx);
+	}
+
+	void TextureFileCache::declareGUI(GuiContext & ctx)
+	{
+		std::unique_lock lock(_mutex);
+		ImGui::PushID(this);
+		const double MiB = 1024.0 * 1024.0;
+		int budget_mib = static_cast<int>(_residency_budget / (1024 * 1024));
+		if (ImGui::InputInt("Textures budget (MiB)", &budget_mib, 64, 256))
+		{
+			_residency_budget = static_cast<size_t>(std::max(budget_mib, 0)) * 1024 * 1024;
+		}
+		ImGui::Text("Textures: %u (%u streamed, %u unused)", static_cast<uint>(_cache.size()), static_cast<uint>(_streamed_textures), static_cast<uint>(_unused_textures));
+		ImGui::Text("Resident: %.3f MiB, target: %.3f MiB (%.3f MiB always resident)", double(_resident_bytes) / MiB, double(_target_bytes) / MiB, double(_fixed_bytes) / MiB);
+		ImGui::PopID();
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,284 @@
+#include <vkl/Utils/ImageConversion.hpp>
+#include <vkl/Execution/ThreadPool.hpp>
+
+#include <cstring>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define VKL_IMAGE_CONVERSION_SSE2 1
+#include <emmintrin.h>
+#else
+#define VKL_IMAGE_CONVERSION_SSE2 0
+#endif
+
+#if defined(__SSSE3__) || defined(__AVX__)
+#define VKL_IMAGE_CONVERSION_SSSE3 1
+#include <tmmintrin.h>
+#else
+#define VKL_IMAGE_CONVERSION_SSSE3 0
+#endif
+
+namespace vkl
+{
+	namespace
+	{
+		enum class ElementKind
+		{
+			Unorm8,
+			Unorm16,
+			Float32,
+			Int8,
+			Int16,
+			Int32,
+			Unsupported,
+		};
+
+		ElementKind GetElementKind(that::FormatInfo const& f)
+		{
+			ElementKind res = ElementKind::Unsupported;
+			switch (f.type)
+			{
+				case that::ElementType::UNORM:
+				case that::ElementType::sRGB:
+					if (f.elem_size == 1)	res = ElementKind::Unorm8;
+					else if (f.elem_size == 2)	res = ElementKind::Unorm16;
+				break;
+				case that::ElementType::FLOAT:
+					if (f.elem_size == 4)	res = ElementKind::Float32;
+				break;
+				case that::ElementType::UINT:
+				case that::ElementType::SINT:
+					if (f.elem_size == 1)	res = ElementKind::Int8;
+					else if (f.elem_size == 2)	res = ElementKind::Int16;
+					else if (f.elem_size == 4)	res = ElementKind::Int32;
+				break;
+				default:
+				break;
+			}
+			return res;
+		}
+
+		bool IsNormalized(ElementKind k)
+		{
+			return k == ElementKind::Unorm8 || k == ElementKind::Unorm16 || k == ElementKind::Float32;
+		}
+
+		template <class T>
+		constexpr T One()
+		{
+			if constexpr (std::is_floating_point_v<T>)
+				return T(1);
+			else
+				return std::numeric_limits<T>::max();
+		}
+
+		template <class S, class D>
+		D ConvertElement(S s)
+		{
+			if constexpr (std::is_same_v<S, D>)
+			{
+				return s;
+			}
+			else if constexpr (std::is_floating_point_v<S>)
+			{
+				const float c = std::clamp(s, 0.0f, 1.0f);
+				return static_cast<D>(c * float(One<D>()) + 0.5f);
+			}
+			else if constexpr (std::is_floating_point_v<D>)
+			{
+				return static_cast<D>(s) * (D(1) / D(One<S>()));
+			}
+			else if constexpr (sizeof(S) < sizeof(D))
+			{
+				// 8 -> 16 bits: x * 257
+				return static_cast<D>(static_cast<D>(s) * (One<D>() / One<S>()));
+			}
+			else
+			{
+				// 16 -> 8 bits, rounded
+				return static_cast<D>((uint32_t(s) * uint32_t(One<D>()) + uint32_t(One<S>() / 2)) / uint32_t(One<S>()));
+			}
+		}
+
+		// Same number of channels: the conversion is a flat loop over the elements
+		template <class S, class D>
+		void ConvertElements(const S * src, D * dst, size_t n)
+		{
+			size_t i = 0;
+#if VKL_IMAGE_CONVERSION_SSE2
+			if constexpr (std::is_same_v<S, uint8_t> && std::is_same_v<D, float>)
+			{
+				const __m128i zero = _mm_setzero_si128();
+				const __m128 scale = _mm_set1_ps(1.0f / 255.0f);
+				for (; i + 16 <= n; i += 16)
+				{
+					const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+					const __m128i lo16 = _mm_unpacklo_epi8(bytes, zero);
+					const __m128i hi16 = _mm_unpackhi_epi8(bytes, zero);
+					_mm_storeu_ps(dst + i + 0, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo16, zero)), scale));
+					_mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo16, zero)), scale));
+					_mm_storeu_ps(dst + i + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi16, zero)), scale));
+					_mm_storeu_ps(dst + i + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi16, zero)), scale));
+				}
+			}
+			else if constexpr (std::is_same_v<S, uint8_t> && std::is_same_v<D, uint16_t>)
+			{
+				const __m128i zero = _mm_setzero_si128();
+				const __m128i scale = _mm_set1_epi16(257);
+				for (; i + 16 <= n; i += 16)
+				{
+					const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 0), _mm_mullo_epi16(_mm_unpacklo_epi8(bytes, zero), scale));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8), _mm_mullo_epi16(_mm_unpackhi_epi8(bytes, zero), scale));
+				}
+			}
+#endif
+			for (; i < n; ++i)
+			{
+				dst[i] = ConvertElement<S, D>(src[i]);
+			}
+		}
+
+		// 3 x 8 bits -> 4 x 8 bits, the most common case (RGB jpg / png)
+		void ExpandRGB8ToRGBA8(const uint8_t * src, uint8_t * dst, size_t n)
+		{
+			size_t i = 0;
+#if VKL_IMAGE_CONVERSION_SSSE3
+			const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+			const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+			// Each iteration reads 16 bytes for 12 used: stop early enough not to read past the source
+			for (; i + 6 <= n; i += 4)
+			{
+				const __m128i rgb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 3 * i));
+				const __m128i rgba = _mm_or_si128(_mm_shuffle_epi8(rgb, shuffle), alpha);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4 * i), rgba);
+			}
+#endif
+			for (; i < n; ++i)
+			{
+				const uint32_t p = uint32_t(src[3 * i + 0]) | (uint32_t(src[3 * i + 1]) << 8) | (uint32_t(src[3 * i + 2]) << 16) | 0xFF000000u;
+				std::memcpy(dst + 4 * i, &p, sizeof(p));
+			}
+		}
+
+		template <class S, class D>
+		void ConvertPixels(const S * src, uint32_t src_channels, D * dst, uint32_t dst_channels, size_t n)
+		{
+			if (src_channels == dst_channels)
+			{
+				ConvertElements(src, dst, n * src_channels);
+				return;
+			}
+			if constexpr (std::is_same_v<S, uint8_t> && std::is_same_v<D, uint8_t>)
+			{
+				if (src_channels == 3 && dst_channels == 4)
+				{
+					ExpandRGB8ToRGBA8(src, dst, n);
+					return;
+				}
+			}
+			const uint32_t common_channels = std::min(src_channels, dst_channels);
+			for (size_t i = 0; i < n; ++i)
+			{
+				const S * s = src + i * src_channels;
+				D * d = dst + i * dst_channels;
+				for (uint32_t c = 0; c < common_channels; ++c)
+				{
+					d[c] = ConvertElement<S, D>(s[c]);
+				}
+				for (uint32_t c = common_channels; c < dst_channels; ++c)
+				{
+					d[c] = (c == 3) ? One<D>() : D(0);
+				}
+			}
+		}
+
+		template <class S>
+		void DispatchDst(ElementKind dst_kind, const S * src, uint32_t sc, void * dst, uint32_t dc, size_t n)
+		{
+			switch (dst_kind)
+			{
+				case ElementKind::Unorm8:
+				case ElementKind::Int8:
+					ConvertPixels(src, sc, static_cast<uint8_t*>(dst), dc, n);
+				break;
+				case ElementKind::Unorm16:
+				case ElementKind::Int16:
+					ConvertPixels(src, sc, static_cast<uint16_t*>(dst), dc, n);
+				break;
+				case ElementKind::Float32:
+					ConvertPixels(src, sc, static_cast<float*>(dst), dc, n);
+				break;
+				case ElementKind::Int32:
+					ConvertPixels(src, sc, static_cast<uint32_t*>(dst), dc, n);
+				break;
+				default:
+				break;
+			}
+		}
+
+		void ConvertRange(ImageConversionInfo const& info, ElementKind src_kind, ElementKind dst_kind, size_t begin, size_t end)
+		{
+			const uint32_t sc = info.src_format.channels;
+			const uint32_t dc = info.dst_format.channels;
+			const size_t src_pixel_size = info.src_format.channels * info.src_format.elem_size;
+			const size_t dst_pixel_size = info.dst_format.channels * info.dst_format.elem_size;
+			const void * src = static_cast<const uint8_t*>(info.src) + begin * src_pixel_size;
+			void * dst = static_cast<uint8_t*>(info.dst) + begin * dst_pixel_size;
+			const size_t n = end - begin;
+			switch (src_kind)
+			{
+				case ElementKind::Unorm8:
+				case ElementKind::Int8:
+					DispatchDst(dst_kind, static_cast<const uint8_t*>(src), sc, dst, dc, n);
+				break;
+				case ElementKind::Unorm16:
+				case ElementKind::Int16:
+					DispatchDst(dst_kind, static_cast<const uint16_t*>(src), sc, dst, dc, n);
+				break;
+				case ElementKind::Float32:
+					DispatchDst(dst_kind, static_cast<const float*>(src), sc, dst, dc, n);
+				break;
+				case ElementKind::Int32:
+					DispatchDst(dst_kind, static_cast<const uint32_t*>(src), sc, dst, dc, n);
+				break;
+				default:
+				break;
+			}
+		}
+	}
+
+	bool CanConvertImage(that::FormatInfo const& src, that::FormatInfo const& dst)
+	{
+		const ElementKind src_kind = GetElementKind(src);
+		const ElementKind dst_kind = GetElementKind(dst);
+		bool res = false;
+		if (src_kind != ElementKind::Unsupported && dst_kind != ElementKind::Unsupported && src.channels > 0 && dst.channels > 0)
+		{
+			// Integers are not normalized: only same size copies
+			res = (IsNormalized(src_kind) && IsNormalized(dst_kind)) || (src_kind == dst_kind);
+		}
+		return res;
+	}
+
+	bool ConvertImage(ImageConversionInfo const& info)
+	{
+		if (!CanConvertImage(info.src_format, info.dst_format))
+		{
+			return false;
+		}
+		const ElementKind src_kind = GetElementKind(info.src_format);
+		const ElementKind dst_kind = GetElementKind(info.dst_format);
+
+		const size_t tile_size = std::max<size_t>(info.tile_size, 1);
+		const size_t tiles = std::divCeil(info.pixel_count, tile_size);
+
+		ProcessInParallel(info.executor, tiles, "ConvertImage", [&](size_t tile)
+		{
+			const size_t begin = tile * tile_size;
+			const size_t end = std::min(begin + tile_size, info.pixel_count);
+			ConvertRange(info, src_kind, dst_kind, begin, end);
+		});
+
+		return true;
+	}
+}
@@ -0,0 +1,194 @@
+#include <vkl/Utils/RangeAllocator.hpp>
+
+#include <cassert>
+#include <algorithm>
+
+namespace vkl
+{
+	RangeAllocator::RangeAllocator(Offset capacity) :
+		_capacity(capacity)
+	{
+		if (_capacity)
+		{
+			_free_segments[0] = _capacity;
+		}
+	}
+
+	void RangeAllocator::insertFreeSegment(Offset begin, Offset len)
+	{
+		if (len == 0)
+		{
+			return;
+		}
+		auto next = _free_segments.lower_bound(begin);
+		// Merge with the previous segment
+		if (next != _free_segments.begin())
+		{
+			auto prev = std::prev(next);
+			if (prev->first + prev->second == begin)
+			{
+				begin = prev->first;
+				len += prev->second;
+				_free_segments.erase(prev);
+			}
+		}
+		// Merge with the next segment
+		if (next != _free_segments.end() && begin + len == next->first)
+		{
+			len += next->second;
+			_free_segments.erase(next);
+		}
+		_free_segments[begin] = len;
+	}
+
+	RangeAllocator::Offset RangeAllocator::allocate(Offset size, Offset alignment)
+	{
+		alignment = std::max<Offset>(alignment, 1);
+		size = std::max<Offset>(size, 1);
+		Offset res = InvalidOffset;
+		for (auto it = _free_segments.begin(); it != _free_segments.end(); ++it)
+		{
+			const Offset segment_begin = it->first;
+			const Offset segment_end = it->first + it->second;
+			const Offset begin = std::divCeil(segment_begin, alignment) * alignment;
+			if (begin + size <= segment_end)
+			{
+				_free_segments.erase(it);
+				// The alignment padding and the tail remain free
+				insertFreeSegment(segment_begin, begin - segment_begin);
+				insertFreeSegment(begin + size, segment_end - (begin + size));
+				_allocations[begin] = Allocation{
+					.size = size,
+					.alignment = alignment,
+				};
+				_used += size;
+				res = begin;
+				break;
+			}
+		}
+		assert(checkIntegrity());
+		return res;
+	}
+
+	void RangeAllocator::release(Offset offset)
+	{
+		auto it = _allocations.find(offset);
+		assert(it != _allocations.end());
+		if (it != _allocations.end())
+		{
+			const Offset size = it->second.size;
+			_allocations.erase(it);
+			_used -= size;
+			insertFreeSegment(offset, size);
+		}
+		assert(checkIntegrity());
+	}
+
+	void RangeAllocator::setPinned(Offset offset, bool pinned)
+	{
+		auto it = _allocations.find(offset);
+		assert(it != _allocations.end());
+		if (it != _allocations.end())
+		{
+			it->second.pinned = pinned;
+		}
+	}
+
+	bool RangeAllocator::hasPinned() const
+	{
+		return std::any_of(_allocations.begin(), _allocations.end(), [](auto const& it) {return it.second.pinned; });
+	}
+
+	MyVector<RangeAllocator::Move> RangeAllocator::compact()
+	{
+		MyVector<Move> res;
+		std::map<Offset, Allocation> allocations;
+		Offset cursor = 0;
+		for (auto const& [offset, allocation] : _allocations)
+		{
+			Offset dst = offset;
+			if (!allocation.pinned)
+			{
+				// cursor <= offset and offset is aligned: dst <= offset
+				dst = std::divCeil(cursor, allocation.alignment) * allocation.alignment;
+				if (dst != offset)
+				{
+					res.push_back(Move{
+						.src = offset,
+						.dst = dst,
+						.size = allocation.size,
+					});
+				}
+			}
+			allocations[dst] = allocation;
+			cursor = dst + allocation.size;
+		}
+		_allocations = std::move(allocations);
+
+		_free_segments.clear();
+		Offset end = 0;
+		for (auto const& [offset, allocation] : _allocations)
+		{
+			insertFreeSegment(end, offset - end);
+			end = offset + allocation.size;
+		}
+		insertFreeSegment(end, _capacity - end);
+		assert(checkIntegrity());
+		return res;
+	}
+
+	RangeAllocator::Stats RangeAllocator::stats() const
+	{
+		Stats res{
+			.capacity = _capacity,
+			.used = _used,
+			.allocations = static_cast<uint32_t>(_allocations.size()),
+			.free_segments = static_cast<uint32_t>(_free_segments.size()),
+		};
+		for (auto const& [begin, len] : _free_segments)
+		{
+			res.largest_free_segment = std::max(res.largest_free_segment, len);
+		}
+		return res;
+	}
+
+	bool RangeAllocator::checkIntegrity() const
+	{
+		bool res = true;
+		// Walk both sorted maps: the free segments and the allocations must tile [0, capacity) without overlap
+		Offset used = 0;
+		Offset covered = 0;
+		auto f = _free_segments.begin();
+		auto a = _allocations.begin();
+		Offset cursor = 0;
+		bool previous_was_free = false;
+		while (f != _free_segments.end() || a != _allocations.end())
+		{
+			if (f != _free_segments.end() && (a == _allocations.end() || f->first < a->first))
+			{
+				res &= (f->second > 0);
+				res &= (f->first >= cursor);
+				// Adjacent free segments should have been merged
+				res &= !(previous_was_free && f->first == cursor);
+				cursor = f->first + f->second;
+				covered += f->second;
+				previous_was_free = true;
+				++f;
+			}
+			else
+			{
+				res &= (a->first >= cursor);
+				res &= (a->first % a->second.alignment) == 0;
+				cursor = a->first + a->second.size;
+				covered += a->second.size;
+				used += a->second.size;
+				previous_was_free = false;
+				++a;
+			}
+		}
+		res &= (cursor <= _capacity);
+		res &= (used == _used);
+		res &= (covered <= _capacity);
+		return res;
+	}
+}
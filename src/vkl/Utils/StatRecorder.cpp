@@ -136,10 +136,33 @@ namespace vkl
 					.provider = Dyn<size_t>(&fpc.main_script_modules_time),
 					.unit = "ms",
 				});
+				{
+					const std::pair<const char*, size_t*> phases[] = {
+						{"Update Images", &fpc.update_images_time},
+						{"Update Buffers", &fpc.update_buffers_time},
+						{"Update Samplers", &fpc.update_samplers_time},
+						{"Update Commands", &fpc.update_commands_time},
+						{"Update Sets", &fpc.update_sets_time},
+						{"Update Framebuffers", &fpc.update_framebuffers_time},
+					};
+					for (auto const& [phase_name, counter] : phases)
+					{
+						exec_update->createChildRecord<TimeCountClock::rep>({
+							.name = phase_name,
+							.scale = stat_ms_scale,
+							.provider = Dyn<size_t>(counter),
+							.unit = "ms",
+						});
+					}
+				}
 				StatRecord<TimeCountClock::rep>* descriptor_updates = update_time_record->createChildRecord<TimeCountClock::rep>({
 					.name = "Descriptor Updates",
 					.provider = Dyn<size_t>(&fpc.descriptor_updates),
 				});
+				StatRecord<size_t>* dynamic_value_evaluations = update_time_record->createChildRecord<size_t>({
+					.name = "Dynamic Value Evaluations",
+					.provider = Dyn<size_t>(&fpc.dynamic_value_evaluations),
+				});
 			}
 
 			StatRecord<TimeCountClock::rep>* render_time_cpu_record = frame_time_record->createChildRecord<TimeCountClock::rep>({
@@ -187,6 +210,46 @@ namespace vkl
 						.provider = Dyn<size_t>(&fpc.layout_transitions),
 					});
 				}
+				StatRecord<size_t>* submissions = render_time_cpu_record->createChildRecord<size_t>({
+					.name = "Submissions",
+					.provider = Dyn<size_t>(&fpc.submissions),
+				});
+				{
+					StatRecord<size_t>* created_semaphores = submissions->createChildRecord<size_t>({
+						.name = "Created Semaphores",
+						.provider = Dyn<size_t>(&fpc.created_semaphores),
+					});
+					StatRecord<size_t>* created_fences = submissions->createChildRecord<size_t>({
+						.name = "Created Fences",
+						.provider = Dyn<size_t>(&fpc.created_fences),
+					});
+				}
+				StatRecord<size_t>* shadow_maps_rendered = render_time_cpu_record->createChildRecord<size_t>({
+					.name = "Shadow Maps Rendered",
+					.provider = Dyn<size_t>(&fpc.shadow_maps_rendered),
+				});
+				{
+					StatRecord<size_t>* static_layers_rendered = shadow_maps_rendered->createChildRecord<size_t>({
+						.name = "Static Layers Rendered",
+						.provider = Dyn<size_t>(&fpc.shadow_map_static_layers_rendered),
+					});
+				}
+				StatRecord<size_t>* shadow_maps_reused = render_time_cpu_record->createChildRecord<size_t>({
+					.name = "Shadow Maps Reused",
+					.provider = Dyn<size_t>(&fpc.shadow_maps_reused),
+				});
+				StatRecord<size_t>* shadow_casters = render_time_cpu_record->createChildRecord<size_t>({
+					.name = "Shadow Casters (all lights)",
+					.provider = Dyn<size_t>(&fpc.shadow_casters),
+				});
+				{
+					StatRecord<TimeCountClock::rep>* shadow_casters_cull_time = shadow_casters->createChildRecord<TimeCountClock::rep>({
+						.name = "Culling Time",
+						.scale = stat_ms_scale,
+						.provider = Dyn<size_t>(&fpc.shadow_casters_cull_time),
+						.unit = "ms",
+					});
+				}
 			}
 		}
 	}
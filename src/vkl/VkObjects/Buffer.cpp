@@ -11,7 +11,8 @@ namespace vkl
 		_aci(ci.aci),
 		_min_align(ci.min_align),
 		_unique_id(std::atomic_fetch_add(&_instance_counter, 1)),
-		_allocator(ci.allocator)
+		_allocator(ci.allocator),
+		_memory_category(ci.memory_category)
 	{
 		create();
 	}
@@ -35,6 +36,15 @@ namespace vkl
 		assert(_allocator);
 		
 		VK_CHECK(vmaCreateBufferWithAlignment(_allocator, &_ci, &_aci, _min_align, &_buffer, &_alloc, nullptr), "Failed to create a buffer.");
+
+		if (_memory_category == MemoryCategory::Auto)
+		{
+			_memory_category = DeduceBufferMemoryCategory(_ci.usage, _aci.usage);
+		}
+		VmaAllocationInfo alloc_info;
+		vmaGetAllocationInfo(_allocator, _alloc, &alloc_info);
+		_memory_size = alloc_info.size;
+		application()->memoryTelemetry().onAllocate(_memory_category, _memory_size);
 		
 		InternalStates is;
 		is.states.push_back(InternalStates::PosAndState{
@@ -67,6 +77,9 @@ namespace vkl
 		}
 
 		callDestructionCallbacks();
+
+		application()->memoryTelemetry().onFree(_memory_category, _memory_size);
+		_memory_size = 0;
 		
 		vmaDestroyBuffer(_allocator, _buffer, _alloc);
 		_buffer = VK_NULL_HANDLE;
@@ -123,6 +136,12 @@ namespace vkl
 		vmaFlushAllocation(_allocator, _alloc, 0, _ci.size);
 	}
 
+	void BufferInstance::invalidate()
+	{
+		assert(_buffer != VK_NULL_HANDLE);
+		vmaInvalidateAllocation(_allocator, _alloc, 0, _ci.size);
+	}
+
 	DoubleDoubleResourceState2 BufferInstance::getState(size_t tid, Range r) const
 	{
 		assert(statesAreSorted(tid));
@@ -288,6 +307,7 @@ namespace vkl
 		_queues(std::filterRedundantValues(ci.queues)),
 		_sharing_mode(_queues.size() > 1 ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE),
 		_mem_usage(ci.mem_usage),
+		_memory_category(ci.memory_category),
 		_allocator(ci.allocator ? ci.allocator : _app->allocator())
 	{
 		if (ci.create_on_construct && holdInstance().value())
@@ -319,6 +339,7 @@ namespace vkl
 			},
 			.min_align = _min_align,
 			.allocator = _allocator,
+			.memory_category = _memory_category,
 		};
 		
 		_inst = std::make_shared<BufferInstance>(ci);
@@ -2,6 +2,32 @@
 
 namespace vkl
 {
+	ImageMemoryBlock::ImageMemoryBlock(CreateInfo const& ci) :
+		_app(ci.app),
+		_requirements(ci.requirements),
+		_memory_category(ci.memory_category)
+	{
+		const VmaAllocationCreateInfo aci{
+			.usage = ci.mem_usage,
+			.memoryTypeBits = _requirements.memoryTypeBits,
+		};
+		VK_CHECK(vmaAllocateMemory(_app->allocator(), &_requirements, &aci, &_alloc, nullptr), "Failed to allocate an image memory block.");
+		VmaAllocationInfo alloc_info;
+		vmaGetAllocationInfo(_app->allocator(), _alloc, &alloc_info);
+		_memory_size = alloc_info.size;
+		_app->memoryTelemetry().onAllocate(_memory_category, _memory_size);
+	}
+
+	ImageMemoryBlock::~ImageMemoryBlock()
+	{
+		if (_alloc)
+		{
+			_app->memoryTelemetry().onFree(_memory_category, _memory_size);
+			vmaFreeMemory(_app->allocator(), _alloc);
+			_alloc = nullptr;
+		}
+	}
+
 	std::atomic<size_t> ImageInstance::_instance_counter = 0;
 
 	void ImageInstance::setVkNameIFP()
@@ -50,7 +76,23 @@ namespace vkl
 	{
 		assert(_image == VK_NULL_HANDLE);
 
-		VK_CHECK(vmaCreateImage(_app->allocator(), &_ci, &_vma_ci, &_image, &_alloc, nullptr), "Failed to create an image.");
+		if (_placement.block)
+		{
+			VK_CHECK(vkCreateImage(device(), &_ci, nullptr, &_image), "Failed to create an image.");
+			VK_CHECK(vmaBindImageMemory2(_app->allocator(), _placement.block->allocation(), _placement.offset, _image, nullptr), "Failed to bind an image memory.");
+		}
+		else
+		{
+			VK_CHECK(vmaCreateImage(_app->allocator(), &_ci, &_vma_ci, &_image, &_alloc, nullptr), "Failed to create an image.");
+			if (_memory_category == MemoryCategory::Auto)
+			{
+				_memory_category = DeduceImageMemoryCategory(_ci.usage);
+			}
+			VmaAllocationInfo alloc_info;
+			vmaGetAllocationInfo(_app->allocator(), _alloc, &alloc_info);
+			_memory_size = alloc_info.size;
+			_app->memoryTelemetry().onAllocate(_memory_category, _memory_size);
+		}
 
 		setVkNameIFP();
 	}
@@ -61,13 +103,20 @@ namespace vkl
 
 		callDestructionCallbacks();
 
-		if (ownership())
+		if (_placement.block)
+		{
+			vkDestroyImage(device(), _image, nullptr);
+		}
+		else if (ownership())
 		{
+			_app->memoryTelemetry().onFree(_memory_category, _memory_size);
+			_memory_size = 0;
 			vmaDestroyImage(_app->allocator(), _image, _alloc);
 		}
 
 		_image = VK_NULL_HANDLE;
 		_alloc = nullptr;
+		_placement = {};
 	}
 
 	bool ImageInstance::statesAreSorted(size_t tid) const
@@ -91,6 +140,8 @@ namespace vkl
 		AbstractInstance(ci.app, ci.name),
 		_ci(ci.ci),
 		_vma_ci(ci.aci),
+		_placement(ci.placement),
+		_memory_category(ci.memory_category),
 		_unique_id(std::atomic_fetch_add(&_instance_counter, 1))
 	{
 		create();
@@ -345,7 +396,8 @@ namespace vkl
 		_sharing_mode(ci.queues.size() <= 1 ? VK_SHARING_MODE_EXCLUSIVE : VK_SHARING_MODE_CONCURRENT),
 		_queues(ci.queues),
 		_initial_layout(ci.initial_layout),
-		_mem_usage(ci.mem_usage)
+		_mem_usage(ci.mem_usage),
+		_memory_category(ci.memory_category)
 	{
 		if(ci.create_on_construct && holdInstance().value())
 			createInstance();
@@ -357,11 +409,10 @@ namespace vkl
 		associateImage(assos);
 	}
 
-	void Image::createInstance()
+	VkImageCreateInfo Image::getInstanceCreateInfo() const
 	{
-		assert(!_inst);
 		uint32_t n_queues = 0;
-		uint32_t* p_queues = nullptr;
+		const uint32_t* p_queues = nullptr;
 		if (_sharing_mode == VK_SHARING_MODE_CONCURRENT)
 		{	
 			n_queues = _queues.size();
@@ -374,12 +425,10 @@ namespace vkl
 			if (desired == uint32_t(-1))
 			{
 				res = howManyMips(_type, extent);
-				_inst_all_mips = true;
 			}
 			else
 			{
 				res = desired;
-				_inst_all_mips = false;
 			}
 			return res;
 		}();
@@ -400,17 +449,47 @@ namespace vkl
 			.pQueueFamilyIndices = p_queues,
 			.initialLayout = _initial_layout,
 		};
+		return image_ci;
+	}
+
+	void Image::createInstance()
+	{
+		assert(!_inst);
+		const VkImageCreateInfo image_ci = getInstanceCreateInfo();
+		_inst_all_mips = (*_mips == uint32_t(-1));
 
 		VmaAllocationCreateInfo alloc{
 			.usage = _mem_usage,
 		};
 
+		ImageMemoryPlacement placement = {};
+		if (_memory_placement.block)
+		{
+			// The placement might have been planned for other dynamic values
+			const VkDeviceImageMemoryRequirements info{
+				.sType = VK_STRUCTURE_TYPE_DEVICE_IMAGE_MEMORY_REQUIREMENTS,
+				.pNext = nullptr,
+				.pCreateInfo = &image_ci,
+			};
+			VkMemoryRequirements2 requirements{
+				.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2,
+				.pNext = nullptr,
+			};
+			vkGetDeviceImageMemoryRequirements(device(), &info, &requirements);
+			if (_memory_placement.fits(requirements.memoryRequirements))
+			{
+				placement = _memory_placement;
+			}
+		}
+
 		_inst = std::make_shared<ImageInstance>(ImageInstance::CI
 		{
 			.app = _app,
 			.name = name(),
 			.ci = image_ci,
 			.aci = alloc,
+			.placement = placement,
+			.memory_category = _memory_category,
 		});
 	}
 
@@ -433,6 +512,8 @@ namespace vkl
 		_sharing_mode = (_queues.size() <= 1) ? VK_SHARING_MODE_EXCLUSIVE : VK_SHARING_MODE_CONCURRENT;
 		_mem_usage = assos.instance->AllocationInfo().usage;
 		_initial_layout = VK_IMAGE_LAYOUT_UNDEFINED; // In which layout are created swapchain images?+
+		// The dynamic values were replaced
+		_checked_epoch = 0;
 	}
 
 
@@ -450,7 +531,10 @@ namespace vkl
 			using namespace vk_operators;
 			if (_inst)
 			{
-				if (_inst->ownership())
+				// Memoized and constant values are not re-evaluated and compared when they did not change
+				const bool may_have_changed = _extent.changedSince(_checked_epoch) || _mips.changedSince(_checked_epoch) || _format.changedSince(_checked_epoch)
+					|| _layers.changedSince(_checked_epoch) || _samples.changedSince(_checked_epoch);
+				if (_inst->ownership() && may_have_changed)
 				{
 					const VkImageCreateInfo & inst_ci = _inst->createInfo();
 					const VkExtent3D new_extent = *_extent;
@@ -494,6 +578,7 @@ namespace vkl
 				createInstance();
 				res = true;
 			}
+			_checked_epoch = DynamicValueEpoch::Global().value();
 		}
 
 		return res;
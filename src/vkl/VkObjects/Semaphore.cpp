@@ -17,12 +17,18 @@ namespace vkl
 		}
 	}
 
-	void Semaphore::create()
+	void Semaphore::create(VkSemaphoreType type, uint64_t initial_value)
 	{
 		assert(_handle == VK_NULL_HANDLE);
+		VkSemaphoreTypeCreateInfo type_ci{
+			.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+			.pNext = nullptr,
+			.semaphoreType = type,
+			.initialValue = initial_value,
+		};
 		VkSemaphoreCreateInfo ci{
 			.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
-			.pNext = nullptr,
+			.pNext = (type == VK_SEMAPHORE_TYPE_BINARY) ? nullptr : &type_ci,
 			.flags = 0,
 		};
 		VK_CHECK(vkCreateSemaphore(_app->device(), &ci, nullptr, &_handle), "Failed to create a semaphore.");
@@ -45,4 +51,35 @@ namespace vkl
 		vkDestroySemaphore(_app->device(), _handle, nullptr);
 		_handle = VK_NULL_HANDLE;
 	}
-}
\ No newline at end of file
+
+	uint64_t TimelineSemaphore::value() const
+	{
+		uint64_t res = 0;
+		VK_CHECK(vkGetSemaphoreCounterValue(device(), _handle, &res), "Failed to get a timeline semaphore value.");
+		return res;
+	}
+
+	VkResult TimelineSemaphore::wait(uint64_t value, uint64_t timeout) const
+	{
+		VkSemaphoreWaitInfo wait_info{
+			.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.semaphoreCount = 1,
+			.pSemaphores = &_handle,
+			.pValues = &value,
+		};
+		return vkWaitSemaphores(device(), &wait_info, timeout);
+	}
+
+	void TimelineSemaphore::signal(uint64_t value)
+	{
+		VkSemaphoreSignalInfo signal_info{
+			.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO,
+			.pNext = nullptr,
+			.semaphore = _handle,
+			.value = value,
+		};
+		VK_CHECK(vkSignalSemaphore(device(), &signal_info), "Failed to signal a timeline semaphore.");
+	}
+}
@@ -1446,12 +1446,39 @@ namespace vkl
 		}
 	}
 
+	ShaderInstanceRegistry::Key Shader::makeRegistryKey(std::string const& collapsed_definitions, size_t string_packed_capacity, bool generate_shader_debug_info) const
+	{
+		return ShaderInstanceRegistry::Key{
+			.path = _cannon_path,
+			.stage = _stage,
+			.definitions = collapsed_definitions,
+			.shader_string_packed_capacity = string_packed_capacity,
+			.generate_debug_info = generate_shader_debug_info,
+		};
+	}
+
+	ShaderInstanceRegistry::CompileFunction Shader::makeCompileFunction(DefinitionsList && definitions, size_t string_packed_capacity, bool generate_shader_debug_info) const
+	{
+		// The compile function must not capture this: the instance can be shared with (and outlive) other Shaders
+		return [app = _app, name = name(), path = _path, stage = _stage, definitions = std::move(definitions), string_packed_capacity, generate_shader_debug_info]() {
+			return std::make_shared<ShaderInstance>(ShaderInstance::CI{
+				.app = app,
+				.name = name,
+				.source_path = path,
+				.stage = stage,
+				.definitions = definitions,
+				.shader_string_packed_capacity = string_packed_capacity,
+				.generate_debug_info = generate_shader_debug_info,
+			});
+		};
+	}
+
 	void Shader::createInstance(SpecializationKey const& key, DefinitionsList const& common_definitions, size_t string_packed_capacity, bool generate_shader_debug_info)
 	{
 		waitForInstanceCreationIFN();
 		if (_specializations.contains(key))
 		{
-			_inst = _specializations[key];
+			_inst = _specializations.get(key);
 			registerDependencies();
 		}
 		else {
@@ -1462,37 +1489,125 @@ namespace vkl
 				definitions = (*_definitions);
 			definitions += common_definitions;
 
-			SpecializationKey lkey = key;
-			
-			_create_instance_task = std::make_shared<AsynchTask>(AsynchTask::CI{
-				.name = "Compiling shader " + _path.string(),
-				.verbosity = AsynchTask::Verbosity::Medium,
-				.priority = TaskPriority::ASAP(),
-				.lambda = [this, definitions = std::move(definitions), string_packed_capacity, lkey, generate_shader_debug_info]() {
-
-					_inst = std::make_shared<ShaderInstance>(ShaderInstance::CI{
-						.app = application(),
-						.name = name(),
-						.source_path = _path,
-						.stage = _stage,
-						.definitions = definitions,
-						.shader_string_packed_capacity = string_packed_capacity,
-						.generate_debug_info = generate_shader_debug_info,
-					});
-
-					const AsynchTask::ReturnType & res = _inst->getCreationResult();
-					
-					if (res.success)
-					{
-						_specializations[lkey] = _inst;
+			ShaderInstanceRegistry::Key registry_key = makeRegistryKey(Collapse(definitions), string_packed_capacity, generate_shader_debug_info);
+			ShaderInstanceRegistry::Acquired acquired = application()->shaderInstanceRegistry().acquire(registry_key, makeCompileFunction(std::move(definitions), string_packed_capacity, generate_shader_debug_info));
+
+			if (acquired.instance)
+			{
+				_inst = std::move(acquired.instance);
+				_specializations.insert(key, _inst);
+				_instance_time = _latest_file_time;
+				registerDependencies();
+			}
+			else
+			{
+				SpecializationKey lkey = key;
+				std::shared_ptr<ShaderInstanceRegistry::PendingCompilation> pending = std::move(acquired.pending);
+				_create_instance_task = std::make_shared<AsynchTask>(AsynchTask::CI{
+					.name = "Acquiring shader " + _path.string(),
+					.verbosity = AsynchTask::Verbosity::High,
+					.priority = TaskPriority::ASAP(),
+					.lambda = [this, lkey, pending]() {
+						if (!pending->result)
+						{
+							// The shared compilation failed (the registry dropped its entry: the next request compiles again)
+							return AsynchTask::ReturnType{
+								.success = false,
+								.can_retry = false,
+								.error_title = pending->error_title,
+								.error_message = pending->error_message,
+							};
+						}
+						_inst = pending->result;
+						_specializations.insert(lkey, _inst);
 						_instance_time = _latest_file_time;
 						registerDependencies();
-					}
+						return AsynchTask::ReturnType{
+							.success = true,
+						};
+					},
+					.dependencies = {pending->task},
+				});
+				application()->threadPool().pushTask(_create_instance_task);
+			}
+		}
+	}
 
-					return res;
-				},
+	static size_t GetShaderStringPackedCapacity(UpdateContext & ctx)
+	{
+		std::string capacity = ctx.commonDefinitions()->getDefinition("SHADER_STRING_CAPACITY");
+		uint32_t packed_capcity = 32;
+		if(!capacity.empty())
+		{	
+			// TODO use a better function that checks the result and can parse hex
+			packed_capcity = std::atoi(capacity.c_str());
+		}
+		return static_cast<size_t>(packed_capcity);
+	}
+
+	void Shader::prepareSpeculativeDefinitions(UpdateContext & ctx, DefinitionsList const& speculative_definitions)
+	{
+		using namespace std::containers_append_operators;
+		
+		static thread_local DefinitionsList definitions = {};
+		definitions = speculative_definitions;
+		definitions += ctx.commonDefinitions()->collapsed();
+		SpecializationKey key{
+			.definitions = Collapse(definitions),
+		};
+
+		bool already_available = (key == _current_key) || std::any_of(_speculative_compilations.begin(), _speculative_compilations.end(), [&key](SpeculativeCompilation const& sc)
+		{
+			return sc.key == key;
+		});
+		// The specialization table may be written by the instance creation task
+		if (!already_available && !_create_instance_task)
+		{
+			already_available = _specializations.contains(key);
+		}
+		if (already_available)
+		{
+			return;
+		}
+
+		const size_t string_packed_capacity = GetShaderStringPackedCapacity(ctx);
+		const bool generate_shader_debug_info = application()->options().generate_shader_debug_info;
+		ShaderInstanceRegistry::Key registry_key = makeRegistryKey(key.definitions, string_packed_capacity, generate_shader_debug_info);
+		ShaderInstanceRegistry::Acquired acquired = application()->shaderInstanceRegistry().acquire(registry_key, makeCompileFunction(DefinitionsList(definitions), string_packed_capacity, generate_shader_debug_info), TaskPriority::WhenPossible());
+		
+		std::shared_ptr<ShaderInstanceRegistry::PendingCompilation> pending = std::move(acquired.pending);
+		if (acquired.instance)
+		{
+			pending = std::make_shared<ShaderInstanceRegistry::PendingCompilation>(ShaderInstanceRegistry::PendingCompilation{
+				.task = nullptr,
+				.result = std::move(acquired.instance),
 			});
-			application()->threadPool().pushTask(_create_instance_task);
+		}
+		_speculative_compilations.push_back(SpeculativeCompilation{
+			.key = std::move(key),
+			.pending = std::move(pending),
+		});
+	}
+
+	void Shader::collectSpeculativeCompilations()
+	{
+		auto it = _speculative_compilations.begin();
+		while (it != _speculative_compilations.end())
+		{
+			const AsynchTask::Status status = it->pending->task ? it->pending->task->getStatus() : AsynchTask::Status::Success;
+			if (AsynchTask::StatusIsFinish(status))
+			{
+				if (status == AsynchTask::Status::Success && !_specializations.contains(it->key))
+				{
+					// Not used yet: must not evict the specializations in use
+					_specializations.insert(it->key, it->pending->result, false);
+				}
+				it = _speculative_compilations.erase(it);
+			}
+			else
+			{
+				++it;
+			}
 		}
 	}
 
@@ -1540,9 +1655,22 @@ namespace vkl
 
 			if (_latest_file_time > _instance_time)
 			{
+				ShaderInstanceRegistry & registry = application()->shaderInstanceRegistry();
+				const size_t string_packed_capacity = GetShaderStringPackedCapacity(ctx);
+				const bool generate_shader_debug_info = application()->options().generate_shader_debug_info;
+				for (const Specialization & spec : _specializations.list())
+				{
+					registry.forget(makeRegistryKey(spec.key.definitions, string_packed_capacity, generate_shader_debug_info), spec.instance);
+				}
 				_specializations.clear();
+				_speculative_compilations.clear();
 				res = true;
 			}
+			else
+			{
+				// Before creating the instance, so that a finished speculative compilation can be used
+				collectSpeculativeCompilations();
+			}
 
 			if (_definitions.hasValue())
 			{
@@ -1569,14 +1697,7 @@ namespace vkl
 		
 			if (!_inst)
 			{
-				std::string capacity = ctx.commonDefinitions()->getDefinition("SHADER_STRING_CAPACITY");
-				uint32_t packed_capcity = 32;
-				if(!capacity.empty())
-				{	
-					// TODO use a better function that checks the result and can parse hex
-					packed_capcity = std::atoi(capacity.c_str());
-				}
-				createInstance(_current_key, ctx.commonDefinitions()->collapsed(), static_cast<size_t>(packed_capcity), application()->options().generate_shader_debug_info);
+				createInstance(_current_key, ctx.commonDefinitions()->collapsed(), GetShaderStringPackedCapacity(ctx), application()->options().generate_shader_debug_info);
 				res = true;
 			}
 		}
@@ -1588,9 +1709,19 @@ namespace vkl
 		ParentType(ci.app, ci.name, ci.hold_instance),
 		_path(ci.source_path),
 		_stage(ci.stage),
-		_definitions(ci.definitions)
+		_definitions(ci.definitions),
+		_specializations(ci.max_specializations, ci.max_specializations_footprint)
 	{
 		_instance_time = FileSystem::TimePoint::min();
+		auto cannon = application()->fileSystem()->resolveAndCannonize(_path);
+		if (cannon.result == that::Result::Success)
+		{
+			_cannon_path = std::move(cannon.value);
+		}
+		else
+		{
+			_cannon_path = _path;
+		}
 		if (ci.create_on_construct)
 		{
 			NOT_YET_IMPLEMENTED;
@@ -1618,4 +1749,246 @@ namespace vkl
 		waitForInstanceCreationIFN();
 		return instance();
 	}
-}
\ No newline at end of file
+
+
+
+	void Shader::SpecializationTable::evictIFN()
+	{
+		// Always keep the most recently used one
+		while ((_list.size() > 1) && ((_list.size() > _max_count) || (_footprint > _max_footprint)))
+		{
+			Specialization const& lru = _list.back();
+			_footprint -= lru.footprint;
+			_index.erase(lru.key);
+			_list.pop_back();
+			++_evicted_count;
+		}
+	}
+
+	std::shared_ptr<ShaderInstance> Shader::SpecializationTable::get(SpecializationKey const& key)
+	{
+		std::shared_ptr<ShaderInstance> res = nullptr;
+		auto found = _index.find(key);
+		if (found != _index.end())
+		{
+			_list.splice(_list.begin(), _list, found->second);
+			res = found->second->instance;
+		}
+		return res;
+	}
+
+	void Shader::SpecializationTable::insert(SpecializationKey const& key, std::shared_ptr<ShaderInstance> const& instance, bool most_recent)
+	{
+		auto found = _index.find(key);
+		if (found != _index.end())
+		{
+			_footprint -= found->second->footprint;
+			_list.erase(found->second);
+			_index.erase(found);
+		}
+		const size_t footprint = instance ? instance->memoryFootprint() : 0;
+		const Specialization spec{
+			.key = key,
+			.instance = instance,
+			.footprint = footprint,
+		};
+		if (most_recent)
+		{
+			_list.push_front(spec);
+			_index[key] = _list.begin();
+		}
+		else
+		{
+			_list.push_back(spec);
+			_index[key] = std::prev(_list.end());
+		}
+		_footprint += footprint;
+		evictIFN();
+	}
+
+	void Shader::SpecializationTable::clear()
+	{
+		_list.clear();
+		_index.clear();
+		_footprint = 0;
+	}
+
+
+	size_t ShaderInstanceRegistry::KeyHasher::operator()(Key const& key) const
+	{
+		std::hash<std::string> hs;
+		std::hash<size_t> h;
+		size_t res = std::filesystem::hash_value(key.path);
+		res = h(res ^ hs(key.definitions));
+		res = h(res ^ static_cast<size_t>(key.stage)) ^ h((key.shader_string_packed_capacity << 1) | static_cast<size_t>(key.generate_debug_info));
+		return res;
+	}
+
+	ShaderInstanceRegistry::ShaderInstanceRegistry(CreateInfo const& ci) :
+		VkObject(ci.app, ci.name)
+	{}
+
+	ShaderInstanceRegistry::~ShaderInstanceRegistry()
+	{
+		// Pending compilations reference this
+		MyVector<std::shared_ptr<AsynchTask>> pending_tasks;
+		{
+			std::unique_lock lock(_mutex);
+			for (auto& [key, entry] : _entries)
+			{
+				if (entry.pending)
+				{
+					pending_tasks.push_back(entry.pending->task);
+				}
+			}
+		}
+		for (auto& task : pending_tasks)
+		{
+			task->cancel();
+			task->waitIFN();
+		}
+	}
+
+	void ShaderInstanceRegistry::sweepExpiredEntriesIFN()
+	{
+		if (_entries.size() >= _sweep_threshold)
+		{
+			std::erase_if(_entries, [](auto const& key_and_entry)
+			{
+				Entry const& entry = key_and_entry.second;
+				return !entry.pending && entry.instance.expired();
+			});
+			_sweep_threshold = std::max<size_t>(64, _entries.size() * 2);
+		}
+	}
+
+	void ShaderInstanceRegistry::reportIFN()
+	{
+		const size_t compiled = _compiled_count.load();
+		const size_t avoided = avoidedCompilationsCount();
+		if (_in_flight == 0 && (compiled != _reported_compiled_count || avoided != _reported_avoided_count))
+		{
+			application()->logger()(std::format("{}: {} shaders compiled, {} compilations avoided ({} reused, {} joined in flight)", 
+				name(), compiled, avoided, _shared_count.load(), _joined_count.load()), Logger::Options::TagInfo);
+			_reported_compiled_count = compiled;
+			_reported_avoided_count = avoided;
+		}
+	}
+
+	ShaderInstanceRegistry::Acquired ShaderInstanceRegistry::acquire(Key const& key, CompileFunction const& compile, TaskPriority priority)
+	{
+		Acquired res;
+		std::shared_ptr<AsynchTask> task_to_push = nullptr;
+		std::unique_lock lock(_mutex);
+		Entry & entry = _entries[key];
+		
+		if (entry.pending)
+		{
+			const AsynchTask::Status status = entry.pending->task->getStatus();
+			if (AsynchTask::StatusIsFinish(status) && status != AsynchTask::Status::Success)
+			{
+				// Failed or canceled: compile again
+				entry.pending = nullptr;
+			}
+		}
+
+		std::shared_ptr<AsynchTask> task_to_promote = nullptr;
+		if (entry.pending)
+		{
+			res.pending = entry.pending;
+			++_joined_count;
+			// Ex: an instance needed now joins a speculative compilation
+			if (res.pending->task->priority() < priority)
+			{
+				task_to_promote = res.pending->task;
+			}
+		}
+		else if (std::shared_ptr<ShaderInstance> instance = entry.instance.lock())
+		{
+			res.instance = std::move(instance);
+			++_shared_count;
+		}
+		else
+		{
+			std::shared_ptr<PendingCompilation> pending = std::make_shared<PendingCompilation>();
+			// Weak: the pending compilation owns the task
+			std::weak_ptr<PendingCompilation> weak_pending = pending;
+			pending->task = std::make_shared<AsynchTask>(AsynchTask::CI{
+				.name = "Compiling shader " + key.path.string(),
+				.verbosity = AsynchTask::Verbosity::Medium,
+				.priority = priority,
+				.lambda = [this, key, weak_pending, compile, attempt = size_t(0)]() mutable {
+					if (attempt > 0)
+					{
+						std::unique_lock lock(_mutex);
+						++_in_flight;
+					}
+					++attempt;
+
+					std::shared_ptr<ShaderInstance> instance = compile();
+					AsynchTask::ReturnType res = instance->getCreationResult();
+					
+					std::unique_lock lock(_mutex);
+					--_in_flight;
+					std::shared_ptr<PendingCompilation> pending = weak_pending.lock();
+					auto it = _entries.find(key);
+					const bool is_entry = pending && it != _entries.end() && it->second.pending == pending;
+					if (res.success)
+					{
+						++_compiled_count;
+						if (pending)
+						{
+							pending->result = instance;
+						}
+						if (is_entry)
+						{
+							it->second.instance = instance;
+							it->second.pending = nullptr;
+						}
+					}
+					else
+					{
+						if (pending)
+						{
+							pending->error_title = res.error_title;
+							pending->error_message = res.error_message;
+						}
+						// Drop the failed entry: a later acquire compiles again (ex: once the source is fixed)
+						if (is_entry)
+						{
+							_entries.erase(it);
+						}
+					}
+					reportIFN();
+					return res;
+				},
+			});
+			entry.pending = pending;
+			res.pending = std::move(pending);
+			++_in_flight;
+			task_to_push = res.pending->task;
+			sweepExpiredEntriesIFN();
+		}
+		lock.unlock();
+		// Pushed outside the lock: a single threaded executor runs the task immediately
+		if (task_to_push)
+		{
+			application()->threadPool().pushTask(task_to_push);
+		}
+		if (task_to_promote)
+		{
+			application()->threadPool().promoteTask(task_to_promote, priority);
+		}
+		return res;
+	}
+
+	void ShaderInstanceRegistry::forget(Key const& key, std::shared_ptr<ShaderInstance> const& instance)
+	{
+		std::unique_lock lock(_mutex);
+		auto it = _entries.find(key);
+		if (it != _entries.end() && !it->second.pending && it->second.instance.lock() == instance)
+		{
+			_entries.erase(it);
+		}
+	}
+}
@@ -255,13 +255,14 @@ namespace vkl
 			//}
 		}
 
-		_dynamic_extent = [&]() {
+		// Read by most of the render targets extents
+		_dynamic_extent = Dyn<VkExtent3D>([&]() {
 			return VkExtent3D{
 				.width = _width,
 				.height = _height,
 				.depth = 1,
 			};
-		};
+		}).memoized(&_extent_epoch);
 
 		initSDL();
 		
@@ -343,6 +344,7 @@ namespace vkl
 
 				_width = width;
 				_height = height;
+				_extent_epoch.advance();
 				_sdl_resized = false;
 			}
 			else if (_gui_resized)
@@ -351,6 +353,7 @@ namespace vkl
 				
 				_width = static_cast<uint32_t>(_desired_resolution[0]);
 				_height = static_cast<uint32_t>(_desired_resolution[1]);
+				_extent_epoch.advance();
 				SDL_SetWindowSize(_window, _desired_resolution[0], _desired_resolution[1]);
 				_sdl_resized = false;
 				_gui_resized = false;